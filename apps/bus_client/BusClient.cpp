@@ -76,7 +76,8 @@ bool BusClient::init_connections()
                 config.reconnect_interval,
                 AmConfig.node_id,
                 config.so_rcvbuf,
-                config.so_sndbuf);
+                config.so_sndbuf,
+                config.binary_arg);
 
             if (!conn[active_connections]) {
                 ERROR("BusConnection creation failed");
@@ -476,6 +477,7 @@ int BusClient::configure(const string& config_)
     AmLcConfig::instance().getMandatoryParameter(cfg, PARAM_SHUTDOWN_CODE_NAME, config.shutdown_code);
     AmLcConfig::instance().getMandatoryParameter(cfg, PARAM_SO_RCVBUF_NAME, config.so_rcvbuf);
     AmLcConfig::instance().getMandatoryParameter(cfg, PARAM_SO_SNDBUF_NAME, config.so_sndbuf);
+    AmLcConfig::instance().getMandatoryParameter(cfg, PARAM_BINARY_ARG_NAME, config.binary_arg);
 
     for(unsigned int i = 0; i < cfg_size(cfg, SECTION_BUS_NODE_NAME); i++) {
         sockaddr_storage addr;
@@ -688,7 +690,8 @@ void BusDynamicQueue::process(AmEvent* ev)
         body["code"] = (unsigned long)e.code;
         body["reason"] = e.reason;
 
-        BusMsg msg(false, string(),application,arg2json(body));
+        BusMsg msg(false, string(),application,string());
+        msg.data = body;
         bus->sendMsg(&msg);
         return;
     }
@@ -85,6 +85,7 @@ class BusClient
         int         reconnect_interval;
         int         query_timeout;
         int         shutdown_code;
+        bool        binary_arg;
         typedef struct {
             string name;
             string application;
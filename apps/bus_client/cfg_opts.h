@@ -16,6 +16,7 @@
 #define PARAM_SHUTDOWN_CODE_NAME    "shutdown_code"
 #define PARAM_SO_RCVBUF_NAME        "so_rcvbuf"
 #define PARAM_SO_SNDBUF_NAME        "so_sndbuf"
+#define PARAM_BINARY_ARG_NAME       "binary_arg"
 #define PARAM_ADDRESS_NAME          "address"
 #define PARAM_PORT_NAME             "port"
 #define PARAM_APP_NAME              "app"
@@ -63,6 +64,7 @@ cfg_opt_t bus_client_opts[] =
     CFG_INT(PARAM_SHUTDOWN_CODE_NAME, SHUTDOWN_DEFAULT_CODE, CFGF_NONE),
     CFG_INT(PARAM_SO_RCVBUF_NAME, 0, CFGF_NONE),
     CFG_INT(PARAM_SO_SNDBUF_NAME, 0, CFGF_NONE),
+    CFG_BOOL(PARAM_BINARY_ARG_NAME, cfg_true, CFGF_NONE),
     CFG_SEC(SECTION_DYN_QUEUE_NAME, dyn_queue, CFGF_MULTI | CFGF_TITLE),
     CFG_SEC(SECTION_BUS_NODE_NAME, bus_node, CFGF_MULTI | CFGF_TITLE),
     CFG_SEC(SECTION_ROUTING_NAME, routing, CFGF_NODEFAULT),
@@ -7,6 +7,7 @@
 #include "connection.h"
 #include "sems.h"
 #include "jsonArg.h"
+#include "binArg.h"
 
 #include <cstring>
 #include <string>
@@ -54,10 +55,11 @@ sctp_sendv(int s, struct iovec *iov, int iov_len,
 
 BusConnection::BusConnection(BusClient *_bus, const sockaddr_storage &_saddr,
                              int _slot, int _reconnect_interval, int _node_id,
-                             int _so_rcvbuf, int _so_sndbuf)
+                             int _so_rcvbuf, int _so_sndbuf, bool _binary_arg)
 :   bus(_bus), saddr(_saddr), slot(_slot), state(Closed),
     reconnect_interval(_reconnect_interval), last_activity(0), node_id(_node_id),
     so_rcvbuf (_so_rcvbuf), so_sndbuf(_so_sndbuf),
+    binary_arg_enabled(_binary_arg), binary_arg(false),
     e_send(0), e_recv(0), reconn(0), last_err(0)
 {
     INFO("%s(): %s:%d", __func__, am_inet_ntop(&saddr).c_str(), am_get_port(&saddr));
@@ -115,6 +117,8 @@ void BusConnection::send_hello()
     pdu.hdr.type   = htons(PDU_TYPE_HELLO);
     pdu.hdr.seq = htonl(++seq);
     pdu.hdr.length = htonl(sizeof(bus_pdu_hello) + info_length);
+    if (binary_arg_enabled)
+        pdu.hdr.status = htons(BUS_HELLO_BINARY_ARG);
 
     bus_pdu_hello_t &hello = pdu.hello;
     hello.node_type = BUS_PEER_TYPE_SEMS_NODE;
@@ -242,6 +246,7 @@ void BusConnection::close()
 
     fd = -1;
     state = Closed;
+    binary_arg = false;
     payload.clear();
     last_err = errno;
     memset(&connected_time, 0, sizeof(connected_time));
@@ -274,6 +279,7 @@ void BusConnection::getInfo(AmArg& ret)
     ret["connected_at"] = timeval2str(connected_time);
     ret["last_err"] = strerror(last_err);
     ret["status"] = state_to_str(state);
+    ret["body_format"] = binary_arg ? "binary" : "json";
 }
 
 void BusConnection::postEvent(const string &sess_id, map<string, string> &params, const AmArg &data)
@@ -332,9 +338,12 @@ void BusConnection::hello_handler(bus_pdu_t *pdu, int info_length)
 {
     bus_pdu_hello_t *hello = &pdu->hello;
 
-    INFO("HELLO: type=%d id=%u ver=0x%08x sign=0x%016lx info='%.*s'",
+    binary_arg = binary_arg_enabled && (pdu->hdr.status & BUS_HELLO_BINARY_ARG);
+
+    INFO("HELLO: type=%d id=%u ver=0x%08x sign=0x%016lx info='%.*s' body=%s",
         hello->node_type, hello->node_id,
-        hello->node_ver, hello->node_sign, info_length, hello + sizeof(struct bus_pdu_hello));
+        hello->node_ver, hello->node_sign, info_length, hello + sizeof(struct bus_pdu_hello),
+        binary_arg ? "binary" : "json");
 }
 
 string BusConnection::inflatePacked(const char* data, uint32_t data_size)
@@ -358,20 +367,29 @@ string BusConnection::inflatePacked(const char* data, uint32_t data_size)
 
 void BusConnection::pdu_handler(int status, const string &src, const string &dst,
                                 const char* body, uint32_t b_size,
-                                const char* packed, uint32_t p_size)
+                                const char* packed, uint32_t p_size,
+                                bool binary)
 {
     map<string, string> params;
     AmArg               event_data;
 
-    if(b_size)
-        if (!json2arg(body, event_data))
+    if(b_size) {
+        if (binary) {
+            if (!bin2arg(body, b_size, event_data))
+                ERROR("failed deserialize binary payload. body size: %u", b_size);
+        } else if (!json2arg(body, event_data))
             ERROR("failed deserialize json payload. body: '%s'",
                   body);
+    }
 
     if(p_size) {
         string conf = inflatePacked(packed, p_size);
         AmArg args;
-        if (!json2arg(conf, args))
+        if (binary) {
+            if (!bin2arg(conf, args))
+                ERROR("failed deserialize binary payload. packed size: %zu",
+                      conf.size());
+        } else if (!json2arg(conf, args))
             ERROR("failed deserialize json payload. packed: '%s'",
                   conf.c_str());
         for(auto& arg : args) {
@@ -550,7 +568,8 @@ void BusConnection::recv()
                 pack = addrs;
             }
 
-            pdu_handler(hdr->status, src, dst, body, body_length, pack, packed_len);
+            pdu_handler(hdr->status, src, dst, body, body_length, pack, packed_len,
+                        hdr->type & PDU_TYPE_BINARY_ARG);
             ++e_recv;
             break;
     }
@@ -611,15 +630,6 @@ bool BusConnection::sendMsg(BusMsg *msg, uint32_t& msg_seq)
     dst.addr = msg->application_method.c_str();
     dst.addr_length = msg->application_method.length();
 
-    data = msg->body.c_str();
-    data_size = msg->body.length();
-
-    uint8_t     src_length = src.addr_length;
-    uint8_t     dst_length = dst.addr_length;
-
-    src_length += !!src_length; // append 0
-    dst_length += !!dst_length; // append 0
-
     int type, pdu_len;
     if(msg->is_query) {
         type = PDU_TYPE_QUERY_PACKED;
@@ -628,6 +638,28 @@ bool BusConnection::sendMsg(BusMsg *msg, uint32_t& msg_seq)
         type = PDU_TYPE_EVENT;
         pdu_len = sizeof(bus_pdu_event_t);
     }
+
+    string encoded;
+    if(msg->body.empty() && !isArgUndef(msg->data)) {
+        if(binary_arg) {
+            type |= PDU_TYPE_BINARY_ARG;
+            arg2bin(msg->data, encoded);
+        } else {
+            encoded = arg2json(msg->data);
+        }
+        data = encoded.data();
+        data_size = encoded.size();
+    } else {
+        data = msg->body.c_str();
+        data_size = msg->body.length();
+    }
+
+    uint8_t     src_length = src.addr_length;
+    uint8_t     dst_length = dst.addr_length;
+
+    src_length += !!src_length; // append 0
+    dst_length += !!dst_length; // append 0
+
     bus_pdu_t pdu = {
                 .hdr = {
                     .magic  = htonl(BUS_MAGIC),
@@ -659,7 +691,8 @@ bool BusConnection::sendMsg(BusMsg *msg, uint32_t& msg_seq)
     DBG("BUS_%s: %.*s: %.*s",
         msg->is_query ? "QUERY" : "EVENT",
         (int)dst.addr_length, (char *)dst.addr,
-        (int)data_size, (char *)data);
+        (type & PDU_TYPE_BINARY_ARG) ? 8 : (int)data_size,
+        (type & PDU_TYPE_BINARY_ARG) ? "<binary>" : (char *)data);
 
     if (sctp_sendv(fd, iov, iov_len, &sinfo, SCTP_UNORDERED | MSG_NOSIGNAL) < 0) {
         ERROR("sctp_send(): %m");
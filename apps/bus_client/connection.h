@@ -28,6 +28,12 @@ using std::string;
 #define     PDU_TYPE_QUERY_PACKED       0x0003
 #define     PDU_TYPE_QUERY_PACKED_RESP  0x8003
 
+/** flag for the QUERY/EVENT types: body and packed data are in the binary AmArg encoding */
+#define     PDU_TYPE_BINARY_ARG         0x0100
+
+/** HELLO/HELLO_RESP status flag: node accepts PDU_TYPE_BINARY_ARG */
+#define     BUS_HELLO_BINARY_ARG        0x0001
+
 
 #pragma pack (1)
 
@@ -145,6 +151,8 @@ using std::string;
                             failed_count,
                             so_rcvbuf,
                             so_sndbuf;
+        bool                binary_arg_enabled,
+                            binary_arg;
         state_t             state;
         uint64_t            last_activity;
 
@@ -170,10 +178,11 @@ using std::string;
         void send_hello();
         void pdu_handler(int status, const string &src, const string &dst,
                          const char* body, uint32_t b_size,
-                         const char* packed, uint32_t p_size);
+                         const char* packed, uint32_t p_size,
+                         bool binary);
         string inflatePacked(const char* data, uint32_t data_size);
     public:
-        BusConnection(BusClient *_bus, const sockaddr_storage &_addr, int _slot, int _reconnect_interval, int node_id, int _so_rcvbuf, int _so_sndbuf);
+        BusConnection(BusClient *_bus, const sockaddr_storage &_addr, int _slot, int _reconnect_interval, int node_id, int _so_rcvbuf, int _so_sndbuf, bool _binary_arg);
         ~BusConnection();
 
         void handler(uint32_t ev);
@@ -186,7 +195,7 @@ using std::string;
         void postError(const string &sess_id, const string &err_str);
 
         bus_pdu_type_t get_pdu_type(uint16_t type) {
-            switch (type) {
+            switch (type & ~PDU_TYPE_BINARY_ARG) {
             case PDU_TYPE_HELLO:               return BUS_PDU_HELLO;
             case PDU_TYPE_HELLO_RESP:          return BUS_PDU_HELLO_RESP;
             case PDU_TYPE_QUERY:               return BUS_PDU_QUERY;
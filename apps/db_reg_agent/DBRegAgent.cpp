@@ -27,6 +27,7 @@
 #include "AmSession.h"
 #include "AmEventDispatcher.h"
 #include "AmLcConfig.h"
+#include "AmStatistics.h"
 
 #include <unistd.h>
 #include <stdlib.h>
@@ -65,6 +66,9 @@ static void _timer_cb(RegTimer* timer, long subscriber_id, int data2) {
 DBRegAgent::DBRegAgent(const string& _app_name)
   : AmDynInvokeFactory(_app_name),
     AmEventQueue(this),
+    domain_shaper(MOD_NAME "_domain"),
+    stat_registers_sent(stat_group(Counter, MOD_NAME, "registers_sent").addAtomicCounter()),
+    stat_deregisters_sent(stat_group(Counter, MOD_NAME, "deregisters_sent").addAtomicCounter()),
     uac_auth_i(NULL)
 {
 }
@@ -135,6 +139,10 @@ int DBRegAgent::onLoad()
 
   }
 
+  int min_interval_per_domain = cfg.getParameterInt("min_interval_per_domain_msec", 0);
+  if (min_interval_per_domain > 0)
+    domain_shaper.set_min_interval(min_interval_per_domain);
+
   delete_removed_registrations =
     cfg.getParameter("delete_removed_registrations", "yes") == "yes";
 
@@ -415,7 +423,8 @@ void DBRegAgent::createRegistration(long subscriber_id,
       registrations_mut.lock();
     }
 
-    AmSIPRegistration* reg = new AmSIPRegistration(handle, reg_info, "" /*MOD_NAME*/);
+    AmSIPRegistration* reg = new AmSIPRegistration(handle, reg_info, "" /*MOD_NAME*/,
+						   domain_shaper);
     reg->setExpiresInterval(expires);
 
     registrations[subscriber_id] = reg;
@@ -607,6 +616,8 @@ void DBRegAgent::onRegistrationActionEvent(RegistrationActionEvent* reg_action_e
 	    setRegistrationTimer(reg_action_ev->subscriber_id, error_retry_interval,
 				 RegistrationActionEvent::Register);
 	  }
+	} else {
+	  stat_registers_sent.inc();
 	}
       }
       registrations_mut.unlock();
@@ -641,6 +652,8 @@ void DBRegAgent::onRegistrationActionEvent(RegistrationActionEvent* reg_action_e
 	  // 			 RegistrationActionEvent::Deregister);
 	  // }
 	  }
+	} else {
+	  stat_deregisters_sent.inc();
 	}
       }
       registrations_mut.unlock();
@@ -1179,7 +1192,7 @@ void DBRegAgent::invoke(const string& method,
 // /////////////// processor thread /////////////////
 
 DBRegAgentProcessorThread::DBRegAgentProcessorThread()
-  : AmEventQueue(this), stopped(false) {
+  : AmEventQueue(this), stopped(false), shaper(MOD_NAME) {
 }
 
 DBRegAgentProcessorThread::~DBRegAgentProcessorThread() {
@@ -1189,35 +1202,18 @@ void DBRegAgentProcessorThread::on_stop() {
 }
 
 void DBRegAgentProcessorThread::rateLimitWait() {
-  DBG("applying rate limit %u initial requests per %us",
-      DBRegAgent::ratelimit_rate, DBRegAgent::ratelimit_per);
-
-  DBG("allowance before ratelimit: %f", allowance);
-
-  struct timeval current;
-  struct timeval time_passed;
-  gettimeofday(&current, 0);
-  timersub(&current, &last_check, &time_passed);
-  memcpy(&last_check, &current, sizeof(struct timeval));
-  double seconds_passed = (double)time_passed.tv_sec +
-    (double)time_passed.tv_usec / 1000000.0;
-  allowance += seconds_passed * 
-    (double) DBRegAgent::ratelimit_rate / (double)DBRegAgent::ratelimit_per;
-
-  if (allowance > (double)DBRegAgent::ratelimit_rate)
-    allowance = (double)DBRegAgent::ratelimit_rate; // enough time passed, but limit to max
-  if (allowance < 1.0) {
-    useconds_t sleep_time = 1000000.0 * (1.0 - allowance) *
-      ((double)DBRegAgent::ratelimit_per/(double)DBRegAgent::ratelimit_rate);
-    DBG("not enough allowance (%f), sleeping %d useconds", allowance, sleep_time);
-    usleep(sleep_time);
-    allowance=0.0;
-    gettimeofday(&last_check, 0);
-  } else {
-    allowance -= 1.0;
-  }
+  RegShaper::timep now = std::chrono::system_clock::now();
+  RegShaper::timep next_attempt;
+
+  if (!shaper.check_rate_limit(MOD_NAME, now, next_attempt))
+    return;
 
-  DBG("allowance left: %f", allowance);
+  // the token at next_attempt is already taken for us
+  useconds_t sleep_time =
+    std::chrono::duration_cast<std::chrono::microseconds>(next_attempt - now).count();
+  DBG("rate limit %u requests per %us reached, sleeping %u useconds",
+      DBRegAgent::ratelimit_rate, DBRegAgent::ratelimit_per, sleep_time);
+  usleep(sleep_time);
 }
 
 void DBRegAgentProcessorThread::run() {
@@ -1228,12 +1224,12 @@ void DBRegAgentProcessorThread::run() {
 
   mysqlpp::Connection::thread_start();
 
-  // initialize ratelimit
-  gettimeofday(&last_check, NULL);
+  // initialize ratelimit: bucket of ratelimit_rate requests,
+  // empty on start for the slow start
+  shaper.set_rate(DBRegAgent::ratelimit_rate, DBRegAgent::ratelimit_per * 1000,
+		  DBRegAgent::ratelimit_rate);
   if (DBRegAgent::ratelimit_slowstart)
-    allowance = 0.0;
-  else
-    allowance = DBRegAgent::ratelimit_rate;
+    shaper.drain(MOD_NAME, std::chrono::system_clock::now());
 
   reg_agent = DBRegAgent::instance();
   while (!stopped) {
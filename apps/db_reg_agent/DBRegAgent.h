@@ -37,6 +37,7 @@ using std::queue;
 
 #include "AmApi.h"
 #include "AmSipRegistration.h"
+#include "RegShaper.h"
 
 #include "RegistrationTimer.h"
 
@@ -96,8 +97,8 @@ class DBRegAgentProcessorThread
 
   void rateLimitWait();
 
-  double allowance;
-  struct timeval last_check;
+  // single bucket for all REGISTER requests
+  RegShaper shaper;
 
  protected:
   void process(AmEvent* ev);
@@ -167,6 +168,12 @@ class DBRegAgent
   RegistrationTimer registration_scheduler;
   DBRegAgentProcessorThread registration_processor;
 
+  // per registrar domain REGISTER interval
+  RegShaper domain_shaper;
+
+  AtomicCounter& stat_registers_sent;
+  AtomicCounter& stat_deregisters_sent;
+
   bool loadRegistrations();
 
   void createDBRegistration(long subscriber_id, mysqlpp::Connection& conn);
@@ -24,61 +24,103 @@
  */
 
 #include "RegistrationTimer.h"
+#include "AmStatistics.h"
+
 #include <stdlib.h>
+#include <algorithm>
+
+#define MS_PER_BUCKET ((uint64_t)TIMER_BUCKET_LENGTH * 1000)
+
+void RegTimerBucket::link(RegTimer* timer) {
+  timer->prev = NULL;
+  timer->next = first;
+  if (first)
+    first->prev = timer;
+  first = timer;
+  timer->slot = this;
+}
+
+void RegTimerBucket::unlink(RegTimer* timer) {
+  if (timer->prev)
+    timer->prev->next = timer->next;
+  else
+    first = timer->next;
+  if (timer->next)
+    timer->next->prev = timer->prev;
+  timer->prev = timer->next = NULL;
+  timer->slot = NULL;
+}
 
 RegistrationTimer::RegistrationTimer()
- : current_bucket(0)
+  : current_tick(now_ms() / TIMER_RESOLUTION_MS),
+    load(2 * TIMER_BUCKETS, 0),
+    stat_scheduled(stat_group(Gauge, MOD_NAME, "timers_scheduled").addAtomicCounter()),
+    stat_fired(stat_group(Counter, MOD_NAME, "timers_fired").addAtomicCounter())
 {
+}
+
+uint64_t RegistrationTimer::now_ms() {
   struct timeval now;
   gettimeofday(&now, 0);
-  current_bucket_start = now.tv_sec; 
+  return now.tv_sec * 1000ULL + now.tv_usec / 1000;
 }
 
 // unsafe!
-int RegistrationTimer::get_bucket_index(time_t tv) {
-  time_t buckets_start_time = current_bucket_start;
-
-  if (tv < buckets_start_time)
-    return -1;
+void RegistrationTimer::update_load(unsigned int bucket, int delta) {
+  unsigned int i = TIMER_BUCKETS + bucket;
+  load[i] += delta;
+  for (i >>= 1; i; i >>= 1)
+    load[i] = std::min(load[2*i], load[2*i+1]);
+}
 
-  // offset
-  int bucket_index =  (tv - buckets_start_time);
-  bucket_index /= TIMER_BUCKET_LENGTH;
-  
-  if (bucket_index > TIMER_BUCKETS) { // too far in the future
-    ERROR("requested timer too far in the future (index %d vs %d TIMER_BUCKETS)",
-	  bucket_index, TIMER_BUCKETS);
-    return -2;
+// unsafe!
+unsigned int RegistrationTimer::find_leastloaded(unsigned int from, unsigned int to) {
+  // covering subtrees from left to right
+  unsigned int left[32], right[32];
+  int n_left = 0, n_right = 0;
+  for (unsigned int l = from + TIMER_BUCKETS, r = to + TIMER_BUCKETS + 1;
+       l < r; l >>= 1, r >>= 1) {
+    if (l & 1) left[n_left++] = l++;
+    if (r & 1) right[n_right++] = --r;
   }
+  while (n_right)
+    left[n_left++] = right[--n_right];
 
-  bucket_index += current_bucket;
-  bucket_index %= TIMER_BUCKETS; // circular array
+  // node 0 is not used by the tree
+  unsigned int best = 0;
+  for (int i = 0; i < n_left; i++)
+    if (!best || load[left[i]] <= load[best])
+      best = left[i];
 
-  return bucket_index;
+  // descend to the latest leaf with the subtree minimum
+  while (best < TIMER_BUCKETS)
+    best = load[2*best+1] <= load[2*best] ? 2*best+1 : 2*best;
+
+  return best - TIMER_BUCKETS;
 }
 
-void RegistrationTimer::place_timer(RegTimer* timer, int bucket_index) {
-  if (bucket_index < 0) {
-    ERROR("trying to place_timer with negative index (%i)", bucket_index);
-    return;
-  }
+// unsafe!
+bool RegistrationTimer::place_timer(RegTimer* timer) {
+  uint64_t tick = timer->expires_ms / TIMER_RESOLUTION_MS;
+  if (tick <= current_tick)
+    return false;
 
-  if (bucket_index > TIMER_BUCKETS) {
-    ERROR("trying to place_timer with too high index (%i vs %i)",
-	  bucket_index, TIMER_BUCKETS);
-    return;
-  }
+  wheel[tick % TIMER_WHEEL_SLOTS].link(timer);
+  timer->load_bucket = (timer->expires_ms / MS_PER_BUCKET) % TIMER_BUCKETS;
+  update_load(timer->load_bucket, 1);
+  stat_scheduled.inc();
 
-  std::list<RegTimer*>::iterator it = buckets[bucket_index].timers.begin();
-  while (it != buckets[bucket_index].timers.end() &&
-	 (timer->expires > (*it)->expires))
-    it++;
-  
-  buckets[bucket_index].timers.insert(it, timer);
-  size_t b_size = buckets[bucket_index].timers.size();
- 
- DBG("inserted timer [%p] in bucket %i (now sized %zd)",
-      timer, bucket_index, b_size);
+  DBG("inserted timer [%p] for %llu ms in slot %llu",
+      timer, (unsigned long long)timer->expires_ms,
+      (unsigned long long)(tick % TIMER_WHEEL_SLOTS));
+  return true;
+}
+
+// unsafe!
+void RegistrationTimer::unplace_timer(RegTimer* timer) {
+  timer->slot->unlink(timer);
+  update_load(timer->load_bucket, -1);
+  stat_scheduled.dec();
 }
 
 void RegistrationTimer::fire_timer(RegTimer* timer) {
@@ -93,24 +135,26 @@ bool RegistrationTimer::insert_timer(RegTimer* timer) {
     return false;
 
   buckets_mut.lock();
-  int bucket_index = get_bucket_index(timer->expires);
+  if (timer->slot)
+    unplace_timer(timer);
 
-  if (bucket_index == -1) {
-    // already expired, fire timer
+  if (timer->expires >= 0 &&
+      (uint64_t)timer->expires * 1000 >=
+      current_tick * TIMER_RESOLUTION_MS + (TIMER_BUCKETS - 1) * MS_PER_BUCKET) {
+    ERROR("trying to place timer too far in the future");
     buckets_mut.unlock();
-    DBG("inserting already expired timer [%p], firing", timer);
-    fire_timer(timer);
     return false;
   }
 
-  if (bucket_index == -2) {
-    ERROR("trying to place timer too far in the future");
+  timer->expires_ms = timer->expires > 0 ? timer->expires * 1000ULL : 0;
+  if (!place_timer(timer)) {
+    // already expired, fire timer
     buckets_mut.unlock();
+    DBG("inserting already expired timer [%p], firing", timer);
+    fire_timer(timer);
     return false;
   }
 
-  place_timer(timer, bucket_index);
-
   buckets_mut.unlock();
 
  return true;
@@ -123,24 +167,10 @@ bool RegistrationTimer::remove_timer(RegTimer* timer) {
   bool res = false;
 
   buckets_mut.lock();
-  int bucket_index = get_bucket_index(timer->expires);
-
-  if (bucket_index < 0) {
-    buckets_mut.unlock();
-    return false;
+  if (timer->slot) {
+    unplace_timer(timer);
+    res = true;
   }
-
-  std::list<RegTimer*>& timerlist = buckets[bucket_index].timers;
-
-  for (std::list<RegTimer*>::iterator it = timerlist.begin();
-       it != timerlist.end(); it++) {
-    if (*it == timer) {
-      timerlist.erase(it);
-      res = true;
-      break;
-    }
-  }
-
   buckets_mut.unlock();  
 
   if (res) {
@@ -152,41 +182,42 @@ bool RegistrationTimer::remove_timer(RegTimer* timer) {
 }
 
 void RegistrationTimer::run_timers() {
-  std::list<RegTimer*> timers_tbf;
+  std::vector<RegTimer*> timers_tbf;
 
-  struct timeval now;
-  gettimeofday(&now, 0);
+  uint64_t now_tick = now_ms() / TIMER_RESOLUTION_MS;
 
   buckets_mut.lock();
 
-  // bucket over?
-  if (now.tv_sec > current_bucket_start + TIMER_BUCKET_LENGTH) {
-    timers_tbf.insert(timers_tbf.begin(),
-		      buckets[current_bucket].timers.begin(),
-		      buckets[current_bucket].timers.end());
-    buckets[current_bucket].timers.clear();
-    current_bucket++;
-    current_bucket %= TIMER_BUCKETS;
-    current_bucket_start += TIMER_BUCKET_LENGTH;
-    // DBG("turned bucket to %i", current_bucket);
+  if (now_tick <= current_tick) {
+    buckets_mut.unlock();
+    return;
   }
 
-  // move timers from current_bucket
-  RegTimerBucket& bucket = buckets[current_bucket];
-  std::list<RegTimer*>::iterator it = bucket.timers.begin();
-  while (it != bucket.timers.end() &&
-	 now.tv_sec > (*it)->expires) {
-    std::list<RegTimer*>::iterator c_it = it;
-    it++;
-    timers_tbf.push_back(*c_it);
-    bucket.timers.erase(c_it);
+  // visit the slots passed since the last run, every slot at most once
+  uint64_t ticks = now_tick - current_tick;
+  if (ticks > TIMER_WHEEL_SLOTS)
+    ticks = TIMER_WHEEL_SLOTS;
+
+  for (uint64_t t = now_tick - ticks + 1; t <= now_tick; t++) {
+    RegTimer* timer = wheel[t % TIMER_WHEEL_SLOTS].first;
+    while (timer) {
+      RegTimer* next = timer->next;
+      // timers of the later revolutions stay in the slot
+      if (timer->expires_ms / TIMER_RESOLUTION_MS <= now_tick) {
+	unplace_timer(timer);
+	timers_tbf.push_back(timer);
+      }
+      timer = next;
+    }
   }
+  current_tick = now_tick;
 
   buckets_mut.unlock();
 
   if (!timers_tbf.empty()) {
     DBG("firing %zd timers", timers_tbf.size());
-    for (std::list<RegTimer*>::iterator it=timers_tbf.begin();
+    stat_fired.inc(timers_tbf.size());
+    for (std::vector<RegTimer*>::iterator it=timers_tbf.begin();
 	 it != timers_tbf.end(); it++) {
       fire_timer(*it);
     }
@@ -239,63 +270,67 @@ void RegistrationTimer::on_stop() {
 bool RegistrationTimer::insert_timer_leastloaded(RegTimer* timer,
 						 time_t from_time,
 						 time_t to_time) {
+  if (!timer)
+    return false;
 
   buckets_mut.lock();
+  if (timer->slot)
+    unplace_timer(timer);
 
-  int from_index = get_bucket_index(from_time);
-  int to_index = get_bucket_index(to_time);
+  // earliest time the wheel can still fire
+  uint64_t start_ms = (current_tick + 1) * TIMER_RESOLUTION_MS;
+  uint64_t from_ms = from_time > 0 ? from_time * 1000ULL : 0;
+  uint64_t to_ms = to_time > 0 ? to_time * 1000ULL : 0;
 
-  if (from_index < 0 && to_index < 0) {
-    ERROR("could not find timer bucket indices - "
-	  "from_index = %d, to_index = %d, from_time = %ld, to_time %ld, "
-	  "current_bucket_start = %ld\n",
-	  from_index, to_index, from_time, to_time, current_bucket_start);
+  if (to_ms < start_ms) {
+    DBG("to_time (%ld) in the past - firing at the next tick", to_time);
+    to_ms = start_ms;
+  }
+  if (from_ms < start_ms) {
+    // use now .. to_time
+    DBG("from_time (%ld) in the past - searching least loaded from now()", from_time);
+    from_ms = start_ms;
+  }
+  if (from_ms > to_ms)
+    from_ms = to_ms;
+
+  uint64_t from_bucket = from_ms / MS_PER_BUCKET;
+  uint64_t to_bucket = to_ms / MS_PER_BUCKET;
+  if (to_bucket - start_ms / MS_PER_BUCKET >= TIMER_BUCKETS) {
+    ERROR("requested timer too far in the future "
+	  "(from_time = %ld, to_time = %ld)\n", from_time, to_time);
     buckets_mut.unlock();
     return false;
   }
 
-  if (from_index < 0) {
-    // use now .. to_index
-    DBG("from_time (%ld) in the past - searching load loaded from now()", from_time);
-    from_index  = current_bucket;
+  // load buckets are a circular array, the range may wrap around
+  unsigned int from_index = from_bucket % TIMER_BUCKETS;
+  unsigned int to_index = to_bucket % TIMER_BUCKETS;
+  unsigned int res_index;
+  if (from_index <= to_index) {
+    res_index = find_leastloaded(from_index, to_index);
+  } else {
+    unsigned int head = find_leastloaded(from_index, TIMER_BUCKETS - 1);
+    unsigned int tail = find_leastloaded(0, to_index);
+    res_index = load[TIMER_BUCKETS + tail] <= load[TIMER_BUCKETS + head] ?
+      tail : head;
   }
-  // find least loaded bucket
-  int res_index = from_index;
-  size_t least_load = buckets[from_index].timers.size();
-
-  int i = from_index;
-  while  (i != to_index) {
-    if (buckets[i].timers.size() <= least_load) {
-      least_load = buckets[i].timers.size();
-      res_index = i;
-    }
 
-    i++;
-    i %= TIMER_BUCKETS;
-  }
-  DBG("found bucket %i with least load %zd (between %i and %i)",
-      res_index, least_load, from_index, to_index);
+  uint64_t res_bucket = from_bucket + (res_index + TIMER_BUCKETS - from_index) % TIMER_BUCKETS;
+  DBG("found bucket %u with least load %u (between %u and %u)",
+      res_index, load[TIMER_BUCKETS + res_index], from_index, to_index);
 
-  // update expires to some random value inside the selected bucket
-  int diff = (unsigned)res_index - current_bucket;
+  // spread the timers inside the selected bucket
+  uint64_t lo = std::max(from_ms, res_bucket * MS_PER_BUCKET);
+  uint64_t hi = std::min(to_ms, (res_bucket + 1) * MS_PER_BUCKET - 1);
+  timer->expires_ms = lo + (uint64_t)rand() % (hi - lo + 1);
+  timer->expires = timer->expires_ms / 1000;
+  DBG("setting expires to %llu ms (between %ld and %ld)",
+      (unsigned long long)timer->expires_ms, from_time, to_time);
+
+  place_timer(timer);
 
-  if ((unsigned)res_index < current_bucket) {
-    diff+=TIMER_BUCKETS;
-  }
-  
-  timer->expires = current_bucket_start + 
-    diff * TIMER_BUCKET_LENGTH + // bucket start
-    rand() % TIMER_BUCKET_LENGTH;
-  DBG("setting expires to %ld (between %ld and %ld)",
-      timer->expires, from_time, to_time);
-
-  place_timer(timer, res_index);
-     
   buckets_mut.unlock();
 
-  return false;
+  return true;
 }
-
-
-
-
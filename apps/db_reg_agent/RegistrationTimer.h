@@ -26,19 +26,25 @@
 #ifndef _RegistrationTimer_h_
 #define _RegistrationTimer_h_
 
-#include <list>
 #include <vector>
 
 #include <sys/time.h>
+#include <stdint.h>
 
 #include "log.h"
 #include "AmThread.h"
 
+class AtomicCounter;
+
 #define TIMER_BUCKET_LENGTH 10     // 10 sec
-#define TIMER_BUCKETS       40000  // 40000 buckets (400000 sec, 111 hrs)
+#define TIMER_BUCKETS       65536  // 65536 buckets (655360 sec, 182 hrs)
 
 // 100 ms == 100000 us
 #define TIMER_RESOLUTION 100000
+#define TIMER_RESOLUTION_MS (TIMER_RESOLUTION / 1000)
+
+// wheel revolution: 8192 * 100 ms (819 sec)
+#define TIMER_WHEEL_SLOTS 8192
 
 class RegTimer;
 typedef void (*timer_cb)(RegTimer*, long /*data1*/,int /*data2*/);
@@ -54,14 +60,33 @@ class RegTimer {
     int            data2;
 
     RegTimer()
-      : expires(0), cb(0), data1(0), data2(0) { }
+      : expires(0), cb(0), data1(0), data2(0),
+      expires_ms(0), load_bucket(0),
+      prev(NULL), next(NULL), slot(NULL) { }
+
+ private:
+    friend class RegistrationTimer;
+    friend class RegTimerBucket;
+
+    // exact firing time, set by the RegistrationTimer
+    uint64_t expires_ms;
+    unsigned int load_bucket;
+
+    // wheel slot links
+    RegTimer* prev;
+    RegTimer* next;
+    RegTimerBucket* slot;
 };
 
+/** wheel slot: intrusive list of timers */
 class RegTimerBucket {
  public:
-  std::list<RegTimer*> timers;
+  RegTimer* first;
 
- RegTimerBucket() { }
+  RegTimerBucket() : first(NULL) { }
+
+  void link(RegTimer* timer);
+  void unlink(RegTimer* timer);
 };
 
 /**
@@ -71,11 +96,14 @@ class RegTimerBucket {
   the timer in some least loaded interval between from_time and to_time
   in order to flatten out re-register spikes (due to restart etc).
 
-  Timer granularity is seconds.
+  Timers are kept in a hashed timing wheel of TIMER_WHEEL_SLOTS slots
+  of TIMER_RESOLUTION each, timers from the later wheel revolutions
+  wait in the same slot. Insert and remove are O(1).
 
-  Timers are saved in buckets of TIMER_BUCKET_LENGTH seconds. the buckets
-  array is a circular one, the current bucket starts from the time 
-  current_bucket_start (in seconds as in time(2)).
+  Load is accounted in buckets of TIMER_BUCKET_LENGTH seconds, so
+  insert_timer_leastloaded() finds the least loaded bucket with a range
+  minimum query over the load tree and spreads the timers inside the
+  bucket with TIMER_RESOLUTION precision.
 
   The timer object is owned by the caller, and MUST be valid until it is
   fired or removed.
@@ -84,14 +112,27 @@ class RegTimerBucket {
 class RegistrationTimer
 : public AmThread
 {
-  time_t current_bucket_start;
-  // every bucket contains TIMER_BUCKET_LENGTH seconds of timers
-  RegTimerBucket buckets[TIMER_BUCKETS];
-  unsigned int current_bucket;
+  RegTimerBucket wheel[TIMER_WHEEL_SLOTS];
+  // last processed wheel tick (ms since epoch / TIMER_RESOLUTION_MS)
+  uint64_t current_tick;
+
+  // min-tree over the load buckets: leaves at [TIMER_BUCKETS..2*TIMER_BUCKETS)
+  std::vector<unsigned int> load;
+
   AmMutex buckets_mut;
 
-  int get_bucket_index(time_t tv);
-  void place_timer(RegTimer* timer, int bucket_index);
+  AtomicCounter& stat_scheduled;
+  AtomicCounter& stat_fired;
+
+  static uint64_t now_ms();
+
+  void update_load(unsigned int bucket, int delta);
+  /** least loaded bucket in [from, to], the latest one on equal load */
+  unsigned int find_leastloaded(unsigned int from, unsigned int to);
+
+  /** @return false if the timer is expired already */
+  bool place_timer(RegTimer* timer);
+  void unplace_timer(RegTimer* timer);
   void fire_timer(RegTimer* timer);
   void run_timers();
 
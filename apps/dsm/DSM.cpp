@@ -38,6 +38,7 @@
 #include "AmSipHeaders.h"
 #include "AmEventDispatcher.h"
 #include "SystemDSM.h"
+#include "DSMBench.h"
 
 #include <string>
 #include <fstream>
@@ -1172,6 +1173,11 @@ void DSMFactory::invoke(const string& method, const AmArg& args,
       ret.push(500);
       ret.push(status);
     }
+  } else if (method == "benchmark"){
+    unsigned int calls = DEFAULT_DSM_BENCH_CALLS;
+    if (args.size() && str2i(arg2str(args.get(0)), calls))
+      throw AmDynInvoke::Exception(400, "wrong calls count");
+    DSMBenchmark(calls, ret);
   } else if(method == "_list"){ 
     ret.push(AmArg("postDSMEvent"));
     ret.push(AmArg("reloadDSMs"));
@@ -1184,6 +1190,7 @@ void DSMFactory::invoke(const string& method, const AmArg& args,
     ret.push(AmArg("listDSMs"));
     ret.push(AmArg("registerApplication"));
     ret.push(AmArg("createSystemDSM"));
+    ret.push(AmArg("benchmark"));
   }  else
     throw AmDynInvoke::NotImplemented(method);
 }
@@ -0,0 +1,184 @@
+#include "DSMBench.h"
+
+#include "DSMSession.h"
+#include "DSMStateEngine.h"
+#include "DSMStateDiagramCollection.h"
+
+#include "AmSession.h"
+#include "AmPlaylist.h"
+#include "AmUtils.h"
+#include "log.h"
+
+#include <chrono>
+#include <set>
+
+typedef std::chrono::steady_clock bench_clock;
+
+#define DSM_BENCH_DIAG "dsm_bench_ivr"
+
+// typical IVR: greeting, PIN entry with retry, goodbye
+static const char* bench_chart =
+  "initial state START;\n"
+  "state MENU\n"
+  "  enter {\n"
+  "    flushPlaylist();\n"
+  "    playPrompt($menu_prompt);\n"
+  "    set($digits=\"\");\n"
+  "  };\n"
+  "state COLLECT;\n"
+  "state CHECK\n"
+  "  enter {\n"
+  "    inc($attempts);\n"
+  "  };\n"
+  "state GOODBYE\n"
+  "  enter {\n"
+  "    flushPlaylist();\n"
+  "    playPrompt(goodbye);\n"
+  "  };\n"
+  "state END\n"
+  "  enter {\n"
+  "    set($finished=1);\n"
+  "    stop(false);\n"
+  "  };\n"
+  "transition \"start\" START - sessionStart / {\n"
+  "    set($attempts=0);\n"
+  "    set($menu_prompt=enter_pin);\n"
+  "    playPrompt(welcome);\n"
+  "  } -> MENU;\n"
+  "transition \"first digit\" MENU - key(#key < 10) / {\n"
+  "    flushPlaylist();\n"
+  "    append($digits, #key);\n"
+  "  } -> COLLECT;\n"
+  "transition \"digit\" COLLECT - key(#key < 10) / append($digits, #key) -> COLLECT;\n"
+  "transition \"submit\" COLLECT - key(#key == 11) / {\n"
+  "    set($entered=$digits);\n"
+  "    repost();\n"
+  "  } -> CHECK;\n"
+  "transition \"pin ok\" CHECK - test($entered == 1234) / set($menu_prompt=main_menu) -> GOODBYE;\n"
+  "transition \"retry\" CHECK - test($attempts < 3) / {\n"
+  "    eval($left=3 - $attempts);\n"
+  "    set($menu_prompt=retry_pin);\n"
+  "  } -> MENU;\n"
+  "transition \"failed\" CHECK - / set($menu_prompt=failed) -> GOODBYE;\n"
+  "transition \"bye\" (MENU, COLLECT, CHECK, GOODBYE) - hangup() -> END;\n";
+
+namespace {
+
+/** DSM session without media and signaling */
+class DSMBenchSession
+  : public DSMSession
+{
+  std::set<DSMDisposable*> gc_trash;
+
+ public:
+  unsigned int prompts;
+
+  DSMBenchSession() : prompts(0) { }
+  ~DSMBenchSession() {
+    for (std::set<DSMDisposable*>::iterator it =
+	   gc_trash.begin(); it != gc_trash.end(); it++)
+      delete *it;
+  }
+
+  void playPrompt(const string& name, bool loop, bool front) { prompts++; }
+  void playFile(const string& name, bool loop, bool front) { prompts++; }
+  void playSilence(unsigned int length, bool front) { }
+  void recordFile(const string& name) { }
+  unsigned int getRecordLength() { return 0; }
+  unsigned int getRecordDataSize() { return 0; }
+  void stopRecord() { }
+  void setInOutPlaylist() { }
+  void setInputPlaylist() { }
+  void setOutputPlaylist() { }
+
+  void addToPlaylist(AmPlaylistItem* item, bool front) { delete item; }
+  void flushPlaylist() { }
+  void setPromptSet(const string& name) { }
+  void addSeparator(const string& name, bool front) { }
+  void connectMedia() { }
+  void disconnectMedia() { }
+  void mute() { }
+  void unmute() { }
+
+  void B2BconnectCallee(const string& remote_party,
+			const string& remote_uri,
+			bool relayed_invite) { }
+  void B2BterminateOtherLeg() { }
+  void B2BaddReceivedRequest(const AmSipRequest& req) { }
+  void B2BsetRelayEarlyMediaSDP(bool enabled) { }
+  void B2BsetHeaders(const string& hdr, bool replaceCRLF) { }
+  void B2BclearHeaders() { }
+  void B2BaddHeader(const string& hdr) { }
+  void B2BremoveHeader(const string& hdr) { }
+
+  void transferOwnership(DSMDisposable* d) { gc_trash.insert(d); }
+  void releaseOwnership(DSMDisposable* d) { gc_trash.erase(d); }
+};
+
+}
+
+static void sendKey(DSMStateEngine& engine, AmSession* sess, DSMSession* sc_sess,
+		    int key, unsigned int& events) {
+  map<string, string> params;
+  params["key"] = int2str(key);
+  params["duration"] = "100";
+  engine.runEvent(sess, sc_sess, DSMCondition::Key, &params);
+  events++;
+}
+
+static void sendPin(DSMStateEngine& engine, AmSession* sess, DSMSession* sc_sess,
+		    const char* pin, unsigned int& events) {
+  for (const char* c = pin; *c; c++)
+    sendKey(engine, sess, sc_sess, *c - '0', events);
+  sendKey(engine, sess, sc_sess, 11, events); // '#'
+}
+
+void DSMBenchmark(unsigned int calls, AmArg& ret) {
+  DSMStateDiagramCollection diags;
+  if (!diags.loadChart(bench_chart, DSM_BENCH_DIAG, "", false)) {
+    ret["error"] = "failed to load the benchmark chart";
+    return;
+  }
+
+  // dummy session: the chart does not use signaling
+  AmSession sess;
+  sess.setLocalTag("dsm_bench");
+
+  unsigned int events = 0;
+  unsigned int prompts = 0;
+  unsigned int completed = 0;
+
+  bench_clock::time_point start = bench_clock::now();
+  for (unsigned int i = 0; i < calls; i++) {
+    DSMBenchSession sc_sess;
+    DSMStateEngine engine;
+    diags.addToEngine(&engine);
+
+    if (!engine.init(&sess, &sc_sess, DSM_BENCH_DIAG, DSMCondition::SessionStart)) {
+      ret["error"] = "failed to init the benchmark chart";
+      return;
+    }
+    events++;
+
+    // every second caller mistypes the PIN once
+    if (i % 2)
+      sendPin(engine, &sess, &sc_sess, "4321", events);
+    sendPin(engine, &sess, &sc_sess, "1234", events);
+
+    engine.runEvent(&sess, &sc_sess, DSMCondition::Hangup, NULL);
+    events++;
+
+    prompts += sc_sess.prompts;
+    if (sc_sess.var["finished"] == "1")
+      completed++;
+  }
+  double ms = std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+
+  ret["calls"] = (int)calls;
+  ret["completed"] = (int)completed;
+  ret["events"] = (int)events;
+  ret["prompts"] = (int)prompts;
+  ret["time_ms"] = ms;
+  ret["calls_per_sec"] = ms > 0 ? calls * 1000.0 / ms : 0.0;
+  ret["events_per_sec"] = ms > 0 ? events * 1000.0 / ms : 0.0;
+}
@@ -0,0 +1,12 @@
+#ifndef _DSMBench_h_
+#define _DSMBench_h_
+
+#include "AmArg.h"
+
+#define DEFAULT_DSM_BENCH_CALLS 10000
+
+/** replay the IVR-like chart (menu, PIN entry with retry, hangup)
+ *  for the given number of calls and report calls/events rate */
+void DSMBenchmark(unsigned int calls, AmArg& ret);
+
+#endif
@@ -71,12 +71,12 @@ DSMCall::~DSMCall()
 
 /** returns whether var exists && var==value*/
 bool DSMCall::checkVar(const string& var_name, const string& var_val) {
-  map<string, string>::iterator it = var.find(var_name);
+  VarMapT::iterator it = var.find(var_name);
   return (it != var.end()) && (it->second == var_val);
 }
 
 string DSMCall::getVar(const string& var_name) {
-  map<string, string>::iterator it = var.find(var_name);
+  VarMapT::iterator it = var.find(var_name);
   if (it != var.end())
     return it->second;
   return "";
@@ -743,6 +743,8 @@ bool DSMChartReader::decode(DSMStateDiagram* e, const string& chart,
 
   }
 
+  e->compile();
+
   for (vector<DSMModule*>::iterator it=
 	 mods.begin(); it != mods.end(); it++)
     out_mods.push_back(*it);
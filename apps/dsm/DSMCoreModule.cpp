@@ -37,6 +37,9 @@
 
 #include "jsonArg.h"
 
+#include <limits.h>
+#include <ctype.h>
+
 DSMCoreModule::DSMCoreModule() {
 }
 
@@ -274,12 +277,12 @@ EXEC_ACTION_START(SCPlayPromptLoopedAction){
   sc_sess->playPrompt(resolveVars(arg, sess, sc_sess, event_params), true);
 } EXEC_ACTION_END;
 
-void setEventParameters(const DSMSession* sc_sess, const string& var, VarMapT& params) {
+void setEventParameters(const DSMSession* sc_sess, const string& var, map<string, string>& params) {
   if (var.empty())
     return;
 
   if (var == "var") {
-    params = sc_sess->var;
+    varsToMap(sc_sess->var, params);
   } else {
     vector<string> vars = explode(var, ";");
     for (vector<string>::iterator it = vars.begin(); it != vars.end(); it++) {
@@ -288,7 +291,7 @@ void setEventParameters(const DSMSession* sc_sess, const string& var, VarMapT& p
       if (varname.length() && varname[varname.length()-1]=='.') {
 	DBG("adding postEvent param %s (struct)", varname.c_str());
 	
-	map<string, string>::const_iterator lb = sc_sess->var.lower_bound(varname);
+	VarMapT::const_iterator lb = sc_sess->var.lower_bound(varname);
 	while (lb != sc_sess->var.end()) {
 	  if ((lb->first.length() < varname.length()) ||
 	      strncmp(lb->first.c_str(), varname.c_str(), varname.length()))
@@ -579,7 +582,7 @@ void log_vars(const string& l_arg, AmSession* sess,
   }
 
   _LOG((int)lvl, "FSM: variables set ---\n");
-  for (map<string, string>::iterator it = 
+  for (VarMapT::iterator it = 
 	 sc_sess->var.begin(); it != sc_sess->var.end(); it++) {
     _LOG((int)lvl, "FSM:  $%s='%s'\n", it->first.c_str(), it->second.c_str());
   }
@@ -827,12 +830,12 @@ EXEC_ACTION_START(SCClearArrayAction) {
 
   varprefix+=".";
 
-  map<string, string>::iterator lb = sc_sess->var.lower_bound(varprefix);
+  VarMapT::iterator lb = sc_sess->var.lower_bound(varprefix);
   while (lb != sc_sess->var.end()) {
     if ((lb->first.length() < varprefix.length()) ||
 	strncmp(lb->first.c_str(), varprefix.c_str(),varprefix.length()))
       break;
-    map<string, string>::iterator lb_d = lb;
+    VarMapT::iterator lb_d = lb;
     lb++;
     sc_sess->var.erase(lb_d);    
   }
@@ -920,12 +923,19 @@ EXEC_ACTION_START(SCSubStrAction) {
 EXEC_ACTION_START(SCIncAction) {
   string var_name = (arg.length() && arg[0] == '$')?
     arg.substr(1) : arg;
+  DSMVar& var = sc_sess->var[var_name];
   unsigned int val = 0;
-  str2i(sc_sess->var[var_name], val);
-  sc_sess->var[var_name] = int2str(val+1);
+  long v;
+  // counter set by inc() before: number is cached, nothing to parse
+  if (var.length() && var.length() <= 10 && isdigit(var[0]) &&
+      var.getInt(v) && v <= UINT_MAX)
+    val = (unsigned int)v;
+  else
+    str2i(var, val);
+  var.setInt((unsigned int)(val+1));
 
   DBG("inc: $%s now '%s'", 
-      var_name.c_str(), sc_sess->var[var_name].c_str());
+      var_name.c_str(), var.c_str());
 
 } EXEC_ACTION_END;
 
@@ -1057,16 +1067,29 @@ bool TestDSMCondition::match(AmSession* sess, DSMSession* sc_sess, DSMCondition:
     return false;
   }
   
+  bool l_len = lhs.length() > 5 &&
+    (lhs.compare(0, 4, "len(") == 0) && lhs[lhs.length()-1] == ')';
+  bool r_len = rhs.length() > 5 &&
+    (rhs.compare(0, 4, "len(") == 0) && rhs[rhs.length()-1] == ')';
+
+  if ((ttype == Less || ttype == Gt) && !l_len && !r_len) {
+    // numbers of the variables are cached by DSMVar, no string copies
+    long l_i, r_i;
+    if (resolveInt(lhs, sess, sc_sess, event_params, l_i) &&
+	resolveInt(rhs, sess, sc_sess, event_params, r_i)) {
+      DBG("test %ld vs %ld", l_i, r_i);
+      return ttype == Less ? l_i < r_i : l_i > r_i;
+    }
+  }
+
   string l;
   string r;
-  if (lhs.length() > 5 && 
-      (lhs.substr(0, 4) == "len(") && lhs[lhs.length()-1] == ')') {
+  if (l_len) {
     l = int2str((unsigned int)resolveVars(lhs.substr(4, lhs.length()-5), sess, sc_sess, event_params).length());
   } else {    
     l   = resolveVars(lhs, sess, sc_sess, event_params);
   }
-  if (rhs.length() > 5 && 
-      rhs.substr(0, 4) == "len(" && rhs[rhs.length()-1] == ')') {
+  if (r_len) {
     r = resolveVars(rhs.substr(4, rhs.length()-5), sess, sc_sess, event_params).length();
   } else {    
     r   = resolveVars(rhs, sess, sc_sess, event_params);
@@ -1202,7 +1225,7 @@ EXEC_ACTION_START(SCDIAction) {
       AmArg var_struct;
       string varprefix = p+".";
       bool has_vars = false;
-      map<string, string>::iterator lb = sc_sess->var.lower_bound(varprefix);
+      VarMapT::iterator lb = sc_sess->var.lower_bound(varprefix);
       while (lb != sc_sess->var.end()) {
 	if ((lb->first.length() < varprefix.length()) ||
 	    strncmp(lb->first.c_str(), varprefix.c_str(),varprefix.length()))
@@ -1210,7 +1233,7 @@ EXEC_ACTION_START(SCDIAction) {
 	
 	string varname = lb->first.substr(varprefix.length());
 	if (varname.find(".") == string::npos)
-	  var_struct[varname] = lb->second;
+	  var_struct[varname] = lb->second.str();
 	else
 	  string2argarray(varname, lb->second, var_struct);
 	
@@ -1226,11 +1249,11 @@ EXEC_ACTION_START(SCDIAction) {
       
       unsigned int i=0;
       while (true) {
-	map<string, string>::iterator it = 
+	VarMapT::iterator it = 
 	  sc_sess->var.find(p+"["+int2str(i)+"]");
 	if (it == sc_sess->var.end())
 	  break;
-	var_array.push(it->second);
+	var_array.push(it->second.str());
 	i++;
       }
     } else if (p.length() > 6 &&  
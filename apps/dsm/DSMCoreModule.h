@@ -153,14 +153,15 @@ class TestDSMCondition
     Less,
     Gt
   };
-  string lhs;
-  string rhs;
+  DSMParam lhs;
+  DSMParam rhs;
   CondType ttype;
 
  public:
   TestDSMCondition(const string& expr, DSMCondition::EventType e);
   bool match(AmSession* sess, DSMSession* sc_sess, DSMCondition::EventType event,
 	     map<string,string>* event_params);
+  bool isEventSpecific() const { return type != DSMCondition::Any; }
 };
 
 #endif
@@ -26,6 +26,7 @@
  */
 
 #include <sstream>
+#include <memory>
 #include "DSMModule.h"
 #include "DSMSession.h"
 #include "AmSession.h"
@@ -93,7 +94,7 @@ string resolveVars(const string ts, AmSession* sess,
     case '$': {
       if (s.substr(1, 1)=="$")
 	return "$";
-      map<string, string>::iterator it = sc_sess->var.find(s.substr(1));
+      VarMapT::iterator it = sc_sess->var.find(s.substr(1));
       if (it != sc_sess->var.end())
 	return it->second;
       return "";
@@ -142,6 +143,314 @@ string resolveVars(const string ts, AmSession* sess,
   return s;
 }
 
+/** parsed form of the resolveVars() expression */
+class DSMExpr {
+ public:
+  enum ExprType {
+    Literal,
+    Var,
+    EventParam,
+    SessionParam,
+    Sum,
+    Diff
+  };
+
+  enum SessionAttr {
+    LocalTag,
+    User,
+    Domain,
+    RemoteTag,
+    CallId,
+    LocalUri,
+    LocalParty,
+    RemoteUri,
+    RemoteParty
+  };
+
+  ExprType type;
+  SessionAttr attr;
+  // literal value, variable or event parameter name
+  string value;
+  // strtol() of the literal value
+  bool value_is_int;
+  long value_int;
+
+  // operands for Sum/Diff, and the value if they are not numbers
+  std::unique_ptr<DSMExpr> lhs;
+  std::unique_ptr<DSMExpr> rhs;
+  std::unique_ptr<DSMExpr> fallback;
+
+  DSMExpr(ExprType type, const string& value = string())
+    : type(type), attr(LocalTag), value(value)
+  {
+    char* endptr = NULL;
+    value_int = strtol(value.c_str(), &endptr, 10);
+    value_is_int = endptr && *endptr == '\0';
+  }
+
+  static DSMExpr* parse(const string& s, bool eval_ops);
+  static DSMExpr* parseValue(const string& s);
+
+  string eval(AmSession* sess, DSMSession* sc_sess,
+	      map<string,string>* event_params) const;
+  /** @return isNumber(eval()), n = atoi(eval()) */
+  bool evalInt(AmSession* sess, DSMSession* sc_sess,
+	       map<string,string>* event_params, int& n) const;
+  /** @return n = strtol(eval()) if the whole value is parsed */
+  bool evalLong(AmSession* sess, DSMSession* sc_sess,
+		map<string,string>* event_params, long& n) const;
+};
+
+// mirrors resolveVars(const string, ...) below
+DSMExpr* DSMExpr::parse(const string& ts, bool eval_ops) {
+  if (ts.empty())
+    return new DSMExpr(Literal);
+
+  if (!eval_ops)
+    return parseValue(ts);
+
+  string s;
+  s.reserve(ts.length());
+  for (string::const_iterator it = ts.begin(); it != ts.end(); it++) {
+    if (*it != ' ')
+      s += *it;
+  }
+
+  ExprType op = Diff;
+  string::size_type p = s.find('-');
+  if (p == string::npos) {
+    op = Sum;
+    p = s.find('+');
+  }
+  if (p == string::npos)
+    return parseValue(s);
+
+  DSMExpr* e = new DSMExpr(op);
+  e->lhs.reset(parse(s.substr(0, p), true));
+  e->rhs.reset(parse(s.substr(p+1), true));
+  e->fallback.reset(parseValue(s));
+  return e;
+}
+
+DSMExpr* DSMExpr::parseValue(const string& s) {
+  if (s.empty())
+    return new DSMExpr(Literal);
+
+  switch (s[0]) {
+  case '$':
+    if (s.compare(1, 1, "$") == 0)
+      return new DSMExpr(Literal, "$");
+    return new DSMExpr(Var, s.substr(1));
+  case '#':
+    if (s.compare(1, 1, "#") == 0)
+      return new DSMExpr(Literal, "#");
+    return new DSMExpr(EventParam, s.substr(1));
+  case '@': {
+    if (s.compare(1, 1, "@") == 0 || s.length() < 2)
+      return new DSMExpr(Literal, "@");
+
+    static const struct {
+      const char* name;
+      SessionAttr attr;
+    } attrs[] = {
+      { "local_tag", LocalTag },
+      { "user", User },
+      { "domain", Domain },
+      { "remote_tag", RemoteTag },
+      { "callid", CallId },
+      { "local_uri", LocalUri },
+      { "local_party", LocalParty },
+      { "remote_uri", RemoteUri },
+      { "remote_party", RemoteParty }
+    };
+
+    for (size_t i = 0; i < sizeof(attrs)/sizeof(attrs[0]); i++) {
+      if (s.compare(1, string::npos, attrs[i].name) == 0) {
+	DSMExpr* e = new DSMExpr(SessionParam);
+	e->attr = attrs[i].attr;
+	return e;
+      }
+    }
+    return new DSMExpr(Literal);
+  }
+  default:
+    return new DSMExpr(Literal, trim(s, "\""));
+  }
+}
+
+string DSMExpr::eval(AmSession* sess, DSMSession* sc_sess,
+		     map<string,string>* event_params) const {
+  switch (type) {
+  case Literal:
+    return value;
+
+  case Var: {
+    VarMapT::iterator it = sc_sess->var.find(value);
+    if (it != sc_sess->var.end())
+      return it->second;
+    return string();
+  }
+
+  case EventParam: {
+    if (!event_params)
+      return string();
+    map<string, string>::iterator it = event_params->find(value);
+    if (it != event_params->end())
+      return it->second;
+    return string();
+  }
+
+  case SessionParam:
+    switch (attr) {
+    case LocalTag: return sess->getLocalTag();
+    case User: return sess->dlg->getUser();
+    case Domain: return sess->dlg->getDomain();
+    case RemoteTag: return sess->getRemoteTag();
+    case CallId: return sess->getCallID();
+    case LocalUri: return sess->dlg->getLocalUri();
+    case LocalParty: return sess->dlg->getLocalParty();
+    case RemoteUri: return sess->dlg->getRemoteUri();
+    case RemoteParty: return sess->dlg->getRemoteParty();
+    }
+    return string();
+
+  case Sum:
+  case Diff: {
+    int a, b;
+    if (lhs->evalInt(sess, sc_sess, event_params, a) &&
+	rhs->evalInt(sess, sc_sess, event_params, b))
+      return int2str(type == Sum ? a + b : a - b);
+    return fallback->eval(sess, sc_sess, event_params);
+  }
+  }
+  return string();
+}
+
+bool DSMExpr::evalInt(AmSession* sess, DSMSession* sc_sess,
+		      map<string,string>* event_params, int& n) const {
+  switch (type) {
+  case Var: {
+    // number of the variable is cached, and digits only means non-negative
+    VarMapT::iterator it = sc_sess->var.find(value);
+    long v;
+    if (it == sc_sess->var.end() || it->second.empty() ||
+	!std::isdigit(it->second[0]) || !it->second.getInt(v))
+      return false;
+    n = (int)v;
+    return true;
+  }
+
+  case Sum:
+  case Diff: {
+    int a, b;
+    if (lhs->evalInt(sess, sc_sess, event_params, a) &&
+	rhs->evalInt(sess, sc_sess, event_params, b)) {
+      // negative result is not a number for the enclosing expression
+      n = type == Sum ? a + b : a - b;
+      return n >= 0;
+    }
+    return fallback->evalInt(sess, sc_sess, event_params, n);
+  }
+
+  default: {
+    string s = eval(sess, sc_sess, event_params);
+    if (!isNumber(s))
+      return false;
+    n = atoi(s.c_str());
+    return true;
+  }
+  }
+}
+
+bool DSMExpr::evalLong(AmSession* sess, DSMSession* sc_sess,
+		       map<string,string>* event_params, long& n) const {
+  switch (type) {
+  case Literal:
+    n = value_int;
+    return value_is_int;
+
+  case Var: {
+    VarMapT::iterator it = sc_sess->var.find(value);
+    if (it == sc_sess->var.end()) {
+      // as strtol() of the empty value
+      n = 0;
+      return true;
+    }
+    return it->second.getInt(n);
+  }
+
+  default: {
+    string s = eval(sess, sc_sess, event_params);
+    char* endptr = NULL;
+    n = strtol(s.c_str(), &endptr, 10);
+    return endptr && *endptr == '\0';
+  }
+  }
+}
+
+DSMParam::DSMParam() {
+  expr[0] = expr[1] = NULL;
+}
+
+DSMParam::DSMParam(const string& s)
+  : string(s) {
+  expr[0] = expr[1] = NULL;
+}
+
+DSMParam::DSMParam(const DSMParam& p)
+  : string(p) {
+  expr[0] = expr[1] = NULL;
+}
+
+DSMParam::~DSMParam() {
+  reset();
+}
+
+void DSMParam::reset() {
+  for (int i = 0; i < 2; i++)
+    delete expr[i].exchange(NULL);
+}
+
+DSMParam& DSMParam::operator=(const string& s) {
+  reset();
+  string::operator=(s);
+  return *this;
+}
+
+DSMParam& DSMParam::operator=(const DSMParam& p) {
+  if (this != &p) {
+    reset();
+    string::operator=(p);
+  }
+  return *this;
+}
+
+const DSMExpr* DSMParam::getExpr(bool eval_ops) const {
+  std::atomic<const DSMExpr*>& e = expr[eval_ops ? 1 : 0];
+  const DSMExpr* res = e.load(std::memory_order_acquire);
+  if (res)
+    return res;
+
+  // parallel sessions may parse it concurrently, first one wins
+  const DSMExpr* parsed = DSMExpr::parse(*this, eval_ops);
+  if (e.compare_exchange_strong(res, parsed, std::memory_order_acq_rel))
+    return parsed;
+  delete parsed;
+  return res;
+}
+
+string resolveVars(const DSMParam& s, AmSession* sess,
+		   DSMSession* sc_sess, map<string,string>* event_params,
+		   bool eval_ops) {
+  return s.getExpr(eval_ops)->eval(sess, sc_sess, event_params);
+}
+
+bool resolveInt(const DSMParam& s, AmSession* sess,
+		DSMSession* sc_sess, map<string,string>* event_params,
+		long& n) {
+  return s.getExpr(false)->evalLong(sess, sc_sess, event_params, n);
+}
+
 void splitCmd(const string& from_str, 
 			    string& cmd, string& params) {
   size_t b_pos = from_str.find('(');
@@ -37,6 +37,7 @@ class DSMSession;
 using std::string;
 
 #include <typeinfo>
+#include <atomic>
 
 // script modules interface
 // factory only: it produces actions and conditions from script statements.
@@ -82,10 +83,39 @@ typedef void* (*SCFactoryCreate)();
 #define SC_EXPORT(class_name)			\
   EXPORT_SC_FACTORY(SC_FACTORY_EXPORT,class_name)
 
+class DSMExpr;
+
+/**
+ * action/condition parameter which is evaluated with resolveVars().
+ *
+ * the expression is parsed on the first evaluation and the parsed
+ * form is reused by all sessions running the chart, so the parameter
+ * must not be modified in place after the chart is loaded.
+ */
+class DSMParam
+  : public string
+{
+  // parsed expression without/with operators evaluation
+  mutable std::atomic<const DSMExpr*> expr[2];
+
+  void reset();
+
+ public:
+  DSMParam();
+  explicit DSMParam(const string& s);
+  DSMParam(const DSMParam& p);
+  ~DSMParam();
+
+  DSMParam& operator=(const string& s);
+  DSMParam& operator=(const DSMParam& p);
+
+  const DSMExpr* getExpr(bool eval_ops) const;
+};
+
 class SCStrArgAction   
 : public DSMAction {
  protected:
-  string arg;
+  DSMParam arg;
  public:
   SCStrArgAction(const string& m_arg); 
 };
@@ -120,8 +150,8 @@ class SCStrArgAction
 #define DEF_ACTION_2P(CL_Name)						\
   class CL_Name								\
   : public DSMAction {							\
-    string par1;							\
-    string par2;							\
+    DSMParam par1;							\
+    DSMParam par2;							\
   public:								\
     CL_Name(const string& arg);						\
     bool execute(AmSession* sess, DSMSession* sc_sess,			\
@@ -220,6 +250,21 @@ string resolveVars(const string s, AmSession* sess,
 		   DSMSession* sc_sess, map<string,string>* event_params,
 		   bool eval_ops = false);
 
+/** same as above, using the parsed form of the parameter */
+string resolveVars(const DSMParam& s, AmSession* sess,
+		   DSMSession* sc_sess, map<string,string>* event_params,
+		   bool eval_ops = false);
+
+/**
+ * resolveVars() value as parsed by strtol() over the whole value.
+ * variables are not copied and their number is cached by DSMVar,
+ * literals are parsed once
+ * @return false if the value is not an integer
+ */
+bool resolveInt(const DSMParam& s, AmSession* sess,
+		DSMSession* sc_sess, map<string,string>* event_params,
+		long& n);
+
 void splitCmd(const string& from_str, 
 		string& cmd, string& params);
 
@@ -236,7 +281,7 @@ void splitCmd(const string& from_str,
 #define DEF_SCCondition(cond_name)		\
   class cond_name				\
   : public DSMCondition {			\
-    string arg;					\
+    DSMParam arg;				\
     bool inv;					\
     						\
   public:					\
@@ -250,8 +295,8 @@ void splitCmd(const string& from_str,
 #define DEF_CONDITION_2P(cond_name)					\
   class cond_name							\
   : public DSMCondition {						\
-    string par1;							\
-    string par2;							\
+    DSMParam par1;							\
+    DSMParam par2;							\
     bool inv;								\
   public:								\
     cond_name(const string& arg, bool inv);				\
@@ -31,6 +31,7 @@
 #include "AmEvent.h"
 #include "AmSipMsg.h"
 #include "AmAudioFile.h"
+#include "DSMVar.h"
 
 #include <string>
 using std::string;
@@ -99,7 +100,6 @@ using std::map;
 #define CLR_STRERROR				\
   var["strerror"] = "";
 
-typedef map<string, string> VarMapT;
 typedef map<string, AmArg>  AVarMapT;
 
 class DSMDisposable;
@@ -100,17 +100,21 @@ bool DSMStateDiagramCollection::loadFile(const string& filename, const string& n
     DBG("dsm text\n------------------\n%s\n------------------", s.c_str());
   }
 
+  return loadChart(s, name, mod_path, check_dsm);
+}
+
+bool DSMStateDiagramCollection::loadChart(const string& chart, const string& name,
+					  const string& mod_path, bool check_dsm) {
   diags.push_back(DSMStateDiagram(name));
   DSMChartReader cr;
-  if (!cr.decode(&diags.back(), s, mod_path, this, mods)) {
+  if (!cr.decode(&diags.back(), chart, mod_path, this, mods)) {
     ERROR("DonkeySM decode script error!");
     return false;
   }
   if (check_dsm) {
     string report;
     if (!diags.back().checkConsistency(report)) {
-      WARN("consistency check failed on '%s' from file '%s':", 
-	   name.c_str(), filename.c_str());
+      WARN("consistency check failed on '%s':", name.c_str());
       WARN("------------------------------------------"
 	   "%s\n"
 	   "------------------------------------------\n", report.c_str());
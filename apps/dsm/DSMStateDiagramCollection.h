@@ -48,6 +48,9 @@ class DSMStateDiagramCollection
   bool loadFile(const string& filename, const string& name, 
 		const string& load_path,
 		const string& mod_path, bool debug_dsm, bool check_dsm);
+  /** decode chart text (includes already resolved) */
+  bool loadChart(const string& chart, const string& name,
+		 const string& mod_path, bool check_dsm);
   void addToEngine(DSMStateEngine* e);
   bool hasDiagram(const string& name);
   vector<string> getDiagramNames();
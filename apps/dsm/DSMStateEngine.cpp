@@ -38,7 +38,7 @@
 #include "DSM.h" // for DSMFactory::MonitoringFullCallgraph
 
 DSMStateDiagram::DSMStateDiagram(const string& name) 
-  : name(name) {
+  : name(name), initial_state_idx(-1) {
 }
 
 DSMStateDiagram::~DSMStateDiagram() {
@@ -56,6 +56,8 @@ void DSMStateDiagram::addState(const State& state, bool is_initial) {
   }
 
   states.push_back(state);
+  // first one wins, as with the lookup by name
+  state_index.insert(std::make_pair(state.name, states.size() - 1));
   if (is_initial) {
     if (!initial_state.empty()) {
       ERROR("trying to override initial state '%s' with '%s'",
@@ -119,14 +121,16 @@ bool DSMStateDiagram::addTransition(const DSMTransition& trans) {
 }
 
 State* DSMStateDiagram::getState(const string& s_name) {
-  // find target state
-  for (vector<State>::iterator target_st = 
-	 states.begin(); target_st != states.end(); target_st++) {
-    if (target_st->name == s_name) 
-      return  &(*target_st);
-  }
+  std::unordered_map<string, size_t>::iterator it = state_index.find(s_name);
+  if (it == state_index.end())
+    return NULL;
+  return &states[it->second];
+}
 
-  return NULL;
+State* DSMStateDiagram::getState(const DSMTransition& trans) {
+  if (trans.to_state_idx >= 0)
+    return &states[trans.to_state_idx];
+  return getState(trans.to_state);
 }
 
 State* DSMStateDiagram::getInitialState() {
@@ -135,9 +139,49 @@ State* DSMStateDiagram::getInitialState() {
 	  name.c_str());
     return NULL;
   }
+  if (initial_state_idx >= 0)
+    return &states[initial_state_idx];
   return getState(initial_state);
 }
 
+void DSMStateDiagram::compile() {
+  std::unordered_map<string, size_t>::iterator s_it;
+
+  s_it = state_index.find(initial_state);
+  initial_state_idx = s_it != state_index.end() ? (int)s_it->second : -1;
+
+  for (vector<State>::iterator it=
+	 states.begin(); it != states.end(); it++) {
+    it->event_transitions.assign(DSMCondition::EventTypeCount,
+				 vector<unsigned int>());
+
+    for (size_t i = 0; i < it->transitions.size(); i++) {
+      DSMTransition& tr = it->transitions[i];
+
+      s_it = state_index.find(tr.to_state);
+      tr.to_state_idx = s_it != state_index.end() ? (int)s_it->second : -1;
+
+      // a transition with a condition on the event type can be skipped
+      // for all other events: the condition would not match anyway
+      int tr_event = -1;
+      for (vector<DSMCondition*>::iterator c_it=
+	     tr.precond.begin(); c_it != tr.precond.end(); c_it++) {
+	if (!(*c_it)->invert && (*c_it)->isEventSpecific()) {
+	  tr_event = (*c_it)->type;
+	  break;
+	}
+      }
+
+      for (int ev = 0; ev < DSMCondition::EventTypeCount; ev++) {
+	if (tr_event < 0 || tr_event == ev)
+	  it->event_transitions[ev].push_back(i);
+      }
+    }
+  }
+
+  DBG("compiled diag '%s': %zd states", name.c_str(), states.size());
+}
+
 
 bool DSMStateDiagram::checkConsistency(string& report) {
   bool res = true;
@@ -363,7 +407,7 @@ bool DSMStateEngine::runactions(vector<DSMElement*>::iterator from,
 	    }
 	  }
 
-	  cnt_values.push_back(make_pair(v->second, ""));
+	  cnt_values.push_back(make_pair(v->second.str(), string()));
 	  DBG("      '%s'", v->second.c_str());
 	  v++;
 	}
@@ -387,7 +431,7 @@ bool DSMStateEngine::runactions(vector<DSMElement*>::iterator from,
       // save counter k
       VarMapT::iterator c_it = sc_sess->var.find(k_name);
       bool k_exists = c_it != sc_sess->var.end();
-      string k_save = k_exists ? c_it->second : string("");
+      string k_save = k_exists ? c_it->second.str() : string("");
 
       // save counter v for Struct
       bool v_exists = false; string v_save;
@@ -493,6 +537,11 @@ bool DSMCondition::_match(AmSession* sess, DSMSession* sc_sess,
   return invert? (!match(sess,sc_sess,event,event_params)) : match(sess, sc_sess, event, event_params);
 }
 
+bool DSMCondition::isEventSpecific() const {
+  // match() of the derived conditions may not check the type
+  return typeid(*this) == typeid(DSMCondition) && type != Any;
+}
+
 bool DSMCondition::match(AmSession* sess, DSMSession* sc_sess,
 			 DSMCondition::EventType event,
 			 map<string,string>* event_params) {
@@ -534,8 +583,18 @@ void DSMStateEngine::runEvent(AmSession* sess, DSMSession* sc_sess,
 
 
       DBG(" > state '%s'", current->name.c_str());
-      for (vector<DSMTransition>::iterator tr = current->transitions.begin();
-	   tr != current->transitions.end();tr++) {
+
+      // check only the transitions which may match the event, if indexed
+      const vector<unsigned int>* ev_transitions = NULL;
+      if (active_event < (int)current->event_transitions.size())
+	ev_transitions = &current->event_transitions[active_event];
+
+      size_t tr_count = ev_transitions ?
+	ev_transitions->size() : current->transitions.size();
+      for (size_t tr_i = 0; tr_i < tr_count; tr_i++) {
+	vector<DSMTransition>::iterator tr = current->transitions.begin() +
+	  (ev_transitions ? (*ev_transitions)[tr_i] : tr_i);
+
 	if (tr->is_exception != is_exception)
 	  continue;
 	
@@ -552,7 +611,7 @@ void DSMStateEngine::runEvent(AmSession* sess, DSMSession* sc_sess,
 	  
 	  //  matched all preconditions
 	  // find target state
-	  State* target_st = current_diag->getState(tr->to_state);
+	  State* target_st = current_diag->getState(*tr);
 	  if (!target_st) {
 	    ERROR("script writer error: transition '%s' from "
 		  "state '%s' to unknown state '%s'\n",
@@ -738,7 +797,7 @@ State::~State() {
 }
 
 DSMTransition::DSMTransition()
-  : is_exception(false)
+  : to_state_idx(-1), is_exception(false)
 {
 }
 
@@ -37,6 +37,7 @@ class DSMSession;
 
 #include <map>
 using std::map;
+#include <unordered_map>
 #include <vector>
 using std::vector;
 #include <string>
@@ -120,7 +121,9 @@ class DSMCondition
     RelayOnSipRequest,
     RelayOnSipReply,
     RelayOnB2BRequest,
-    RelayOnB2BReply
+    RelayOnB2BReply,
+
+    EventTypeCount
   };
 
   bool invert; 
@@ -136,6 +139,9 @@ class DSMCondition
 
   virtual bool match(AmSession* sess, DSMSession* sc_sess, DSMCondition::EventType event,
 		     map<string,string>* event_params);
+
+  /** @return whether the condition never matches events other than 'type' */
+  virtual bool isEventSpecific() const;
 };
 
 class DSMAction 
@@ -176,6 +182,10 @@ class State
   vector<DSMElement*> post_actions;
   
   vector<DSMTransition> transitions;
+
+  /** transitions which may match the event type, in definition order
+      (filled by DSMStateDiagram::compile) */
+  vector<vector<unsigned int> > event_transitions;
 };
 
 class DSMTransition
@@ -188,6 +198,8 @@ class DSMTransition
   vector<DSMElement*> actions;
   string from_state;
   string to_state;
+  /** index of to_state in the diagram, -1 if not resolved */
+  int to_state_idx;
 
   bool is_exception;
 };
@@ -233,6 +245,9 @@ class DSMStateDiagram  {
   string name;
   string initial_state;
 
+  std::unordered_map<string, size_t> state_index;
+  int initial_state_idx;
+
   bool checkInitialState(string& report);
   bool checkDestinationStates(string& report);
   bool checkHangupHandled(string& report);
@@ -243,11 +258,15 @@ class DSMStateDiagram  {
 
   State* getInitialState();
   State* getState(const string& s_name);
+  State* getState(const DSMTransition& trans);
 
   void addState(const State& state, bool is_initial = false);
   bool addTransition(const DSMTransition& trans);
   const string& getName() { return name; }
   bool checkConsistency(string& report);
+
+  /** resolve transitions' target states and index them by event type */
+  void compile();
 };
 
 class DSMException {
@@ -0,0 +1,301 @@
+/*
+ * This file is part of SEMS, a free SIP media server.
+ *
+ * SEMS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * For a license to use the SEMS software under conditions
+ * other than those described here, or to purchase support for this
+ * software, please contact iptel.org by e-mail at the following addresses:
+ *    info@iptel.org
+ *
+ * SEMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _DSMVar_h_
+#define _DSMVar_h_
+
+#include <string>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <type_traits>
+#include <cstddef>
+
+#include <stdlib.h>
+
+using std::string;
+
+/**
+ * value of a DSM variable ($var).
+ *
+ * holds the string value (short strings are stored inline) and
+ * remembers whether it is an integer and its value, so inc(),
+ * operators and numeric comparisons do not parse it on every use,
+ * and integers set with setInt() are never parsed.
+ *
+ * the value can only be modified through DSMVar,
+ * so the remembered number can not get stale.
+ */
+class DSMVar {
+  enum NumState {
+    NumUnknown = 0,
+    NumInt,
+    NumNone
+  };
+
+  string s;
+  mutable NumState num_state;
+  mutable long num;
+
+  void changed() { num_state = NumUnknown; }
+
+ public:
+  typedef string::size_type size_type;
+  typedef string::const_iterator const_iterator;
+  static const size_type npos = string::npos;
+
+  DSMVar() : num_state(NumUnknown), num(0) { }
+  DSMVar(const string& v) : s(v), num_state(NumUnknown), num(0) { }
+  DSMVar(string&& v) : s(std::move(v)), num_state(NumUnknown), num(0) { }
+  DSMVar(const char* v) : s(v), num_state(NumUnknown), num(0) { }
+
+  DSMVar& operator=(const string& v) { s = v; changed(); return *this; }
+  DSMVar& operator=(string&& v) { s = std::move(v); changed(); return *this; }
+  DSMVar& operator=(const char* v) { s = v; changed(); return *this; }
+
+  /** set integer value, keeps the number as is */
+  void setInt(long v);
+
+  /**
+   * integer value as parsed by strtol() (the empty value is 0)
+   * @return false if the value is not an integer
+   */
+  bool getInt(long& v) const;
+
+  const string& str() const { return s; }
+  operator const string&() const { return s; }
+
+  /* read access as for string */
+  const char* c_str() const { return s.c_str(); }
+  const char* data() const { return s.data(); }
+  size_type size() const { return s.size(); }
+  size_type length() const { return s.length(); }
+  bool empty() const { return s.empty(); }
+  char operator[](size_type pos) const { return s[pos]; }
+  const_iterator begin() const { return s.begin(); }
+  const_iterator end() const { return s.end(); }
+  string substr(size_type pos = 0, size_type n = npos) const { return s.substr(pos, n); }
+
+  template<typename T>
+  size_type find(const T& v, size_type pos = 0) const { return s.find(v, pos); }
+  template<typename T>
+  size_type rfind(const T& v, size_type pos = npos) const { return s.rfind(v, pos); }
+  template<typename T>
+  size_type find_first_of(const T& v, size_type pos = 0) const { return s.find_first_of(v, pos); }
+  template<typename T>
+  size_type find_first_not_of(const T& v, size_type pos = 0) const { return s.find_first_not_of(v, pos); }
+  template<typename T>
+  size_type find_last_of(const T& v, size_type pos = npos) const { return s.find_last_of(v, pos); }
+
+  /* modifications */
+  DSMVar& operator+=(const string& v) { s += v; changed(); return *this; }
+  DSMVar& operator+=(const char* v) { s += v; changed(); return *this; }
+  DSMVar& operator+=(char c) { s += c; changed(); return *this; }
+  DSMVar& append(const string& v) { return *this += v; }
+  DSMVar& replace(size_type pos, size_type n, const string& v) {
+    s.replace(pos, n, v); changed(); return *this;
+  }
+  void clear() { s.clear(); changed(); }
+};
+
+inline void DSMVar::setInt(long v) {
+  // formatted in place: no allocation, the value always fits inline
+  char buf[24];
+  char* p = buf + sizeof(buf);
+  unsigned long u = v < 0 ? 0UL - (unsigned long)v : (unsigned long)v;
+  do {
+    *--p = '0' + u % 10;
+    u /= 10;
+  } while (u);
+  if (v < 0)
+    *--p = '-';
+  s.assign(p, buf + sizeof(buf) - p);
+
+  num = v;
+  num_state = NumInt;
+}
+
+inline bool DSMVar::getInt(long& v) const {
+  if (num_state == NumUnknown) {
+    // as strtol() over the whole value, as the test() comparisons did
+    char* endptr = NULL;
+    num = strtol(s.c_str(), &endptr, 10);
+    num_state = (endptr && *endptr == '\0') ? NumInt : NumNone;
+  }
+
+  if (num_state != NumInt)
+    return false;
+  v = num;
+  return true;
+}
+
+inline bool operator==(const DSMVar& a, const DSMVar& b) { return a.str() == b.str(); }
+inline bool operator==(const DSMVar& a, const string& b) { return a.str() == b; }
+inline bool operator==(const string& a, const DSMVar& b) { return a == b.str(); }
+inline bool operator==(const DSMVar& a, const char* b) { return a.str() == b; }
+inline bool operator==(const char* a, const DSMVar& b) { return a == b.str(); }
+inline bool operator!=(const DSMVar& a, const DSMVar& b) { return a.str() != b.str(); }
+inline bool operator!=(const DSMVar& a, const string& b) { return a.str() != b; }
+inline bool operator!=(const string& a, const DSMVar& b) { return a != b.str(); }
+inline bool operator!=(const DSMVar& a, const char* b) { return a.str() != b; }
+inline bool operator!=(const char* a, const DSMVar& b) { return a != b.str(); }
+inline bool operator<(const DSMVar& a, const DSMVar& b) { return a.str() < b.str(); }
+
+inline string operator+(const DSMVar& a, const DSMVar& b) { return a.str() + b.str(); }
+inline string operator+(const DSMVar& a, const string& b) { return a.str() + b; }
+inline string operator+(const string& a, const DSMVar& b) { return a + b.str(); }
+inline string operator+(const DSMVar& a, const char* b) { return a.str() + b; }
+inline string operator+(const char* a, const DSMVar& b) { return a + b.str(); }
+inline string operator+(const DSMVar& a, char b) { return a.str() + b; }
+inline string operator+(char a, const DSMVar& b) { return a + b.str(); }
+
+inline std::ostream& operator<<(std::ostream& o, const DSMVar& v) { return o << v.str(); }
+
+/**
+ * per-map node pool of the variables map.
+ * nodes are taken from chunks and reused after erase,
+ * so setting a variable does not call malloc every time.
+ */
+class DSMVarPool {
+  struct FreeNode {
+    FreeNode* next;
+  };
+  struct Chunk {
+    Chunk* next;
+  };
+
+  size_t node_size;
+  size_t chunk_nodes;
+  FreeNode* free_nodes;
+  Chunk* chunks;
+
+  static size_t align(size_t size) {
+    const size_t a = alignof(std::max_align_t);
+    return (size + a - 1) & ~(a - 1);
+  }
+
+ public:
+  DSMVarPool() : node_size(0), chunk_nodes(16), free_nodes(NULL), chunks(NULL) { }
+  DSMVarPool(const DSMVarPool&) = delete;
+  DSMVarPool& operator=(const DSMVarPool&) = delete;
+  ~DSMVarPool() {
+    while (chunks) {
+      Chunk* c = chunks;
+      chunks = c->next;
+      ::operator delete(c);
+    }
+  }
+
+  void* allocate(size_t size) {
+    size = align(size);
+    if (!node_size)
+      node_size = size;
+    else if (size != node_size)
+      return ::operator new(size);
+
+    if (!free_nodes) {
+      // chunk header is padded to keep the nodes aligned
+      char* c = static_cast<char*>(::operator new(align(sizeof(Chunk)) + chunk_nodes * node_size));
+      reinterpret_cast<Chunk*>(c)->next = chunks;
+      chunks = reinterpret_cast<Chunk*>(c);
+
+      char* n = c + align(sizeof(Chunk));
+      for (size_t i = 0; i < chunk_nodes; i++, n += node_size) {
+	FreeNode* f = reinterpret_cast<FreeNode*>(n);
+	f->next = free_nodes;
+	free_nodes = f;
+      }
+      if (chunk_nodes < 256)
+	chunk_nodes *= 2;
+    }
+
+    FreeNode* f = free_nodes;
+    free_nodes = f->next;
+    return f;
+  }
+
+  void deallocate(void* p, size_t size) {
+    if (align(size) != node_size) {
+      ::operator delete(p);
+      return;
+    }
+    FreeNode* f = static_cast<FreeNode*>(p);
+    f->next = free_nodes;
+    free_nodes = f;
+  }
+};
+
+/** allocator of the variables map, copies share the pool.
+ *  a copied map gets its own pool */
+template<typename T>
+class DSMVarAllocator {
+  template<typename U> friend class DSMVarAllocator;
+
+  std::shared_ptr<DSMVarPool> pool;
+
+ public:
+  typedef T value_type;
+  typedef std::false_type propagate_on_container_copy_assignment;
+  typedef std::true_type propagate_on_container_move_assignment;
+  typedef std::true_type propagate_on_container_swap;
+
+  DSMVarAllocator() : pool(std::make_shared<DSMVarPool>()) { }
+  template<typename U>
+  DSMVarAllocator(const DSMVarAllocator<U>& a) : pool(a.pool) { }
+
+  T* allocate(size_t n) {
+    if (n != 1)
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    return static_cast<T*>(pool->allocate(sizeof(T)));
+  }
+
+  void deallocate(T* p, size_t n) {
+    if (n != 1) {
+      ::operator delete(p);
+      return;
+    }
+    pool->deallocate(p, sizeof(T));
+  }
+
+  DSMVarAllocator select_on_container_copy_construction() const {
+    return DSMVarAllocator();
+  }
+
+  template<typename U>
+  bool operator==(const DSMVarAllocator<U>& a) const { return pool == a.pool; }
+  template<typename U>
+  bool operator!=(const DSMVarAllocator<U>& a) const { return pool != a.pool; }
+};
+
+/* ordered: arrays and structs ($a[0], $s.x) are iterated by name prefix */
+typedef std::map<string, DSMVar, std::less<string>,
+		 DSMVarAllocator<std::pair<const string, DSMVar> > > VarMapT;
+
+/** replace dst with the string values of all variables */
+inline void varsToMap(const VarMapT& vars, std::map<string, string>& dst) {
+  dst.clear();
+  for (VarMapT::const_iterator it = vars.begin(); it != vars.end(); it++)
+    dst.emplace_hint(dst.end(), it->first, it->second.str());
+}
+
+#endif
@@ -241,7 +241,7 @@ EXEC_ACTION_START(DLGDialoutAction) {
   if (it != sc_sess->var.end())		      \
     outvar = it->second;
 
-  map<string, string>::iterator it; 
+  VarMapT::iterator it; 
 
   string v_from;
   GET_VARIABLE_MANDATORY("_caller", v_from);
@@ -304,16 +304,16 @@ EXEC_ACTION_START(DLGDialoutAction) {
   AmArg var_struct;
   string varprefix = arrayname+"_var.";
   bool has_vars = false;
-  map<string, string>::iterator lb = sc_sess->var.lower_bound(varprefix);
+  VarMapT::iterator lb = sc_sess->var.lower_bound(varprefix);
   while (lb != sc_sess->var.end()) {
     if ((lb->first.length() < varprefix.length()) ||
 	strncmp(lb->first.c_str(), varprefix.c_str(),varprefix.length()))
       break;
     string varname = lb->first.substr(varprefix.length());
     if (!has_auth) // sess_params is variable struct
-      (*sess_params)[varname] = lb->second;
+      (*sess_params)[varname] = lb->second.str();
     else // variable struct is in sess_params array
-      var_struct[varname] = lb->second;
+      var_struct[varname] = lb->second.str();
 
     lb++;
     has_vars = true;
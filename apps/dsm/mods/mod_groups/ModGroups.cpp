@@ -133,7 +133,7 @@ EXEC_ACTION_START(GroupsPostEventAction) {
 
   if (!var.empty()) {
     if (var == "var")
-      ev_params = sc_sess->var;
+      varsToMap(sc_sess->var, ev_params);
     else {
       vector<string> vars = explode(var, ";");
       for (vector<string>::iterator it =
@@ -126,7 +126,7 @@ bool MonLogVarsAction::execute(AmSession* sess,   DSMSession* sc_sess,
   AmArg di_args,ret;
   di_args.push(AmArg(sess->getLocalTag().c_str()));
 
-  for (map<string,string>::iterator it=
+  for (VarMapT::iterator it=
 	 sc_sess->var.begin(); it != sc_sess->var.end();it++) {
     di_args.push(it->first.c_str());
     di_args.push(it->second.c_str());
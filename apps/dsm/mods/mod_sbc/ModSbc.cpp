@@ -361,7 +361,7 @@ EXEC_ACTION_START(MODSBCActionGetCallStatus) {
   DBG("set $%s='%s'", varname.c_str(), sc_sess->var[varname].c_str());
 } EXEC_ACTION_END;
 
-void setReliableEventParameters(const DSMSession* sc_sess, const string& var, VarMapT& params) {
+void setReliableEventParameters(const DSMSession* sc_sess, const string& var, map<string, string>& params) {
   vector<string> vars = explode(var, ";");
   for (vector<string>::iterator it = vars.begin(); it != vars.end(); it++) {
     string varname = *it;
@@ -369,7 +369,7 @@ void setReliableEventParameters(const DSMSession* sc_sess, const string& var, Va
     if (varname.length() && varname[varname.length()-1]=='.') {
       DBG("adding postEvent param %s (struct)", varname.c_str());
 
-      map<string, string>::const_iterator lb = sc_sess->var.lower_bound(varname);
+      VarMapT::const_iterator lb = sc_sess->var.lower_bound(varname);
       while (lb != sc_sess->var.end()) {
 	if ((lb->first.length() < varname.length()) ||
 	    strncmp(lb->first.c_str(), varname.c_str(), varname.length()))
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "../DSMCoreModule.h"
+#include "../DSMSession.h"
+
+class TestDSMSession : public DSMSession
+{
+  public:
+    void playPrompt(const string&, bool, bool) override {}
+    void playFile(const string&, bool, bool) override {}
+    void playSilence(unsigned int, bool) override {}
+    void recordFile(const string&) override {}
+    unsigned int getRecordLength() override { return 0; }
+    unsigned int getRecordDataSize() override { return 0; }
+    void stopRecord() override {}
+    void setInOutPlaylist() override {}
+    void setInputPlaylist() override {}
+    void setOutputPlaylist() override {}
+    void addToPlaylist(AmPlaylistItem*, bool) override {}
+    void flushPlaylist() override {}
+    void setPromptSet(const string&) override {}
+    void addSeparator(const string&, bool) override {}
+    void connectMedia() override {}
+    void disconnectMedia() override {}
+    void mute() override {}
+    void unmute() override {}
+    void B2BconnectCallee(const string&, const string&, bool) override {}
+    void B2BterminateOtherLeg() override {}
+    void B2BaddReceivedRequest(const AmSipRequest&) override {}
+    void B2BsetRelayEarlyMediaSDP(bool) override {}
+    void B2BsetHeaders(const string&, bool) override {}
+    void B2BclearHeaders() override {}
+    void B2BaddHeader(const string&) override {}
+    void B2BremoveHeader(const string&) override {}
+    void transferOwnership(DSMDisposable*) override {}
+    void releaseOwnership(DSMDisposable*) override {}
+};
+
+TEST(DSMVar, CachedInt)
+{
+    DSMVar v("12");
+    long n = 0;
+    ASSERT_TRUE(v.getInt(n));
+    ASSERT_EQ(n, 12);
+
+    v.setInt(-40);
+    ASSERT_EQ(v.str(), "-40");
+    ASSERT_TRUE(v.getInt(n));
+    ASSERT_EQ(n, -40);
+
+    //modification drops the cached number
+    v += "x";
+    ASSERT_FALSE(v.getInt(n));
+    v = "7";
+    ASSERT_TRUE(v.getInt(n));
+    ASSERT_EQ(n, 7);
+
+    v.clear();
+    ASSERT_TRUE(v.getInt(n));
+    ASSERT_EQ(n, 0);
+}
+
+TEST(DSMCondition, NumericTest)
+{
+    TestDSMSession sc_sess;
+    map<string,string> params;
+
+    TestDSMCondition less("$cnt < 5", DSMCondition::Any),
+                     greater("12 > $cnt", DSMCondition::Any),
+                     vars("$cnt > $limit", DSMCondition::Any),
+                     param("#code < 300", DSMCondition::Any);
+
+    sc_sess.var["cnt"].setInt(3);
+    ASSERT_TRUE(less.match(NULL, &sc_sess, DSMCondition::Any, &params));
+    ASSERT_TRUE(greater.match(NULL, &sc_sess, DSMCondition::Any, &params));
+
+    //compared as numbers, not as strings
+    sc_sess.var["cnt"] = "10";
+    ASSERT_FALSE(less.match(NULL, &sc_sess, DSMCondition::Any, &params));
+    ASSERT_TRUE(greater.match(NULL, &sc_sess, DSMCondition::Any, &params));
+    sc_sess.var["limit"] = "9";
+    ASSERT_TRUE(vars.match(NULL, &sc_sess, DSMCondition::Any, &params));
+    sc_sess.var["limit"].setInt(100);
+    ASSERT_FALSE(vars.match(NULL, &sc_sess, DSMCondition::Any, &params));
+
+    //missed variable is 0 as before
+    sc_sess.var.erase("cnt");
+    ASSERT_TRUE(less.match(NULL, &sc_sess, DSMCondition::Any, &params));
+
+    //not numbers are compared as strings
+    sc_sess.var["cnt"] = "abc";
+    ASSERT_FALSE(less.match(NULL, &sc_sess, DSMCondition::Any, &params));
+    ASSERT_FALSE(greater.match(NULL, &sc_sess, DSMCondition::Any, &params));
+
+    params["code"] = "200";
+    ASSERT_TRUE(param.match(NULL, &sc_sess, DSMCondition::Any, &params));
+    params["code"] = "486";
+    ASSERT_FALSE(param.match(NULL, &sc_sess, DSMCondition::Any, &params));
+}
@@ -116,16 +116,16 @@ void b2b_connectDialog::onInvite(const AmSipRequest& req)
 
   invite_req = req;
   if (b2b_connectFactory::TransparentHeaders) {
-    removeHeader(invite_req.hdrs, PARAM_HDR);
-    removeHeader(invite_req.hdrs, "P-App-Name");
-    removeHeader(invite_req.hdrs, "User-Agent");
-    removeHeader(invite_req.hdrs, "Max-Forwards");
+    removeHeader(invite_req.hdrs.modify(), PARAM_HDR);
+    removeHeader(invite_req.hdrs.modify(), "P-App-Name");
+    removeHeader(invite_req.hdrs.modify(), "User-Agent");
+    removeHeader(invite_req.hdrs.modify(), "Max-Forwards");
   }
 
   recvd_req.insert(std::make_pair(req.cseq,req));
   
   connectCallee(remote_party, remote_uri, from, from, 
-		b2b_connectFactory::TransparentHeaders ? invite_req.hdrs : "");
+		b2b_connectFactory::TransparentHeaders ? invite_req.hdrs.str() : "");
 
   MONITORING_LOG(other_id.c_str(), 
 		 "app", MOD_NAME);
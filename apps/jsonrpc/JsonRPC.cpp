@@ -29,6 +29,7 @@
 
 #include "JsonRPC.h"
 #include "JsonRPCServer.h"
+#include "RpcMethodStats.h"
 #include <AmLcConfig.h>
 
 #include <netinet/tcp.h>
@@ -38,6 +39,7 @@ JsonRPCServerModule* JsonRPCServerModule::_instance = NULL;
 string JsonRPCServerModule::host = DEFAULT_JSONRPC_SERVER_HOST;
 int JsonRPCServerModule::port = DEFAULT_JSONRPC_SERVER_PORT;
 int JsonRPCServerModule::threads = DEFAULT_JSONRPC_SERVER_THREADS;
+int JsonRPCServerModule::accept_loops = DEFAULT_JSONRPC_ACCEPT_LOOPS;
 trsp_acl JsonRPCServerModule::acl;
 string JsonRPCServerModule::tcp_md5_password;
 
@@ -73,6 +75,7 @@ int JsonRPCServerModule::configure(const std::string & config)
     static const char opt_whitelist[] = "whitelist";
     static const char opt_method[] = "method";
     static const char opt_server_threads[] = "server_threads";
+    static const char opt_accept_loops[] = "accept_loops";
     static const char opt_tcp_md5_password[] = "tcp_md5_password";
     static const char sec_listen[] = "listen";
     static const char sec_acl[] = "acl";
@@ -94,6 +97,7 @@ int JsonRPCServerModule::configure(const std::string & config)
         CFG_SEC(sec_listen,listen_sec, CFGF_NONE),
         CFG_SEC(sec_acl,acl_sec, CFGF_NODEFAULT),
         CFG_INT(opt_server_threads, DEFAULT_JSONRPC_SERVER_THREADS, CFGF_NONE),
+        CFG_INT(opt_accept_loops, DEFAULT_JSONRPC_ACCEPT_LOOPS, CFGF_NONE),
         CFG_STR(opt_tcp_md5_password, NULL, CFGF_NONE),
         CFG_END()
     };
@@ -117,6 +121,12 @@ int JsonRPCServerModule::configure(const std::string & config)
     host = cfg_getstr(listen, opt_address);
     port = cfg_getint(listen, opt_port);
     threads = cfg_getint(cfg, opt_server_threads);
+    accept_loops = cfg_getint(cfg, opt_accept_loops);
+    if(accept_loops < 1) {
+        ERROR("%s must be greater than 0", opt_accept_loops);
+        cfg_free(cfg);
+        return -1;
+    }
     if(cfg_getstr(cfg,opt_tcp_md5_password)) {
         tcp_md5_password = cfg_getstr(cfg,opt_tcp_md5_password);
         if(tcp_md5_password.size() > TCP_MD5SIG_MAXKEYLEN) {
@@ -127,15 +137,17 @@ int JsonRPCServerModule::configure(const std::string & config)
     if(cfg_size(cfg, sec_acl)) {
         cfg_t* cfg_acl = cfg_getsec(cfg, sec_acl);
         int networks = 0;
+        vector<AmSubnet> nets;
         for(unsigned int j = 0; j < cfg_size(cfg_acl, opt_whitelist); j++) {
             AmSubnet net;
             std::string host = cfg_getnstr(cfg_acl, opt_whitelist, j);
             if(!net.parse(host)) {
                 return -1;
             }
-            acl.add_network(net);
+            nets.push_back(net);
             networks++;
         }
+        acl.set_networks(nets);
 
         DBG("parsed %d networks",networks);
 
@@ -169,9 +181,13 @@ int JsonRPCServerModule::load() {
   DBG("using server listen address %s", host.c_str());
   DBG("using server port %d", port);
   DBG("using %d server threads", threads);
+  DBG("using %d accept loops", accept_loops);
   if(tcp_md5_password.size()) {
     DBG("use tcp md5 password");
   }
+  statistics::instance()->add_groups_container(
+    MOD_NAME "_method_duration_us", RpcMethodStats::instance(), false);
+
   DBG("starting server loop thread");
   server_loop = JsonRPCServerLoop::instance();
   if(server_loop->configure())
@@ -211,10 +227,13 @@ void JsonRPCServerModule::invoke(const string& method,
     // JsonRpcServer::execRpc(args, ret);
   } else if (method == "getServerPort"){
     ret.push(port);
+  } else if (method == "getMethodStats"){
+    getMethodStats(args, ret);
   } else if(method == "_list"){ 
     ret.push(AmArg("execRpc"));
     ret.push(AmArg("sendMessage"));
     ret.push(AmArg("getServerPort"));
+    ret.push(AmArg("getMethodStats"));
     ret.push(AmArg("execServerFunction"));
     ret.push(AmArg("setNotifySink"));
     ret.push(AmArg("setRequestSink"));
@@ -264,3 +283,7 @@ void JsonRPCServerModule::sendMessage(const AmArg& args, AmArg& ret) {
 				 args.get(4).asCStr(), // reply_sink
 				 params, udata, ret);
 }
+
+void JsonRPCServerModule::getMethodStats(const AmArg&, AmArg& ret) {
+  RpcMethodStats::instance()->getStats(ret);
+}
@@ -35,6 +35,7 @@
 #define DEFAULT_JSONRPC_SERVER_HOST    "127.0.0.1"
 #define DEFAULT_JSONRPC_SERVER_PORT    7080
 #define DEFAULT_JSONRPC_SERVER_THREADS 5
+#define DEFAULT_JSONRPC_ACCEPT_LOOPS   1
 
 class JsonRPCServerModule
 : public AmDynInvokeFactory, 
@@ -50,6 +51,7 @@ class JsonRPCServerModule
   // DI methods
   void execRpc(const AmArg& args, AmArg& ret);
   void sendMessage(const AmArg& args, AmArg& ret);
+  void getMethodStats(const AmArg& args, AmArg& ret);
 
  public:
   JsonRPCServerModule(const string& mod_name);
@@ -72,6 +74,7 @@ class JsonRPCServerModule
   static string host;
   static int port;
   static int threads;
+  static int accept_loops;
   static trsp_acl acl;
   static string tcp_md5_password;
 };
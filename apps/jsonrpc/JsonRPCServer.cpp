@@ -30,6 +30,7 @@
 #include "JsonRPCServer.h"
 #include "RpcPeer.h"
 #include "JsonRPCEvents.h"
+#include "RpcMethodStats.h"
 #include "jsonArg.h"
 
 #include "AmEventDispatcher.h"
@@ -59,16 +60,16 @@ int JsonRpcServer::createRequest(const string& evq_link, const string& method,
 
   }
 
-  string rpc_params_json = arg2json(rpc_params);
-  if (rpc_params_json.length() > MAX_RPC_MSG_SIZE) {
+  // reserve one byte for the netstring terminator
+  ssize_t len = arg2json(rpc_params, peer->msgbuf, MAX_RPC_MSG_SIZE-1);
+  if (len < 0) {
     ERROR("internal error: message exceeded MAX_RPC_MSG_SIZE (%d)", 
 	  MAX_RPC_MSG_SIZE);
     return -3;
   }
 
-  DBG("RPC message: >>%.*s<<", (int)rpc_params_json.length(), rpc_params_json.c_str());
-  memcpy(peer->msgbuf, rpc_params_json.c_str(), rpc_params_json.length());
-  peer->msg_size = rpc_params_json.length();
+  DBG("RPC message: >>%.*s<<", (int)len, peer->msgbuf);
+  peer->msg_size = len;
   // set peer connection up for sending
   peer->msg_recv = false;
   return 0;
@@ -88,16 +89,15 @@ int JsonRpcServer::createReply(
   else
     rpc_res["result"] = result;
 
-  string res_s = arg2json(rpc_res);
-  if (res_s.length() > MAX_RPC_MSG_SIZE) {
+  ssize_t len = arg2json(rpc_res, peer->msgbuf, MAX_RPC_MSG_SIZE-1);
+  if (len < 0) {
     ERROR("internal error: reply exceeded MAX_RPC_MSG_SIZE (%d)",
 	  MAX_RPC_MSG_SIZE);
     return -3;
   }
 
-  DBG("created RPC reply: >>%.*s<<", (int)res_s.length(), res_s.c_str());
-  memcpy(peer->msgbuf, res_s.c_str(), res_s.length());
-  peer->msg_size = res_s.length();
+  DBG("created RPC reply: >>%.*s<<", (int)len, peer->msgbuf);
+  peer->msg_size = len;
 
   return 0;
 }
@@ -148,7 +148,7 @@ int JsonRpcServer::processMessage(char* msgbuf, unsigned int* msg_size,
     //DBG("parsing message ...");
     // const char* txt = "{\"jsonrpc\": \"2.0\", \"result\": 19, \"id\": 1}";
     AmArg rpc_params;
-    if (!json2arg(msgbuf, rpc_params)) {
+    if (!json2arg(msgbuf, *msg_size, rpc_params)) {
         INFO("Error parsing message '%.*s'", (int)*msg_size, msgbuf);
         return -1;
     }
@@ -345,16 +345,16 @@ int JsonRpcServer::processMessage(char* msgbuf, unsigned int* msg_size,
     if(!is_notify)
         rpc_res["id"] = id;
 
-    string res_s = arg2json(rpc_res);
-    if (res_s.length() > MAX_RPC_MSG_SIZE) {
+    // serialize in place: request is not needed anymore
+    ssize_t len = arg2json(rpc_res, msgbuf, MAX_RPC_MSG_SIZE-1);
+    if (len < 0) {
         ERROR("internal error: reply exceeded MAX_RPC_MSG_SIZE (%d)",
               MAX_RPC_MSG_SIZE);
         return -3;
     }
 
-    //DBG("RPC result: >>%.*s<<", (int)res_s.length(), res_s.c_str());
-    memcpy(msgbuf, res_s.c_str(), res_s.length());
-    *msg_size = res_s.length();
+    //DBG("RPC result: >>%.*s<<", (int)len, msgbuf);
+    *msg_size = len;
 
     return 0;
 }
@@ -418,6 +418,8 @@ static bool traverse_tree(AmDynInvoke* di,const string &method, AmArg args, AmAr
 
 bool JsonRpcServer::execRpc(const string &connection_id, const string& method, const AmArg& id, const AmArg& params, AmArg& rpc_res) {
 
+RpcMethodStats::Timer timer(method);
+
 try  {
 
     if(method=="_list") {
@@ -483,6 +485,7 @@ try  {
             connection_id, id,
             fact_meth, params))
         {
+            timer.cancel();
             return true;
         }
 
@@ -524,6 +527,8 @@ try  {
     rpc_res["id"] = id;
     rpc_res["jsonrpc"] = "2.0";
 } catch (const JsonRpcError& e) {
+    // do not create histograms for arbitrary unknown method names
+    if(e.code == -32601) timer.cancel();
     INFO("got JsonRpcError. code %d, message '%s', data: '%s', method: %s, id: %s, params: '%s'",
         e.code, e.message.c_str(), AmArg::print(e.data).c_str(),
         method.c_str(), isArgCStr(id) ? id.asCStr() : int2str(id.asInt()).c_str(),
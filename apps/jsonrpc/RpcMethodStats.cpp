@@ -0,0 +1,125 @@
+#include "RpcMethodStats.h"
+#include "AmUtils.h"
+
+#include <algorithm>
+
+const vector<unsigned long long> _RpcMethodStats::bounds_us = {
+    100, 250, 500,
+    1000, 2500, 5000,
+    10000, 25000, 50000,
+    100000, 250000, 500000,
+    1000000, 5000000
+};
+
+_RpcMethodStats::Histogram::Histogram()
+  : buckets(bounds_us.size() + 1, 0),
+    sum_us(0),
+    count(0)
+{}
+
+_RpcMethodStats::Timer::~Timer()
+{
+    if(!active) return;
+    RpcMethodStats::instance()->record(
+        method,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            clock::now() - start).count());
+}
+
+void _RpcMethodStats::record(const string &method, unsigned long long duration_us)
+{
+    size_t idx = std::lower_bound(bounds_us.begin(), bounds_us.end(), duration_us)
+                 - bounds_us.begin();
+
+    AmLock l(methods_mut);
+    Histogram &h = methods[method];
+    h.buckets[idx]++;
+    h.sum_us += duration_us;
+    h.count++;
+}
+
+void _RpcMethodStats::getStats(AmArg &ret)
+{
+    ret.assertStruct();
+
+    AmLock l(methods_mut);
+    for(const auto &it : methods) {
+        const Histogram &h = it.second;
+        AmArg &m = ret[it.first];
+        m["count"] = (long long)h.count;
+        m["sum_us"] = (long long)h.sum_us;
+        m["avg_us"] = (long long)(h.count ? h.sum_us / h.count : 0);
+        AmArg &buckets = m["buckets"];
+        buckets.assertStruct();
+        for(size_t i = 0; i < bounds_us.size(); i++)
+            buckets[longlong2str((long long)bounds_us[i])] = (long long)h.buckets[i];
+        buckets["+Inf"] = (long long)h.buckets.back();
+    }
+}
+
+namespace {
+
+class MethodStatsGroup
+  : public StatCountersGroupsInterface
+{
+  public:
+    enum Mode {
+        Bucket,
+        Sum,
+        Count
+    } mode;
+
+    map<string, _RpcMethodStats::Histogram> methods;
+
+    MethodStatsGroup()
+      : StatCountersGroupsInterface(Counter),
+        mode(Bucket)
+    {}
+
+    void iterate_counters(iterate_counters_callback_type callback) override
+    {
+        map<string, string> labels;
+        for(const auto &it : methods) {
+            const auto &h = it.second;
+            labels.clear();
+            labels.emplace("method", it.first);
+
+            switch(mode) {
+            case Sum:
+                callback(h.sum_us, labels);
+                break;
+            case Count:
+                callback(h.count, labels);
+                break;
+            case Bucket: {
+                unsigned long long cumulative = 0;
+                for(size_t i = 0; i < _RpcMethodStats::bounds_us.size(); i++) {
+                    cumulative += h.buckets[i];
+                    labels["le"] = longlong2str((long long)_RpcMethodStats::bounds_us[i]);
+                    callback(cumulative, labels);
+                }
+                labels["le"] = "+Inf";
+                callback(h.count, labels);
+            } break;
+            }
+        }
+    }
+};
+
+} //namespace
+
+void _RpcMethodStats::operator ()(const string &name, iterate_groups_callback_type callback)
+{
+    MethodStatsGroup g;
+    {
+        AmLock l(methods_mut);
+        g.methods = methods;
+    }
+
+    g.mode = MethodStatsGroup::Bucket;
+    callback(name + "_bucket", g);
+    g.mode = MethodStatsGroup::Sum;
+    callback(name + "_sum", g);
+    g.mode = MethodStatsGroup::Count;
+    callback(name + "_count", g);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "AmStatistics.h"
+#include "AmArg.h"
+#include "singleton.h"
+
+#include <chrono>
+#include <string>
+#include <map>
+#include <vector>
+using std::string;
+using std::map;
+using std::vector;
+
+/* per-method execution time histograms.
+ * exported as <name>_bucket{method,le}, <name>_sum and <name>_count
+ * counters (microseconds) to be used with prometheus histogram_quantile() */
+class _RpcMethodStats
+  : public StatsCountersGroupsContainerInterface
+{
+  public:
+    typedef std::chrono::steady_clock clock;
+
+    struct Histogram {
+        vector<unsigned long long> buckets; //non-cumulative, last one is +Inf
+        unsigned long long sum_us;
+        unsigned long long count;
+        Histogram();
+    };
+
+    //buckets upper bounds in microseconds
+    static const vector<unsigned long long> bounds_us;
+
+    /* measures time from construction till destruction
+     * unless cancelled (async or unknown methods) */
+    class Timer {
+        const string &method;
+        clock::time_point start;
+        bool active;
+      public:
+        Timer(const string &method)
+          : method(method),
+            start(clock::now()),
+            active(true)
+        {}
+        ~Timer();
+        void cancel() { active = false; }
+    };
+
+  private:
+    AmMutex methods_mut;
+    map<string, Histogram> methods;
+
+  protected:
+    void dispose() {}
+
+  public:
+    void record(const string &method, unsigned long long duration_us);
+    void getStats(AmArg &ret);
+
+    void operator ()(const string &name, iterate_groups_callback_type callback) override;
+};
+
+typedef singleton<_RpcMethodStats> RpcMethodStats;
@@ -74,7 +74,7 @@ void JsonrpcPeerConnection::notifyDisconnect()
 
 JsonrpcNetstringsConnection::JsonrpcNetstringsConnection(const std::string& id) 
   : JsonrpcPeerConnection(id), 
-    fd(0), msg_size(0), rcvd_size(0), in_msg(false), msg_recv(true)
+    fd(0), owner_queue(NULL), msg_size(0), rcvd_size(0), in_msg(false), msg_recv(true)
 {
 }
 
@@ -191,84 +191,105 @@ void JsonrpcNetstringsConnection::resetRead() {
 
 int JsonrpcNetstringsConnection::netstringsRead() {
   if (!in_msg) {
-    while (true) {
-      if (rcvd_size > MAX_NS_LEN_SIZE) {
-	DBG("closing connection [%p/%d]: oversize length", this, fd);
-	close();
-	return REMOVE;
-      }
-      // reading length
-      ssize_t r=read(fd,&msgbuf[rcvd_size],1);
-      if (!r) {
-	DBG("closing connection [%p/%d] on peer hangup", this, fd);
+    // reading length: peek what is available and consume
+    // only the length prefix instead of reading it bytewise
+    ssize_t r = recv(fd, &msgbuf[rcvd_size], MAX_NS_LEN_SIZE+1-rcvd_size, MSG_PEEK);
+    if (!r) {
+      DBG("closing connection [%p/%d] on peer hangup", this, fd);
+      close();
+      return REMOVE;
+    }
+
+    if ((r<0 && errno == EAGAIN) || 
+	(r<0 && errno == EWOULDBLOCK))
+      return CONTINUE;
+
+    if (r<0) {
+      INFO("socket error on connection [%p/%d]: %s",
+	   this, fd, strerror(errno));
+      close();
+      return REMOVE;
+    }
+
+    char* colon = (char*)memchr(&msgbuf[rcvd_size], ':', r);
+    size_t hdr_len = colon ? colon - &msgbuf[rcvd_size] + 1 : r;
+
+    for (size_t i = 0; i < (colon ? hdr_len-1 : hdr_len); i++) {
+      char c = msgbuf[rcvd_size+i];
+      if (c < '0' || c > '9') {
+	INFO("Protocol error on connection [%p/%d]: invalid character in size",
+	     this, fd);
 	close();
 	return REMOVE;
       }
+    }
 
-      if ((r<0 && errno == EAGAIN) || 
-	  (r<0 && errno == EWOULDBLOCK))
-	return CONTINUE;
-     
-      if (r != 1) {
-	INFO("socket error on connection [%p/%d]: %s",
-	     this, fd, strerror(errno));
+    // consume peeked length prefix
+    if (read(fd, &msgbuf[rcvd_size], hdr_len) != (ssize_t)hdr_len) {
+      INFO("socket error on connection [%p/%d]: %s",
+	   this, fd, strerror(errno));
+      close();
+      return REMOVE;
+    }
+    rcvd_size += hdr_len;
+
+    if (!colon) {
+      if (rcvd_size > MAX_NS_LEN_SIZE) {
+	DBG("closing connection [%p/%d]: oversize length", this, fd);
 	close();
 	return REMOVE;
       }
-      
-      //DBG("received '%c'", msgbuf[rcvd_size]);
-      if (msgbuf[rcvd_size] == ':') {
-	msgbuf[rcvd_size] = '\0';
-	if (str2i(std::string(msgbuf, rcvd_size), msg_size)) {
-	  ERROR("Protocol error decoding size '%s'", msgbuf);
-	  close();
-	  return REMOVE;
-	}
-	// received len - switch to receive msg mode
-	in_msg = true;
-	rcvd_size = read(fd,msgbuf,msg_size+1);
-	// DBG("received '%.*s'", rcvd_size, msgbuf);
-
-	if (rcvd_size == msg_size+1) { 
-	  if (msgbuf[msg_size] == ',') {
-	    msgbuf[msg_size+1] = '\0';
-	    return DISPATCH;
-	  }
-	  INFO("Protocol error on connection [%p/%d]: netstring not terminated with ','",
-	       this, fd);
-	  close();
-	  return REMOVE;
-	}
+      // wait for the rest of the length prefix
+      return CONTINUE;
+    }
 
-	if (!rcvd_size) {
-	  DBG("closing connection [%p/%d] on peer hangup", this, fd);
-	  close();
-	  return REMOVE;
-	}
+    msgbuf[rcvd_size-1] = '\0';
+    if (str2i(std::string(msgbuf, rcvd_size-1), msg_size)) {
+      ERROR("Protocol error decoding size '%s'", msgbuf);
+      close();
+      return REMOVE;
+    }
+    if (msg_size >= MAX_RPC_MSG_SIZE) {
+      INFO("Protocol error on connection [%p/%d]: message size %u exceeds limit",
+	   this, fd, msg_size);
+      close();
+      return REMOVE;
+    }
 
-	if ((rcvd_size<0 && errno == EAGAIN) || 
-	    (rcvd_size<0 && errno == EWOULDBLOCK))
-	  return CONTINUE; // necessary?
+    // received len - switch to receive msg mode
+    in_msg = true;
+    rcvd_size = 0;
+    r = read(fd,msgbuf,msg_size+1);
+    // DBG("received '%.*s'", r, msgbuf);
+
+    if (r == msg_size+1) { 
+      if (msgbuf[msg_size] == ',')
+	return DISPATCH;
+      INFO("Protocol error on connection [%p/%d]: netstring not terminated with ','",
+	   this, fd);
+      close();
+      return REMOVE;
+    }
 
-	if (rcvd_size<0) {
-	  INFO("socket error on connection [%p/%d]: %s",
-	       this, fd, strerror(errno));
-	  close();
-	  return REMOVE;
-	}
-	       
-	return CONTINUE; 	
-      } 
+    if (!r) {
+      DBG("closing connection [%p/%d] on peer hangup", this, fd);
+      close();
+      return REMOVE;
+    }
 
-      if (msgbuf[rcvd_size] < '0' || msgbuf[rcvd_size] > '9') {
-	INFO("Protocol error on connection [%p/%d]: invalid character in size",
-	     this, fd);
-	close();
-	return REMOVE;
-      }
-    
-      rcvd_size++;
+    if ((r<0 && errno == EAGAIN) || 
+	(r<0 && errno == EWOULDBLOCK))
+      return CONTINUE;
+
+    if (r<0) {
+      INFO("socket error on connection [%p/%d]: %s",
+	   this, fd, strerror(errno));
+      close();
+      return REMOVE;
     }
+
+    rcvd_size = r;
+    return CONTINUE;
   } else {
     ssize_t r = read(fd,msgbuf+rcvd_size,msg_size-rcvd_size+1);
     if (r>0) {
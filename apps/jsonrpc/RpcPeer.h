@@ -42,6 +42,8 @@
 #include <map>
 #include <string>
 
+class AmEventQueue;
+
 struct JsonrpcPeerConnection {
   std::string id;
 
@@ -97,6 +99,8 @@ struct JsonrpcNetstringsConnection
   int fd;  
   ev_io ev_write;
   ev_io ev_read;
+  // queue of the server loop which reads the connection
+  AmEventQueue* owner_queue;
 
   char snd_size[MAX_NS_LEN_SIZE+1];
   char msgbuf[MAX_RPC_MSG_SIZE];
@@ -181,7 +181,12 @@ void JsonRPCServerLoop::dispatchServerEvent(AmEvent* ev) {
   threadpool.dispatch(ev);
 }
 
-static void  accept_cb(struct ev_loop *loop, struct ev_io *w, int revents)
+static void accept_cb(struct ev_loop *loop, struct ev_io *w, int revents)
+{
+  JsonRPCServerLoop::acceptConnection(loop, w, static_cast<AmEventQueue*>(w->data));
+}
+
+void JsonRPCServerLoop::acceptConnection(struct ev_loop *loop, ev_io *w, AmEventQueue* owner_queue)
 {
   int client_fd;
   struct sockaddr_storage client_addr;
@@ -211,6 +216,7 @@ static void  accept_cb(struct ev_loop *loop, struct ev_io *w, int revents)
     JsonrpcNetstringsConnection* peer = new JsonrpcNetstringsConnection(connection_id);
     peer->fd=client_fd;
     peer->flags=0;
+    peer->owner_queue = owner_queue;
     if (setnonblock(peer->fd) < 0) {
         delete peer;
         ERROR("failed to set client socket to non-blocking");
@@ -286,6 +292,12 @@ void JsonRPCServerLoop::process(AmEvent* ev)
         return;
     }
 
+    processServerEvent(loop, this, server_event);
+}
+
+void JsonRPCServerLoop::processServerEvent(struct ev_loop *loop, AmEventQueue* owner_queue,
+                                           JsonServerEvent* server_event)
+{
     switch(server_event->event_id) {
     case JsonServerEvent::StartReadLoop: {
         JsonrpcNetstringsConnection* a_client = server_event->conn;
@@ -347,6 +359,12 @@ void JsonRPCServerLoop::process(AmEvent* ev)
             return;
         }
 
+        if(peer->owner_queue && peer->owner_queue != owner_queue) {
+            // connection is served by another accept loop
+            peer->owner_queue->postEvent(new JsonServerSendMessageEvent(*snd_msg_ev));
+            return;
+        }
+
         if(ev_is_active(&peer->ev_read)) {
             // ok, peer is in read loop, we can dispatch it to thread for sending
             ev_io_stop(EV_A_ &peer->ev_read);
@@ -382,17 +400,17 @@ JsonRPCServerLoop::~JsonRPCServerLoop() {
     ev_default_destroy();
 }
 
-int JsonRPCServerLoop::configure()
+int JsonRPCServerLoop::createListenSocket(bool reuse_port)
 {
     struct sockaddr_in listen_addr;
     int reuseaddr_on = 1;
-    listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
 
     SOCKET_LOG("socket(AF_INET, SOCK_STREAM, 0) = %d",listen_fd);
 
     if (listen_fd < 0) {
         ERROR("listen failed");
-        return 1;
+        return -1;
     }
 
     if (setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuseaddr_on,
@@ -401,6 +419,15 @@ int JsonRPCServerLoop::configure()
         ERROR("setsockopt(SO_REUSEADDR): %d", errno);
     }
 
+    if (reuse_port &&
+        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEPORT, &reuseaddr_on,
+                   sizeof(reuseaddr_on)) == -1)
+    {
+        ERROR("setsockopt(SO_REUSEPORT): %d", errno);
+        close(listen_fd);
+        return -1;
+    }
+
     memset(&listen_addr, 0, sizeof(listen_addr));
     listen_addr.sin_family = AF_INET;
     if(JsonRPCServerModule::host.empty()){
@@ -411,7 +438,8 @@ int JsonRPCServerLoop::configure()
         {
             ERROR("invalid address to listen: %s",
                 JsonRPCServerModule::host.c_str());
-            return 1;
+            close(listen_fd);
+            return -1;
         }
     }
 
@@ -428,7 +456,8 @@ int JsonRPCServerLoop::configure()
 
         if (setsockopt(listen_fd, IPPROTO_TCP, TCP_MD5SIG, &md5sig, sizeof(md5sig)) < 0) {
             ERROR("setsockopt(TCP_MD5SIG): %d", errno);
-            return 1;
+            close(listen_fd);
+            return -1;
         }
     }
 
@@ -437,17 +466,50 @@ int JsonRPCServerLoop::configure()
         sizeof(listen_addr)) < 0)
     {
         ERROR("bind failed");
-        return 1;
+        close(listen_fd);
+        return -1;
     }
 
-    if (listen(listen_fd,5) < 0) {
+    if (listen(listen_fd,SOMAXCONN) < 0) {
         ERROR("listen failed");
-        return 1;
+        close(listen_fd);
+        return -1;
     }
 
     if (setnonblock(listen_fd) < 0) {
         ERROR("failed to set server socket to non-blocking");
+        close(listen_fd);
+        return -1;
+    }
+
+    return listen_fd;
+}
+
+void JsonRPCServerLoop::clearAcceptLoops()
+{
+    for(auto l : accept_loops)
+        delete l;
+    accept_loops.clear();
+}
+
+int JsonRPCServerLoop::configure()
+{
+    bool reuse_port = JsonRPCServerModule::accept_loops > 1;
+
+    listen_fd = createListenSocket(reuse_port);
+    if(listen_fd < 0)
         return 1;
+
+    clearAcceptLoops();
+    for(int i = 1; i < JsonRPCServerModule::accept_loops; i++) {
+        JsonRpcAcceptLoop* l = new JsonRpcAcceptLoop(i);
+        accept_loops.push_back(l);
+        if(l->configure()) {
+            clearAcceptLoops();
+            close(listen_fd);
+            listen_fd = 0;
+            return 1;
+        }
     }
 
     return 0;
@@ -466,7 +528,11 @@ void JsonRPCServerLoop::run()
         JsonRPCServerModule::port);
 
 
+    for(auto l : accept_loops)
+        l->start();
+
     ev_io_init(&ev_accept,accept_cb,listen_fd,EV_READ);
+    ev_accept.data = static_cast<AmEventQueue*>(this);
     ev_io_start(loop,&ev_accept);
 
     // async watcher to process our events in event loop
@@ -483,6 +549,12 @@ void JsonRPCServerLoop::run()
     AmEventDispatcher::instance()->delEventQueue(JSONRPC_QUEUE_NAME);
     INFO("event loop finished");
     threadpool.cleanup();
+
+    // stop after workers to avoid connections returning into the stopped loops
+    for(auto l : accept_loops)
+        l->stop(true);
+    clearAcceptLoops();
+
     close(listen_fd);
     listen_fd = 0;
 }
@@ -498,6 +570,81 @@ void JsonRPCServerLoop::on_stop() {
   ev_async_send(loop, &async_stop);
 }
 
+JsonRpcAcceptLoop::JsonRpcAcceptLoop(int idx)
+  : AmEventQueue(this),
+    listen_fd(-1),
+    idx(idx)
+{
+    loop = ev_loop_new(EVFLAG_AUTO);
+}
+
+JsonRpcAcceptLoop::~JsonRpcAcceptLoop()
+{
+    if(listen_fd >= 0)
+        close(listen_fd);
+    ev_loop_destroy(loop);
+}
+
+int JsonRpcAcceptLoop::configure()
+{
+    listen_fd = JsonRPCServerLoop::createListenSocket(true);
+    return listen_fd < 0 ? 1 : 0;
+}
+
+void JsonRpcAcceptLoop::run()
+{
+    char thread_name[16];
+    snprintf(thread_name, sizeof(thread_name), "rpc-accept-%d", idx);
+    setThreadName(thread_name);
+
+    ev_io_init(&ev_accept, [](EV_P_ ev_io *w, int) {
+        JsonRPCServerLoop::acceptConnection(loop, w, static_cast<AmEventQueue*>(w->data));
+    }, listen_fd, EV_READ);
+    ev_accept.data = static_cast<AmEventQueue*>(this);
+    ev_io_start(loop, &ev_accept);
+
+    ev_async_init(&async_w, [](EV_P_ ev_async *w, int) {
+        static_cast<JsonRpcAcceptLoop*>(w->data)->processEvents();
+    });
+    async_w.data = this;
+    ev_async_start(loop, &async_w);
+
+    setEventNotificationSink(this);
+
+    INFO("running accept loop %d", idx);
+    ev_loop(loop, 0);
+    INFO("accept loop %d finished", idx);
+}
+
+void JsonRpcAcceptLoop::on_stop()
+{
+    ev_async_init(&async_stop, [](EV_P_ ev_async *w, int) {
+        JsonRpcAcceptLoop *l = static_cast<JsonRpcAcceptLoop*>(w->data);
+        ev_async_stop(loop, &l->async_stop);
+        ev_async_stop(loop, &l->async_w);
+        ev_io_stop(loop, &l->ev_accept);
+        ev_break(loop);
+    });
+    async_stop.data = this;
+    ev_async_start(loop, &async_stop);
+    ev_async_send(loop, &async_stop);
+}
+
+void JsonRpcAcceptLoop::notify(AmEventQueue* sender)
+{
+    ev_async_send(loop, &async_w);
+}
+
+void JsonRpcAcceptLoop::process(AmEvent* ev)
+{
+    JsonServerEvent* server_event = dynamic_cast<JsonServerEvent*>(ev);
+    if(server_event==NULL) {
+        ERROR("wrong event type received");
+        return;
+    }
+    JsonRPCServerLoop::processServerEvent(loop, this, server_event);
+}
+
 void JsonRPCServerLoop::returnConnection(JsonrpcNetstringsConnection* conn)
 {
     pending_events_mut.lock();
@@ -523,7 +670,8 @@ void JsonRPCServerLoop::returnConnection(JsonrpcNetstringsConnection* conn)
     pending_events_mut.unlock();
 
     //DBG("returning connection %p", conn);
-    instance()->postEvent(new JsonServerEvent(conn, JsonServerEvent::StartReadLoop));
+    AmEventQueue* owner_queue = conn->owner_queue ? conn->owner_queue : instance();
+    owner_queue->postEvent(new JsonServerEvent(conn, JsonServerEvent::StartReadLoop));
     //ev_async_send(loop, &async_w);
 }
 
@@ -539,6 +687,7 @@ void JsonRPCServerLoop::execRpc(const string& evq_link,
   string connection_id = newConnectionId();
   JsonrpcNetstringsConnection* peer = new JsonrpcNetstringsConnection(connection_id);
   peer->flags = flags;
+  peer->owner_queue = instance();
   peer->notificationReceiver = notificationReceiver;
   peer->requestReceiver = requestReceiver;
 
@@ -43,6 +43,32 @@
 
 #include <map>
 
+/**
+   additional accept loop listening on the same address
+   as the main server loop (SO_REUSEPORT).
+   connections accepted by the loop are read and returned to it
+*/
+class JsonRpcAcceptLoop
+: public AmThread, public AmEventQueue, public AmEventHandler, public AmEventNotificationSink
+{
+  struct ev_loop *loop;
+  ev_io ev_accept;
+  ev_async async_w;
+  ev_async async_stop;
+  int listen_fd;
+  int idx;
+
+ public:
+  JsonRpcAcceptLoop(int idx);
+  ~JsonRpcAcceptLoop();
+
+  int configure();
+  void run();
+  void on_stop();
+  void notify(AmEventQueue* sender);
+  void process(AmEvent* ev);
+};
+
 class JsonRPCServerLoop 
 : public AmThread, public AmEventQueue, public AmEventHandler, public AmEventNotificationSink
 {
@@ -60,6 +86,9 @@ class JsonRPCServerLoop
   static AmMutex pending_events_mut;
 
   int listen_fd;
+  vector<JsonRpcAcceptLoop*> accept_loops;
+
+  void clearAcceptLoops();
 
  public:
   JsonRPCServerLoop();
@@ -72,6 +101,18 @@ class JsonRPCServerLoop
   static void dispatchServerEvent(AmEvent* ev);
   static void _processEvents();
 
+  /** create listening socket for the configured address
+      @return socket fd or -1 on errors */
+  static int createListenSocket(bool reuse_port);
+
+  /** accept new connection and start read loop on it in the loop owned by queue */
+  static void acceptConnection(struct ev_loop *loop, ev_io *w, AmEventQueue* owner_queue);
+
+  /** process StartReadLoop/SendMessage events
+      for connections owned by the loop of owner_queue */
+  static void processServerEvent(struct ev_loop *loop, AmEventQueue* owner_queue,
+                                 JsonServerEvent* server_event);
+
   static void execRpc(const string& evq_link, 
 		      const string& notificationReceiver,
 		      const string& requestReceiver,
@@ -16,4 +16,13 @@ module "jsonrpc" {
     # optional; default: 5
     #
     server_threads=5
+
+    # accept_loops  - number of event loops accepting and reading
+    #                 connections. loops listen on the same address
+    #                 using SO_REUSEPORT, so the kernel spreads
+    #                 incoming connections among them
+    #
+    # optional; default: 1
+    #
+    # accept_loops=1
 }
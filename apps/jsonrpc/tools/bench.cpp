@@ -0,0 +1,234 @@
+/* JSON-RPC load generator.
+ * runs request/reply loops over several netstrings connections
+ * and reports requests/sec with latency percentiles */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <getopt.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+using std::string;
+using std::vector;
+typedef std::chrono::steady_clock bench_clock;
+
+struct BenchConfig {
+    string host;
+    string port;
+    string method;
+    string params;
+    int connections;
+    int duration;
+    BenchConfig()
+      : host("127.0.0.1"),
+        port("7080"),
+        method("core.show.version"),
+        params("[]"),
+        connections(4),
+        duration(10)
+    {}
+} cfg;
+
+std::atomic<bool> stop_flag(false);
+
+struct ConnectionStats {
+    unsigned long long requests;
+    unsigned long long errors;
+    vector<unsigned int> latencies_us;
+    ConnectionStats()
+      : requests(0),
+        errors(0)
+    {}
+};
+
+static int connect_to(const BenchConfig &c)
+{
+    struct addrinfo hints, *res;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    if(getaddrinfo(c.host.c_str(), c.port.c_str(), &hints, &res)) {
+        fprintf(stderr, "failed to resolve %s:%s\n", c.host.c_str(), c.port.c_str());
+        return -1;
+    }
+
+    int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if(fd < 0 || connect(fd, res->ai_addr, res->ai_addrlen) < 0) {
+        fprintf(stderr, "failed to connect to %s:%s: %s\n",
+                c.host.c_str(), c.port.c_str(), strerror(errno));
+        if(fd >= 0) close(fd);
+        freeaddrinfo(res);
+        return -1;
+    }
+    freeaddrinfo(res);
+
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    return fd;
+}
+
+static bool write_all(int fd, const char *buf, size_t len)
+{
+    while(len) {
+        ssize_t r = write(fd, buf, len);
+        if(r < 0) {
+            if(errno == EINTR) continue;
+            return false;
+        }
+        buf += r;
+        len -= r;
+    }
+    return true;
+}
+
+static bool read_all(int fd, char *buf, size_t len)
+{
+    while(len) {
+        ssize_t r = read(fd, buf, len);
+        if(r <= 0) {
+            if(r < 0 && errno == EINTR) continue;
+            return false;
+        }
+        buf += r;
+        len -= r;
+    }
+    return true;
+}
+
+/* @return false on connection errors */
+static bool read_reply(int fd, string &reply)
+{
+    size_t len = 0;
+    char c;
+    while(true) {
+        if(!read_all(fd, &c, 1)) return false;
+        if(c == ':') break;
+        if(c < '0' || c > '9') return false;
+        len = len*10 + (c - '0');
+    }
+    reply.resize(len + 1);
+    if(!read_all(fd, &reply[0], len + 1)) return false;
+    if(reply[len] != ',') return false;
+    reply.resize(len);
+    return true;
+}
+
+static void run_connection(ConnectionStats &stats)
+{
+    int fd = connect_to(cfg);
+    if(fd < 0) {
+        stats.errors++;
+        return;
+    }
+
+    string reply, msg;
+    char prefix[32];
+    unsigned long long id = 0;
+
+    while(!stop_flag.load(std::memory_order_relaxed)) {
+        msg = "{\"jsonrpc\":\"2.0\",\"id\":" + std::to_string(++id) +
+              ",\"method\":\"" + cfg.method + "\",\"params\":" + cfg.params + "}";
+        int prefix_len = snprintf(prefix, sizeof(prefix), "%zu:", msg.size());
+        msg.insert(0, prefix, prefix_len);
+        msg += ',';
+
+        auto start = bench_clock::now();
+        if(!write_all(fd, msg.data(), msg.size()) || !read_reply(fd, reply)) {
+            stats.errors++;
+            break;
+        }
+        stats.latencies_us.push_back(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                bench_clock::now() - start).count());
+
+        if(reply.find("\"error\"") != string::npos)
+            stats.errors++;
+        stats.requests++;
+    }
+
+    close(fd);
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+        "usage: %s [-a host] [-p port] [-c connections] [-d seconds] [-m method] [-P params_json]\n"
+        "\tdefaults: -a %s -p %s -c %d -d %d -m %s -P '%s'\n",
+        name,
+        cfg.host.c_str(), cfg.port.c_str(), cfg.connections, cfg.duration,
+        cfg.method.c_str(), cfg.params.c_str());
+}
+
+int main(int argc, char **argv)
+{
+    int opt;
+    while((opt = getopt(argc, argv, "a:p:c:d:m:P:h")) != -1) {
+        switch(opt) {
+        case 'a': cfg.host = optarg; break;
+        case 'p': cfg.port = optarg; break;
+        case 'c': cfg.connections = atoi(optarg); break;
+        case 'd': cfg.duration = atoi(optarg); break;
+        case 'm': cfg.method = optarg; break;
+        case 'P': cfg.params = optarg; break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if(cfg.connections < 1 || cfg.duration < 1) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("%s:%s method '%s', %d connections, %d seconds\n",
+           cfg.host.c_str(), cfg.port.c_str(), cfg.method.c_str(),
+           cfg.connections, cfg.duration);
+
+    vector<ConnectionStats> stats(cfg.connections);
+    vector<std::thread> threads;
+    auto start = bench_clock::now();
+    for(auto &s : stats)
+        threads.emplace_back(run_connection, std::ref(s));
+
+    std::this_thread::sleep_for(std::chrono::seconds(cfg.duration));
+    stop_flag = true;
+    for(auto &t : threads)
+        t.join();
+    double elapsed = std::chrono::duration<double>(bench_clock::now() - start).count();
+
+    unsigned long long requests = 0, errors = 0;
+    vector<unsigned int> latencies;
+    for(auto &s : stats) {
+        requests += s.requests;
+        errors += s.errors;
+        latencies.insert(latencies.end(), s.latencies_us.begin(), s.latencies_us.end());
+    }
+
+    printf("requests: %llu, errors: %llu, elapsed: %.2fs\n", requests, errors, elapsed);
+    printf("requests/sec: %.0f\n", requests / elapsed);
+
+    if(!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        auto percentile = [&latencies](double p) {
+            return latencies[std::min(latencies.size() - 1, (size_t)(latencies.size() * p))];
+        };
+        printf("latency us: p50 %u, p90 %u, p99 %u, max %u\n",
+               percentile(0.5), percentile(0.9), percentile(0.99), latencies.back());
+    }
+
+    return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -37,6 +37,8 @@
 #include <unistd.h>
 #include <AmLcConfig.h>
 
+#include <functional>
+
 EXPORT_PLUGIN_CLASS_FACTORY(Monitor);
 EXPORT_PLUGIN_CONF_FACTORY(Monitor)
 
@@ -53,7 +55,11 @@ Monitor* Monitor::instance()
 }
 
 Monitor::Monitor(const string& name) 
-  : AmDynInvokeFactory(MOD_NAME), AmConfigFactory(MOD_NAME), gc_thread(NULL) {
+  : AmDynInvokeFactory(MOD_NAME), AmConfigFactory(MOD_NAME), gc_thread(NULL),
+    num_buckets(NUM_LOG_BUCKETS), logs(new LogBucket[NUM_LOG_BUCKETS]),
+    bucket_max_records(0),
+    stat_records(stat_group(Gauge, MOD_NAME, "records").addAtomicCounter()),
+    stat_evicted(stat_group(Counter, MOD_NAME, "evicted").addAtomicCounter()) {
 }
 
 Monitor::~Monitor() {
@@ -65,6 +71,9 @@ int Monitor::configure(const string& config)
         CFG_BOOL("run_garbage_collector", cfg_true, CFGF_NONE),
         CFG_INT("garbage_collector_interval", 10, CFGF_NONE),
         CFG_INT("retain_samples_s", 10, CFGF_NONE),
+        CFG_INT("buckets", NUM_LOG_BUCKETS, CFGF_NONE),
+        CFG_INT("max_records", 0, CFGF_NONE),
+        CFG_STR_LIST("indexed_attributes", 0, CFGF_NODEFAULT),
         CFG_END()
     };
 
@@ -87,6 +96,24 @@ int Monitor::configure(const string& config)
     gcInterval = cfg_getint(cfg, "garbage_collector_interval");
     retain_samples_s = cfg_getint(cfg, "retain_samples_s");
 
+    long buckets = cfg_getint(cfg, "buckets");
+    if(buckets < 1) {
+        ERROR("%s: buckets must be greater than 0",MOD_NAME);
+        cfg_free(cfg);
+        return -1;
+    }
+    if((unsigned int)buckets != num_buckets) {
+        num_buckets = buckets;
+        logs.reset(new LogBucket[num_buckets]);
+    }
+
+    long max_records = cfg_getint(cfg, "max_records");
+    bucket_max_records = max_records > 0 ? (max_records + num_buckets - 1) / num_buckets : 0;
+
+    indexed_attributes.clear();
+    for(unsigned int j = 0; j < cfg_size(cfg, "indexed_attributes"); j++)
+        indexed_attributes.emplace(cfg_getnstr(cfg, "indexed_attributes", j));
+
     cfg_free(cfg);
     return 0;
 }
@@ -155,6 +182,8 @@ void Monitor::invoke(const string& method,
     listFinished(args,ret);
   } else if(method == "listActive"){
     listActive(args,ret);
+  } else if(method == "getStats"){
+    getStats(args,ret);
   } else if(method == "clear"){
     clear(args,ret);
   } else if(method == "clearFinished"){
@@ -188,6 +217,7 @@ void Monitor::invoke(const string& method,
     ret.push(AmArg("listByRegex"));
     ret.push(AmArg("listFinished"));
     ret.push(AmArg("listActive"));
+    ret.push(AmArg("getStats"));
   } else
     throw AmDynInvoke::NotImplemented(method);
 }
@@ -195,11 +225,22 @@ void Monitor::invoke(const string& method,
 void Monitor::log(const AmArg& args, AmArg& ret) {
   assertArgCStr(args[0]);
   
-  LogBucket& bucket = getLogBucket(args[0].asCStr());
+  string id = args[0].asCStr();
+  LogBucket& bucket = getLogBucket(id);
   bucket.log_lock.lock();
   try {
-    for (size_t i=1;i<args.size();i+=2)
-      bucket.log[args[0].asCStr()].info[args[i].asCStr()]=AmArg(args[i+1]);
+    LogInfo& log_info = getLogInfo(bucket, id);
+    for (size_t i=1;i<args.size();i+=2) {
+      const char* attr = args[i].asCStr();
+      AmArg& v = log_info.info[attr];
+      if (isIndexed(attr)) {
+        indexErase(bucket, id, attr, v);
+        v = AmArg(args[i+1]);
+        indexInsert(bucket, id, attr, v);
+      } else {
+        v = AmArg(args[i+1]);
+      }
+    }
   } catch (...) {
     bucket.log_lock.unlock();
     ret.push(-1);
@@ -214,16 +255,23 @@ void Monitor::log(const AmArg& args, AmArg& ret) {
 void Monitor::add(const AmArg& args, AmArg& ret, int a) {
   assertArgCStr(args[0]);
 
-  LogBucket& bucket = getLogBucket(args[0].asCStr());
+  string id = args[0].asCStr();
+  LogBucket& bucket = getLogBucket(id);
   bucket.log_lock.lock();
   try {
     //for (size_t i=1;i<args.size();i++) {
     int val = 0;
-    AmArg& v = bucket.log[args[0].asCStr()].info[args[1].asCStr()];
+    const char* attr = args[1].asCStr();
+    AmArg& v = getLogInfo(bucket, id).info[attr];
+    bool indexed = isIndexed(attr);
+    if (indexed)
+      indexErase(bucket, id, attr, v);
     if (isArgInt(v))
       val = v.asInt();
     val+=a;
     v = val;
+    if (indexed)
+      indexInsert(bucket, id, attr, v);
     //}
   } catch (...) {
     bucket.log_lock.unlock();
@@ -253,16 +301,23 @@ void Monitor::logAdd(const AmArg& args, AmArg& ret) {
   assertArgCStr(args[0]);
   assertArgCStr(args[1]);
 
-  LogBucket& bucket = getLogBucket(args[0].asCStr());
+  string id = args[0].asCStr();
+  LogBucket& bucket = getLogBucket(id);
   bucket.log_lock.lock();
   try {
-    AmArg& val = bucket.log[args[0].asCStr()].info[args[1].asCStr()];
+    const char* attr = args[1].asCStr();
+    AmArg& val = getLogInfo(bucket, id).info[attr];
+    bool indexed = isIndexed(attr);
+    if (indexed)
+      indexErase(bucket, id, attr, val);
     if (!isArgArray(val) && !isArgUndef(val)) {
       AmArg v1 = val;
       val = AmArg();
       val.push(v1);
     }
     val.push(AmArg(args[2]));
+    if (indexed)
+      indexInsert(bucket, id, attr, val);
   } catch (...) {
     bucket.log_lock.unlock();
     throw;
@@ -366,7 +421,7 @@ void Monitor::getCount(const AmArg& args, AmArg& ret) {
   LogBucket& bucket = getLogBucket(args[0].asCStr());
   bucket.log_lock.lock();
 
-  map<string, SampleInfo>::iterator it =
+  std::unordered_map<string, SampleInfo>::iterator it =
         bucket.samples.find(args[0].asCStr());
   if (it != bucket.samples.end()) {
 
@@ -442,7 +497,7 @@ void Monitor::getAllCounts(const AmArg& args, AmArg& ret) {
   LogBucket& bucket = getLogBucket(args[0].asCStr());
   bucket.log_lock.lock();
 
-  map<string, SampleInfo>::iterator it =
+  std::unordered_map<string, SampleInfo>::iterator it =
         bucket.samples.find(args[0].asCStr());
   if (it != bucket.samples.end()) {
 
@@ -475,10 +530,12 @@ void Monitor::getAllCounts(const AmArg& args, AmArg& ret) {
 void Monitor::markFinished(const AmArg& args, AmArg& ret) {
   assertArgCStr(args[0]);
 
-  LogBucket& bucket = getLogBucket(args[0].asCStr());
+  string id = args[0].asCStr();
+  LogBucket& bucket = getLogBucket(id);
   bucket.log_lock.lock();
-  if (!bucket.log[args[0].asCStr()].finished)
-    bucket.log[args[0].asCStr()].finished = time(0);
+  LogInfo& log_info = getLogInfo(bucket, id);
+  if (!log_info.finished)
+    setFinished(bucket, id, log_info, time(0));
   bucket.log_lock.unlock();
   ret.push(0);
   ret.push("OK");
@@ -488,9 +545,10 @@ void Monitor::setExpiration(const AmArg& args, AmArg& ret) {
   assertArgCStr(args[0]);
   assertArgInt(args[1]);
 
-  LogBucket& bucket = getLogBucket(args[0].asCStr());
+  string id = args[0].asCStr();
+  LogBucket& bucket = getLogBucket(id);
   bucket.log_lock.lock();
-  bucket.log[args[0].asCStr()].finished = args[1].asInt();
+  setFinished(bucket, id, getLogInfo(bucket, id), args[1].asInt());
   bucket.log_lock.unlock();
   ret.push(0);
   ret.push("OK");
@@ -500,7 +558,9 @@ void Monitor::erase(const AmArg& args, AmArg& ret) {
   assertArgCStr(args[0]);
   LogBucket& bucket = getLogBucket(args[0].asCStr());
   bucket.log_lock.lock();
-  bucket.log.erase(args[0].asCStr());
+  std::unordered_map<string, LogInfo>::iterator it = bucket.log.find(args[0].asCStr());
+  if (it != bucket.log.end())
+    eraseLogInfo(bucket, it);
   bucket.samples.erase(args[0].asCStr());
   bucket.log_lock.unlock();
   ret.push(0);
@@ -508,10 +568,14 @@ void Monitor::erase(const AmArg& args, AmArg& ret) {
 }
 
 void Monitor::clear(const AmArg& args, AmArg& ret) {
-  for (int i=0;i<NUM_LOG_BUCKETS;i++) {
+  for (unsigned int i=0;i<num_buckets;i++) {
     logs[i].log_lock.lock();
+    stat_records.dec(logs[i].log.size());
     logs[i].log.clear();
     logs[i].samples.clear();
+    logs[i].finished.clear();
+    logs[i].over_limit = false;
+    logs[i].index.clear();
     logs[i].log_lock.unlock();
   }
   ret.push(0);
@@ -527,17 +591,15 @@ void Monitor::clearFinished(const AmArg& args, AmArg& ret) {
 
 void Monitor::clearFinished() {
   time_t now = time(0);
-  for (int i=0;i<NUM_LOG_BUCKETS;i++) {
+  for (unsigned int i=0;i<num_buckets;i++) {
     logs[i].log_lock.lock();
-    std::map<string, LogInfo>::iterator it=
+    std::unordered_map<string, LogInfo>::iterator it=
       logs[i].log.begin();
     while (it != logs[i].log.end()) {
       if (it->second.finished && 
 	  it->second.finished <= now) {
-	std::map<string, LogInfo>::iterator d_it = it;
-	it++;
-	logs[i].samples.erase(d_it->first);
-	logs[i].log.erase(d_it);
+	logs[i].samples.erase(it->first);
+	it = eraseLogInfo(logs[i], it);
       } else {
 	it++;
       }
@@ -551,7 +613,7 @@ void Monitor::get(const AmArg& args, AmArg& ret) {
   ret.assertArray();
   LogBucket& bucket = getLogBucket(args[0].asCStr());
   bucket.log_lock.lock();
-  std::map<string, LogInfo>::iterator it=bucket.log.find(args[0].asCStr());
+  std::unordered_map<string, LogInfo>::iterator it=bucket.log.find(args[0].asCStr());
   if (it!=bucket.log.end())
     ret.push(it->second.info);
   bucket.log_lock.unlock();
@@ -568,7 +630,7 @@ void Monitor::getSingle(const AmArg& args, AmArg& ret) {
 
   LogBucket& bucket = getLogBucket(args[0].asCStr());
   bucket.log_lock.lock();
-  std::map<string, LogInfo>::iterator it=bucket.log.find(args[0].asCStr());
+  std::unordered_map<string, LogInfo>::iterator it=bucket.log.find(args[0].asCStr());
   if (it!=bucket.log.end()){
     AmArg& _v = it->second.info;
     DBG("found log: %s",AmArg::print(_v).c_str());
@@ -583,9 +645,9 @@ void Monitor::getSingle(const AmArg& args, AmArg& ret) {
 void Monitor::getAttribute(const AmArg& args, AmArg& ret) {
   assertArgCStr(args[0]);
   string attr_name = args[0].asCStr();
-  for (int i=0;i<NUM_LOG_BUCKETS;i++) {
+  for (unsigned int i=0;i<num_buckets;i++) {
     logs[i].log_lock.lock();
-    for (std::map<string, LogInfo>::iterator it=
+    for (std::unordered_map<string, LogInfo>::iterator it=
 	   logs[i].log.begin();it != logs[i].log.end();it++) {
       ret.push(AmArg());
       AmArg& val = ret.get(ret.size()-1);
@@ -603,9 +665,9 @@ void Monitor::getAttribute(const AmArg& args, AmArg& ret) {
     ret.assertArray();							\
     string attr_name = args[0].asCStr();				\
     time_t now = time(0);						\
-    for (int i=0;i<NUM_LOG_BUCKETS;i++) {				\
+    for (unsigned int i=0;i<num_buckets;i++) {			\
       logs[i].log_lock.lock();						\
-      for (std::map<string, LogInfo>::iterator it=			\
+      for (std::unordered_map<string, LogInfo>::iterator it=			\
 	     logs[i].log.begin();it != logs[i].log.end();it++) {	\
 	if (cond) {							\
 	  ret.push(AmArg());						\
@@ -626,9 +688,9 @@ DEF_GET_ATTRIB_FUNC(getAttributeFinished,(it->second.finished &&
 
 void Monitor::listAll(const AmArg& args, AmArg& ret) {
   ret.assertArray();
-  for (int i=0;i<NUM_LOG_BUCKETS;i++) {
+  for (unsigned int i=0;i<num_buckets;i++) {
     logs[i].log_lock.lock();
-    for (std::map<string, LogInfo>::iterator it=
+    for (std::unordered_map<string, LogInfo>::iterator it=
 	   logs[i].log.begin(); it != logs[i].log.end(); it++) {
       ret.push(AmArg(it->first.c_str()));
     }
@@ -636,47 +698,95 @@ void Monitor::listAll(const AmArg& args, AmArg& ret) {
   }
 }
 
+static bool matchFilter(const AmArg& args, const AmArg& info) {
+  for (size_t a_i=0;a_i<args.size();a_i++) {
+    AmArg& p = args.get(a_i);
+    const char* attr = p.get(0).asCStr();
+    if (info.hasMember(attr)) {
+      if (!(info[attr]==p.get(1)))
+	return false;
+    } else if (!isArgUndef(p.get(1))) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void Monitor::listByFilter(const AmArg& args, AmArg& ret, bool erase, filter_respone_type rtype) {
   ret.assertArray();
-  for (int i=0;i<NUM_LOG_BUCKETS;i++) {
-    logs[i].log_lock.lock();
-    try {
-      std::map<string, LogInfo>::iterator it=logs[i].log.begin();
-
-      while (it != logs[i].log.end()) {
-	bool match = true;
-	for (size_t a_i=0;a_i<args.size();a_i++) {
-	  AmArg& p = args.get(a_i);	  
-	  if (!(it->second.info[p.get(0).asCStr()]==p.get(1))) {
-	    match = false;
-	    break;
-	  }
-	}
 
-	if (match) {
-	  switch(rtype){
-		case frtype_info:
-		  ret.push(it->second.info);
-		  ret.back()["id"] = it->first.c_str();
-		  break;
-		case frtype_id:
-		default:
-		  ret.push(AmArg(it->first.c_str()));
-	  }
-	  if (erase) {
-	    std::map<string, LogInfo>::iterator d_it=it;
-	    it++;
-	    logs[i].log.erase(d_it);
-	    continue;
+  // candidates lookup by the first indexed attribute of the filter
+  const char* index_attr = NULL;
+  string index_value;
+  for (size_t a_i=0;a_i<args.size();a_i++) {
+    AmArg& p = args.get(a_i);
+    if (isIndexed(p.get(0).asCStr()) && !isArgUndef(p.get(1))) {
+      index_attr = p.get(0).asCStr();
+      index_value = AmArg::print(p.get(1));
+      break;
+    }
+  }
+
+  // filter is matched on the bucket snapshot without holding the lock
+  vector<std::pair<string, AmArg> > snapshot;
+  vector<string> matched;
+  for (unsigned int i=0;i<num_buckets;i++) {
+    LogBucket& bucket = logs[i];
+    bucket.log_lock.lock();
+    try {
+      if (index_attr) {
+	auto a_it = bucket.index.find(index_attr);
+	if (a_it != bucket.index.end()) {
+	  auto v_it = a_it->second.find(index_value);
+	  if (v_it != a_it->second.end()) {
+	    snapshot.reserve(v_it->second.size());
+	    for (const auto& id : v_it->second) {
+	      auto it = bucket.log.find(id);
+	      if (it != bucket.log.end())
+		snapshot.emplace_back(it->first, it->second.info);
+	    }
 	  }
 	}
-	it++;
+      } else {
+	snapshot.reserve(bucket.log.size());
+	for (std::unordered_map<string, LogInfo>::iterator it=
+	       bucket.log.begin(); it != bucket.log.end(); it++)
+	  snapshot.emplace_back(it->first, it->second.info);
       }
     } catch(...) {
-      logs[i].log_lock.unlock();
+      bucket.log_lock.unlock();
       throw;
     }
-    logs[i].log_lock.unlock();
+    bucket.log_lock.unlock();
+
+    for (auto& entry : snapshot) {
+      if (!matchFilter(args, entry.second))
+	continue;
+
+      switch(rtype){
+      case frtype_info:
+	ret.push(entry.second);
+	ret.back()["id"] = entry.first.c_str();
+	break;
+      case frtype_id:
+      default:
+	ret.push(AmArg(entry.first.c_str()));
+      }
+      if (erase)
+	matched.push_back(entry.first);
+    }
+    snapshot.clear();
+
+    if (!matched.empty()) {
+      bucket.log_lock.lock();
+      for (const auto& id : matched) {
+	auto it = bucket.log.find(id);
+	if (it != bucket.log.end())
+	  eraseLogInfo(bucket, it);
+      }
+      bucket.log_lock.unlock();
+      matched.clear();
+    }
   }
 }
 
@@ -690,24 +800,26 @@ void Monitor::listByRegex(const AmArg& args, AmArg& ret) {
     ERROR("could not compile regex '%s'", args[1].asCStr());
     return;
   }
-  
-  for (int i=0;i<NUM_LOG_BUCKETS;i++) {
+
+  const char* attr = args[0].asCStr();
+  // matching is done on the bucket snapshot without holding the lock
+  vector<std::pair<string, string> > snapshot;
+  for (unsigned int i=0;i<num_buckets;i++) {
     logs[i].log_lock.lock();
-    try {
-      for (std::map<string, LogInfo>::iterator it=
-	     logs[i].log.begin(); it != logs[i].log.end(); it++) {
-	if (!it->second.info.hasMember(args[0].asCStr())  || 
-	    !isArgCStr(it->second.info[args[0].asCStr()]) ||
-	    regexec(&attr_reg,it->second.info[args[0].asCStr()].asCStr(),0,0,0))
-	  continue;
-
-	ret.push(AmArg(it->first.c_str()));  
-      }
-    } catch(...) {
-      logs[i].log_lock.unlock();
-      throw;
+    snapshot.reserve(logs[i].log.size());
+    for (std::unordered_map<string, LogInfo>::iterator it=
+	   logs[i].log.begin(); it != logs[i].log.end(); it++) {
+      const AmArg& info = it->second.info;
+      if (info.hasMember(attr) && isArgCStr(info[attr]))
+	snapshot.emplace_back(it->first, info[attr].asCStr());
     }
     logs[i].log_lock.unlock();
+
+    for (const auto& entry : snapshot) {
+      if (!regexec(&attr_reg,entry.second.c_str(),0,0,0))
+	ret.push(AmArg(entry.first.c_str()));
+    }
+    snapshot.clear();
   }
 
   regfree(&attr_reg);
@@ -716,9 +828,9 @@ void Monitor::listByRegex(const AmArg& args, AmArg& ret) {
 void Monitor::listFinished(const AmArg& args, AmArg& ret) {
   time_t now = time(0);
   ret.assertArray();
-  for (int i=0;i<NUM_LOG_BUCKETS;i++) {
+  for (unsigned int i=0;i<num_buckets;i++) {
     logs[i].log_lock.lock();
-    for (std::map<string, LogInfo>::iterator it=
+    for (std::unordered_map<string, LogInfo>::iterator it=
 	   logs[i].log.begin(); it != logs[i].log.end(); it++) {
       if (it->second.finished && 
 	  it->second.finished <= now)
@@ -732,9 +844,9 @@ void Monitor::listFinished(const AmArg& args, AmArg& ret) {
 void Monitor::listActive(const AmArg& args, AmArg& ret) {
   time_t now = time(0);
   ret.assertArray();
-  for (int i=0;i<NUM_LOG_BUCKETS;i++) {
+  for (unsigned int i=0;i<num_buckets;i++) {
     logs[i].log_lock.lock();
-    for (std::map<string, LogInfo>::iterator it=
+    for (std::unordered_map<string, LogInfo>::iterator it=
 	   logs[i].log.begin(); it != logs[i].log.end(); it++) {
       if (!(it->second.finished &&
 	    it->second.finished <= now))
@@ -744,14 +856,96 @@ void Monitor::listActive(const AmArg& args, AmArg& ret) {
   }
 }
 
+void Monitor::getStats(const AmArg& args, AmArg& ret) {
+  ret.assertStruct();
+  ret["buckets"] = (int)num_buckets;
+  ret["max_records"] = (long long)(bucket_max_records*num_buckets);
+  ret["records"] = (long long)stat_records.get();
+  ret["evicted"] = (long long)stat_evicted.get();
+  AmArg& attrs = ret["indexed_attributes"];
+  attrs.assertArray();
+  for (const auto& attr : indexed_attributes)
+    attrs.push(attr);
+}
+
 LogBucket& Monitor::getLogBucket(const string& call_id) {
   if (call_id.empty())
     return logs[0];
-  char c = '\0'; // some distribution...bad luck if all callid start with 00000...
-  for (size_t i=0;i<5 && i<call_id.length();i++) 
-    c = c ^ call_id[i];
-  
-  return logs[c % NUM_LOG_BUCKETS];
+  return logs[std::hash<string>()(call_id) % num_buckets];
+}
+
+LogInfo& Monitor::getLogInfo(LogBucket& bucket, const string& id) {
+  std::unordered_map<string, LogInfo>::iterator it = bucket.log.find(id);
+  if (it != bucket.log.end())
+    return it->second;
+
+  if (bucket_max_records && bucket.log.size() >= bucket_max_records) {
+    // evict the oldest finished entries, active calls are never dropped
+    time_t now = time(0);
+    list<string>::iterator f_it = bucket.finished.begin();
+    while (bucket.log.size() >= bucket_max_records &&
+	   f_it != bucket.finished.end()) {
+      it = bucket.log.find(*f_it);
+      f_it++;
+      if (it->second.finished > now)
+	continue;
+      bucket.samples.erase(it->first);
+      eraseLogInfo(bucket, it);
+      stat_evicted.inc();
+    }
+
+    if (bucket.log.size() < bucket_max_records) {
+      bucket.over_limit = false;
+    } else if (!bucket.over_limit) {
+      WARN("max_records limit reached with no finished calls to evict, "
+	   "bucket has %zu active calls", bucket.log.size());
+      bucket.over_limit = true;
+    }
+  }
+
+  LogInfo& log_info = bucket.log[id];
+  stat_records.inc();
+  return log_info;
+}
+
+std::unordered_map<string, LogInfo>::iterator
+Monitor::eraseLogInfo(LogBucket& bucket, std::unordered_map<string, LogInfo>::iterator it) {
+  for (const auto& attr : indexed_attributes) {
+    if (it->second.info.hasMember(attr))
+      indexErase(bucket, it->first, attr, it->second.info[attr]);
+  }
+  if (it->second.finished)
+    bucket.finished.erase(it->second.finished_it);
+  stat_records.dec();
+  return bucket.log.erase(it);
+}
+
+void Monitor::setFinished(LogBucket& bucket, const string& id, LogInfo& log_info, time_t finished) {
+  if (finished && !log_info.finished)
+    log_info.finished_it = bucket.finished.insert(bucket.finished.end(), id);
+  else if (!finished && log_info.finished)
+    bucket.finished.erase(log_info.finished_it);
+  log_info.finished = finished;
+}
+
+void Monitor::indexInsert(LogBucket& bucket, const string& id, const string& attr, const AmArg& value) {
+  if (isArgUndef(value))
+    return;
+  bucket.index[attr][AmArg::print(value)].insert(id);
+}
+
+void Monitor::indexErase(LogBucket& bucket, const string& id, const string& attr, const AmArg& value) {
+  if (isArgUndef(value))
+    return;
+  auto a_it = bucket.index.find(attr);
+  if (a_it == bucket.index.end())
+    return;
+  auto v_it = a_it->second.find(AmArg::print(value));
+  if (v_it == a_it->second.end())
+    return;
+  v_it->second.erase(id);
+  if (v_it->second.empty())
+    a_it->second.erase(v_it);
 }
 
 void MonitorGarbageCollector::run() {
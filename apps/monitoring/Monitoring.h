@@ -29,11 +29,15 @@
 #define _MONITORING_H_
 
 #include <map>
+#include <set>
+#include <list>
+#include <unordered_map>
 #include <memory>
 
 #include "AmThread.h"
 #include "AmApi.h"
 #include "AmArg.h"
+#include "AmStatistics.h"
 
 #include <time.h>
 
@@ -41,6 +45,7 @@
 
 struct LogInfo {
   time_t finished; // for garbage collection
+  list<string>::iterator finished_it; // position in LogBucket::finished if finished
 LogInfo() 
  : finished(0) { }
   AmArg info;
@@ -61,8 +66,16 @@ struct SampleInfo {
 
 struct LogBucket {
   AmMutex log_lock;
-  std::map<string, LogInfo> log;
-  std::map<string, SampleInfo> samples;
+  std::unordered_map<string, LogInfo> log;
+  std::unordered_map<string, SampleInfo> samples;
+  // finished log ids in finishing order (eviction candidates)
+  list<string> finished;
+  // max_records reached without finished entries to evict (warned)
+  bool over_limit;
+  // indexed attribute -> printed value -> log ids
+  std::map<string, std::unordered_map<string, std::set<string> > > index;
+
+  LogBucket() : over_limit(false) { }
 };
 class MonitorGarbageCollector;
 
@@ -76,10 +89,30 @@ class Monitor
 
   enum filter_respone_type { frtype_id, frtype_info };
 
-  LogBucket logs[NUM_LOG_BUCKETS];
+  unsigned int num_buckets;
+  std::unique_ptr<LogBucket[]> logs;
+
+  // max log entries per bucket, 0 - unlimited
+  size_t bucket_max_records;
+  std::set<string> indexed_attributes;
+
+  AtomicCounter& stat_records;
+  AtomicCounter& stat_evicted;
 
   LogBucket& getLogBucket(const string& call_id);
 
+  // get or create log entry. may evict the oldest finished entry of the bucket
+  LogInfo& getLogInfo(LogBucket& bucket, const string& id);
+  void setFinished(LogBucket& bucket, const string& id, LogInfo& log_info, time_t finished);
+  std::unordered_map<string, LogInfo>::iterator
+    eraseLogInfo(LogBucket& bucket, std::unordered_map<string, LogInfo>::iterator it);
+
+  bool isIndexed(const string& attr) {
+    return !indexed_attributes.empty() && indexed_attributes.count(attr);
+  }
+  void indexInsert(LogBucket& bucket, const string& id, const string& attr, const AmArg& value);
+  void indexErase(LogBucket& bucket, const string& id, const string& attr, const AmArg& value);
+
   static unsigned int retain_samples_s;
   void truncate_samples(list<SampleInfo::time_cnt>& v, struct timeval now);
 
@@ -109,6 +142,7 @@ class Monitor
   void listByRegex(const AmArg& args, AmArg& ret);
   void listFinished(const AmArg& args, AmArg& ret);
   void listActive(const AmArg& args, AmArg& ret);
+  void getStats(const AmArg& args, AmArg& ret);
 
   void add(const AmArg& args, AmArg& ret, int a);
 
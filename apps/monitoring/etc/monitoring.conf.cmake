@@ -12,4 +12,26 @@ module "monitoring" {
     # Default: 10
     #
     #garbage_collector_interval = 20
+
+    #buckets=16
+    #
+    # number of locked buckets the calls info is sharded to
+    # Default: 16
+    #
+    #buckets = 64
+
+    #max_records=0
+    #
+    # max calls info entries. the oldest finished entries are evicted
+    # if the limit is reached, active calls are never evicted.
+    # 0 means unlimited
+    # Default: 0
+    #
+    #max_records = 100000
+
+    #indexed_attributes
+    #
+    # attributes to index for listByFilter/getByFilter/eraseByFilter
+    #
+    #indexed_attributes = { "dir", "app" }
 }
@@ -129,9 +129,9 @@ void PGConnection::check_conn()
             close_conn();
             return;
         }
-        PGnotify* notify =  PQnotifies(conn);
-        if(notify) {
+        while(PGnotify* notify = PQnotifies(conn)) {
             //DBG("notification");
+            handler->onNotify(this, notify->relname, notify->extra ? notify->extra : "");
             PQfreemem(notify);
         }
     }
@@ -28,6 +28,7 @@ struct IConnectionHandler
     virtual void onReset(IPGConnection* conn, bool connected) = 0;
     virtual void onPQError(IPGConnection* conn, const string& error) = 0;
     virtual void onStopTransaction(IPGTransaction* trans) = 0;
+    virtual void onNotify(IPGConnection* conn, const string& channel, const string& payload) {}
 };
 
 class IPGConnection
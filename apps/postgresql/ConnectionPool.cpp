@@ -31,6 +31,7 @@ Worker::Worker(const std::string& name, int epollfd)
 , retransmit_next_time(0), wait_next_time(0)
 , reset_next_time(0), send_next_time(0)
 , master(0), slave(0)
+, cache(name)
 , queue_size(stat_group(Gauge, MOD_NAME, "queue").addAtomicCounter().addLabel("worker", name))
 , dropped(stat_group(Counter, MOD_NAME, "dropped").addAtomicCounter().addLabel("worker", name))
 , ret_size(stat_group(Gauge, MOD_NAME, "retransmit").addAtomicCounter().addLabel("worker", name))
@@ -77,6 +78,7 @@ void Worker::getStats(AmArg& ret)
     ret["dropped"] = (long long)dropped.get();
     ret["active"] = (long long)tr_size.get();
     ret["finished"] = (long long)finished.get();
+    cache.getStats(ret["cache"]);
 
     if(master)
         master->getStats(ret);
@@ -135,12 +137,21 @@ void Worker::onConnectionFailed(IPGConnection* conn, const std::string& error) {
 void Worker::onDisconnect(IPGConnection* conn) {
     INFO("pg connection %s:%p/%s disconnect", name.c_str(), conn, conn->getConnInfo().c_str());
     if(master && !master->checkConnection(conn, false) && slave) slave->checkConnection(conn, false); 
+    //invalidation notifications could be lost while disconnected
+    cache.invalidate();
     resetConnections.push_back(conn);
     reset_next_time = resetConnections[0]->getDisconnectedTime();
     //DBG("worker \'%s\' set next reset time: %lu", name.c_str(), reset_next_time);
     setWorkTimer(false);
 }
 
+void Worker::onNotify(IPGConnection* conn, const string& channel, const string& payload)
+{
+    DBG("pg connection %s:%p/%s notification on channel '%s': %s",
+        name.c_str(), conn, conn->getConnInfo().c_str(), channel.c_str(), payload.c_str());
+    cache.invalidate(channel);
+}
+
 void Worker::onSock(IPGConnection* conn, IConnectionHandler::EventType type)
 {
     int ret = 0;
@@ -217,6 +228,8 @@ void Worker::onFinish(IPGTransaction* trans, const AmArg& result) {
                 tr_it->token.data(),
                 AmArg::print(result).c_str());*/
 
+            if(!tr_it->cache_key.empty())
+                cache.put(tr_it->cache_stmt, tr_it->cache_key, result, tr_it->cache_generation);
             if(!tr_it->sender_id.empty())
                 AmEventDispatcher::instance()->post(tr_it->sender_id, new PGResponse(result, tr_it->token));
             finished.inc((long long)tr_it->trans->get_size());
@@ -319,7 +332,9 @@ int Worker::retransmitTransaction(TransContainer& trans)
         string token = trans.token;
         getFreeConnection(&conn, &pool, ERROR_CALLBACK);
         if(!conn) return -1;
-        transactions.emplace_back(trans.trans, pool, sender_id, token);
+        auto &tr = transactions.emplace_back(trans.trans, pool, sender_id, token);
+        tr.cache_stmt = trans.cache_stmt;
+        tr.cache_key = trans.cache_key;
         tr_size.inc((long long)trans.trans->get_size());
         wait_next_time = transactions.front().createdTime + trans_wait_time;
         //DBG("worker \'%s\' set next wait time %lu", name.c_str(), wait_next_time);
@@ -347,7 +362,9 @@ int Worker::retransmitTransaction(TransContainer& trans)
         if(failover_to_slave && slave && !conn)
             return 1;
         else if(failover_to_slave && conn) {
-            transactions.emplace_back(trans.trans, pool, trans.sender_id, token);
+            auto &tr = transactions.emplace_back(trans.trans, pool, trans.sender_id, token);
+            tr.cache_stmt = trans.cache_stmt;
+            tr.cache_key = trans.cache_key;
             tr_size.inc((long long)trans.trans->get_size());
             wait_next_time = transactions.front().createdTime + trans_wait_time;
             //DBG("worker \'%s\' set next wait time %lu", name.c_str(), wait_next_time);
@@ -428,23 +445,29 @@ void Worker::checkQueue()
     if(send_next_time > time(0) && queue.size() < batch_size) return;
 
     IPGTransaction* trans = 0;
-    size_t count = 0;
+    size_t count = 0, merged = 0;
     bool need_send = false;
     for(auto trans_it = queue.begin();
         trans_it != queue.end();) {
         if(!trans) {
             trans = trans_it->trans->clone();
             count += trans_it->trans->get_size();
+            merged++;
         } else if(!trans->merge(trans_it->trans)) {
             need_send = true;
             trans_it--;
         } else {
             count += trans_it->trans->get_size();
+            merged++;
         }
 
         auto next_it = trans_it; next_it++;
         if(count >= batch_size || need_send || next_it == queue.end()) {
             TransContainer tr(trans, (ConnectionPool*)0, trans_it->sender_id, trans_it->token);
+            if(merged == 1) {
+                tr.cache_stmt = trans_it->cache_stmt;
+                tr.cache_key = trans_it->cache_key;
+            }
             int ret = retransmitTransaction(tr);
             if(ret < 0) {
                 delete trans;
@@ -456,6 +479,7 @@ void Worker::checkQueue()
                 queue_size.dec(count);
             }
             count = 0;
+            merged = 0;
             need_send = false;
             trans = 0;
         } else {
@@ -468,7 +492,9 @@ void Worker::checkQueue()
     //DBG("worker \'%s\' set next batch time: %lu", name.c_str(), send_next_time);
 }
 
-void Worker::runTransaction(IPGTransaction* trans, const string& sender_id, const std::string& token)
+void Worker::runTransaction(IPGTransaction* trans, const string& sender_id, const std::string& token,
+                            const string& cache_stmt, const string& cache_key,
+                            unsigned long long cache_generation)
 {
     string sender = sender_id;
     if(batch_size > 1 && !sender.empty()) {
@@ -482,7 +508,12 @@ void Worker::runTransaction(IPGTransaction* trans, const string& sender_id, cons
         delete trans;
         return;
     }
-    queue.emplace_back(trans, (ConnectionPool*)0, sender, token);
+    auto &tr = queue.emplace_back(trans, (ConnectionPool*)0, sender, token);
+    if(!sender.empty()) {
+        tr.cache_stmt = cache_stmt;
+        tr.cache_key = cache_key;
+        tr.cache_generation = cache_generation;
+    }
     queue_size.inc((long long)trans->get_size());
     if(!send_next_time) {
         send_next_time = time(0) + batch_timeout;
@@ -491,10 +522,40 @@ void Worker::runTransaction(IPGTransaction* trans, const string& sender_id, cons
     setWorkTimer(false);
 }
 
+void Worker::runPreparedExec(const PGPrepareExec& e)
+{
+    string cache_key;
+    unsigned long long cache_generation = 0;
+    if(!e.sender_id.empty() && cache.enabled(e.stmt)) {
+        AmArg result;
+        cache_key = PreparedCache::make_key(e.info);
+        if(cache.get(e.stmt, cache_key, result)) {
+            AmEventDispatcher::instance()->post(e.sender_id, new PGResponse(result, e.token));
+            return;
+        }
+        //notifications received while the query runs make its result stale
+        cache_generation = cache.generation(e.stmt);
+    }
+    runTransaction(new PreparedTransaction(e, this), e.sender_id, e.token, e.stmt, cache_key,
+                   cache_generation);
+}
+
 void Worker::runPrepared(const PGPrepareData& prepared)
 {
     prepareds.emplace(prepared.stmt, prepared);
 
+    cache.configure(prepared);
+    for(const auto &channel : prepared.cache_invalidate_channels) {
+        if(!listen_channels.insert(channel).second) continue;
+        string quoted;
+        for(auto c : channel) {
+            if(c == '"') quoted += c;
+            quoted += c;
+        }
+        Query listen("LISTEN \"" + quoted + "\"", false);
+        runInitial(&listen);
+    }
+
     std::unique_ptr<PreparedTransaction> trans;
     if(prepared.sql_types.empty()) {
         trans.reset(new PreparedTransaction(prepared.stmt, prepared.query, prepared.oids, this));
@@ -560,6 +621,8 @@ void Worker::configure(const PGWorkerConfig& e)
     search_pathes.clear();
     init_queries.clear();
     reconnect_errors.clear();
+    cache.reset();
+    listen_channels.clear();
 
     failover_to_slave = e.failover_to_slave;
     retransmit_enable = e.retransmit_enable;
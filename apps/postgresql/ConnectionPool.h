@@ -4,12 +4,14 @@
 #include <string>
 #include <vector>
 #include <list>
+#include <set>
 using std::string;
 using std::vector;
 using std::list;
 #include <PostgreSqlAPI.h>
 #include "Connection.h"
 #include "Transaction.h"
+#include "PreparedCache.h"
 
 class ConnectionPool;
 class Worker;
@@ -43,10 +45,14 @@ class Worker : public ITransactionHandler,
         std::chrono::steady_clock::time_point sendTime;
         string token;
         string sender_id;
+        //prepared statement and key to put result into the cache
+        string cache_stmt;
+        string cache_key;
+        unsigned long long cache_generation;
         TransContainer(IPGTransaction* trans, ConnectionPool* pool,
                        const string& sender, const string& token)
             : trans(trans), currentPool(pool), createdTime(time(0))
-            , token(token), sender_id(sender) {}
+            , token(token), sender_id(sender), cache_generation(0) {}
     };
 
     AtomicCounter& tr_size;
@@ -62,6 +68,8 @@ class Worker : public ITransactionHandler,
     vector<string> search_pathes;         //search pathes for all connections that has connected
     vector< std::unique_ptr<IPGQuery> > init_queries; //queries to run on connect
     vector<string> reconnect_errors;
+    PreparedCache cache;                  //results cache for prepared statements
+    std::set<string> listen_channels;     //cache invalidation channels for all connections
 
     list<TransContainer> retransmit_q;    //queue of retransmit transactions
     list<TransContainer> queue;           //queue of transaction
@@ -88,7 +96,10 @@ public:
     void setSearchPath(const vector<string>& search_path);
     void setReconnectErrors(const vector<string>& errors);
 
-    void runTransaction(IPGTransaction* trans, const string& sender_id, const string& token);
+    void runTransaction(IPGTransaction* trans, const string& sender_id, const string& token,
+                        const string& cache_stmt = string(), const string& cache_key = string(),
+                        unsigned long long cache_generation = 0);
+    void runPreparedExec(const PGPrepareExec& e);
     void configure(const PGWorkerConfig& e);
     void resetPools(PGWorkerPoolCreate::PoolType type);
     void resetPools();
@@ -105,6 +116,7 @@ public:
     void onReset(IPGConnection* conn, bool connected) override;
     void onPQError(IPGConnection* conn, const string& error) override;
     void onStopTransaction(IPGTransaction* trans) override;
+    void onNotify(IPGConnection* conn, const string& channel, const string& payload) override;
 
     //ITransactionHandler
     void onCancel(IPGTransaction* conn) override;
@@ -376,7 +376,7 @@ void PostgreSQL::onPrepareExecute(const PGPrepareExec& e)
 {
     Worker* worker = getWorker(PGQueryData(e.worker_name, e.sender_id, e.token));
     if(worker) {
-        worker->runTransaction(new PreparedTransaction(e, worker), e.sender_id, e.token);
+        worker->runPreparedExec(e);
     }
 }
 
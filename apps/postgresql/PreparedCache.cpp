@@ -0,0 +1,171 @@
+#include "PreparedCache.h"
+#include "PostgreSQL.h"
+
+#include <AmStatistics.h>
+#include <algorithm>
+
+void PreparedCache::StmtCache::erase(unordered_map<string, Entry>::iterator it)
+{
+    lru.erase(it->second.lru_it);
+    entries.erase(it);
+}
+
+void PreparedCache::StmtCache::clear()
+{
+    entries.clear();
+    lru.clear();
+}
+
+PreparedCache::PreparedCache(const string& worker_name)
+  : hits(stat_group(Counter, MOD_NAME, "cache_hits").addAtomicCounter().addLabel("worker", worker_name)),
+    misses(stat_group(Counter, MOD_NAME, "cache_misses").addAtomicCounter().addLabel("worker", worker_name)),
+    last_generation(0)
+{}
+
+void PreparedCache::configure(const PGPrepareData& pdata)
+{
+    if(!pdata.cache_ttl || !pdata.cache_max_entries) {
+        stmts.erase(pdata.stmt);
+        return;
+    }
+
+    auto it = stmts.find(pdata.stmt);
+    if(it != stmts.end()) stmts.erase(it);
+    stmts.emplace(std::piecewise_construct,
+                  std::forward_as_tuple(pdata.stmt),
+                  std::forward_as_tuple(pdata.cache_ttl, pdata.cache_max_entries,
+                                        ++last_generation));
+
+    for(const auto &channel : pdata.cache_invalidate_channels) {
+        auto &subscribed = channels[channel];
+        if(subscribed.end() == std::find(subscribed.begin(), subscribed.end(), pdata.stmt))
+            subscribed.push_back(pdata.stmt);
+    }
+}
+
+void PreparedCache::reset()
+{
+    stmts.clear();
+    channels.clear();
+}
+
+string PreparedCache::make_key(const QueryInfo& info)
+{
+    //single row mode changes the result layout
+    string key(1, info.single ? 's' : 'm');
+    for(const auto &p : info.params) {
+        key += AmArg::print(p);
+        key += '\x1f';
+    }
+    return key;
+}
+
+bool PreparedCache::get(const string& stmt, const string& key, AmArg& result,
+                        const clock::time_point& now)
+{
+    auto sit = stmts.find(stmt);
+    if(sit == stmts.end()) return false;
+    StmtCache &c = sit->second;
+
+    auto it = c.entries.find(key);
+    if(it == c.entries.end()) {
+        c.misses++;
+        misses.inc();
+        return false;
+    }
+
+    if(it->second.expire_at <= now) {
+        c.erase(it);
+        c.misses++;
+        misses.inc();
+        return false;
+    }
+
+    c.lru.splice(c.lru.begin(), c.lru, it->second.lru_it);
+    result = it->second.result;
+    c.hits++;
+    hits.inc();
+    return true;
+}
+
+void PreparedCache::put(const string& stmt, const string& key, const AmArg& result,
+                        const clock::time_point& now)
+{
+    auto sit = stmts.find(stmt);
+    if(sit == stmts.end()) return;
+    StmtCache &c = sit->second;
+
+    auto it = c.entries.find(key);
+    if(it != c.entries.end()) {
+        it->second.result = result;
+        it->second.expire_at = now + c.ttl;
+        c.lru.splice(c.lru.begin(), c.lru, it->second.lru_it);
+        return;
+    }
+
+    while(c.entries.size() >= c.max_entries && !c.lru.empty()) {
+        c.entries.erase(c.lru.back());
+        c.lru.pop_back();
+        c.evictions++;
+    }
+
+    c.lru.push_front(key);
+    Entry &e = c.entries[key];
+    e.result = result;
+    e.expire_at = now + c.ttl;
+    e.lru_it = c.lru.begin();
+}
+
+unsigned long long PreparedCache::generation(const string& stmt) const
+{
+    auto sit = stmts.find(stmt);
+    if(sit == stmts.end()) return 0;
+    return sit->second.generation;
+}
+
+void PreparedCache::put(const string& stmt, const string& key, const AmArg& result,
+                        unsigned long long generation, const clock::time_point& now)
+{
+    auto sit = stmts.find(stmt);
+    if(sit == stmts.end() || sit->second.generation != generation) return;
+    put(stmt, key, result, now);
+}
+
+void PreparedCache::invalidate(const string& channel)
+{
+    auto it = channels.find(channel);
+    if(it == channels.end()) return;
+
+    for(const auto &stmt : it->second) {
+        auto sit = stmts.find(stmt);
+        if(sit == stmts.end()) continue;
+        sit->second.clear();
+        sit->second.invalidations++;
+        sit->second.generation = ++last_generation;
+    }
+}
+
+void PreparedCache::invalidate()
+{
+    for(auto &it : stmts) {
+        it.second.clear();
+        it.second.invalidations++;
+        it.second.generation = ++last_generation;
+    }
+}
+
+void PreparedCache::getStats(AmArg& ret)
+{
+    ret.assertStruct();
+    for(auto &it : stmts) {
+        AmArg &s = ret[it.first];
+        const StmtCache &c = it.second;
+        s["entries"] = (long long)c.entries.size();
+        s["max_entries"] = (long long)c.max_entries;
+        s["ttl"] = (long long)c.ttl.count();
+        s["hits"] = (long long)c.hits;
+        s["misses"] = (long long)c.misses;
+        s["evictions"] = (long long)c.evictions;
+        s["invalidations"] = (long long)c.invalidations;
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <PostgreSqlAPI.h>
+#include <AmArg.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <unordered_map>
+using std::string;
+using std::vector;
+using std::list;
+using std::map;
+using std::unordered_map;
+
+class AtomicCounter;
+
+/* results cache for PGPrepareExec.
+ * entries are grouped by prepared statement and keyed by parameters values.
+ * not thread-safe, must be used from the worker context only */
+class PreparedCache
+{
+  public:
+    typedef std::chrono::steady_clock clock;
+
+  private:
+    struct Entry {
+        AmArg result;
+        clock::time_point expire_at;
+        list<string>::iterator lru_it;
+    };
+
+    struct StmtCache {
+        std::chrono::seconds ttl;
+        size_t max_entries;
+        unordered_map<string, Entry> entries;
+        list<string> lru; //most recently used first
+
+        unsigned long long hits;
+        unsigned long long misses;
+        unsigned long long evictions;
+        unsigned long long invalidations;
+        //changed on every flush to skip results of the queries started before
+        unsigned long long generation;
+
+        StmtCache(uint32_t ttl, uint32_t max_entries, unsigned long long generation)
+          : ttl(ttl), max_entries(max_entries),
+            hits(0), misses(0), evictions(0), invalidations(0),
+            generation(generation)
+        {}
+
+        void erase(unordered_map<string, Entry>::iterator it);
+        void clear();
+    };
+
+    map<string, StmtCache> stmts;
+    map<string, vector<string> > channels; //channel -> stmts
+    unsigned long long last_generation;
+
+    AtomicCounter& hits;
+    AtomicCounter& misses;
+
+  public:
+    PreparedCache(const string& worker_name);
+
+    /* enables cache for the statement if pdata.cache_ttl is set */
+    void configure(const PGPrepareData& pdata);
+    /* drops all statements configuration and cached results */
+    void reset();
+
+    bool enabled(const string& stmt) const {
+        return stmts.find(stmt) != stmts.end();
+    }
+    const map<string, vector<string> >& get_channels() const { return channels; }
+
+    /* parameters values and the single row mode */
+    static string make_key(const QueryInfo& info);
+
+    bool get(const string& stmt, const string& key, AmArg& result,
+             const clock::time_point& now = clock::now());
+    void put(const string& stmt, const string& key, const AmArg& result,
+             const clock::time_point& now = clock::now());
+
+    /* generation of the statement cache to be passed to put()
+     * along with the result of the query started now */
+    unsigned long long generation(const string& stmt) const;
+    /* skips the result if the cache was flushed after generation() call */
+    void put(const string& stmt, const string& key, const AmArg& result,
+             unsigned long long generation,
+             const clock::time_point& now = clock::now());
+
+    /* flush cached results of statements subscribed to the channel */
+    void invalidate(const string& channel);
+    /* flush cached results of all statements */
+    void invalidate();
+
+    void getStats(AmArg& ret);
+};
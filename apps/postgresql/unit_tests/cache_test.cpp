@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include "PGHandler.h"
+#include "../PreparedCache.h"
+
+TEST_F(PostgresqlTest, PreparedCacheTest)
+{
+    PreparedCache cache("cache_test");
+    PGPrepareData pdata("stmt", "SELECT $1::int");
+    pdata.cache_results(10, 2).add_cache_invalidate_channel("changes");
+    cache.configure(pdata);
+    ASSERT_TRUE(cache.enabled("stmt"));
+    ASSERT_FALSE(cache.enabled("other"));
+
+    auto now = PreparedCache::clock::now();
+    string key1 = PreparedCache::make_key(QueryInfo("stmt", false).addParam(1)),
+           key2 = PreparedCache::make_key(QueryInfo("stmt", false).addParam(2)),
+           key3 = PreparedCache::make_key(QueryInfo("stmt", false).addParam("1"));
+    ASSERT_NE(key1, key3);
+
+    AmArg result;
+    ASSERT_FALSE(cache.get("stmt", key1, result, now));
+    cache.put("stmt", key1, AmArg(10), now);
+    ASSERT_TRUE(cache.get("stmt", key1, result, now));
+    ASSERT_TRUE(result == AmArg(10));
+
+    //ttl
+    ASSERT_FALSE(cache.get("stmt", key1, result, now + std::chrono::seconds(11)));
+
+    //lru eviction
+    cache.put("stmt", key1, AmArg(10), now);
+    cache.put("stmt", key2, AmArg(20), now);
+    ASSERT_TRUE(cache.get("stmt", key1, result, now));
+    cache.put("stmt", key3, AmArg(30), now);
+    ASSERT_TRUE(cache.get("stmt", key1, result, now));
+    ASSERT_FALSE(cache.get("stmt", key2, result, now));
+    ASSERT_TRUE(cache.get("stmt", key3, result, now));
+
+    //notification
+    cache.invalidate("unknown");
+    ASSERT_TRUE(cache.get("stmt", key1, result, now));
+    cache.invalidate("changes");
+    ASSERT_FALSE(cache.get("stmt", key1, result, now));
+
+    //notification during the query
+    unsigned long long generation = cache.generation("stmt");
+    cache.invalidate("changes");
+    cache.put("stmt", key1, AmArg(10), generation, now);
+    ASSERT_FALSE(cache.get("stmt", key1, result, now));
+    generation = cache.generation("stmt");
+    cache.put("stmt", key1, AmArg(11), generation, now);
+    ASSERT_TRUE(cache.get("stmt", key1, result, now));
+    ASSERT_TRUE(result == AmArg(11));
+
+    //same query in the single row mode is cached separately
+    string single_key1 = PreparedCache::make_key(QueryInfo("stmt", true).addParam(1));
+    ASSERT_NE(key1, single_key1);
+    ASSERT_FALSE(cache.get("stmt", single_key1, result, now));
+    cache.put("stmt", single_key1, AmArg(12), now);
+    ASSERT_TRUE(cache.get("stmt", single_key1, result, now));
+    ASSERT_TRUE(result == AmArg(12));
+    ASSERT_TRUE(cache.get("stmt", key1, result, now));
+    ASSERT_TRUE(result == AmArg(11));
+
+    AmArg stats;
+    cache.getStats(stats);
+    ASSERT_EQ(stats["stmt"]["evictions"].asLongLong(), 1);
+    ASSERT_EQ(stats["stmt"]["invalidations"].asLongLong(), 2);
+}
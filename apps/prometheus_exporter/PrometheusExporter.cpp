@@ -271,15 +271,17 @@ int PrometheusExporter::configure(const string& config)
 int PrometheusExporter::readAcl(cfg_t* cfg)
 {
     int networks = 0;
+    vector<AmSubnet> nets;
     for(unsigned int j = 0; j < cfg_size(cfg, PARAM_WHITELIST); j++) {
         AmSubnet net;
         std::string host = cfg_getnstr(cfg, PARAM_WHITELIST, j);
         if(!net.parse(host)) {
             return 1;
         }
-        acl.add_network(net);
+        nets.push_back(net);
         networks++;
     }
+    acl.set_networks(nets);
 
     DBG("parsed %d networks",networks);
 
@@ -0,0 +1,64 @@
+#include "RegistrationScheduler.h"
+
+#include <algorithm>
+
+void RegistrationScheduler::schedule(AmSIPRegistration* reg, const RegShaper::timep &now)
+{
+    /* deadlines are the first moments when the corresponding
+     * AmSIPRegistration checks used by checkTimeouts() become true */
+    RegShaper::timep deadline;
+
+    if(reg->postponed) {
+        deadline = reg->postponed_next_attempt;
+    } else if(reg->active) {
+        time_t t = reg->reg_begin + reg->reg_expires + 1;
+        if(!reg->waiting_result)
+            t = std::min<time_t>(t, reg->reg_begin + reg->reg_expires/2 + 1);
+        deadline = std::chrono::system_clock::from_time_t(t);
+    } else if(reg->remove) {
+        deadline = now;
+    } else if(!reg->waiting_result && reg->error_code!=0) {
+        deadline = std::chrono::system_clock::from_time_t(
+            reg->reg_send_begin + reg->getInfo().retry_delay + 1);
+    } else {
+        //waiting for the reply or for the external request
+        unschedule(reg);
+        return;
+    }
+
+    auto it = scheduled.find(reg);
+    if(it != scheduled.end()) {
+        if(it->second->first == deadline)
+            return;
+        deadlines.erase(it->second);
+        it->second = deadlines.emplace(deadline, reg).first;
+    } else {
+        scheduled.emplace(reg, deadlines.emplace(deadline, reg).first);
+    }
+}
+
+void RegistrationScheduler::unschedule(AmSIPRegistration* reg)
+{
+    auto it = scheduled.find(reg);
+    if(it == scheduled.end())
+        return;
+    deadlines.erase(it->second);
+    scheduled.erase(it);
+}
+
+void RegistrationScheduler::takeDue(const RegShaper::timep &now, vector<AmSIPRegistration*> &due)
+{
+    for(auto it = deadlines.begin();
+        it != deadlines.end() && it->first <= now;)
+    {
+        due.push_back(it->second);
+        scheduled.erase(it->second);
+        it = deadlines.erase(it);
+    }
+}
+
+void RegistrationScheduler::clear()
+{
+    deadlines.clear();
+    scheduled.clear();
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "AmSipRegistration.h"
+#include "RegShaper.h"
+
+#include <set>
+#include <unordered_map>
+#include <vector>
+using std::vector;
+
+/* registrations ordered by the time of the next required action
+ * (re-register, expiration, send retry, postponing end, removal).
+ * updated after each processed event or timer action for the registration,
+ * so the timer tick touches due registrations only. not thread-safe */
+class RegistrationScheduler
+{
+    typedef std::set<std::pair<RegShaper::timep, AmSIPRegistration*> > Deadlines;
+    Deadlines deadlines;
+    std::unordered_map<AmSIPRegistration*, Deadlines::iterator> scheduled;
+
+  public:
+    /* (re)schedule the registration according to its state.
+     * registrations waiting for a reply or an external request are unscheduled */
+    void schedule(AmSIPRegistration* reg, const RegShaper::timep &now);
+    void unschedule(AmSIPRegistration* reg);
+
+    /* move registrations with deadline <= now to 'due' */
+    void takeDue(const RegShaper::timep &now, vector<AmSIPRegistration*> &due);
+
+    void clear();
+
+    size_t size() const { return scheduled.size(); }
+    bool empty() const { return deadlines.empty(); }
+    /* the earliest deadline, must not be empty */
+    const RegShaper::timep &next() const { return deadlines.begin()->first; }
+};
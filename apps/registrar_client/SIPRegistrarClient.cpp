@@ -35,8 +35,10 @@
 #define MOD_NAME "registrar_client"
 
 #include <unistd.h>
+#include <algorithm>
 
 #define CFG_OPT_NAME_SHAPER_MIN_INTERVAL "min_interval_per_domain_msec"
+#define CFG_OPT_NAME_SHAPER_BURST "burst_per_domain"
 #define CFG_OPT_NAME_DEFAULT_EXPIRES "default_expires"
 #define CFG_OPT_NAME_EXPORT_METRICS "export_metrics"
 
@@ -48,9 +50,8 @@
 EXPORT_PLUGIN_CLASS_FACTORY(SIPRegistrarClient);
 EXPORT_PLUGIN_CONF_FACTORY(SIPRegistrarClient);
 
-static void reg2arg(const map<string, AmSIPRegistration*>::iterator &it, AmArg &ret, const RegShaper::timep &now) {
+static void reg2arg(const string &handle, AmSIPRegistration *reg, AmArg &ret, const RegShaper::timep &now) {
     AmArg r;
-    AmSIPRegistration *reg = it->second;
     const SIPRegistrationInfo &ri = reg->getInfo();
     AmSIPRegistration::RegistrationState state;
 
@@ -59,7 +60,7 @@ static void reg2arg(const map<string, AmSIPRegistration*>::iterator &it, AmArg &
 
     state = reg->getState();
 
-    r["handle"] = it->first;
+    r["handle"] = handle;
     r["id"] = ri.id;
     r["domain"] = ri.domain;
     r["user"] = ri.user;
@@ -122,6 +123,12 @@ SIPRegistrarClient::SIPRegistrarClient(const string& name)
     AmEventFdQueue(this),
     stopped(false),
     default_expires(DEFAULT_EXPIRES),
+    stat_ticks(stat_group(Counter, MOD_NAME, "ticks").addAtomicCounter()),
+    stat_tick_time_us(stat_group(Counter, MOD_NAME, "tick_time_us").addAtomicCounter()),
+    stat_tick_last_us(stat_group(Gauge, MOD_NAME, "tick_last_us").addAtomicCounter()),
+    stat_tick_processed(stat_group(Counter, MOD_NAME, "tick_processed").addAtomicCounter()),
+    stat_scheduled(stat_group(Gauge, MOD_NAME, "scheduled").addAtomicCounter()),
+    shaper(MOD_NAME),
     uac_auth_i(NULL)
 { }
 
@@ -129,6 +136,7 @@ int SIPRegistrarClient::configure(const std::string& config)
 {
     cfg_opt_t opt[] = {
         CFG_INT(CFG_OPT_NAME_SHAPER_MIN_INTERVAL, 0, CFGF_NODEFAULT),
+        CFG_INT(CFG_OPT_NAME_SHAPER_BURST, 1, CFGF_NONE),
         CFG_INT(CFG_OPT_NAME_DEFAULT_EXPIRES, DEFAULT_EXPIRES, CFGF_NONE),
         CFG_BOOL(CFG_OPT_NAME_EXPORT_METRICS, cfg_false, CFGF_NONE),
         CFG_END()
@@ -158,7 +166,13 @@ int SIPRegistrarClient::configure(const std::string& config)
                      i,(TIMEOUT_CHECKING_INTERVAL/1000));
                 i = TIMEOUT_CHECKING_INTERVAL/1000;
             }
-            shaper.set_min_interval(i);
+            int burst = cfg_getint(cfg, CFG_OPT_NAME_SHAPER_BURST);
+            if(burst < 1) {
+                ERROR("%s must be positive", CFG_OPT_NAME_SHAPER_BURST);
+                cfg_free(cfg);
+                return -1;
+            }
+            shaper.set_rate(1, i, burst);
         }
     }
     default_expires = cfg_getint(cfg, CFG_OPT_NAME_DEFAULT_EXPIRES);
@@ -253,46 +267,57 @@ void SIPRegistrarClient::run()
 
 void SIPRegistrarClient::checkTimeouts()
 {
-    struct timeval now;
-    gettimeofday(&now, NULL);
     RegShaper::timep now_point(std::chrono::system_clock::now());
-    reg_mut.lock();
-    vector<string> remove_regs;
+    time_t now_sec = std::chrono::system_clock::to_time_t(now_point);
+    vector<AmSIPRegistration*> due;
+    vector<AmSIPRegistration*> remove_regs;
 
-    for (map<string, AmSIPRegistration*>::iterator it = registrations.begin();
-        it != registrations.end(); it++)
-    {
-        AmSIPRegistration* reg = it->second;
+    auto tick_start = std::chrono::steady_clock::now();
+
+    AmLock l(reg_mut);
+
+    /* collect due registrations before processing. rescheduled ones
+     * are checked on the next tick even if their new deadline has passed */
+    scheduler.takeDue(now_point, due);
+
+    for(auto reg : due) {
         if (reg->postponed) {
             if(reg->postponingExpired(now_point)) {
                 reg->onPostponeExpired();
             }
         } else if (reg->active) {
-            if (reg->registerExpired(now.tv_sec)) {
+            if (reg->registerExpired(now_sec)) {
                 reg->onRegisterExpired();
             } else if (!reg->waiting_result &&
-                       reg->timeToReregister(now.tv_sec))
+                       reg->timeToReregister(now_sec))
             {
                 reg->doRegistration();
             }
         } else if (reg->remove) {
-            remove_regs.push_back(it->first);
+            remove_regs.push_back(reg);
+            continue;
         } else if (!reg->waiting_result && reg->error_code!=0 &&
-                   reg->registerSendTimeout(now.tv_sec))
+                   reg->registerSendTimeout(now_sec))
         {
             reg->onRegisterSendTimeout();
         }
+        scheduler.schedule(reg, now_point);
     }
 
-    for (vector<string>::iterator it = remove_regs.begin();
-         it != remove_regs.end(); it++)
-    {
-        AmSIPRegistration *reg = remove_reg_unsafe(*it);
+    for(auto reg : remove_regs) {
+        reg = remove_reg_unsafe(reg->getHandle());
         if (reg)
             delete reg;
     }
 
-    reg_mut.unlock();
+    unsigned long long tick_us =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - tick_start).count();
+    stat_ticks.inc();
+    stat_tick_time_us.inc(tick_us);
+    stat_tick_last_us.set(tick_us);
+    stat_tick_processed.inc(due.size());
+    stat_scheduled.set(scheduler.size());
 }
 
 int SIPRegistrarClient::onLoad()
@@ -319,13 +344,18 @@ void SIPRegistrarClient::onServerShutdown()
 {
     // TODO: properly wait until unregistered, with timeout
     DBG("shutdown SIP registrar client: deregistering");
-    for (std::map<std::string, AmSIPRegistration*>::iterator it=
-         registrations.begin(); it != registrations.end(); it++)
+    AmLock l(reg_mut);
+    for (RegHash::iterator it = registrations.begin();
+         it != registrations.end(); it++)
     {
         it->second->doUnregister();
         delete it->second;
         AmEventDispatcher::instance()->delEventQueue(it->first);
     }
+    registrations.clear();
+    registrations_by_id.clear();
+    scheduler.clear();
+    stat_scheduled.set(0);
 }
 
 void SIPRegistrarClient::process(AmEvent* ev) 
@@ -373,6 +403,8 @@ void SIPRegistrarClient::onSipReplyEvent(AmSipReplyEvent* ev)
     AmSIPRegistration* reg = get_reg(ev->reply.from_tag);
     if (reg != NULL) {
         reg->getDlg()->onRxReply(ev->reply);
+        AmLock l(reg_mut);
+        scheduler.schedule(reg, std::chrono::system_clock::now());
     }
 }
 
@@ -418,6 +450,9 @@ void SIPRegistrarClient::onNewRegistration(SIPNewRegistrationEvent* new_reg)
         return;
 
     reg->doRegistration();
+
+    AmLock l(reg_mut);
+    scheduler.schedule(reg, std::chrono::system_clock::now());
 }
 
 void SIPRegistrarClient::onRemoveRegistration(SIPRemoveRegistrationEvent* reg)
@@ -462,6 +497,9 @@ void SIPRegistrarClient::onRemoveRegistration(SIPRemoveRegistrationEvent* reg)
     reg_mut.unlock();
 
     _reg->doUnregister();
+
+    AmLock l(reg_mut);
+    scheduler.schedule(_reg, std::chrono::system_clock::now());
 }
 
 void SIPRegistrarClient::processAmArgRegistration(AmArg &data)
@@ -513,6 +551,7 @@ void SIPRegistrarClient::processAmArgRegistration(AmArg &data)
             reg.second->doUnregister();
         registrations.clear();
         registrations_by_id.clear();
+        scheduler.clear();
     } else {
         ERROR("unknown action '%s'",action.c_str());
     }
@@ -566,8 +605,7 @@ AmSIPRegistration* SIPRegistrarClient::get_reg(const string& reg_id)
     DBG("get registration '%s'", reg_id.c_str());
     AmSIPRegistration* res = NULL;
     reg_mut.lock();
-    map<string, AmSIPRegistration*>::iterator it =
-        registrations.find(reg_id);
+    RegHash::iterator it = registrations.find(reg_id);
     if (it!=registrations.end())
         res = it->second;
     reg_mut.unlock();
@@ -579,8 +617,7 @@ AmSIPRegistration* SIPRegistrarClient::get_reg_unsafe(const string& reg_id)
 {
     //	DBG("get registration_unsafe '%s'", reg_id.c_str());
     AmSIPRegistration* res = NULL;
-    map<string, AmSIPRegistration*>::iterator it =
-        registrations.find(reg_id);
+    RegHash::iterator it = registrations.find(reg_id);
     if (it!=registrations.end())
         res = it->second;
     //     DBG("get registration_unsafe : res = '%ld' (this = %ld)", (long)res, (long)this);
@@ -599,11 +636,11 @@ AmSIPRegistration* SIPRegistrarClient::remove_reg_unsafe(const string& reg_id)
 {
     DBG("removing registration %s", reg_id.c_str());
     AmSIPRegistration* reg = NULL;
-    map<string, AmSIPRegistration*>::iterator it =
-        registrations.find(reg_id);
+    RegHash::iterator it = registrations.find(reg_id);
     if (it!=registrations.end()) {
         reg = it->second;
         registrations.erase(it);
+        scheduler.unschedule(reg);
     }
     AmEventDispatcher::instance()->delEventQueue(reg_id);
     return reg;
@@ -615,10 +652,10 @@ bool SIPRegistrarClient::add_reg(const string& reg_id, AmSIPRegistration* new_re
         reg_id.c_str(), new_reg->getInfo().id.c_str());
     AmSIPRegistration* reg = NULL;
     reg_mut.lock();
-    map<string, AmSIPRegistration*>::iterator it =
-        registrations.find(reg_id);
+    RegHash::iterator it = registrations.find(reg_id);
     if (it!=registrations.end()) {
         reg = it->second;
+        scheduler.unschedule(reg);
     }
 
     std::pair<RegHash::iterator,bool> ret =
@@ -741,10 +778,10 @@ void SIPRegistrarClient::listRegistrations(AmArg& res)
     res.assertArray();
     reg_mut.lock();
     RegShaper::timep now(std::chrono::system_clock::now());
-    for (map<string, AmSIPRegistration*>::iterator it =
-         registrations.begin(); it != registrations.end(); it++)
+    for (RegHash::iterator it = registrations.begin();
+         it != registrations.end(); it++)
     {
-        reg2arg(it,res,now);
+        reg2arg(it->first,it->second,res,now);
     }
     reg_mut.unlock();
 }
@@ -752,10 +789,10 @@ void SIPRegistrarClient::listRegistrations(AmArg& res)
 void SIPRegistrarClient::showRegistration(const string& handle, AmArg &ret)
 {
     AmLock l(reg_mut);
-    map<string, AmSIPRegistration*>::iterator it = registrations.find(handle);
+    RegHash::iterator it = registrations.find(handle);
     ret.assertArray();
     if(it!=registrations.end())
-        reg2arg(it,ret,std::chrono::system_clock::now());
+        reg2arg(it->first,it->second,ret,std::chrono::system_clock::now());
 }
 
 void SIPRegistrarClient::showRegistrationById(const string& id, AmArg &ret)
@@ -764,7 +801,7 @@ void SIPRegistrarClient::showRegistrationById(const string& id, AmArg &ret)
     RegHash::iterator it = registrations_by_id.find(id);
     ret.assertArray();
     if(it!=registrations_by_id.end())
-        reg2arg(it,ret,std::chrono::system_clock::now());
+        reg2arg(it->first,it->second,ret,std::chrono::system_clock::now());
 }
 
 void SIPRegistrarClient::getRegistrationsCount(AmArg& res)
@@ -774,6 +811,23 @@ void SIPRegistrarClient::getRegistrationsCount(AmArg& res)
     reg_mut.unlock();
 }
 
+void SIPRegistrarClient::getTimerStats(AmArg& res)
+{
+    reg_mut.lock();
+    res["scheduled"] = (long long)scheduler.size();
+    if(!scheduler.empty()) {
+        res["next_deadline_msec"] = (long long)
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                scheduler.next() - std::chrono::system_clock::now()).count();
+    }
+    reg_mut.unlock();
+
+    res["ticks"] = (long long)stat_ticks.get();
+    res["tick_time_us"] = (long long)stat_tick_time_us.get();
+    res["tick_last_us"] = (long long)stat_tick_last_us.get();
+    res["tick_processed"] = (long long)stat_tick_processed.get();
+}
+
 void SIPRegistrarClient::invoke(
     const string& method,
     const AmArg& args,
@@ -917,6 +971,8 @@ void SIPRegistrarClient::invoke(
         showRegistrationById(args.get(0).asCStr(),ret);
     } else if(method == "getRegistrationsCount") {
         getRegistrationsCount(ret);
+    } else if(method == "getTimerStats") {
+        getTimerStats(ret);
     } else if(method == "_list") {
         ret.push(AmArg("createRegistration"));
         ret.push(AmArg("removeRegistration"));
@@ -926,6 +982,7 @@ void SIPRegistrarClient::invoke(
         ret.push(AmArg("showRegistration"));
         ret.push(AmArg("showRegistrationById"));
         ret.push(AmArg("getRegistrationsCount"));
+        ret.push(AmArg("getTimerStats"));
     }  else
         throw AmDynInvoke::NotImplemented(method);
 }
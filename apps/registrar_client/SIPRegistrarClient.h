@@ -32,10 +32,14 @@
 #include "AmApi.h"
 #include "ampi/BusAPI.h"
 #include "RegShaper.h"
+#include "RegistrationScheduler.h"
+#include "AmStatistics.h"
 
 #include <sys/time.h>
 
 #include <map>
+#include <set>
+#include <unordered_map>
 #include <string>
 using std::map;
 using std::string;
@@ -62,12 +66,21 @@ class SIPRegistrarClient
     // registrations container
     AmMutex reg_mut;
 
-    typedef std::map<std::string, AmSIPRegistration*> RegHash;
+    typedef std::unordered_map<std::string, AmSIPRegistration*> RegHash;
     typedef std::pair<std::string, AmSIPRegistration*> RegHashPair;
 
     RegHash registrations;
     RegHash registrations_by_id;
 
+    // protected by reg_mut
+    RegistrationScheduler scheduler;
+
+    AtomicCounter &stat_ticks;
+    AtomicCounter &stat_tick_time_us;
+    AtomicCounter &stat_tick_last_us;
+    AtomicCounter &stat_tick_processed;
+    AtomicCounter &stat_scheduled;
+
     RegShaper shaper;
     int default_expires;
 
@@ -86,6 +99,7 @@ class SIPRegistrarClient
     void showRegistration(const string& handle, AmArg &ret);
     void showRegistrationById(const string& id, AmArg &ret);
     void getRegistrationsCount(AmArg& res);
+    void getTimerStats(AmArg& res);
 
     static SIPRegistrarClient* _instance;
 
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include "../RegistrationScheduler.h"
+#include "sip/parse_via.h"
+
+class RegistrationSchedulerTest : public ::testing::Test
+{
+  protected:
+    RegShaper shaper;
+    SIPRegistrationInfo info;
+    RegShaper::timep now;
+    time_t now_sec;
+
+    RegistrationSchedulerTest()
+      : shaper("scheduler_test")
+    {
+        info.domain = "example.com";
+        info.user = "user";
+        info.transport_protocol_id = sip_transport::UDP;
+        info.retry_delay = 5;
+        now_sec = time(0);
+        now = std::chrono::system_clock::from_time_t(now_sec);
+    }
+
+    RegShaper::timep at(time_t sec) {
+        return std::chrono::system_clock::from_time_t(sec);
+    }
+};
+
+TEST_F(RegistrationSchedulerTest, Scheduling)
+{
+    RegistrationScheduler scheduler;
+    AmSIPRegistration reg("reg", info, "", shaper);
+    vector<AmSIPRegistration*> due;
+
+    //nothing to do for the new registration until it is sent
+    scheduler.schedule(&reg, now);
+    ASSERT_EQ(scheduler.size(), 0);
+    ASSERT_TRUE(scheduler.empty());
+
+    //re-register at half of expires
+    reg.active = true;
+    reg.reg_begin = now_sec;
+    reg.reg_expires = 60;
+    scheduler.schedule(&reg, now);
+    ASSERT_EQ(scheduler.size(), 1);
+    ASSERT_TRUE(scheduler.next() == at(now_sec + 31));
+
+    //expiration while waiting for the reply
+    reg.waiting_result = true;
+    scheduler.schedule(&reg, now);
+    ASSERT_EQ(scheduler.size(), 1);
+    ASSERT_TRUE(scheduler.next() == at(now_sec + 61));
+
+    //send retry after the error
+    reg.active = false;
+    reg.waiting_result = false;
+    reg.error_code = 408;
+    reg.reg_send_begin = now_sec;
+    scheduler.schedule(&reg, now);
+    ASSERT_EQ(scheduler.size(), 1);
+    ASSERT_TRUE(scheduler.next() == at(now_sec + 6));
+
+    //postponing end
+    reg.postponed = true;
+    reg.postponed_next_attempt = now + std::chrono::milliseconds(1500);
+    scheduler.schedule(&reg, now);
+    ASSERT_EQ(scheduler.size(), 1);
+    ASSERT_TRUE(scheduler.next() == reg.postponed_next_attempt);
+
+    //removal is due immediately
+    reg.postponed = false;
+    reg.remove = true;
+    scheduler.schedule(&reg, now);
+    ASSERT_TRUE(scheduler.next() == now);
+
+    //waiting for the reply
+    reg.remove = false;
+    reg.error_code = 0;
+    reg.waiting_result = true;
+    scheduler.schedule(&reg, now);
+    ASSERT_EQ(scheduler.size(), 0);
+    scheduler.takeDue(now + std::chrono::hours(1), due);
+    ASSERT_TRUE(due.empty());
+}
+
+TEST_F(RegistrationSchedulerTest, Expiry)
+{
+    RegistrationScheduler scheduler;
+    AmSIPRegistration reg1("reg1", info, "", shaper),
+                      reg2("reg2", info, "", shaper),
+                      reg3("reg3", info, "", shaper);
+    vector<AmSIPRegistration*> due;
+
+    reg1.active = reg2.active = true;
+    reg1.reg_begin = reg2.reg_begin = now_sec;
+    reg1.reg_expires = 60;
+    reg2.reg_expires = 120;
+    reg3.remove = true;
+    scheduler.schedule(&reg1, now);
+    scheduler.schedule(&reg2, now);
+    scheduler.schedule(&reg3, now);
+    ASSERT_EQ(scheduler.size(), 3);
+
+    scheduler.takeDue(now, due);
+    ASSERT_EQ(due.size(), 1);
+    ASSERT_EQ(due[0], &reg3);
+    ASSERT_EQ(scheduler.size(), 2);
+
+    due.clear();
+    scheduler.takeDue(at(now_sec + 30), due);
+    ASSERT_TRUE(due.empty());
+    ASSERT_TRUE(scheduler.next() == at(now_sec + 31));
+
+    //rescheduled entries are kept until their new deadline
+    reg1.reg_begin = now_sec + 10;
+    scheduler.schedule(&reg1, now);
+    ASSERT_EQ(scheduler.size(), 2);
+    scheduler.takeDue(at(now_sec + 31), due);
+    ASSERT_TRUE(due.empty());
+
+    scheduler.takeDue(at(now_sec + 61), due);
+    ASSERT_EQ(due.size(), 2);
+    ASSERT_EQ(due[0], &reg1);
+    ASSERT_EQ(due[1], &reg2);
+    ASSERT_EQ(scheduler.size(), 0);
+
+    scheduler.schedule(&reg1, now);
+    scheduler.schedule(&reg2, now);
+    scheduler.unschedule(&reg1);
+    ASSERT_EQ(scheduler.size(), 1);
+    scheduler.clear();
+    ASSERT_EQ(scheduler.size(), 0);
+    ASSERT_TRUE(scheduler.empty());
+}
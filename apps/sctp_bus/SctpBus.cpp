@@ -36,6 +36,7 @@ SctpBus::SctpBus(const string& name)
     AmEventFdQueue(this),
     reader(MOD_NAME),
     epoll_fd(-1),
+    binary_payload(true),
     stopped(false)
 {}
 
@@ -102,6 +103,7 @@ int SctpBus::configure()
         default_port = cfg_getint(neighbours_cfg,opt_name_default_port);
         reconnect_interval = cfg_getint(neighbours_cfg,opt_name_reconnect_interval);
         default_address = cfg_getstr(neighbours_cfg,opt_name_default_address);
+        binary_payload = cfg_getbool(neighbours_cfg,opt_name_binary_payload);
 
         if(0!=server_connection.init(epoll_fd,addr)) {
             ERROR("failed to init sctp server connection");
@@ -403,6 +405,18 @@ void SctpBus::onReloadEvent()
     }
 }
 
+void SctpBus::onPeerPayloadFormat(int node_id, bool binary)
+{
+    if(binary && !binary_payload)
+        return;
+
+    auto it = connections_by_id.find(node_id);
+    if(it == connections_by_id.end())
+        return;
+
+    it->second->set_binary_payload(binary);
+}
+
 int SctpBus::addClientConnection(
     unsigned int id,
     const sockaddr_storage &a,
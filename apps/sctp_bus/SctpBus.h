@@ -40,6 +40,7 @@ class SctpBus
     AmCondition<bool> stopped;
 
     int epoll_fd;
+    bool binary_payload;
 
   protected:
     void init_rpc_tree();
@@ -70,6 +71,9 @@ class SctpBus
     void onConnectionRemove(const SctpBusRemoveConnection &e);
     void onReloadEvent();
 
+    /** update payload format of the connection to the node by the received PDU */
+    void onPeerPayloadFormat(int node_id, bool binary);
+
     //client connections management
     int addClientConnection(unsigned int id,
                             const sockaddr_storage &a,
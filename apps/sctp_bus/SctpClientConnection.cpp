@@ -7,6 +7,7 @@
 #include <netinet/sctp.h>
 
 #include "jsonArg.h"
+#include "binArg.h"
 #include "AmUtils.h"
 
 #include "SctpBusPDU.pb.h"
@@ -35,6 +36,8 @@ int SctpClientConnection::connect()
 
     close();
     events_sent = 0;
+    //peer could be replaced by the older version
+    binary_payload = false;
 
     if((fd = socket(addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK, IPPROTO_SCTP )) == -1)
         sctp_sys_err("socket()");
@@ -208,9 +211,14 @@ void SctpClientConnection::send(const SctpBusSendEvent &e)
     r.set_dst_node_id(_id);
     r.set_dst_session_id(e.dst_session_id);
 
-    //!TODO: implement direct serialization AmArg -> protobuf
-    r.set_payload(arg2json(e.data));
-    //r.set_json_data(arg2json(e.data));
+    if(binary_payload) {
+        r.set_payload_format(SctpBusPDU::BINARY);
+        arg2bin(e.data, *r.mutable_payload());
+    } else {
+        //also tells the peer that we are able to decode binary payload
+        r.set_payload_format(SctpBusPDU::JSON);
+        r.set_payload(arg2json(e.data));
+    }
 
     if(!r.SerializePartialToArray(payload,sizeof(payload))){
         ERROR("event serialization failed");
@@ -326,6 +334,16 @@ void SctpClientConnection::send(const SctpBusRawReply &e)
     events_sent++;
 }
 
+void SctpClientConnection::set_binary_payload(bool binary)
+{
+    if(binary == binary_payload)
+        return;
+
+    INFO("switch events payload for peer %d to %s",
+         _id, binary ? "binary" : "json");
+    binary_payload = binary;
+}
+
 int SctpClientConnection::on_timer(time_t now)
 {
     /*DBG("client on timer. state = %d, last connect: %s",
@@ -402,5 +420,6 @@ void SctpClientConnection::getInfo(AmArg &info)
     info["remote_host"] = am_inet_ntop(&addr);
     info["remote_port"] = am_get_port(&addr);
     info["state"] = status_str[state];
+    info["payload_format"] = binary_payload ? "binary" : "json";
 }
 
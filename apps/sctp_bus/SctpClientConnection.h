@@ -12,13 +12,15 @@ class SctpClientConnection
     int reconnect_interval;
     unsigned long events_sent;
     AmDynInvoke *json_rpc;
+    bool binary_payload;
 
   public:
 
     SctpClientConnection()
       : events_sent(0),
         assoc_id(-1),
-        json_rpc(nullptr)
+        json_rpc(nullptr),
+        binary_payload(false)
     {}
 
     int init(int efd, const sockaddr_storage &a, int reconnect_seconds,
@@ -34,6 +36,8 @@ class SctpClientConnection
     void send(const SctpBusRawRequest &e) override;
     void send(const SctpBusRawReply &e) override;
 
+    void set_binary_payload(bool binary) override;
+
     void onIncomingPDU(const SctpBusPDU &e);
 
     void getInfo(AmArg &info);
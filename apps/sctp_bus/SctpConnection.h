@@ -75,6 +75,9 @@ class SctpConnection {
     virtual void send(const SctpBusRawRequest &e) { }
     virtual void send(const SctpBusRawReply &e) { }
 
+    /** peer is able to decode binary event payload */
+    virtual void set_binary_payload(bool) { }
+
     virtual void getInfo(AmArg &info) = 0;
 };
 
@@ -1,4 +1,5 @@
 #include "SctpServerConnection.h"
+#include "SctpBus.h"
 #include "SctpBusPDU.pb.h"
 
 #include "sip/ip_util.h"
@@ -13,6 +14,7 @@
 
 #include "AmUtils.h"
 #include "jsonArg.h"
+#include "binArg.h"
 #include "AmSessionContainer.h"
 
 int SctpServerConnection::init(int efd, const sockaddr_storage &a)
@@ -230,8 +232,16 @@ int SctpServerConnection::process(uint32_t events)
         WARN("node_id is 0 (default value). this may cause not intended behavior");
     }
 
+    SctpBus::instance()->onPeerPayloadFormat(r.src_node_id(), r.has_payload_format());
+
     SctpBusEvent *ev = new SctpBusEvent(r.src_node_id(), r.src_session_id());
-    if(!json2arg(r.payload(),ev->data)){
+    if(r.payload_format() == SctpBusPDU::BINARY) {
+        if(!bin2arg(r.payload(),ev->data)){
+            ERROR("failed deserialize binary payload");
+            delete ev;
+            return -1;
+        }
+    } else if(!json2arg(r.payload(),ev->data)){
         ERROR("failed deserialize json payload");
         delete ev;
         return -1;
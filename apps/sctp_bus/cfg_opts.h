@@ -16,6 +16,7 @@ char section_name_neighbours[] = "neighbours";
 char opt_name_default_port[] = "port";
 char opt_name_default_address[] = "address";
 char opt_name_reconnect_interval[] = "reconnect_interval";
+char opt_name_binary_payload[] = "binary_payload";
 char section_name_node[] = "node";
 
 static cfg_opt_t listen_opts[] = {
@@ -33,6 +34,7 @@ static cfg_opt_t node_opts[] = {
 static cfg_opt_t neighbours_opts[] = {
     CFG_INT(opt_name_default_port,SCTP_BUS_DEFAULT_PORT,CFGF_NONE),
     CFG_INT(opt_name_reconnect_interval,SCTP_BUS_DEFAULT_RECONNECT_INTERVAL,CFGF_NONE),
+    CFG_BOOL(opt_name_binary_payload,cfg_true,CFGF_NONE),
     CFG_STR(opt_name_default_address,NULL,CFGF_NONE),
     CFG_SEC(section_name_node,node_opts, CFGF_MULTI | CFGF_TITLE),
     CFG_END()
@@ -5,7 +5,18 @@ set (SRTP_SRC_DIR ${PROJECT_SOURCE_DIR}/${SRTP_DIR})
 set (SRTP_BIN_DIR ${PROJECT_BINARY_DIR}/${SRTP_DIR})
 set (SRTP_BUNDLED_LIB ${SRTP_BIN_DIR}/libsrtp2.a)
 
-set(SRTP_CONFIG_ARGS --disable-openssl --enable-debug-logging CPPFLAGS='-fPIC -fcommon')
+# OpenSSL crypto uses AES-NI/PCLMUL when the CPU has them
+# and is required for the AEAD_AES_128_GCM/AEAD_AES_256_GCM profiles
+OPTION(SEMS_SRTP_OPENSSL "Build bundled libsrtp with OpenSSL crypto" ON)
+
+IF(SEMS_SRTP_OPENSSL)
+    FIND_PACKAGE(OpenSSL REQUIRED)
+    MESSAGE(STATUS "libsrtp crypto: OpenSSL ${OPENSSL_VERSION}")
+    set(SRTP_CONFIG_ARGS --enable-openssl --enable-debug-logging CPPFLAGS='-fPIC -fcommon')
+ELSE(SEMS_SRTP_OPENSSL)
+    MESSAGE(STATUS "libsrtp crypto: builtin (no AEAD-GCM profiles)")
+    set(SRTP_CONFIG_ARGS --disable-openssl --enable-debug-logging CPPFLAGS='-fPIC -fcommon')
+ENDIF(SEMS_SRTP_OPENSSL)
 
 add_custom_target(libsrtp ALL DEPENDS ${SRTP_BUNDLED_LIB})
 
@@ -23,6 +34,9 @@ set(SRTP_BUNDLED_INCLUDE_DIRS ${SRTP_BIN_DIR}/include/)
 add_library(SRTP_bundled STATIC IMPORTED)
 set_property(TARGET SRTP_bundled PROPERTY IMPORTED_LOCATION ${SRTP_BUNDLED_LIB})
 set(SRTP_BUNDLED_LIBS ${SRTP_BUNDLED_LIB})
+IF(SEMS_SRTP_OPENSSL)
+    list(APPEND SRTP_BUNDLED_LIBS ${OPENSSL_CRYPTO_LIBRARY})
+ENDIF(SEMS_SRTP_OPENSSL)
 list(APPEND sems_dependency_targets libsrtp)
 
 install(DIRECTORY ${SRTP_BIN_DIR}/include/ DESTINATION /usr/include/sems/srtp FILES_MATCHING PATTERN "*.h")
@@ -29,9 +29,9 @@ int  Am100rel::onRequestIn(const AmSipRequest& req)
         switch(uas_state) {
         case REL100_SUPPORTED: /* if support is on, enforce if asked by UAC */
         case REL100_SUPPORTED_NOT_ANNOUNCED:
-            if (key_in_list(getHeader(req.hdrs, SIP_HDR_SUPPORTED, SIP_HDR_SUPPORTED_COMPACT),
+            if (key_in_list(req.getHeader(SIP_HDR_SUPPORTED, SIP_HDR_SUPPORTED_COMPACT),
                             SIP_EXT_100REL) ||
-               key_in_list(getHeader(req.hdrs, SIP_HDR_REQUIRE),
+               key_in_list(req.getHeader(SIP_HDR_REQUIRE),
                            SIP_EXT_100REL))
             {
                 uas_state = REL100_REQUIRE;
@@ -39,9 +39,9 @@ int  Am100rel::onRequestIn(const AmSipRequest& req)
             }
             break;
         case REL100_REQUIRE: /* if support is required, reject if UAC doesn't */
-            if (!(key_in_list(getHeader(req.hdrs,SIP_HDR_SUPPORTED, SIP_HDR_SUPPORTED_COMPACT),
+            if (!(key_in_list(req.getHeader(SIP_HDR_SUPPORTED, SIP_HDR_SUPPORTED_COMPACT),
                               SIP_EXT_100REL) ||
-                key_in_list(getHeader(req.hdrs, SIP_HDR_REQUIRE),
+                key_in_list(req.getHeader(SIP_HDR_REQUIRE),
                             SIP_EXT_100REL)))
             {
                 ERROR("'" SIP_EXT_100REL "' extension required, but not advertised"
@@ -56,7 +56,7 @@ int  Am100rel::onRequestIn(const AmSipRequest& req)
             break; // 100rel required
         case REL100_DISABLED:
             // TODO: shouldn't this be part of a more general check in SEMS?
-            if (key_in_list(getHeader(req.hdrs,SIP_HDR_REQUIRE),SIP_EXT_100REL)) {
+            if (key_in_list(req.getHeader(SIP_HDR_REQUIRE),SIP_EXT_100REL)) {
                 AmBasicSipDialog::reply_error(
                     req, 420, SIP_REPLY_BAD_EXTENSION,
                     SIP_HDR_COLSP(SIP_HDR_UNSUPPORTED) SIP_EXT_100REL CRLF,
@@ -111,7 +111,7 @@ int  Am100rel::onReplyIn(const AmSipReply& reply)
         switch(uac_state) {
         case REL100_SUPPORTED:
         case REL100_SUPPORTED_NOT_ANNOUNCED:
-            if (key_in_list(getHeader(reply.hdrs, SIP_HDR_REQUIRE),
+            if (key_in_list(reply.getHeader(SIP_HDR_REQUIRE),
                             SIP_EXT_100REL))
             {
                 uac_state = REL100_REQUIRE;
@@ -120,7 +120,7 @@ int  Am100rel::onReplyIn(const AmSipReply& reply)
             else
                 break;
         case REL100_REQUIRE:
-            if (!key_in_list(getHeader(reply.hdrs,SIP_HDR_REQUIRE),SIP_EXT_100REL) ||
+            if (!key_in_list(reply.getHeader(SIP_HDR_REQUIRE),SIP_EXT_100REL) ||
                 !reply.rseq)
             {
                 ERROR(SIP_EXT_100REL " not supported or no positive RSeq value in "
@@ -173,11 +173,11 @@ void Am100rel::onRequestOut(AmSipRequest& req)
     case REL100_SUPPORTED_NOT_ANNOUNCED:
         return;
     case REL100_SUPPORTED:
-        if (! key_in_list(getHeader(req.hdrs, SIP_HDR_REQUIRE), SIP_EXT_100REL))
+        if (! key_in_list(req.getHeader(SIP_HDR_REQUIRE), SIP_EXT_100REL))
             req.hdrs += SIP_HDR_COLSP(SIP_HDR_SUPPORTED) SIP_EXT_100REL CRLF;
         break;
     case REL100_REQUIRE:
-        if (! key_in_list(getHeader(req.hdrs, SIP_HDR_REQUIRE), SIP_EXT_100REL))
+        if (! key_in_list(req.getHeader(SIP_HDR_REQUIRE), SIP_EXT_100REL))
             req.hdrs += SIP_HDR_COLSP(SIP_HDR_REQUIRE) SIP_EXT_100REL CRLF;
         break;
     default:
@@ -198,15 +198,15 @@ void Am100rel::onReplyOut(AmSipReply& reply)
         if (100 < reply.code && reply.code < 200) {
             switch(uas_state) {
             case REL100_SUPPORTED:
-                if (! key_in_list(getHeader(reply.hdrs, SIP_HDR_REQUIRE),SIP_EXT_100REL))
+                if (! key_in_list(reply.getHeader(SIP_HDR_REQUIRE),SIP_EXT_100REL))
                     reply.hdrs += SIP_HDR_COLSP(SIP_HDR_SUPPORTED) SIP_EXT_100REL CRLF;
                 break;
             case REL100_REQUIRE:
                 // add Require HF
-                if (! key_in_list(getHeader(reply.hdrs, SIP_HDR_REQUIRE),SIP_EXT_100REL))
+                if (! key_in_list(reply.getHeader(SIP_HDR_REQUIRE),SIP_EXT_100REL))
                     reply.hdrs += SIP_HDR_COLSP(SIP_HDR_REQUIRE) SIP_EXT_100REL CRLF;
                 // add RSeq HF
-                if (getHeader(reply.hdrs, SIP_HDR_RSEQ).length())
+                if (reply.getHeader(SIP_HDR_RSEQ).length())
                     // already added (by app?)
                     break;
                 if (! rseq) { // only init rseq if 1xx is used
@@ -34,18 +34,19 @@ using std::map;
 
 class app_timer : public timer 
 {
-    string q_id;
+    std::shared_ptr<_AmAppTimer::TimerQueue> q;
     int timer_id;
 
   public:
-    app_timer(const string& q_id, int timer_id, unsigned int expires)
-      : timer(expires), q_id(q_id), timer_id(timer_id)
+    app_timer(const std::shared_ptr<_AmAppTimer::TimerQueue>& q,
+              int timer_id, unsigned int expires)
+      : timer(expires), q(q), timer_id(timer_id)
     {}
 
     ~app_timer() {}
 
     int get_id() { return timer_id; }
-    string get_q_id() { return q_id; }
+    _AmAppTimer::TimerQueue& get_q() { return *q; }
 
     // timer interface
     void fire() {
@@ -60,62 +61,58 @@ _AmAppTimer::_AmAppTimer()
 _AmAppTimer::~_AmAppTimer() {
 }
 
+_AmAppTimer::Shard& _AmAppTimer::get_shard(const string& q_id, unsigned int& shard_idx)
+{
+    shard_idx = std::hash<string>()(q_id) & (APP_TIMER_SHARDS - 1);
+    return shards[shard_idx];
+}
+
 void _AmAppTimer::app_timer_cb(app_timer* at)
 {
-    user_timers_mut.lock();
-    app_timer* at_local = erase_timer(at->get_q_id(), at->get_id());
-
-    if (NULL != at_local) {
-        if (at_local != at) {
-            DBG("timer was reset while expiring - not firing timer");
-            // we'd better re-insert at_local into user_timers
-            // what happens else, when at_local get fired ???
-            user_timers[at->get_q_id()][at->get_id()] = at_local;
-        } else {
-            DBG("timer fired: %d for '%s'", at->get_id(), at->get_q_id().c_str());
-            AmSessionContainer::instance()->postEvent(
-                at->get_q_id(), new AmTimeoutEvent(at->get_id()));
-            delete at;
-        }
-    } else {
-        DBG("timer %d for '%s' already removed",
-            at->get_id(), at->get_q_id().c_str());
+    TimerQueue& q = at->get_q();
+    Shard& shard = shards[q.shard];
+
+    shard.mut.lock();
+    AppTimers::iterator t_it = q.timers.find(at->get_id());
+    if (t_it == q.timers.end() || t_it->second != at) {
+        // removed, or reset while expiring - then the new one stays in the queue
+        DBG("timer %d for '%s' already removed or reset",
+            at->get_id(), q.name.c_str());
         // will be deleted by wheeltimer
+        shard.mut.unlock();
+        return;
+    }
+
+    q.timers.erase(t_it);
+    if (q.timers.empty()) {
+        TimerQueues::iterator it = shard.queues.find(q.name);
+        if (it != shard.queues.end() && it->second.get() == &q)
+            shard.queues.erase(it);
     }
+    shard.mut.unlock();
 
-    user_timers_mut.unlock();
+    DBG("timer fired: %d for '%s'", at->get_id(), q.name.c_str());
+    AmSessionContainer::instance()->postEvent(
+        q.name, new AmTimeoutEvent(at->get_id()));
+    delete at;
 }
 
-app_timer* _AmAppTimer::erase_timer(const string& q_id, int id)
+app_timer* _AmAppTimer::erase_timer(Shard& shard, TimerQueues::iterator it, int id)
 {
     app_timer* res = NULL;
 
-    map<string, map<int, app_timer*> >::iterator it=user_timers.find(q_id);
-    if (it != user_timers.end()) {
-        map<int, app_timer*>::iterator t_it = it->second.find(id);
-        if (t_it != it->second.end()) {
-            res = t_it->second;
-            it->second.erase(t_it);
-            if (it->second.empty())
-                user_timers.erase(it);
-        }
+    AppTimers& timers = it->second->timers;
+    AppTimers::iterator t_it = timers.find(id);
+    if (t_it != timers.end()) {
+        res = t_it->second;
+        timers.erase(t_it);
+        if (timers.empty())
+            shard.queues.erase(it);
     }
 
     return res;
 }
 
-app_timer* _AmAppTimer::create_timer(const string& q_id, int id,
-                                     unsigned int expires)
-{
-    app_timer* timer = new app_timer(q_id, id, expires);
-    if (!timer)
-        return NULL;
-
-    user_timers[q_id][id] = timer;
-
-    return timer;
-}
-
 #define MAX_TIMER_SECONDS 365*24*3600 // one year, well below 1<<31
 
 void _AmAppTimer::setTimer(const string& eventqueue_name, int timer_id, double timeout)
@@ -134,40 +131,63 @@ void _AmAppTimer::setTimer(const string& eventqueue_name, int timer_id, double t
 
     expires += wall_clock;
 
-    user_timers_mut.lock();
-    app_timer* t = erase_timer(eventqueue_name, timer_id);
-    if (NULL != t) {
-        remove_timer(t);
-    }
-    t = create_timer(eventqueue_name, timer_id, expires);
-    if (NULL != t) {
-        insert_timer(t);
+    unsigned int shard_idx;
+    Shard& shard = get_shard(eventqueue_name, shard_idx);
+
+    shard.mut.lock();
+    std::shared_ptr<TimerQueue>& q = shard.queues[eventqueue_name];
+    if (!q)
+        q = std::make_shared<TimerQueue>(eventqueue_name, shard_idx);
+
+    app_timer* t = new app_timer(q, timer_id, expires);
+    app_timer*& slot = q->timers[timer_id];
+    app_timer* old = slot;
+    slot = t;
+    // insertion must be requested before the timer can be removed by others
+    insert_timer(t);
+    shard.mut.unlock();
+
+    if (NULL != old) {
+        remove_timer(old);
     }
-    user_timers_mut.unlock();
 }
 
 void _AmAppTimer::removeTimer(const string& eventqueue_name, int timer_id)
 {
-    user_timers_mut.lock();
-    app_timer* t = erase_timer(eventqueue_name, timer_id);
+    app_timer* t = NULL;
+    unsigned int shard_idx;
+    Shard& shard = get_shard(eventqueue_name, shard_idx);
+
+    shard.mut.lock();
+    TimerQueues::iterator it = shard.queues.find(eventqueue_name);
+    if (it != shard.queues.end())
+        t = erase_timer(shard, it, timer_id);
+    shard.mut.unlock();
+
     if (NULL != t) {
         remove_timer(t);
     }
-    user_timers_mut.unlock();
 }
 
 void _AmAppTimer::removeTimers(const string& eventqueue_name)
 {
-    user_timers_mut.lock();
-    TimerQueues::iterator it=user_timers.find(eventqueue_name);
-    if (it != user_timers.end()) {
-        for (AppTimers::iterator t_it = it->second.begin();
-             t_it != it->second.end(); t_it++)
-        {
-            if (NULL != t_it->second)
-                remove_timer(t_it->second);
-        }
-        user_timers.erase(it);
+    AppTimers timers;
+    unsigned int shard_idx;
+    Shard& shard = get_shard(eventqueue_name, shard_idx);
+
+    // detach the queue timers, removal is requested out of the lock
+    shard.mut.lock();
+    TimerQueues::iterator it = shard.queues.find(eventqueue_name);
+    if (it != shard.queues.end()) {
+        timers.swap(it->second->timers);
+        shard.queues.erase(it);
+    }
+    shard.mut.unlock();
+
+    for (AppTimers::iterator t_it = timers.begin();
+         t_it != timers.end(); t_it++)
+    {
+        if (NULL != t_it->second)
+            remove_timer(t_it->second);
     }
-    user_timers_mut.unlock();
 }
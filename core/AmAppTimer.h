@@ -36,24 +36,45 @@ using std::string;
 
 #include <map>
 #include <set>
+#include <memory>
+#include <unordered_map>
 
 #define TICKS_PER_SEC (1000000 / TIMER_RESOLUTION)
 
+/** user timers storage shards count. must be a power of two */
+#define APP_TIMER_SHARDS 64
+
 class app_timer;
 
 class _AmAppTimer
   : public _wheeltimer
 {
-    typedef std::map<int, app_timer*>   AppTimers;
-    typedef std::map<string, AppTimers> TimerQueues;
+    typedef std::unordered_map<int, app_timer*> AppTimers;
+
+    /** timers of the event queue. shared by the queue timers,
+        so the fired timer finds its queue without the name lookup */
+    struct TimerQueue {
+        const string name;
+        const unsigned int shard;
+        AppTimers timers;
+
+        TimerQueue(const string& name, unsigned int shard)
+          : name(name), shard(shard)
+        {}
+    };
+    typedef std::unordered_map<string, std::shared_ptr<TimerQueue> > TimerQueues;
+
+    /** event queues are spread over the shards by the name hash */
+    struct Shard {
+        AmMutex mut;
+        TimerQueues queues;
+    } shards[APP_TIMER_SHARDS];
 
-    AmMutex user_timers_mut;
-    TimerQueues user_timers;
+    Shard& get_shard(const string& q_id, unsigned int& shard_idx);
 
-    /** creates timer object and inserts it into our container */
-    app_timer* create_timer(const string& q_id, int id, unsigned int expires);
-    /** erases timer - does not delete timer object @return timer object pointer, if found */
-    app_timer* erase_timer(const string& q_id, int id);
+    /** erases timer from the queue - does not delete timer object
+        @return timer object pointer, if found */
+    app_timer* erase_timer(Shard& shard, TimerQueues::iterator it, int id);
 
     /* callback used by app_timer */
     void app_timer_cb(app_timer* at);
@@ -89,8 +89,9 @@ AmArg& AmArg::operator=(const AmArg& v) {
     case Bool:   { v_bool = v.v_bool; } break;
     case Double: { v_double = v.v_double; } break;
     case CStr:   {
-        v_cstr = strdup(v.v_cstr);
-        INC_AMARGSIZE(strlen(v.v_cstr));
+        size_t len = strlen(v.asCStr());
+        setCStr(v.asCStr(), len);
+        INC_AMARGSIZE(len);
     } break;
     case AObject:{ v_obj = v.v_obj; } break;
     case ADynInv:{ v_inv = v.v_inv; } break;
@@ -209,8 +210,8 @@ void AmArg::assertStruct() const {
 
 void AmArg::invalidate() {
   if(type == CStr) {
-      DEC_AMARGSIZE(strlen(v_cstr));
-      free((void*)v_cstr); 
+      DEC_AMARGSIZE(strlen(asCStr()));
+      freeCStr();
   }
   else if(type == Array) { delete v_array; }
   else if(type == Struct) {
@@ -389,7 +390,7 @@ bool operator==(const AmArg& lhs, const AmArg& rhs) {
   case AmArg::LongLong: { return lhs.v_long == rhs.v_long; } break;
   case AmArg::Bool:   { return lhs.v_bool == rhs.v_bool; } break;
   case AmArg::Double: { return lhs.v_double == rhs.v_double; } break;
-  case AmArg::CStr:   { return !strcmp(lhs.v_cstr,rhs.v_cstr); } break;
+  case AmArg::CStr:   { return !strcmp(lhs.asCStr(),rhs.asCStr()); } break;
   case AmArg::AObject:{ return lhs.v_obj == rhs.v_obj; } break;
   case AmArg::ADynInv:{ return lhs.v_inv == rhs.v_inv; } break;
   case AmArg::Array:  { return lhs.v_array == rhs.v_array;  } break;
@@ -486,7 +487,7 @@ size_t AmArg::getAllocatedSize()
     size_t size = sizeof(*this);
     switch(type) {
     case CStr:
-        size += strlen(v_cstr);
+        size += strlen(asCStr());
       break;
     case Blob:
         size += v_blob->len + sizeof(*v_blob);
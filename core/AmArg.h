@@ -42,6 +42,12 @@ using std::string;
 #include "log.h"
 #include "AmStatistics.h"
 
+#ifdef USE_AMARG_COMPACT
+#include "AmArgStruct.h"
+/** strings shorter than this are stored inside AmArg */
+#define AMARG_SSO_SIZE 8
+#endif
+
 #ifdef USE_AMARG_STATISTICS
     extern AtomicCounter& amargsize;
     #define INC_AMARGSIZE(s) amargsize.inc(s)
@@ -126,7 +132,11 @@ class AmArg
   };
   
   typedef std::vector<AmArg> ValueArray;
+#ifdef USE_AMARG_COMPACT
+  typedef AmArgStructT<AmArg> ValueStruct;
+#else
   typedef std::map<std::string, AmArg> ValueStruct; 
+#endif
 
   struct ValueRef
     : public atomic_ref_cnt
@@ -153,6 +163,10 @@ class AmArg
 private:
   // type
   short type;
+#ifdef USE_AMARG_COMPACT
+  // CStr value is stored in v_sso
+  bool v_inline = false;
+#endif
   // value
   union {
     long int       v_int;
@@ -166,10 +180,40 @@ private:
     ValueArray*    v_array;
     ValueStruct*   v_struct;
     ValueRef*      v_ref;
+#ifdef USE_AMARG_COMPACT
+    char           v_sso[AMARG_SSO_SIZE];
+#endif
   };
 
   void invalidate();
 
+  void setCStr(const char* v, size_t len) {
+#ifdef USE_AMARG_COMPACT
+    if(len < AMARG_SSO_SIZE) {
+      memcpy(v_sso, v, len + 1);
+      v_inline = true;
+      return;
+    }
+    char* s = static_cast<char*>(malloc(len + 1));
+    if(!s) throw std::bad_alloc();
+    memcpy(s, v, len + 1);
+    v_cstr = s;
+    v_inline = false;
+#else
+    (void)len;
+    v_cstr = strdup(v);
+#endif
+  }
+
+  void freeCStr() {
+#ifdef USE_AMARG_COMPACT
+    if(!v_inline) free((void*)v_cstr);
+    v_inline = false;
+#else
+    free((void*)v_cstr);
+#endif
+  }
+
  public:
 
  AmArg() 
@@ -216,15 +260,17 @@ private:
  AmArg(const char* v)
    : type(CStr)
   {
-    INC_AMARGSIZE(sizeof(*this) + strlen(v));
-    v_cstr = strdup(v);
+    size_t len = strlen(v);
+    INC_AMARGSIZE(sizeof(*this) + len);
+    setCStr(v, len);
   }
   
  AmArg(const string &v)
    : type(CStr)
   {
-    INC_AMARGSIZE(sizeof(*this) + strlen(v.c_str()));
-    v_cstr = strdup(v.c_str());
+    size_t len = strlen(v.c_str());
+    INC_AMARGSIZE(sizeof(*this) + len);
+    setCStr(v.c_str(), len);
   }
   
  AmArg(const ArgBlob v)
@@ -340,7 +386,11 @@ private:
   long long   asLongLong() const { return v_long; }
   bool        asBool()   const { return v_bool; }
   double      asDouble() const { return v_double; }
+#ifdef USE_AMARG_COMPACT
+  const char* asCStr()   const { return v_inline ? v_sso : v_cstr; }
+#else
   const char* asCStr()   const { return v_cstr; }
+#endif
   AmObject*  asObject() const { return v_obj; }
   AmDynInvoke* asDynInv() const { return v_inv; }
   ArgBlob*    asBlob()   const { return v_blob; }
@@ -0,0 +1,352 @@
+#pragma once
+
+#include <string.h>
+#include <stdlib.h>
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <new>
+
+/**
+ * std::map<std::string, V> replacement for the compact AmArg mode.
+ *
+ * entries are stored in slabs which are never relocated, so references
+ * to the values stay valid until the entry is erased (as for std::map).
+ * lookup is a binary search over the flat index of entries sorted by key
+ * in std::map order. slabs and index grow together, so the struct of
+ * N members needs O(log N) allocations instead of N tree nodes.
+ *
+ * iterators point to the entries, not to the index positions,
+ * so as with std::map they stay valid on insertion and on erasure
+ * of the other entries and erase(it++) is safe. iterator keeps
+ * the index position hint and falls back to the key lookup
+ * if the index was shifted under it.
+ *
+ * insertion moves the tail of the index, so it is intended for the
+ * typical small structs with tens of members.
+ */
+template<typename V>
+class AmArgStructT
+{
+  public:
+    typedef std::string key_type;
+    typedef V mapped_type;
+    typedef std::pair<const std::string, V> value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    template<typename T>
+    class iterator_base
+    {
+        template<typename> friend class iterator_base;
+        friend class AmArgStructT;
+
+        typedef typename AmArgStructT::value_type entry_type;
+
+        const AmArgStructT *s;
+        //nullptr for end()
+        entry_type *e;
+        mutable size_t hint;
+
+        iterator_base(const AmArgStructT *s, size_t pos)
+          : s(s),
+            e(pos < s->index.size() ? s->index[pos] : nullptr),
+            hint(pos)
+        {}
+
+        size_t pos() const
+        {
+            if(!e) return s->index.size();
+            if(hint >= s->index.size() || s->index[hint] != e)
+                hint = s->lower_bound_pos(e->first.data(), e->first.size());
+            return hint;
+        }
+
+        void set(size_t p)
+        {
+            hint = p;
+            e = p < s->index.size() ? s->index[p] : nullptr;
+        }
+
+      public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        iterator_base()
+          : s(nullptr),
+            e(nullptr),
+            hint(0)
+        {}
+
+        //iterator to const_iterator conversion
+        iterator_base(const iterator_base<entry_type> &it)
+          : s(it.s),
+            e(it.e),
+            hint(it.hint)
+        {}
+        iterator_base &operator=(const iterator_base &) = default;
+
+        T &operator*() const { return *e; }
+        T *operator->() const { return e; }
+
+        iterator_base &operator++() { set(pos() + 1); return *this; }
+        iterator_base operator++(int) { iterator_base r(*this); ++*this; return r; }
+        iterator_base &operator--() { set(pos() - 1); return *this; }
+        iterator_base operator--(int) { iterator_base r(*this); --*this; return r; }
+
+        template<typename U>
+        bool operator==(const iterator_base<U> &it) const { return e == it.e; }
+        template<typename U>
+        bool operator!=(const iterator_base<U> &it) const { return e != it.e; }
+    };
+
+    typedef iterator_base<value_type> iterator;
+    typedef iterator_base<const value_type> const_iterator;
+
+  private:
+    struct Slab {
+        Slab *next;
+        unsigned int capacity;
+        unsigned int used;
+
+        value_type *entry(unsigned int i) {
+            return reinterpret_cast<value_type *>(this + 1) + i;
+        }
+    };
+
+    //first slab size. next ones are doubled up to the MAX
+    static const unsigned int SLAB_MIN_ENTRIES = 4;
+    static const unsigned int SLAB_MAX_ENTRIES = 256;
+
+    typedef std::vector<value_type *> Index;
+
+    Index index;
+    Slab *slabs;
+    //erased entries slots for reuse. slot memory keeps the next pointer
+    void *free_slots;
+
+    static int compare(const std::string &key, const char *k, size_t len)
+    {
+        size_t klen = key.size();
+        int r = memcmp(key.data(), k, klen < len ? klen : len);
+        if(r) return r;
+        return klen < len ? -1 : (klen > len ? 1 : 0);
+    }
+
+    /** first index position with key not less than k */
+    size_t lower_bound_pos(const char *k, size_t len) const
+    {
+        size_t lo = 0, hi = index.size();
+        //fast path for the sorted input
+        if(hi && compare(index[hi - 1]->first, k, len) < 0)
+            return hi;
+        while(lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if(compare(index[mid]->first, k, len) < 0) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+    size_t find_pos(const char *k, size_t len) const
+    {
+        size_t pos = lower_bound_pos(k, len);
+        if(pos != index.size() && !compare(index[pos]->first, k, len))
+            return pos;
+        return index.size();
+    }
+
+    void *alloc_slot(size_t reserve)
+    {
+        if(free_slots) {
+            void *slot = free_slots;
+            free_slots = *static_cast<void **>(slot);
+            return slot;
+        }
+
+        if(!slabs || slabs->used == slabs->capacity) {
+            unsigned int capacity = slabs ? slabs->capacity * 2 : SLAB_MIN_ENTRIES;
+            if(capacity > SLAB_MAX_ENTRIES) capacity = SLAB_MAX_ENTRIES;
+            if(reserve > capacity) capacity = reserve;
+
+            Slab *s = static_cast<Slab *>(
+                malloc(sizeof(Slab) + capacity * sizeof(value_type)));
+            if(!s) throw std::bad_alloc();
+            s->next = slabs;
+            s->capacity = capacity;
+            s->used = 0;
+            slabs = s;
+
+            index.reserve(index.size() + capacity);
+        }
+
+        return slabs->entry(slabs->used++);
+    }
+
+    void free_slot(void *slot)
+    {
+        *static_cast<void **>(slot) = free_slots;
+        free_slots = slot;
+    }
+
+    /* index capacity is reserved for all slab slots on the slab allocation,
+     * so the index insertion does not throw */
+    value_type *insert_at(size_t pos, const char *k, size_t len, const V &v)
+    {
+        void *slot = alloc_slot(1);
+        value_type *e;
+        try {
+            e = new (slot) value_type(std::piecewise_construct,
+                                      std::forward_as_tuple(k, len),
+                                      std::forward_as_tuple(v));
+        } catch(...) {
+            free_slot(slot);
+            throw;
+        }
+        index.insert(index.begin() + pos, e);
+        return e;
+    }
+
+    size_t erase_key(const char *k, size_t len)
+    {
+        size_t pos = find_pos(k, len);
+        if(pos == index.size()) return 0;
+        erase(const_iterator(this, pos));
+        return 1;
+    }
+
+    void copy_from(const AmArgStructT &s)
+    {
+        for(const auto &e : s.index) {
+            void *slot = alloc_slot(s.index.size());
+            index.push_back(new (slot) value_type(*e));
+        }
+    }
+
+  public:
+    AmArgStructT()
+      : slabs(nullptr),
+        free_slots(nullptr)
+    {}
+
+    AmArgStructT(const AmArgStructT &s)
+      : slabs(nullptr),
+        free_slots(nullptr)
+    {
+        try {
+            copy_from(s);
+        } catch(...) {
+            clear();
+            throw;
+        }
+    }
+
+    AmArgStructT &operator=(const AmArgStructT &s)
+    {
+        if(this != &s) {
+            AmArgStructT tmp(s);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    ~AmArgStructT() { clear(); }
+
+    void swap(AmArgStructT &s)
+    {
+        index.swap(s.index);
+        std::swap(slabs, s.slabs);
+        std::swap(free_slots, s.free_slots);
+    }
+
+    void clear()
+    {
+        for(auto &e : index)
+            e->~value_type();
+        index.clear();
+        while(slabs) {
+            Slab *next = slabs->next;
+            free(slabs);
+            slabs = next;
+        }
+        free_slots = nullptr;
+    }
+
+    size_t size() const { return index.size(); }
+    bool empty() const { return index.empty(); }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, index.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, index.size()); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    iterator find(const std::string &key) {
+        return iterator(this, find_pos(key.data(), key.size()));
+    }
+    iterator find(const char *key) {
+        return iterator(this, find_pos(key, strlen(key)));
+    }
+    const_iterator find(const std::string &key) const {
+        return const_iterator(this, find_pos(key.data(), key.size()));
+    }
+    const_iterator find(const char *key) const {
+        return const_iterator(this, find_pos(key, strlen(key)));
+    }
+
+    size_t count(const std::string &key) const {
+        return find_pos(key.data(), key.size()) != index.size();
+    }
+
+    std::pair<iterator, bool> insert(const value_type &v)
+    {
+        const std::string &k = v.first;
+        size_t pos = lower_bound_pos(k.data(), k.size());
+        if(pos != index.size() && !compare(index[pos]->first, k.data(), k.size()))
+            return std::make_pair(iterator(this, pos), false);
+        insert_at(pos, k.data(), k.size(), v.second);
+        return std::make_pair(iterator(this, pos), true);
+    }
+
+    std::pair<iterator, bool> emplace(const std::string &k, const V &v)
+    {
+        return insert(value_type(k, v));
+    }
+
+    V &operator[](const char *k)
+    {
+        size_t len = strlen(k);
+        size_t pos = lower_bound_pos(k, len);
+        if(pos != index.size() && !compare(index[pos]->first, k, len))
+            return index[pos]->second;
+        return insert_at(pos, k, len, V())->second;
+    }
+
+    V &operator[](const std::string &k)
+    {
+        size_t pos = lower_bound_pos(k.data(), k.size());
+        if(pos != index.size() && !compare(index[pos]->first, k.data(), k.size()))
+            return index[pos]->second;
+        return insert_at(pos, k.data(), k.size(), V())->second;
+    }
+
+    /** returns iterator to the entry following the erased one */
+    iterator erase(const_iterator it)
+    {
+        size_t pos = it.pos();
+        value_type *e = index[pos];
+        index.erase(index.begin() + pos);
+        e->~value_type();
+        free_slot(e);
+        return iterator(this, pos);
+    }
+
+    size_t erase(const std::string &key) { return erase_key(key.data(), key.size()); }
+    size_t erase(const char *key) { return erase_key(key, strlen(key)); }
+};
@@ -610,20 +610,94 @@ int AmAudio::incRecordTime(unsigned int samples)
 }
 
 
+AmAudioScratch::AmAudioScratch()
+  : top(0),
+    depth(0),
+    last_owner(0)
+{}
+
+AmAudioScratch& AmAudioScratch::thread()
+{
+  static thread_local AmAudioScratch scratch;
+  return scratch;
+}
+
+AmAudioScratch::Scope::Scope()
+{
+  AmAudioScratch& s = thread();
+  top = s.top;
+  s.depth++;
+}
+
+AmAudioScratch::Scope::~Scope()
+{
+  AmAudioScratch& s = thread();
+  for(size_t i = top; i < s.top; i++)
+    s.owners[i] = 0;
+  s.top = top;
+  s.depth--;
+}
+
+bool AmAudioScratch::inScope()
+{
+  return thread().depth != 0;
+}
+
+unsigned char* AmAudioScratch::acquire(size_t& frame, unsigned long long& owner)
+{
+  AmAudioScratch& s = thread();
+  if(s.top == s.frames.size()) {
+    s.frames.emplace_back(new unsigned char[AUDIO_BUFFER_SIZE * 2]);
+    s.owners.push_back(0);
+  }
+
+  frame = s.top++;
+  owner = ++s.last_owner;
+  s.owners[frame] = owner;
+  return s.frames[frame].get();
+}
+
+bool AmAudioScratch::owns(size_t frame, unsigned long long owner)
+{
+  AmAudioScratch& s = thread();
+  return frame < s.top && s.owners[frame] == owner;
+}
+
+size_t AmAudioScratch::getAllocated()
+{
+  return thread().frames.size() * AUDIO_BUFFER_SIZE * 2;
+}
+
 DblBuffer::DblBuffer()
-  : active_buf(0)
-{ 
-  memset(samples, 0, AUDIO_BUFFER_SIZE * 2);
+  : samples(NULL),
+    frame(0),
+    owner(0),
+    active_buf(0)
+{}
+
+unsigned char* DblBuffer::buffers()
+{
+  if(AmAudioScratch::inScope()) {
+    if(!samples || !AmAudioScratch::owns(frame, owner))
+      samples = AmAudioScratch::acquire(frame, owner);
+    return samples;
+  }
+
+  if(!own_samples) {
+    own_samples.reset(new unsigned char[AUDIO_BUFFER_SIZE * 2]);
+    memset(own_samples.get(), 0, AUDIO_BUFFER_SIZE * 2);
+  }
+  return own_samples.get();
 }
 
 DblBuffer::operator unsigned char*()
 {
-  return samples + (active_buf ? AUDIO_BUFFER_SIZE : 0);
+  return buffers() + (active_buf ? AUDIO_BUFFER_SIZE : 0);
 }
 
 unsigned char* DblBuffer::back_buffer()
 {
-  return samples + (active_buf ? 0 : AUDIO_BUFFER_SIZE);
+  return buffers() + (active_buf ? 0 : AUDIO_BUFFER_SIZE);
 }
 
 void DblBuffer::swap()
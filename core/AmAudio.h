@@ -42,6 +42,7 @@ using std::unique_ptr;
 #include <string>
 using std::string;
 #include <map>
+#include <vector>
 
 #ifdef USE_LIBSAMPLERATE
 #include <samplerate.h>
@@ -99,18 +100,64 @@ public:
 };
 
 
+/**
+ * \brief scratch space of the audio processing thread
+ *
+ * DblBuffer takes its memory from here while a scope is open
+ * in the calling thread. frames taken within a scope are returned
+ * when it is closed, so their content is only valid within it.
+ * AmMediaProcessorThread opens a scope for every session it processes.
+ */
+class AmAudioScratch
+{
+  std::vector<std::unique_ptr<unsigned char[]>> frames;
+  /** owner stamp of the frames, 0 for free ones */
+  std::vector<unsigned long long> owners;
+  size_t top;
+  unsigned int depth;
+  unsigned long long last_owner;
+
+  AmAudioScratch();
+
+  static AmAudioScratch& thread();
+
+public:
+  class Scope {
+    size_t top;
+  public:
+    Scope();
+    ~Scope();
+  };
+
+  /** @return true if a scope is open in the calling thread */
+  static bool inScope();
+  /** take a frame of AUDIO_BUFFER_SIZE * 2 bytes */
+  static unsigned char* acquire(size_t& frame, unsigned long long& owner);
+  /** @return true if the frame is still taken by owner */
+  static bool owns(size_t frame, unsigned long long owner);
+  /** bytes allocated for the frames of the calling thread */
+  static size_t getAllocated();
+};
+
 /**
  * \brief double buffer with back and front
  * Implements double buffering.
+ * the memory is taken from AmAudioScratch if a scope is open,
+ * otherwise a buffer of its own is allocated on first use.
  */
-
 class DblBuffer
 {
   /** Buffer. */
-  unsigned char samples[AUDIO_BUFFER_SIZE * 2];
+  unsigned char* samples;
+  size_t frame;
+  unsigned long long owner;
+  /** used out of AmAudioScratch scopes */
+  std::unique_ptr<unsigned char[]> own_samples;
   /** 0 for first buffer, 1 for the second. */
   int active_buf;
 
+  unsigned char* buffers();
+
 public:
   /** Constructs a double buffer. */
   DblBuffer();
@@ -120,6 +167,8 @@ public:
   unsigned char* back_buffer();
   /** swaps front and back buffer. */
   void swap();
+  /** bytes allocated by the buffer itself */
+  size_t getAllocated() const { return own_samples ? AUDIO_BUFFER_SIZE * 2 : 0; }
 };
 
 class AmAudio;
@@ -153,6 +202,9 @@ public:
   virtual amci_codec_t* getCodec();
   void resetCodec();
 
+  /** return the codec id */
+  int getCodecId() const { return codec_id; }
+
   /** return the sampling rate */
   unsigned int getRate() { return rate; }
 
@@ -385,6 +437,15 @@ public:
   virtual int get(unsigned long long system_ts, unsigned char* buffer, 
 		  int output_sample_rate, unsigned int nb_samples);
 
+  /**
+   * Get the next frame already encoded with the stream format
+   * (e.g. pre-encoded prompts). Called instead of get().
+   * @return # bytes, 0 if not available (get() is used then),
+   *         else -1 if error or -2 at the end as get()
+   */
+  virtual int getEncoded(unsigned long long system_ts, AmAudioFormat& rtp_fmt,
+			 unsigned char* buffer) { return 0; }
+
   /** 
    * Put some samples to the output stream.
    * @warning For packet based payloads / file formats, use:
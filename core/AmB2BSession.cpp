@@ -454,7 +454,7 @@ void AmB2BSession::onSipRequest(const AmSipRequest& req)
 
     if(r_ev->req.method == SIP_METH_NOTIFY) {
 
-      string event = getHeader(r_ev->req.hdrs,SIP_HDR_EVENT,true);
+      string event = r_ev->req.getHeader(SIP_HDR_EVENT,true);
       string id = get_header_param(event,"id");
       event = strip_header_params(event);
 
@@ -466,7 +466,7 @@ void AmB2BSession::onSipRequest(const AmSipRequest& req)
 	  unsigned int mapped_id=0;
 	  if(getMappedReferID(id_int,mapped_id)) {
 
-	    removeHeader(r_ev->req.hdrs,SIP_HDR_EVENT);
+	    removeHeader(r_ev->req.hdrs.modify(),SIP_HDR_EVENT);
 	    r_ev->req.hdrs += SIP_HDR_COLSP(SIP_HDR_EVENT) "refer;id=" 
 	      + int2str(mapped_id) + CRLF;
 	  }
@@ -913,7 +913,7 @@ int AmB2BSession::relaySip(const AmSipRequest& req)
   if (req.method != "ACK") {
     relayed_req[dlg->cseq] = req;
 
-    const string* hdrs = &req.hdrs;
+    const string* hdrs = &req.hdrs.str();
     string m_hdrs;
 
     // translate RAck for PRACK
@@ -986,7 +986,7 @@ int AmB2BSession::relaySip(const AmSipRequest& req)
 
 int AmB2BSession::relaySip(const AmSipRequest& orig, const AmSipReply& reply)
 {
-  const string* hdrs = &reply.hdrs;
+  const string* hdrs = &reply.hdrs.str();
   string m_hdrs;
   const string method(orig.method);
 
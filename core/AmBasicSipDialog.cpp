@@ -498,7 +498,7 @@ void AmBasicSipDialog::onRxRequest(const AmSipRequest& req)
       }
     }
 
-    string ua = getHeader(req.hdrs,"User-Agent");
+    string ua = req.getHeader("User-Agent");
     setRemoteUA(ua);
   }
 
@@ -674,7 +674,7 @@ void AmBasicSipDialog::updateDialogTarget(const AmSipReply& reply)
       setNextHop(nh);
     }
 
-    string ua = getHeader(reply.hdrs,"Server");
+    string ua = reply.getHeader("Server");
     setRemoteUA(ua);
   }
 }
@@ -788,7 +788,7 @@ int AmBasicSipDialog::reply(const AmSipRequest& req,
     return -1;
   }
 
-  inplaceHeadersErase(reply.hdrs,hdrs2remove);
+  inplaceHeadersErase(reply.hdrs.modify(),hdrs2remove);
   AmLcConfig::instance().addSignatureHdr(reply);
 
   if ((code > 100 && code < 300) && !(flags & SIP_FLAGS_NOCONTACT)) {
@@ -826,7 +826,7 @@ int AmBasicSipDialog::reply_error(const AmSipRequest& req, unsigned int code,
   reply.hdrs = hdrs;
   reply.to_tag = AmSession::getNewId();
 
-  inplaceHeadersErase(reply.hdrs,hdrs2remove);
+  inplaceHeadersErase(reply.hdrs.modify(),hdrs2remove);
   AmLcConfig::instance().addSignatureHdr(reply);
 
   // add transcoder statistics into reply headers
@@ -890,7 +890,7 @@ int AmBasicSipDialog::sendRequest(const string& method,
     req.contact = getContactHdr();
   }
 
-  inplaceHeadersErase(req.hdrs,hdrs2remove);
+  inplaceHeadersErase(req.hdrs.modify(),hdrs2remove);
   AmLcConfig::instance().addSignatureHdr(req);
 
   int send_flags = 0;
@@ -101,14 +101,6 @@ int AmFileCache::read(void* buf,
   return r_size;
 }
 
-inline size_t AmFileCache::getSize() {
-  return data_size;
-}
-
-inline const string& AmFileCache::getFilename() {
-  return name;
-}
-
 
 AmCachedAudioFile::AmCachedAudioFile(AmFileCache* cache) 
   : cache(cache), loop(false), fpos(0), begin(0), good(false)
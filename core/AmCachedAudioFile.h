@@ -51,11 +51,11 @@ class AmFileCache
    */
   int load(const std::string& filename);
   /** get the size of the file */
-  size_t getSize();
+  size_t getSize() { return data_size; }
   /** read size bytes from pos into buf */
   int read(void* buf, size_t* pos, size_t size);
   /** get the filename */
-  const string& getFilename();
+  const string& getFilename() { return name; }
   /** get a pointer to the file's data - use with caution! */
   void* getData() { return data; }
 };
@@ -69,11 +69,14 @@ class AmFileCache
 class AmCachedAudioFile 
 : public AmAudio
 {
+ protected:
   AmFileCache* cache;
   /** current position */
   size_t fpos;
   /** beginning of data in file */
   size_t begin; 
+
+ private:
   bool good;
 
   /** @see AmAudio::read */
@@ -98,7 +101,7 @@ class AmCachedAudioFile
   /**
    * Rewind the file.
    */
-  void rewind();
+  virtual void rewind();
 
   /** Closes the file. */
   void close();
@@ -0,0 +1,361 @@
+/*
+ * This file is part of SEMS, a free SIP media server.
+ *
+ * SEMS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * For a license to use the sems software under conditions
+ * other than those described here, or to purchase support for this
+ * software, please contact iptel.org by e-mail at the following addresses:
+ *    info@iptel.org
+ *
+ * SEMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "AmCpuPlacement.h"
+#include "AmLcConfig.h"
+#include "AmUtils.h"
+#include "log.h"
+
+#include <sched.h>
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <fstream>
+#include <map>
+
+static const char *cpu_role_names[CPU_ROLE_MAX] = {
+    "media", "rtp", "session", "sip"
+};
+
+const char *cpu_role_name(CpuThreadRole role)
+{
+    if(role < 0 || role >= CPU_ROLE_MAX) return "unknown";
+    return cpu_role_names[role];
+}
+
+bool parse_cpu_list(const std::string &s, std::vector<int> &cpus)
+{
+    cpus.clear();
+
+    const char *p = s.c_str();
+    while(*p) {
+        while(*p == ' ' || *p == '\n') p++;
+        if(!*p) break;
+
+        char *end;
+        long first = strtol(p, &end, 10);
+        if(end == p || first < 0) return false;
+        long last = first;
+        p = end;
+
+        if(*p == '-') {
+            p++;
+            last = strtol(p, &end, 10);
+            if(end == p || last < first) return false;
+            p = end;
+        }
+
+        if(last >= CPU_SETSIZE) return false;
+        for(long i = first; i <= last; i++)
+            cpus.push_back(static_cast<int>(i));
+
+        while(*p == ' ' || *p == '\n') p++;
+        if(*p == ',') p++;
+        else if(*p) return false;
+    }
+
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return true;
+}
+
+std::string cpu_list2str(const std::vector<int> &cpus)
+{
+    std::string ret;
+    for(size_t i = 0; i < cpus.size(); ) {
+        size_t j = i;
+        while(j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1)
+            j++;
+
+        if(!ret.empty()) ret += ',';
+        ret += int2str(cpus[i]);
+        if(j != i) {
+            ret += '-';
+            ret += int2str(cpus[j]);
+        }
+        i = j + 1;
+    }
+    return ret;
+}
+
+CpuPlacementConfig::CpuPlacementConfig()
+  : policy(PLACEMENT_NONE),
+    role_threads{},
+    media_realtime(false),
+    media_realtime_priority(CPU_DEFAULT_RT_PRIORITY)
+{}
+
+const char *CpuPlacementConfig::policy2str(Policy policy)
+{
+    switch(policy) {
+    case PLACEMENT_NONE: return "none";
+    case PLACEMENT_ROLE: return "role";
+    case PLACEMENT_SPREAD: return "spread";
+    case PLACEMENT_NUMA: return "numa";
+    }
+    return "unknown";
+}
+
+bool CpuPlacementConfig::str2policy(const std::string &s, Policy &policy)
+{
+    if(s == "none") policy = PLACEMENT_NONE;
+    else if(s == "role") policy = PLACEMENT_ROLE;
+    else if(s == "spread") policy = PLACEMENT_SPREAD;
+    else if(s == "numa") policy = PLACEMENT_NUMA;
+    else return false;
+    return true;
+}
+
+static bool read_sysfs(const std::string &path, std::string &value)
+{
+    std::ifstream f(path);
+    if(!f.is_open()) return false;
+    std::getline(f, value);
+    return !f.fail();
+}
+
+static int read_sysfs_int(const std::string &path, int default_value)
+{
+    std::string value;
+    int ret;
+    if(!read_sysfs(path, value) || !str2int(value, ret))
+        return default_value;
+    return ret;
+}
+
+bool CpuTopology::load(const std::string &sysfs_root)
+{
+    std::string value;
+    std::vector<int> ids;
+
+    cpus.clear();
+
+    if(!read_sysfs(sysfs_root + "/cpu/online", value) ||
+       !parse_cpu_list(value, ids) || ids.empty())
+    {
+        ERROR("failed to read online cpus from %s/cpu/online", sysfs_root.c_str());
+        return false;
+    }
+
+    for(int id : ids) {
+        std::string topology_path = sysfs_root + "/cpu/cpu" + int2str(id) + "/topology/";
+        cpus.push_back({
+            id,
+            read_sysfs_int(topology_path + "core_id", id),
+            read_sysfs_int(topology_path + "physical_package_id", 0),
+            0
+        });
+    }
+
+    // kernels without NUMA support have no node directory
+    std::vector<int> nodes;
+    if(!read_sysfs(sysfs_root + "/node/online", value) ||
+       !parse_cpu_list(value, nodes))
+    {
+        return true;
+    }
+
+    for(int node : nodes) {
+        std::vector<int> node_cpus;
+        if(!read_sysfs(sysfs_root + "/node/node" + int2str(node) + "/cpulist", value) ||
+           !parse_cpu_list(value, node_cpus))
+        {
+            WARN("failed to read cpus of the NUMA node %d", node);
+            continue;
+        }
+        for(auto &cpu : cpus) {
+            if(std::binary_search(node_cpus.begin(), node_cpus.end(), cpu.id))
+                cpu.node = node;
+        }
+    }
+
+    return true;
+}
+
+static std::vector<int> node_ids(const std::vector<CpuTopology::Cpu> &cpus)
+{
+    std::vector<int> ret;
+    for(const auto &cpu : cpus)
+        ret.push_back(cpu.node);
+    std::sort(ret.begin(), ret.end());
+    ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+    return ret;
+}
+
+unsigned int CpuTopology::nodes() const
+{
+    return static_cast<unsigned int>(node_ids(cpus).size());
+}
+
+std::vector<int> CpuTopology::nodeCpus(int node) const
+{
+    std::vector<int> ret;
+    for(const auto &cpu : cpus) {
+        if(cpu.node == node)
+            ret.push_back(cpu.id);
+    }
+    return ret;
+}
+
+std::vector<std::vector<int> > CpuTopology::cores() const
+{
+    // node -> cores of the node ordered by (package, core)
+    std::map<int, std::map<std::pair<int, int>, std::vector<int> > > node_cores;
+    for(const auto &cpu : cpus)
+        node_cores[cpu.node][std::make_pair(cpu.package, cpu.core)].push_back(cpu.id);
+
+    std::vector<std::vector<std::vector<int> > > per_node;
+    for(auto &node : node_cores) {
+        per_node.emplace_back();
+        for(auto &core : node.second)
+            per_node.back().push_back(std::move(core.second));
+    }
+
+    std::vector<std::vector<int> > ret;
+    for(size_t i = 0; ret.size() < cpus.size(); i++) {
+        bool added = false;
+        for(auto &node : per_node) {
+            if(i < node.size()) {
+                ret.push_back(std::move(node[i]));
+                added = true;
+            }
+        }
+        if(!added) break;
+    }
+    return ret;
+}
+
+std::vector<int> CpuTopology::select(const CpuPlacementConfig &cfg,
+                                     CpuThreadRole role, unsigned int idx) const
+{
+    switch(cfg.policy) {
+    case CpuPlacementConfig::PLACEMENT_ROLE:
+        return cfg.role_cpus[role];
+
+    case CpuPlacementConfig::PLACEMENT_SPREAD: {
+        auto all_cores = cores();
+        if(all_cores.empty()) break;
+        unsigned int slot = idx;
+        for(int r = 0; r < role; r++)
+            slot += cfg.role_threads[r];
+        return all_cores[slot % all_cores.size()];
+    }
+
+    case CpuPlacementConfig::PLACEMENT_NUMA: {
+        auto nodes = node_ids(cpus);
+        if(nodes.size() < 2) break;
+        return nodeCpus(nodes[idx % nodes.size()]);
+    }
+
+    case CpuPlacementConfig::PLACEMENT_NONE:
+        break;
+    }
+
+    return std::vector<int>();
+}
+
+_AmCpuPlacement::_AmCpuPlacement()
+  : topology_loaded(false),
+    next_idx{}
+{}
+
+void _AmCpuPlacement::place(AmThread *thread, const char *name, CpuThreadRole role, int idx)
+{
+    const CpuPlacementConfig &cfg = AmConfig.cpu_placement;
+
+    PlacedThread t;
+    t.name = name;
+    t.role = role;
+    t.tid = static_cast<pid_t>(_self_tid);
+    t.realtime = false;
+
+    mut.lock();
+    t.idx = idx < 0 ? next_idx[role]++ : static_cast<unsigned int>(idx);
+    if(cfg.policy != CpuPlacementConfig::PLACEMENT_NONE) {
+        if(!topology_loaded) {
+            topology.load();
+            topology_loaded = true;
+        }
+        t.cpus = topology.select(cfg, role, t.idx);
+    }
+    mut.unlock();
+
+    if(!t.cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for(int cpu : t.cpus)
+            CPU_SET(cpu, &set);
+
+        int res = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if(res) {
+            WARN("failed to pin %s thread %u to cpus %s: %s",
+                 name, t.idx, cpu_list2str(t.cpus).c_str(), strerror(res));
+            t.cpus.clear();
+        } else {
+            INFO("%s thread %u pinned to cpus %s",
+                 name, t.idx, cpu_list2str(t.cpus).c_str());
+        }
+    }
+
+    if(cfg.media_realtime && (role == CPU_ROLE_MEDIA || role == CPU_ROLE_RTP))
+        t.realtime = (thread->setRealtime(cfg.media_realtime_priority) == 0);
+
+    AmLock l(mut);
+    threads.push_back(t);
+}
+
+void _AmCpuPlacement::getInfo(AmArg &ret)
+{
+    const CpuPlacementConfig &cfg = AmConfig.cpu_placement;
+
+    AmLock l(mut);
+
+    if(!topology_loaded) {
+        topology.load();
+        topology_loaded = true;
+    }
+
+    ret["policy"] = CpuPlacementConfig::policy2str(cfg.policy);
+    ret["media_realtime"] = cfg.media_realtime;
+
+    AmArg &topo = ret["topology"];
+    topo["cpus"] = static_cast<int>(topology.cpus.size());
+    topo["cores"] = static_cast<int>(topology.cores().size());
+    AmArg &nodes = topo["nodes"];
+    nodes.assertStruct();
+    for(int node : node_ids(topology.cpus))
+        nodes[int2str(node)] = cpu_list2str(topology.nodeCpus(node));
+
+    AmArg &threads_info = ret["threads"];
+    threads_info.assertArray();
+    for(const auto &t : threads) {
+        threads_info.push(AmArg());
+        AmArg &a = threads_info.back();
+        a["name"] = t.name;
+        a["role"] = cpu_role_name(t.role);
+        a["idx"] = static_cast<int>(t.idx);
+        a["tid"] = static_cast<int>(t.tid);
+        a["cpus"] = t.cpus.empty() ? "any" : cpu_list2str(t.cpus);
+        a["realtime"] = t.realtime;
+    }
+}
@@ -0,0 +1,151 @@
+/*
+ * This file is part of SEMS, a free SIP media server.
+ *
+ * SEMS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * For a license to use the sems software under conditions
+ * other than those described here, or to purchase support for this
+ * software, please contact iptel.org by e-mail at the following addresses:
+ *    info@iptel.org
+ *
+ * SEMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/** @file AmCpuPlacement.h */
+#ifndef _AMCPUPLACEMENT_H
+#define _AMCPUPLACEMENT_H
+
+#include "AmThread.h"
+#include "AmArg.h"
+#include "singleton.h"
+
+#include <string>
+#include <vector>
+
+#define CPU_SYSFS_ROOT "/sys/devices/system"
+#define CPU_DEFAULT_RT_PRIORITY 50
+
+/** worker thread pools with configurable placement */
+enum CpuThreadRole {
+    CPU_ROLE_MEDIA = 0, //media-proc
+    CPU_ROLE_RTP,       //rtp-rx
+    CPU_ROLE_SESSION,   //session-proc
+    CPU_ROLE_SIP,       //sip-udp-rx, sip-worker
+    CPU_ROLE_MAX
+};
+
+const char *cpu_role_name(CpuThreadRole role);
+
+/** parse cpus list in the sysfs format: "0-3,8,10-11" */
+bool parse_cpu_list(const std::string &s, std::vector<int> &cpus);
+std::string cpu_list2str(const std::vector<int> &cpus);
+
+struct CpuPlacementConfig
+{
+    enum Policy {
+        /** threads are not pinned */
+        PLACEMENT_NONE = 0,
+        /** threads of the role share the configured cpus */
+        PLACEMENT_ROLE,
+        /** every thread gets own physical core while there are free ones */
+        PLACEMENT_SPREAD,
+        /** threads of the role are distributed over NUMA nodes by index.
+         *  RTP receiver and media processor with the same index
+         *  share the node */
+        PLACEMENT_NUMA
+    };
+
+    Policy policy;
+    std::vector<int> role_cpus[CPU_ROLE_MAX];
+    /** threads count of each role. defines core offsets for PLACEMENT_SPREAD */
+    unsigned int role_threads[CPU_ROLE_MAX];
+    /** SCHED_FIFO for media and RTP threads */
+    bool media_realtime;
+    int media_realtime_priority;
+
+    CpuPlacementConfig();
+
+    static const char *policy2str(Policy policy);
+    /** @return false for unknown policy name */
+    static bool str2policy(const std::string &s, Policy &policy);
+};
+
+/**
+ * \brief online cpus with their physical cores and NUMA nodes
+ */
+struct CpuTopology
+{
+    struct Cpu {
+        int id;
+        int core;
+        int package;
+        int node;
+    };
+
+    /** ordered by id */
+    std::vector<Cpu> cpus;
+
+    /** read the topology from sysfs (CPU_SYSFS_ROOT) */
+    bool load(const std::string &sysfs_root = CPU_SYSFS_ROOT);
+
+    unsigned int nodes() const;
+    std::vector<int> nodeCpus(int node) const;
+    /** hyperthread siblings of each physical core,
+     *  cores of different nodes are interleaved */
+    std::vector<std::vector<int> > cores() const;
+
+    /** @return cpus allowed for the thread idx of the role, empty if not restricted */
+    std::vector<int> select(const CpuPlacementConfig &cfg,
+                            CpuThreadRole role, unsigned int idx) const;
+};
+
+/**
+ * \brief applies the configured placement to the worker threads
+ *
+ * threads call place() at the start of run(). placement
+ * is remembered for the 'show.threads.placement' RPC.
+ */
+class _AmCpuPlacement
+{
+    struct PlacedThread {
+        std::string name;
+        CpuThreadRole role;
+        unsigned int idx;
+        pid_t tid;
+        std::vector<int> cpus;
+        bool realtime;
+    };
+
+    AmMutex mut;
+    CpuTopology topology;
+    bool topology_loaded;
+    std::vector<PlacedThread> threads;
+    unsigned int next_idx[CPU_ROLE_MAX];
+
+  protected:
+    _AmCpuPlacement();
+    virtual ~_AmCpuPlacement() {}
+    void dispose() {}
+
+  public:
+    /**
+     * pin the calling thread according to AmConfig.cpu_placement
+     * @param idx index within the role, negative to take the next one
+     */
+    void place(AmThread *thread, const char *name, CpuThreadRole role, int idx = -1);
+
+    void getInfo(AmArg &ret);
+};
+
+typedef singleton<_AmCpuPlacement> AmCpuPlacement;
+
+#endif
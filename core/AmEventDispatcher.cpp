@@ -46,6 +46,123 @@ unsigned int AmEventDispatcher::hash(const string& s1, const string s2)
     return h & (EVENT_DISPATCHER_BUCKETS-1);
 }
 
+EventQueueIdTable::Shard::Shard()
+  : slots(1 << EVENT_QUEUE_ID_SHARD_POWER),
+    power(EVENT_QUEUE_ID_SHARD_POWER),
+    used(0)
+{}
+
+EventQueueIdTable::EventQueueIdTable()
+  : last_id(EVENT_QUEUE_ID_NONE)
+{}
+
+size_t EventQueueIdTable::home(AmEventQueueId id, unsigned int power)
+{
+    // fibonacci hashing. low bits are taken by the shard index
+    return (id * 0x9e3779b97f4a7c15ULL) >> (64 - power);
+}
+
+void EventQueueIdTable::insert(Shard& s, AmEventQueueId id, AmEventQueueInterface* q)
+{
+    size_t mask = s.slots.size() - 1;
+    size_t i = home(id, s.power);
+    while(s.slots[i].id != EVENT_QUEUE_ID_NONE)
+        i = (i + 1) & mask;
+    s.slots[i].id = id;
+    s.slots[i].q = q;
+    s.used++;
+}
+
+EventQueueIdTable::Slot* EventQueueIdTable::find(Shard& s, AmEventQueueId id)
+{
+    size_t mask = s.slots.size() - 1;
+    for(size_t i = home(id, s.power);
+        s.slots[i].id != EVENT_QUEUE_ID_NONE;
+        i = (i + 1) & mask)
+    {
+        if(s.slots[i].id == id)
+            return &s.slots[i];
+    }
+    return nullptr;
+}
+
+AmEventQueueId EventQueueIdTable::add(AmEventQueueInterface* q)
+{
+    AmEventQueueId id = last_id.fetch_add(1) + 1;
+    Shard& s = shards[id & (EVENT_QUEUE_ID_SHARDS - 1)];
+
+    AmLock l(s.mut);
+
+    // keep the load factor below 3/4
+    if((s.used + 1) * 4 > s.slots.size() * 3) {
+        std::vector<Slot> old(1 << (s.power + 1));
+        old.swap(s.slots);
+        s.power++;
+        s.used = 0;
+        for(const auto& slot : old) {
+            if(slot.id != EVENT_QUEUE_ID_NONE)
+                insert(s, slot.id, slot.q);
+        }
+    }
+
+    insert(s, id, q);
+    return id;
+}
+
+bool EventQueueIdTable::remove(AmEventQueueId id)
+{
+    Shard& s = shards[id & (EVENT_QUEUE_ID_SHARDS - 1)];
+
+    AmLock l(s.mut);
+
+    Slot* slot = find(s, id);
+    if(!slot) return false;
+
+    // shift back the following entries of the cluster
+    // which can not be found anymore after the gap
+    size_t mask = s.slots.size() - 1;
+    size_t i = slot - s.slots.data();
+    for(size_t j = (i + 1) & mask;
+        s.slots[j].id != EVENT_QUEUE_ID_NONE;
+        j = (j + 1) & mask)
+    {
+        size_t k = home(s.slots[j].id, s.power);
+        if(i <= j ? (i < k && k <= j) : (i < k || k <= j))
+            continue;
+        s.slots[i] = s.slots[j];
+        i = j;
+    }
+
+    s.slots[i].id = EVENT_QUEUE_ID_NONE;
+    s.slots[i].q = NULL;
+    s.used--;
+
+    return true;
+}
+
+bool EventQueueIdTable::post(AmEventQueueId id, AmEvent* ev)
+{
+    Shard& s = shards[id & (EVENT_QUEUE_ID_SHARDS - 1)];
+
+    AmLock l(s.mut);
+
+    Slot* slot = find(s, id);
+    if(!slot) return false;
+
+    slot->q->postEvent(ev);
+    return true;
+}
+
+size_t EventQueueIdTable::size()
+{
+    size_t ret = 0;
+    for(auto& s : shards) {
+        AmLock l(s.mut);
+        ret += s.used;
+    }
+    return ret;
+}
+
 AmEventDispatcher* AmEventDispatcher::_instance=NULL;
 
 AmEventDispatcher* AmEventDispatcher::instance()
@@ -55,7 +172,8 @@ AmEventDispatcher* AmEventDispatcher::instance()
 
 
 bool AmEventDispatcher::addEventQueue(const string& local_tag,
-				      AmEventQueueInterface* q)
+				      AmEventQueueInterface* q,
+				      AmEventQueueId* qid)
 {
     unsigned int queue_bucket = hash(local_tag);
 
@@ -66,8 +184,11 @@ bool AmEventDispatcher::addEventQueue(const string& local_tag,
       return false;
     }
 
-    queues[queue_bucket][local_tag] = QueueEntry(q);
+    AmEventQueueId new_qid = qids.add(q);
+    queues[queue_bucket][local_tag] = QueueEntry(q,new_qid);
     queues_mut[queue_bucket].unlock();
+
+    if(qid) *qid = new_qid;
     
     return true;
 }
@@ -78,7 +199,8 @@ bool AmEventDispatcher::addEventQueue(const string& local_tag,
 				      AmEventQueueInterface* q,
 				      const string& callid, 
 				      const string& remote_tag,
-				      const string& via_branch)
+				      const string& via_branch,
+				      AmEventQueueId* qid)
 {
     if(local_tag.empty () ||callid.empty() || remote_tag.empty() || via_branch.empty()) {
       ERROR("local_tag, callid, remote_tag or via_branch is empty");
@@ -110,11 +232,14 @@ bool AmEventDispatcher::addEventQueue(const string& local_tag,
       return false;
     }
 
-    queues[queue_bucket][local_tag] = QueueEntry(q,id);
-    id_lookup[id_bucket][id] = local_tag;
+    AmEventQueueId new_qid = qids.add(q);
+    queues[queue_bucket][local_tag] = QueueEntry(q,id,new_qid);
+    id_lookup[id_bucket][id] = IdLookupEntry(local_tag,new_qid);
 
     id_lookup_mut[id_bucket].unlock();
     queues_mut[queue_bucket].unlock();
+
+    if(qid) *qid = new_qid;
     
     return true;
 }
@@ -132,13 +257,14 @@ AmEventQueueInterface* AmEventDispatcher::delEventQueue(const string& local_tag)
       QueueEntry qe(qi->second);
       queues[queue_bucket].erase(qi);
       q = qe.q;
+      qids.remove(qe.qid);
       
       if(!qe.id.empty()) {
 	unsigned int id_bucket = hash(qe.id);
 	
 	id_lookup_mut[id_bucket].lock();
 	
-	DictIter di = id_lookup[id_bucket].find(qe.id);
+	IdLookupIter di = id_lookup[id_bucket].find(qe.id);
 	if(di != id_lookup[id_bucket].end()) {	    
 	  id_lookup[id_bucket].erase(di);
 	}
@@ -151,6 +277,26 @@ AmEventQueueInterface* AmEventDispatcher::delEventQueue(const string& local_tag)
     return q;
 }
 
+AmEventQueueId AmEventDispatcher::getQueueId(const string& local_tag)
+{
+    unsigned int queue_bucket = hash(local_tag);
+    AmLock l(queues_mut[queue_bucket]);
+    EvQueueMapIter it = queues[queue_bucket].find(local_tag);
+    if(it == queues[queue_bucket].end())
+        return EVENT_QUEUE_ID_NONE;
+    return it->second.qid;
+}
+
+AmEventQueueId AmEventDispatcher::lookupId(const string& id)
+{
+    unsigned int id_bucket = hash(id);
+    AmLock l(id_lookup_mut[id_bucket]);
+    IdLookupIter di = id_lookup[id_bucket].find(id);
+    if(di == id_lookup[id_bucket].end())
+        return EVENT_QUEUE_ID_NONE;
+    return di->second.qid;
+}
+
 bool AmEventDispatcher::post(const string& local_tag, AmEvent* ev)
 {
     bool posted = false;
@@ -180,19 +326,17 @@ bool AmEventDispatcher::post(const string& callid,
     if(AmConfig.accept_forked_dialogs){
       id += via_branch;
     }
-    unsigned int id_bucket = hash(id);
-
-    id_lookup_mut[id_bucket].lock();
 
-    DictIter di = id_lookup[id_bucket].find(id);
-    if (di == id_lookup[id_bucket].end()) {
-      id_lookup_mut[id_bucket].unlock();
+    AmEventQueueId qid = lookupId(id);
+    if(qid == EVENT_QUEUE_ID_NONE)
       return false;
-    }
-    string local_tag = di->second;
-    id_lookup_mut[id_bucket].unlock();
- 
-    return post(local_tag, ev);
+
+    return qids.post(qid, ev);
+}
+
+bool AmEventDispatcher::post(AmEventQueueId qid, AmEvent* ev)
+{
+    return qids.post(qid, ev);
 }
 
 bool AmEventDispatcher::broadcast(AmEvent* ev)
@@ -296,39 +440,22 @@ void AmEventDispatcher::dispose()
     - if the session does not exist, no event need to be created (req copied) */
 bool AmEventDispatcher::postSipRequest(const AmSipRequest& req)
 {
-    // get local tag
-    bool posted = false;
-    string callid = req.callid;
-    string remote_tag = req.from_tag;
-
-    string id = callid+remote_tag;
+    // get queue id
+    string id = req.callid+req.from_tag;
     if(AmConfig.accept_forked_dialogs){
       id += req.via_branch;
     }
-    unsigned int id_bucket = hash(id);
 
-    id_lookup_mut[id_bucket].lock();
+    AmEventQueueId qid = lookupId(id);
+    if(qid == EVENT_QUEUE_ID_NONE)
+      return false;
 
-    DictIter di = id_lookup[id_bucket].find(id);
-    if (di == id_lookup[id_bucket].end()) {
-      id_lookup_mut[id_bucket].unlock();
+    // the queue can still be removed in between
+    AmEvent* ev = new AmSipRequestEvent(req);
+    if(!qids.post(qid, ev)) {
+      delete ev;
       return false;
     }
-    string local_tag = di->second;
-    id_lookup_mut[id_bucket].unlock();
- 
-    // post(local_tag)
-    unsigned int queue_bucket = hash(local_tag);
-  
-    queues_mut[queue_bucket].lock();
- 
-    EvQueueMapIter it = queues[queue_bucket].find(local_tag);
-    if(it != queues[queue_bucket].end()){
-	it->second.q->postEvent(new AmSipRequestEvent(req));
-	posted = true;
-    }
 
-    queues_mut[queue_bucket].unlock();
-    
-    return posted;
+    return true;
 }
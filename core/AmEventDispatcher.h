@@ -30,10 +30,61 @@
 #include "AmEventQueue.h"
 #include "AmSipMsg.h"
 #include <map>
+#include <vector>
+#include <atomic>
 
 #define EVENT_DISPATCHER_POWER   10
 #define EVENT_DISPATCHER_BUCKETS (1<<EVENT_DISPATCHER_POWER)
 
+#define EVENT_QUEUE_ID_SHARDS_POWER 8
+#define EVENT_QUEUE_ID_SHARDS       (1<<EVENT_QUEUE_ID_SHARDS_POWER)
+#define EVENT_QUEUE_ID_SHARD_POWER  4
+
+/** interned event queue handle. never reused, 0 is invalid */
+typedef unsigned long long AmEventQueueId;
+#define EVENT_QUEUE_ID_NONE 0ULL
+
+/**
+ * \brief flat hash table AmEventQueueId -> event queue
+ *
+ * ids are spread over the shards by the low bits. every shard
+ * is an open addressing table with linear probing and
+ * backward shift deletion guarded by its own mutex,
+ * so lookups do neither allocate nor compare strings.
+ */
+class EventQueueIdTable
+{
+    struct Slot {
+      AmEventQueueId         id;
+      AmEventQueueInterface* q;
+    };
+
+    struct Shard {
+      AmMutex           mut;
+      std::vector<Slot> slots;
+      unsigned int      power;
+      size_t            used;
+
+      Shard();
+    };
+
+    Shard shards[EVENT_QUEUE_ID_SHARDS];
+    std::atomic<AmEventQueueId> last_id;
+
+    static size_t home(AmEventQueueId id, unsigned int power);
+    static void insert(Shard& s, AmEventQueueId id, AmEventQueueInterface* q);
+    static Slot* find(Shard& s, AmEventQueueId id);
+
+public:
+    EventQueueIdTable();
+
+    AmEventQueueId add(AmEventQueueInterface* q);
+    bool remove(AmEventQueueId id);
+    /** post under the shard lock, so the queue can not be removed meanwhile */
+    bool post(AmEventQueueId id, AmEvent* ev);
+    size_t size();
+};
+
 class AmEventDispatcher
 {
 public:
@@ -41,22 +92,34 @@ public:
     struct QueueEntry {
       AmEventQueueInterface* q;
       string                 id;
+      AmEventQueueId         qid;
 
       QueueEntry()
-	: q(NULL), id() {}
+	: q(NULL), id(), qid(EVENT_QUEUE_ID_NONE) {}
 
-      QueueEntry(AmEventQueueInterface* q)
-        : q(q), id() {} 
+      QueueEntry(AmEventQueueInterface* q, AmEventQueueId qid)
+        : q(q), id(), qid(qid) {}
 
-      QueueEntry(AmEventQueueInterface* q, string id)
-	: q(q), id(id){} 
+      QueueEntry(AmEventQueueInterface* q, string id, AmEventQueueId qid)
+	: q(q), id(id), qid(qid) {}
     };
 
     typedef std::map<string, QueueEntry> EvQueueMap;
     typedef EvQueueMap::iterator         EvQueueMapIter;
-    
-    typedef std::map<string,string>  Dictionnary;
-    typedef Dictionnary::iterator    DictIter;
+
+    struct IdLookupEntry {
+      string         local_tag;
+      AmEventQueueId qid;
+
+      IdLookupEntry()
+        : local_tag(), qid(EVENT_QUEUE_ID_NONE) {}
+
+      IdLookupEntry(const string& local_tag, AmEventQueueId qid)
+        : local_tag(local_tag), qid(qid) {}
+    };
+
+    typedef std::map<string,IdLookupEntry> IdLookupMap;
+    typedef IdLookupMap::iterator          IdLookupIter;
 
     using QueueEntryIterateHandler = std::function<
         void (const string &key,const QueueEntry &entry) >;
@@ -81,10 +144,15 @@ private:
      *  (needed for CANCELs)
      *  (UAS sessions only)
      */
-    Dictionnary id_lookup[EVENT_DISPATCHER_BUCKETS];
+    IdLookupMap id_lookup[EVENT_DISPATCHER_BUCKETS];
     // mutex for "id_lookup" 
     AmMutex id_lookup_mut[EVENT_DISPATCHER_BUCKETS];
 
+    /** interned id -> event queue */
+    EventQueueIdTable qids;
+
+    AmEventQueueId lookupId(const string& id);
+
     unsigned int hash(const string& s1);
     unsigned int hash(const string& s1, const string s2);
 public:
@@ -99,21 +167,30 @@ public:
 	      const string& remote_tag, 
 	      const string& via_branch,
 	      AmEvent* ev);
+    /** post by the id returned from addEventQueue */
+    bool post(AmEventQueueId qid, AmEvent* ev);
 
     /* send event to all event queues. Note: event instances will be cloned */
     bool broadcast(AmEvent* ev);
 
+    /** @param qid receives the interned id of the added queue */
     bool addEventQueue(const string& local_tag,
-		       AmEventQueueInterface* q);
+		       AmEventQueueInterface* q,
+		       AmEventQueueId* qid = NULL);
 
     bool addEventQueue(const string& local_tag, 
 		       AmEventQueueInterface* q,
 		       const string& callid, 
 		       const string& remote_tag,
-		       const string& via_branch);
+		       const string& via_branch,
+		       AmEventQueueId* qid = NULL);
 
+    /** invalidates the interned id of the queue as well */
     AmEventQueueInterface* delEventQueue(const string& local_tag);
 
+    /** @return EVENT_QUEUE_ID_NONE if there is no such queue */
+    AmEventQueueId getQueueId(const string& local_tag);
+
     bool empty();
 
     void dump();
@@ -34,7 +34,8 @@ AmEventQueue::AmEventQueue(AmEventHandler* handler)
   : handler(handler),
     wakeup_handler(NULL),
     ev_pending(false),
-    finalized(false)
+    finalized(false),
+    depth_counter(NULL)
 {
 }
 
@@ -44,6 +45,7 @@ AmEventQueue::~AmEventQueue()
   while(!ev_queue.empty()){
     delete ev_queue.front();
     ev_queue.pop();
+    if(depth_counter) depth_counter->dec();
   }
   m_queue.unlock();
 }
@@ -55,8 +57,10 @@ void AmEventQueue::postEvent(AmEvent* event)
 
   m_queue.lock();
 
-  if(event)
+  if(event) {
     ev_queue.push(event);
+    if(depth_counter) depth_counter->inc();
+  }
 
   if(!ev_pending.get()) {
     ev_pending.set(true);
@@ -79,6 +83,7 @@ void AmEventQueue::processEvents(EventStats *stats)
     while(!ev_queue.empty()) {
         AmEvent* event = ev_queue.front();
         ev_queue.pop();
+        if(depth_counter) depth_counter->dec();
         m_queue.unlock();
 
         if(stats) {
@@ -120,6 +125,7 @@ void AmEventQueue::processSingleEvent()
 
     AmEvent* event = ev_queue.front();
     ev_queue.pop();
+    if(depth_counter) depth_counter->dec();
     m_queue.unlock();
 
     if (AmConfig.log_events) 
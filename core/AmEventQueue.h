@@ -74,6 +74,9 @@ protected:
 
   bool finalized;
 
+  /** events pending in the queue are added to it, if set */
+  atomic_int64*             depth_counter;
+
 public:
   AmEventQueue(AmEventHandler* handler);
   virtual ~AmEventQueue();
@@ -85,6 +88,8 @@ public:
   bool eventPending();
 
   void setEventNotificationSink(AmEventNotificationSink* _wakeup_handler);
+  /** must be set before the first event is posted */
+  void setDepthCounter(atomic_int64* counter) { depth_counter = counter; }
 
   bool is_finalized() { return finalized; }
 
@@ -144,15 +144,20 @@ class SIP_TCP_info : public SIP_info
 {
 protected:
     explicit SIP_TCP_info(SIP_info::SIP_type type)
-    : SIP_info(type), tcp_connect_timeout(DEFAULT_TCP_CONNECT_TIMEOUT), tcp_idle_timeout(DEFAULT_IDLE_TIMEOUT){}
+    : SIP_info(type), tcp_connect_timeout(DEFAULT_TCP_CONNECT_TIMEOUT), tcp_idle_timeout(DEFAULT_IDLE_TIMEOUT),
+      tcp_send_queue_high(0), tcp_send_queue_low(0){}
 public:
     SIP_TCP_info()
-    : SIP_info(TCP), tcp_connect_timeout(DEFAULT_TCP_CONNECT_TIMEOUT), tcp_idle_timeout(DEFAULT_IDLE_TIMEOUT){}
+    : SIP_info(TCP), tcp_connect_timeout(DEFAULT_TCP_CONNECT_TIMEOUT), tcp_idle_timeout(DEFAULT_IDLE_TIMEOUT),
+      tcp_send_queue_high(0), tcp_send_queue_low(0){}
     SIP_TCP_info(const SIP_TCP_info& info) = delete;
     virtual ~SIP_TCP_info(){}
 
     unsigned int tcp_connect_timeout;
     unsigned int tcp_idle_timeout;
+    /** per connection send queue watermarks in bytes, 0 - unlimited */
+    unsigned int tcp_send_queue_high;
+    unsigned int tcp_send_queue_low;
 
     static SIP_TCP_info* toSIP_TCP(SIP_info* info)
     {
@@ -1,6 +1,7 @@
 #include "AmLcConfig.h"
 #include <algorithm>
 #include <string.h>
+#include <sched.h>
 #include <netdb.h>
 #include <ifaddrs.h>
 #include <net/if.h>
@@ -42,6 +43,8 @@
 #define SECTION_OSLIM_NAME           "options_session_limit"
 #define SECTION_CPS_LIMIT_NAME       "cps_limit"
 #define SECCTION_SDM_NAME            "shutdown_mode"
+#define SECTION_CPU_PLACEMENT_NAME   "cpu_placement"
+#define SECTION_OVERLOAD_NAME        "overload_control"
 #define SECTION_SERVER_NAME          "server"
 #define SECTION_CLIENT_NAME          "client"
 #define SECTION_SRTP_NAME            "srtp"
@@ -71,9 +74,13 @@
 #define PARAM_ANNOUNCE_PORT_NAME     "announce-port"
 #define PARAM_CONNECT_TIMEOUT_NAME   "connect-timeout"
 #define PARAM_IDLE_TIMEOUT_NAME      "idle-timeout"
+#define PARAM_SEND_QUEUE_HIGH_NAME   "send-queue-high-watermark"
+#define PARAM_SEND_QUEUE_LOW_NAME    "send-queue-low-watermark"
 #define PARAM_CORS_MODE_NAME         "cors_mode"
 #define PARAM_WHITELIST_NAME         "whitelist"
 #define PARAM_METHOD_NAME            "method"
+#define PARAM_RATE_LIMIT_NAME        "rate-limit"
+#define PARAM_RATE_BURST_NAME        "rate-burst"
 #define PARAM_PATH_NAME              "path"
 #define PARAM_CPATH_NAME             "config_path"
 #define PARAM_BL_TTL_NAME            "default_bl_ttl"
@@ -172,6 +179,23 @@
 #define PARAM_SYMMETRIC_MODE_NAME    "symmetric_rtp_mode"
 #define PARAM_SYMMETRIC_PACKETS_NAME "symmetric_rtp_packets"
 #define PARAM_SYMMETRIC_DELAY_NAME   "symmetric_rtp_delay"
+#define PARAM_POLICY_NAME            "policy"
+#define PARAM_MEDIA_CPUS_NAME        "media_cpus"
+#define PARAM_RTP_CPUS_NAME          "rtp_cpus"
+#define PARAM_SESSION_CPUS_NAME      "session_cpus"
+#define PARAM_SIP_CPUS_NAME          "sip_cpus"
+#define PARAM_MEDIA_REALTIME_NAME    "media_realtime"
+#define PARAM_MEDIA_RT_PRIORITY_NAME "media_realtime_priority"
+#define PARAM_ENABLED_NAME           "enabled"
+#define PARAM_SAMPLE_INTERVAL_NAME   "sample_interval"
+#define PARAM_MEDIA_LATENESS_NAME    "media_tick_lateness"
+#define PARAM_SESSION_QUEUE_NAME     "session_queue_depth"
+#define PARAM_RTP_DROP_RATE_NAME     "rtp_drop_rate"
+#define PARAM_TIMER_LAG_NAME         "timer_lag"
+#define PARAM_MIN_CPS_NAME           "min_cps"
+#define PARAM_DECREASE_PERCENT_NAME  "decrease_percent"
+#define PARAM_INCREASE_CPS_NAME      "increase_cps"
+#define PARAM_RETRY_AFTER_NAME       "retry_after"
 
 #define VALUE_OFF                    "off"
 #define VALUE_DROP                   "drop"
@@ -189,6 +213,7 @@
 #define VALUE_503_ERR_CODE           503
 #define VALUE_SESSION_LIMIT_ERR      "Server overload"
 #define VALUE_CPSLIMIT_ERR           "Server overload"
+#define VALUE_OVERLOAD_ERR           "Server overload"
 #define VALUE_SDM_ERR_REASON         "Server shutting down"
 #define VALUE_MAX_SHUTDOWN_TIME      10
 #define VALUE_DEAD_RTP_TIME          5*60
@@ -231,6 +256,8 @@ namespace Config {
     {
         CFG_STR_LIST(PARAM_WHITELIST_NAME, 0, CFGF_NODEFAULT),
         CFG_STR(PARAM_METHOD_NAME, "", CFGF_NODEFAULT),
+        CFG_INT(PARAM_RATE_LIMIT_NAME, 0, CFGF_NONE),
+        CFG_INT(PARAM_RATE_BURST_NAME, 0, CFGF_NONE),
         CFG_END()
     };
 
@@ -339,6 +366,8 @@ namespace Config {
         CFG_INT(PARAM_DSCP_NAME, 0, CFGF_NONE),
         CFG_INT(PARAM_CONNECT_TIMEOUT_NAME, 0, CFGT_NONE),
         CFG_INT(PARAM_IDLE_TIMEOUT_NAME, 0, CFGT_NONE),
+        CFG_INT(PARAM_SEND_QUEUE_HIGH_NAME, 0, CFGF_NONE),
+        CFG_INT(PARAM_SEND_QUEUE_LOW_NAME, 0, CFGF_NONE),
         CFG_SEC(SECTION_OPT_NAME, acl, CFGF_NODEFAULT),
         CFG_SEC(SECTION_ORIGACL_NAME, acl, CFGF_NODEFAULT),
         CFG_SEC(SECTION_REG_ACL_NAME, acl, CFGF_NODEFAULT),
@@ -404,6 +433,8 @@ namespace Config {
         CFG_INT(PARAM_DSCP_NAME, 0, CFGF_NONE),
         CFG_INT(PARAM_CONNECT_TIMEOUT_NAME, 0, CFGT_NONE),
         CFG_INT(PARAM_IDLE_TIMEOUT_NAME, 0, CFGT_NONE),
+        CFG_INT(PARAM_SEND_QUEUE_HIGH_NAME, 0, CFGF_NONE),
+        CFG_INT(PARAM_SEND_QUEUE_LOW_NAME, 0, CFGF_NONE),
         CFG_SEC(SECTION_OPT_NAME, acl, CFGF_NODEFAULT),
         CFG_SEC(SECTION_ORIGACL_NAME, acl, CFGF_NODEFAULT),
         CFG_SEC(SECTION_REG_ACL_NAME, acl, CFGF_NODEFAULT),
@@ -534,12 +565,41 @@ namespace Config {
         CFG_END()
     };
 
+    static cfg_opt_t cpu_placement[] {
+        CFG_STR(PARAM_POLICY_NAME, "none", CFGF_NONE),
+        CFG_STR(PARAM_MEDIA_CPUS_NAME, "", CFGF_NONE),
+        CFG_STR(PARAM_RTP_CPUS_NAME, "", CFGF_NONE),
+        CFG_STR(PARAM_SESSION_CPUS_NAME, "", CFGF_NONE),
+        CFG_STR(PARAM_SIP_CPUS_NAME, "", CFGF_NONE),
+        CFG_BOOL(PARAM_MEDIA_REALTIME_NAME, cfg_false, CFGF_NONE),
+        CFG_INT(PARAM_MEDIA_RT_PRIORITY_NAME, CPU_DEFAULT_RT_PRIORITY, CFGF_NONE),
+        CFG_END()
+    };
+
+    static cfg_opt_t overload_control[] {
+        CFG_BOOL(PARAM_ENABLED_NAME, cfg_false, CFGF_NONE),
+        CFG_INT(PARAM_SAMPLE_INTERVAL_NAME, 1000, CFGF_NONE),
+        CFG_INT(PARAM_MEDIA_LATENESS_NAME, 20, CFGF_NONE),
+        CFG_INT(PARAM_SESSION_QUEUE_NAME, 10000, CFGF_NONE),
+        CFG_INT(PARAM_RTP_DROP_RATE_NAME, 0, CFGF_NONE),
+        CFG_INT(PARAM_TIMER_LAG_NAME, 100, CFGF_NONE),
+        CFG_INT(PARAM_MIN_CPS_NAME, 1, CFGF_NONE),
+        CFG_INT(PARAM_DECREASE_PERCENT_NAME, 25, CFGF_NONE),
+        CFG_INT(PARAM_INCREASE_CPS_NAME, 5, CFGF_NONE),
+        CFG_INT(PARAM_CODE_NAME, VALUE_503_ERR_CODE, CFGF_NONE),
+        CFG_STR(PARAM_REASON_NAME, VALUE_OVERLOAD_ERR, CFGF_NONE),
+        CFG_INT(PARAM_RETRY_AFTER_NAME, 5, CFGF_NONE),
+        CFG_END()
+    };
+
     static cfg_opt_t general[] =
     {
         CFG_SEC(SECTION_SESSION_LIMIT_NAME, slimit, CFGF_NONE),
         CFG_SEC(SECTION_OSLIM_NAME, options_slimit, CFGF_NONE),
         CFG_SEC(SECTION_CPS_LIMIT_NAME, cps_limit, CFGF_NONE),
         CFG_SEC(SECCTION_SDM_NAME, sdm, CFGF_NONE),
+        CFG_SEC(SECTION_CPU_PLACEMENT_NAME, cpu_placement, CFGF_NONE),
+        CFG_SEC(SECTION_OVERLOAD_NAME, overload_control, CFGF_NONE),
         CFG_BOOL(PARAM_LOG_PARS_NAME, cfg_true, CFGF_NONE),
         CFG_BOOL(PARAM_STDERR_NAME, cfg_false, CFGF_NONE),
         CFG_BOOL(PARAM_FORCE_OUTBOUND_NAME, cfg_false, CFGF_NONE),
@@ -825,6 +885,28 @@ int validate_symmetric_mode_func(cfg_t *cfg, cfg_opt_t *opt)
     return valid ? 0 : 1;
 }
 
+int validate_cpu_placement_func(cfg_t *cfg, cfg_opt_t *opt)
+{
+    std::string value = cfg_getstr(cfg, opt->name);
+    CpuPlacementConfig::Policy policy;
+    bool valid = CpuPlacementConfig::str2policy(value, policy);
+    if(!valid) {
+        ERROR("invalid value \'%s\' of option \'%s\' - must be \'none\', \'role\', \'spread\' or \'numa\'", value.c_str(), opt->name);
+    }
+    return valid ? 0 : 1;
+}
+
+int validate_cpu_list_func(cfg_t *cfg, cfg_opt_t *opt)
+{
+    std::string value = cfg_getstr(cfg, opt->name);
+    std::vector<int> cpus;
+    bool valid = parse_cpu_list(value, cpus);
+    if(!valid) {
+        ERROR("invalid value \'%s\' of option \'%s\' - must be cpus list like \'0-3,8\'", value.c_str(), opt->name);
+    }
+    return valid ? 0 : 1;
+}
+
 static int check_dir_write_permissions(const string &dir, const char *opt_name)
 {
     std::ofstream st;
@@ -935,6 +1017,11 @@ void AmLcConfig::setValidationFunction(cfg_t* cfg)
     cfg_set_validate_func(cfg, SECTION_GENERAL_NAME "|" PARAM_UNHDL_REP_LOG_LVL_NAME , validate_log_func);
     cfg_set_validate_func(cfg, SECTION_GENERAL_NAME "|" PARAM_RESAMPLE_LIBRARY_NAME , validate_resampling_func);
     cfg_set_validate_func(cfg, SECTION_GENERAL_NAME "|" PARAM_SYMMETRIC_MODE_NAME , validate_symmetric_mode_func);
+    cfg_set_validate_func(cfg, SECTION_GENERAL_NAME "|" SECTION_CPU_PLACEMENT_NAME "|" PARAM_POLICY_NAME , validate_cpu_placement_func);
+    cfg_set_validate_func(cfg, SECTION_GENERAL_NAME "|" SECTION_CPU_PLACEMENT_NAME "|" PARAM_MEDIA_CPUS_NAME , validate_cpu_list_func);
+    cfg_set_validate_func(cfg, SECTION_GENERAL_NAME "|" SECTION_CPU_PLACEMENT_NAME "|" PARAM_RTP_CPUS_NAME , validate_cpu_list_func);
+    cfg_set_validate_func(cfg, SECTION_GENERAL_NAME "|" SECTION_CPU_PLACEMENT_NAME "|" PARAM_SESSION_CPUS_NAME , validate_cpu_list_func);
+    cfg_set_validate_func(cfg, SECTION_GENERAL_NAME "|" SECTION_CPU_PLACEMENT_NAME "|" PARAM_SIP_CPUS_NAME , validate_cpu_list_func);
 
     cfg_set_error_function(cfg,cfg_error_callback);
 }
@@ -1090,6 +1177,27 @@ int AmLcConfig::readGeneral(cfg_t* cfg, ConfigContainer* config)
         config->cps_limit_err_reason = cfg_getstr(s, PARAM_REASON_NAME);
     }
 
+    WITH_SECTION(SECTION_OVERLOAD_NAME) {
+        OverloadControlConfig &overload = config->overload_control;
+        overload.enabled = cfg_getbool(s, PARAM_ENABLED_NAME);
+        overload.sample_interval = cuint(cfg_getint(s, PARAM_SAMPLE_INTERVAL_NAME));
+        overload.media_tick_lateness = cuint(cfg_getint(s, PARAM_MEDIA_LATENESS_NAME));
+        overload.session_queue_depth = cuint(cfg_getint(s, PARAM_SESSION_QUEUE_NAME));
+        overload.rtp_drop_rate = cuint(cfg_getint(s, PARAM_RTP_DROP_RATE_NAME));
+        overload.timer_lag = cuint(cfg_getint(s, PARAM_TIMER_LAG_NAME));
+        overload.min_cps = cuint(cfg_getint(s, PARAM_MIN_CPS_NAME));
+        overload.decrease_percent = cuint(cfg_getint(s, PARAM_DECREASE_PERCENT_NAME));
+        overload.increase_cps = cuint(cfg_getint(s, PARAM_INCREASE_CPS_NAME));
+        overload.err_code = cuint(cfg_getint(s, PARAM_CODE_NAME));
+        overload.err_reason = cfg_getstr(s, PARAM_REASON_NAME);
+        overload.retry_after = cuint(cfg_getint(s, PARAM_RETRY_AFTER_NAME));
+        if(!overload.sample_interval || overload.decrease_percent > 100) {
+            ERROR("invalid overload_control: sample_interval must be positive, "
+                  "decrease_percent must be in range from 0 to 100\n");
+            return -1;
+        }
+    }
+
     WITH_SECTION(SECCTION_SDM_NAME) {
         config->shutdown_mode_err_code = cuint(cfg_getint(s, PARAM_CODE_NAME));
         config->shutdown_mode_err_reason = cfg_getstr(s, PARAM_REASON_NAME);
@@ -1100,6 +1208,30 @@ int AmLcConfig::readGeneral(cfg_t* cfg, ConfigContainer* config)
     config->rtp_recv_threads = cint(cfg_getint(gen, PARAM_RTP_RECEIVERS_NAME));
     config->sip_tcp_server_threads = cint(cfg_getint(gen, PARAM_SIP_TCP_SERVERS_NAME));
     config->sip_udp_server_threads = cint(cfg_getint(gen, PARAM_SIP_UDP_SERVERS_NAME));
+
+    WITH_SECTION(SECTION_CPU_PLACEMENT_NAME) {
+        CpuPlacementConfig &placement = config->cpu_placement;
+        CpuPlacementConfig::str2policy(cfg_getstr(s, PARAM_POLICY_NAME), placement.policy);
+        parse_cpu_list(cfg_getstr(s, PARAM_MEDIA_CPUS_NAME), placement.role_cpus[CPU_ROLE_MEDIA]);
+        parse_cpu_list(cfg_getstr(s, PARAM_RTP_CPUS_NAME), placement.role_cpus[CPU_ROLE_RTP]);
+        parse_cpu_list(cfg_getstr(s, PARAM_SESSION_CPUS_NAME), placement.role_cpus[CPU_ROLE_SESSION]);
+        parse_cpu_list(cfg_getstr(s, PARAM_SIP_CPUS_NAME), placement.role_cpus[CPU_ROLE_SIP]);
+        placement.media_realtime = cfg_getbool(s, PARAM_MEDIA_REALTIME_NAME);
+        placement.media_realtime_priority = cint(cfg_getint(s, PARAM_MEDIA_RT_PRIORITY_NAME));
+        if(placement.media_realtime_priority < sched_get_priority_min(SCHED_FIFO) ||
+           placement.media_realtime_priority > sched_get_priority_max(SCHED_FIFO))
+        {
+            ERROR("invalid media_realtime_priority value specified."
+                  "it must be in range from %d to %d\n",
+                  sched_get_priority_min(SCHED_FIFO), sched_get_priority_max(SCHED_FIFO));
+            return -1;
+        }
+    }
+    config->cpu_placement.role_threads[CPU_ROLE_MEDIA] = cuint(config->media_proc_threads);
+    config->cpu_placement.role_threads[CPU_ROLE_RTP] = cuint(config->rtp_recv_threads);
+    config->cpu_placement.role_threads[CPU_ROLE_SESSION] = cuint(config->session_proc_threads);
+    config->cpu_placement.role_threads[CPU_ROLE_SIP] =
+        cuint(config->sip_udp_server_threads + config->sip_tcp_server_threads);
     config->outbound_proxy = cfg_getstr(gen, PARAM_OUTBOUND_PROXY_NAME);
     config->options_transcoder_out_stats_hdr = cfg_getstr(gen, PARAM_OPT_TRANSCODE_OUT_NAME);
     config->options_transcoder_in_stats_hdr = cfg_getstr(gen, PARAM_OPT_TRANSCODE_IN_NAME);
@@ -1681,7 +1813,7 @@ IP_info* AmLcConfig::readInterface(cfg_t* cfg, const std::string& if_name, Addre
 
         if(cfg_size(cfg, SECTION_ORIGACL_NAME)) {
             cfg_t* acl = cfg_getsec(cfg, SECTION_ORIGACL_NAME);
-            if(readAcl(acl, sinfo->acls.inv, if_name)) {
+            if(readAcl(acl, sinfo->acls.inv, if_name, "sip_invite_acl")) {
                  ERROR("error parsing invite acl for interface: %s",if_name.c_str());
                  return nullptr;
             }
@@ -1689,7 +1821,7 @@ IP_info* AmLcConfig::readInterface(cfg_t* cfg, const std::string& if_name, Addre
 
         if(cfg_size(cfg, SECTION_OPT_NAME)) {
             cfg_t* opt_acl = cfg_getsec(cfg, SECTION_OPT_NAME);
-            if(readAcl(opt_acl, sinfo->acls.opt, if_name)) {
+            if(readAcl(opt_acl, sinfo->acls.opt, if_name, "sip_options_acl")) {
                 ERROR("error parsing options acl for interface: %s",if_name.c_str());
                 return nullptr;
             }
@@ -1697,7 +1829,7 @@ IP_info* AmLcConfig::readInterface(cfg_t* cfg, const std::string& if_name, Addre
 
         if(cfg_size(cfg, SECTION_REG_ACL_NAME)) {
             cfg_t* reg_acl = cfg_getsec(cfg, SECTION_REG_ACL_NAME);
-            if(readAcl(reg_acl, sinfo->acls.reg, if_name)) {
+            if(readAcl(reg_acl, sinfo->acls.reg, if_name, "sip_register_acl")) {
                 ERROR("error parsing register acl for interface: %s",if_name.c_str());
                 return nullptr;
             }
@@ -1710,6 +1842,19 @@ IP_info* AmLcConfig::readInterface(cfg_t* cfg, const std::string& if_name, Addre
         stinfo->tcp_idle_timeout = cuint(cfg_getint(cfg, PARAM_IDLE_TIMEOUT_NAME));
     }
 
+    //TCP/TLS send queue watermarks
+    if(stinfo && !wsinfo) {
+        stinfo->tcp_send_queue_high = cuint(cfg_getint(cfg, PARAM_SEND_QUEUE_HIGH_NAME));
+        stinfo->tcp_send_queue_low = cuint(cfg_getint(cfg, PARAM_SEND_QUEUE_LOW_NAME));
+        if(!stinfo->tcp_send_queue_low)
+            stinfo->tcp_send_queue_low = stinfo->tcp_send_queue_high / 2;
+        if(stinfo->tcp_send_queue_low > stinfo->tcp_send_queue_high) {
+            ERROR("%s must not be greater than %s for interface: %s",
+                  PARAM_SEND_QUEUE_LOW_NAME, PARAM_SEND_QUEUE_HIGH_NAME, if_name.c_str());
+            return nullptr;
+        }
+    }
+
     //TLS specific opts
     if(stlinfo) {
         cfg_t* server = cfg_getsec(cfg, SECTION_SERVER_NAME);
@@ -1772,18 +1917,21 @@ IP_info* AmLcConfig::readInterface(cfg_t* cfg, const std::string& if_name, Addre
     return info;
 }
 
-int AmLcConfig::readAcl(cfg_t* cfg, trsp_acl& acl, const std::string& if_name)
+int AmLcConfig::readAcl(cfg_t* cfg, trsp_acl& acl, const std::string& if_name,
+                        const std::string& key_class)
 {
     int networks = 0;
+    vector<AmSubnet> nets;
     for(unsigned int j = 0; j < cfg_size(cfg, PARAM_WHITELIST_NAME); j++) {
         AmSubnet net;
         std::string host = cfg_getnstr(cfg, PARAM_WHITELIST_NAME, j);
         if(!net.parse(host)) {
             return 1;
         }
-        acl.add_network(net);
+        nets.push_back(net);
         networks++;
     }
+    acl.set_networks(nets);
 
     DBG("parsed %d networks from key %s",networks,if_name.c_str());
 
@@ -1797,6 +1945,15 @@ int AmLcConfig::readAcl(cfg_t* cfg, trsp_acl& acl, const std::string& if_name)
         return 1;
     }
 
+    long rate = cfg_getint(cfg, PARAM_RATE_LIMIT_NAME),
+         burst = cfg_getint(cfg, PARAM_RATE_BURST_NAME);
+    if(rate < 0 || burst < 0) {
+        ERROR("negative %s rate limit for interface %s",
+              key_class.c_str(), if_name.c_str());
+        return 1;
+    }
+    acl.set_rate_limit(cuint(rate), cuint(burst), key_class);
+
     return 0;
 }
 
@@ -1931,14 +2088,18 @@ void AmLcConfig::dump_Ifs(ConfigContainer* config)
         for(; it != it_ref.proto_info.end(); it++) {
             if((*it)->type == SIP_info::TCP) {
                 SIP_TCP_info* info = SIP_TCP_info::toSIP_TCP(*it);
-                INFO("\t\tTCP %u/%u",
+                INFO("\t\tTCP %u/%u send queue %u/%u",
                     info->tcp_connect_timeout,
-                    info->tcp_idle_timeout);
+                    info->tcp_idle_timeout,
+                    info->tcp_send_queue_high,
+                    info->tcp_send_queue_low);
             } else if((*it)->type == SIP_info::TLS) {
                 SIP_TLS_info* info = SIP_TLS_info::toSIP_TLS(*it);
-                INFO("\t\tTLS %u/%u",
+                INFO("\t\tTLS %u/%u send queue %u/%u",
                     info->tcp_connect_timeout,
-                    info->tcp_idle_timeout);
+                    info->tcp_idle_timeout,
+                    info->tcp_send_queue_high,
+                    info->tcp_send_queue_low);
 
                 info->client_settings.dump("client");
                 info->server_settings.dump("server");
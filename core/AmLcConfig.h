@@ -8,6 +8,8 @@
 #include "Am100rel.h"
 #include "AmAudio.h"
 #include "AmUtils.h"
+#include "AmCpuPlacement.h"
+#include "AmOverloadControl.h"
 
 #define VALUE_LOG_NO                 "no"
 #define VALUE_LOG_DEBUG              "debug"
@@ -80,6 +82,7 @@ struct ConfigContainer
     int rtp_recv_threads;
     int sip_tcp_server_threads;
     int sip_udp_server_threads;
+    CpuPlacementConfig cpu_placement;
     std::string outbound_proxy;
     bool force_outbound_proxy;
     bool force_outbound_if;
@@ -109,6 +112,7 @@ struct ConfigContainer
     bool shutdown_mode_allow_uac;
     unsigned int cps_limit_err_code;
     std::string cps_limit_err_reason;
+    OverloadControlConfig overload_control;
     bool enable_srtp;
     bool enable_ice;
     bool enable_rtsp;
@@ -194,7 +198,8 @@ protected:
     int readRoutings(cfg_t* cfg, ConfigContainer* config);
     int checkSipInterfaces(ConfigContainer* config);
     IP_info* readInterface(cfg_t* cfg, const std::string& if_name, AddressType ip_type);
-    int readAcl(cfg_t* cfg, trsp_acl& acl, const std::string& if_name);
+    int readAcl(cfg_t* cfg, trsp_acl& acl, const std::string& if_name,
+                const std::string& key_class);
 
     bool fillSysIntfList(ConfigContainer* config);
     void fillMissingLocalSIPIPfromSysIntfs(ConfigContainer* config);
@@ -27,6 +27,7 @@
 #include "AmSession.h"
 #include "AmRtpStream.h"
 #include "AmUtils.h"
+#include "AmCpuPlacement.h"
 
 #include <assert.h>
 #include <sys/time.h>
@@ -95,7 +96,7 @@ void AmMediaProcessor::init()
     DBG("Starting %u MediaProcessorThreads.", num_threads);
     threads = new AmMediaProcessorThread*[num_threads];
     for (unsigned int i=0;i<num_threads;i++) {
-        threads[i] = new AmMediaProcessorThread();
+        threads[i] = new AmMediaProcessorThread(i);
         threads[i]->start();
     }
 }
@@ -343,10 +344,20 @@ void AmMediaProcessor::getInfo(AmArg& ret)
     group_mut.unlock();
 }
 
+unsigned long long AmMediaProcessor::takeMaxTickLateness()
+{
+    unsigned long long ret = 0;
+    for (unsigned int i=0;i<num_threads;i++) {
+        unsigned long long lateness = threads[i]->takeMaxTickLateness();
+        if(lateness > ret) ret = lateness;
+    }
+    return ret;
+}
+
 /* the actual media processing thread */
 
-AmMediaProcessorThread::AmMediaProcessorThread()
-  : events(this), stop_requested(false)
+AmMediaProcessorThread::AmMediaProcessorThread(unsigned int idx)
+  : events(this), idx(idx), max_tick_lateness_us(0), stop_requested(false)
 {}
 
 AmMediaProcessorThread::~AmMediaProcessorThread()
@@ -361,6 +372,7 @@ void AmMediaProcessorThread::on_stop()
 void AmMediaProcessorThread::run()
 {
     setThreadName("media-proc");
+    AmCpuPlacement::instance()->place(this, "media-proc", CPU_ROLE_MEDIA, static_cast<int>(idx));
 
     stop_requested = false;
     struct timeval now,next_tick,diff,tick;
@@ -386,6 +398,11 @@ void AmMediaProcessorThread::run()
 
             if(sdiff.tv_nsec > 2000000) // 2 ms
             nanosleep(&sdiff,&rem);
+        } else {
+            timersub(&now,&next_tick,&diff);
+            unsigned long long lateness = diff.tv_sec*1000000ULL + diff.tv_usec;
+            if(lateness > max_tick_lateness_us.load(std::memory_order_relaxed))
+                max_tick_lateness_us.store(lateness, std::memory_order_relaxed);
         }
 
         processAudio(ts);
@@ -408,8 +425,11 @@ void AmMediaProcessorThread::processDtmfEvents()
 
 void AmMediaProcessorThread::processAudio(unsigned long long ts)
 {
+    // audio of one session at a time uses the thread scratch space
+
     // receiving
     for(auto &s : sessions) {
+        AmAudioScratch::Scope scratch;
         if(s->readStreams(ts, buffer) < 0) {
             DBG("readStreams for media session %p returned value < 0",to_void(s));
             postRequest(new SchedRequest(AmMediaProcessor::ClearSession, s));
@@ -418,6 +438,7 @@ void AmMediaProcessorThread::processAudio(unsigned long long ts)
 
     // sending
     for(auto &s : sessions) {
+        AmAudioScratch::Scope scratch;
         if (s->writeStreams(ts, buffer) < 0) {
             DBG("writeStreams for media session %p returned value < 0",to_void(s));
             postRequest(new SchedRequest(AmMediaProcessor::ClearSession, s));
@@ -425,8 +446,10 @@ void AmMediaProcessorThread::processAudio(unsigned long long ts)
     }
 
     // process tail
-    for(auto &h : tail_handlers)
+    for(auto &h : tail_handlers) {
+        AmAudioScratch::Scope scratch;
         h->processMediaTail(ts);
+    }
 }
 
 void AmMediaProcessorThread::process(AmEvent* e)
@@ -511,6 +534,11 @@ unsigned int AmMediaProcessorThread::getLoad()
     return static_cast<unsigned int>(sessions.size());
 }
 
+unsigned long long AmMediaProcessorThread::takeMaxTickLateness()
+{
+    return max_tick_lateness_us.exchange(0, std::memory_order_relaxed);
+}
+
 void AmMediaProcessorThread::getInfo(AmArg &ret)
 {
     ret.assertArray();
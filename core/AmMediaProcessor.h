@@ -34,6 +34,7 @@
 #include <set>
 using std::set;
 #include <map>
+#include <atomic>
 
 struct SchedRequest;
 struct SchedTailRequest;
@@ -197,6 +198,10 @@ class AmMediaProcessorThread :
   set<AmMediaSession*> sessions;
   set<AmMediaTailHandler *> tail_handlers;
   unsigned long long ts;
+  /** thread index, defines the cpu placement */
+  unsigned int idx;
+  /** max delay of the tick start since the last takeMaxTickLateness() */
+  std::atomic<unsigned long long> max_tick_lateness_us;
 
   void processAudio(unsigned long long ts);
   /**
@@ -212,13 +217,15 @@ class AmMediaProcessorThread :
   // AmEventHandler interface
   void process(AmEvent* e);
 public:
-  AmMediaProcessorThread();
+  AmMediaProcessorThread(unsigned int idx);
   ~AmMediaProcessorThread();
 
   inline void postRequest(SchedRequest* sr);
   inline void postTailRequest(SchedTailRequest* sr);
 
   unsigned int getLoad();
+  /** @return max tick lateness in microseconds and reset it */
+  unsigned long long takeMaxTickLateness();
   void getInfo(AmArg &ret);
 };
 
@@ -285,6 +292,8 @@ public:
   static void dispose();
 
   void getInfo(AmArg& ret);
+  /** @return max tick lateness of all threads in microseconds and reset it */
+  unsigned long long takeMaxTickLateness();
 };
 
 
@@ -16,6 +16,7 @@
 
 #include <rtp/rtp.h>
 #include <sys/ioctl.h>
+#include <typeinfo>
 
 #define RTCP_PAYLOAD_MIN 72
 #define RTCP_PAYLOAD_MAX 76
@@ -949,6 +950,37 @@ ssize_t AmMediaTransport::send(sockaddr_storage* raddr, unsigned char* buf, int
     return err;
 }
 
+ssize_t AmMediaTransport::sendRelayed(AmRtpPacket* packet, sockaddr_storage* raddr)
+{
+    AmStreamConnection* conn = cur_rtp_conn;
+    if(!conn || typeid(*conn) != typeid(AmRtpConnection) || logger || sensor)
+        return RELAY_NOT_SENT;
+
+    MEDIA_info* iface = AmConfig.media_ifs[static_cast<size_t>(l_if)]
+        .proto_info[static_cast<size_t>(lproto_id)];
+    if(iface->net_if_idx &&
+       ((iface->sig_sock_opts&trsp_socket::use_raw_sockets) || AmConfig.force_outbound_if))
+        return RELAY_NOT_SENT;
+
+    conn->getRAddr(raddr);
+
+    ssize_t err = ::sendto(
+        l_sd, packet->getBuffer(), packet->getBufferSize(), 0,
+        reinterpret_cast<const struct sockaddr*>(raddr), SA_len(raddr));
+
+    if(err == -1) {
+        CLASS_ERROR("sendto(%d,%p,%u,0,%p,%ld): errno: %d, raddr:'%s', relayed",
+            l_sd,
+            static_cast<void *>(packet->getBuffer()),packet->getBufferSize(),
+            static_cast<void *>(raddr),SA_len(raddr),
+            errno, get_addr_str(raddr).data());
+        return -1;
+    }
+
+    stream->update_sender_stats(*packet);
+    return err;
+}
+
 int AmMediaTransport::sendmsg(unsigned char* buf, int size)
 {
     MEDIA_info &iface = AmConfig.getMediaProtoInfo(l_if, lproto_id);
@@ -24,6 +24,9 @@ class AmRtpPacket;
 #define RTCP_TRANSPORT      2
 #define FAX_TRANSPORT       3
 
+/** returned by sendRelayed() if the packet must be sent with send() */
+#define RELAY_NOT_SENT      -2
+
 class AmMediaTransport
   : public AmObject,
     public AmRtpSession
@@ -116,6 +119,15 @@ public:
     ssize_t send(sockaddr_storage* raddr, unsigned char* buf, int size, AmStreamConnection::ConnectionType type);
     int sendmsg(unsigned char* buf, int size);
 
+    /**
+    * Relay fast path: send the received RTP packet as is
+    * with sendto() to the plain RTP connection peer.
+    * @param raddr [out] address the packet was sent to.
+    * @return RELAY_NOT_SENT if the connection is not plain RTP (SRTP, ZRTP, ICE)
+    *         or packets are logged or sent through raw sockets or forced interface.
+    */
+    ssize_t sendRelayed(AmRtpPacket* packet, sockaddr_storage* raddr);
+
     void allowStunConnection(sockaddr_storage* remote_addr, int priority);
     void dtlsSessionActivated(uint16_t srtp_profile, const vector<uint8_t>& local_key, const vector<uint8_t>& remote_key);
     void onRtpPacket(AmRtpPacket* packet, AmStreamConnection* conn);
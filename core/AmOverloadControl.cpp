@@ -0,0 +1,257 @@
+/*
+ * This file is part of SEMS, a free SIP media server.
+ *
+ * SEMS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * For a license to use the sems software under conditions
+ * other than those described here, or to purchase support for this
+ * software, please contact iptel.org by e-mail at the following addresses:
+ *    info@iptel.org
+ *
+ * SEMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "AmOverloadControl.h"
+#include "AmLcConfig.h"
+#include "AmMediaProcessor.h"
+#include "AmRtpReceiver.h"
+#include "AmAppTimer.h"
+#include "AmSession.h"
+#include "sip/wheeltimer.h"
+#include "log.h"
+
+#include <sys/time.h>
+
+OverloadControlConfig::OverloadControlConfig()
+  : enabled(false),
+    sample_interval(1000),
+    media_tick_lateness(20),
+    session_queue_depth(10000),
+    rtp_drop_rate(0),
+    timer_lag(100),
+    min_cps(1),
+    decrease_percent(25),
+    increase_cps(5),
+    err_code(503),
+    err_reason("Server overload"),
+    retry_after(5)
+{}
+
+OverloadSample::OverloadSample()
+  : media_tick_lateness_us(0),
+    session_queue_depth(0),
+    rtp_drops(0),
+    timer_lag_us(0)
+{}
+
+AmOverloadController::AmOverloadController(const OverloadControlConfig &cfg,
+                                           unsigned long long now_ms)
+  : cfg(cfg),
+    state(NORMAL),
+    limit(0),
+    tokens(0),
+    last_refill_ms(now_ms),
+    last_sample_ms(now_ms),
+    admitted(0),
+    rejected(0),
+    admitted_cps(0),
+    rtp_drop_rate(0),
+    overload_signal(nullptr)
+{}
+
+bool AmOverloadController::sampleDue(unsigned long long now_ms) const
+{
+    return now_ms >= last_sample_ms + cfg.sample_interval;
+}
+
+void AmOverloadController::onSample(const OverloadSample &sample, unsigned long long now_ms)
+{
+    unsigned long long elapsed = now_ms > last_sample_ms ? now_ms - last_sample_ms : 1;
+
+    admitted_cps = admitted * 1000.0 / elapsed;
+    rtp_drop_rate = sample.rtp_drops * 1000.0 / elapsed;
+    last_sample = sample;
+
+    overload_signal = nullptr;
+    if(cfg.media_tick_lateness &&
+       sample.media_tick_lateness_us > cfg.media_tick_lateness * 1000ULL)
+    {
+        overload_signal = "media_tick_lateness";
+    } else if(cfg.session_queue_depth &&
+              sample.session_queue_depth > cfg.session_queue_depth)
+    {
+        overload_signal = "session_queue_depth";
+    } else if(cfg.rtp_drop_rate && rtp_drop_rate > cfg.rtp_drop_rate) {
+        overload_signal = "rtp_drop_rate";
+    } else if(cfg.timer_lag && sample.timer_lag_us > cfg.timer_lag * 1000ULL) {
+        overload_signal = "timer_lag";
+    }
+
+    if(overload_signal) {
+        if(state == NORMAL) {
+            // start from the actual rate
+            limit = admitted_cps;
+            tokens = 0;
+            last_refill_ms = now_ms;
+            WARN("overload detected by %s. limiting CPS", overload_signal);
+        }
+        limit = limit * (100 - cfg.decrease_percent) / 100;
+        if(limit < cfg.min_cps) limit = cfg.min_cps;
+        state = OVERLOAD;
+    } else if(state != NORMAL) {
+        if(!rejected) {
+            INFO("overload is over. CPS limit %u lifted", getLimit());
+            state = NORMAL;
+            limit = 0;
+        } else {
+            limit += cfg.increase_cps;
+            state = RECOVERY;
+        }
+    }
+
+    admitted = 0;
+    rejected = 0;
+    last_sample_ms = now_ms;
+}
+
+bool AmOverloadController::admit(unsigned long long now_ms)
+{
+    if(state == NORMAL) {
+        admitted++;
+        return true;
+    }
+
+    if(now_ms > last_refill_ms) {
+        tokens += (now_ms - last_refill_ms) * limit / 1000;
+        last_refill_ms = now_ms;
+    }
+
+    // allow bursts up to one second of the limit
+    double burst = limit < 1 ? 1 : limit;
+    if(tokens > burst) tokens = burst;
+
+    if(tokens < 1) {
+        rejected++;
+        return false;
+    }
+
+    tokens -= 1;
+    admitted++;
+    return true;
+}
+
+unsigned int AmOverloadController::getLimit() const
+{
+    return state == NORMAL ? 0 : static_cast<unsigned int>(limit);
+}
+
+const char *AmOverloadController::state2str(State state)
+{
+    switch(state) {
+    case NORMAL: return "normal";
+    case OVERLOAD: return "overload";
+    case RECOVERY: return "recovery";
+    }
+    return "unknown";
+}
+
+void AmOverloadController::getInfo(AmArg &ret) const
+{
+    ret["state"] = state2str(state);
+    ret["cps_limit"] = static_cast<int>(getLimit());
+    ret["admitted_cps"] = admitted_cps;
+    ret["overload_signal"] = overload_signal ? overload_signal : "";
+
+    AmArg &signals = ret["signals"];
+    signals["media_tick_lateness_us"] = static_cast<long long>(last_sample.media_tick_lateness_us);
+    signals["session_queue_depth"] = static_cast<long long>(last_sample.session_queue_depth);
+    signals["rtp_drop_rate"] = rtp_drop_rate;
+    signals["timer_lag_us"] = static_cast<long long>(last_sample.timer_lag_us);
+}
+
+static unsigned long long now_ms()
+{
+    struct timeval now;
+    gettimeofday(&now, nullptr);
+    return now.tv_sec * 1000ULL + now.tv_usec / 1000;
+}
+
+_AmOverloadControl::_AmOverloadControl()
+  : controller(AmConfig.overload_control, now_ms()),
+    last_rtp_drops(0),
+    stat_state(stat_group(Gauge, "core", "overload_state").addAtomicCounter()),
+    stat_limit(stat_group(Gauge, "core", "overload_cps_limit").addAtomicCounter()),
+    stat_rejects(stat_group(Counter, "core", "overload_rejects").addAtomicCounter()),
+    stat_media_tick_lateness(stat_group(Gauge, "core", "overload_media_tick_lateness_us")
+                             .addAtomicCounter()),
+    stat_session_queue_depth(stat_group(Gauge, "core", "overload_session_queue_depth")
+                             .addAtomicCounter()),
+    stat_timer_lag(stat_group(Gauge, "core", "overload_timer_lag_us").addAtomicCounter())
+{}
+
+void _AmOverloadControl::sample(unsigned long long now)
+{
+    OverloadSample s;
+
+    s.media_tick_lateness_us = AmMediaProcessor::instance()->takeMaxTickLateness();
+    s.session_queue_depth = AmSession::getPendingEventsNum();
+
+    unsigned long long drops = AmRtpReceiver::instance()->get_drop_packets();
+    s.rtp_drops = drops - last_rtp_drops;
+    last_rtp_drops = drops;
+
+    s.timer_lag_us = wheeltimer::instance()->take_max_lag();
+    unsigned long long app_timer_lag = AmAppTimer::instance()->take_max_lag();
+    if(app_timer_lag > s.timer_lag_us) s.timer_lag_us = app_timer_lag;
+
+    controller.onSample(s, now);
+
+    stat_state.set(controller.getState());
+    stat_limit.set(controller.getLimit());
+    stat_media_tick_lateness.set(s.media_tick_lateness_us);
+    stat_session_queue_depth.set(s.session_queue_depth);
+    stat_timer_lag.set(s.timer_lag_us);
+}
+
+bool _AmOverloadControl::admit()
+{
+    if(!AmConfig.overload_control.enabled)
+        return true;
+
+    unsigned long long now = now_ms();
+
+    AmLock l(mut);
+
+    if(controller.sampleDue(now))
+        sample(now);
+
+    if(controller.admit(now))
+        return true;
+
+    stat_rejects.inc();
+    return false;
+}
+
+void _AmOverloadControl::getInfo(AmArg &ret)
+{
+    unsigned long long now = now_ms();
+
+    AmLock l(mut);
+
+    ret["enabled"] = AmConfig.overload_control.enabled;
+    if(AmConfig.overload_control.enabled && controller.sampleDue(now))
+        sample(now);
+
+    controller.getInfo(ret);
+    ret["rejects"] = static_cast<long long>(stat_rejects.get());
+}
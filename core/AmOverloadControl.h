@@ -0,0 +1,169 @@
+/*
+ * This file is part of SEMS, a free SIP media server.
+ *
+ * SEMS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * For a license to use the sems software under conditions
+ * other than those described here, or to purchase support for this
+ * software, please contact iptel.org by e-mail at the following addresses:
+ *    info@iptel.org
+ *
+ * SEMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/** @file AmOverloadControl.h */
+#ifndef _AMOVERLOADCONTROL_H
+#define _AMOVERLOADCONTROL_H
+
+#include "AmThread.h"
+#include "AmArg.h"
+#include "AmStatistics.h"
+#include "singleton.h"
+
+#include <string>
+
+struct OverloadControlConfig
+{
+    bool enabled;
+    /** ms between the health samples */
+    unsigned int sample_interval;
+
+    /* overload thresholds, 0 disables the signal */
+    /** ms, max delay of the media processor tick */
+    unsigned int media_tick_lateness;
+    /** events waiting in the session queues */
+    unsigned int session_queue_depth;
+    /** RTP packets dropped per second */
+    unsigned int rtp_drop_rate;
+    /** ms, max delay of the SIP timer tick */
+    unsigned int timer_lag;
+
+    /** lowest CPS limit */
+    unsigned int min_cps;
+    /** limit decrease on every overloaded sample */
+    unsigned int decrease_percent;
+    /** limit increase on every healthy sample */
+    unsigned int increase_cps;
+
+    unsigned int err_code;
+    std::string err_reason;
+    /** seconds for the Retry-After header, 0 to omit it */
+    unsigned int retry_after;
+
+    OverloadControlConfig();
+};
+
+/** pipeline health signals for one sample interval */
+struct OverloadSample
+{
+    unsigned long long media_tick_lateness_us;
+    unsigned long long session_queue_depth;
+    /** RTP packets dropped during the interval */
+    unsigned long long rtp_drops;
+    unsigned long long timer_lag_us;
+
+    OverloadSample();
+};
+
+/**
+ * \brief adaptive CPS limit
+ *
+ * every overloaded sample lowers the limit by decrease_percent
+ * (starting from the CPS admitted in the last interval),
+ * every healthy one raises it by increase_cps. the limit is lifted
+ * when nothing was rejected during a healthy interval.
+ * admission is a token bucket refilled with the limit rate.
+ * not thread safe.
+ */
+class AmOverloadController
+{
+  public:
+    enum State {
+        NORMAL = 0,
+        OVERLOAD,
+        RECOVERY
+    };
+
+  private:
+    const OverloadControlConfig &cfg;
+
+    State state;
+    double limit;
+    double tokens;
+    unsigned long long last_refill_ms;
+    unsigned long long last_sample_ms;
+
+    unsigned int admitted;
+    unsigned int rejected;
+    double admitted_cps;
+
+    OverloadSample last_sample;
+    double rtp_drop_rate;
+    /** signal which caused the last overloaded sample */
+    const char *overload_signal;
+
+  public:
+    AmOverloadController(const OverloadControlConfig &cfg, unsigned long long now_ms);
+
+    bool sampleDue(unsigned long long now_ms) const;
+    void onSample(const OverloadSample &sample, unsigned long long now_ms);
+    /** @return false if the request must be rejected */
+    bool admit(unsigned long long now_ms);
+
+    State getState() const { return state; }
+    /** @return 0 if not limited */
+    unsigned int getLimit() const;
+    static const char *state2str(State state);
+
+    void getInfo(AmArg &ret) const;
+};
+
+/**
+ * \brief admission control of the new sessions by the pipeline health
+ *
+ * samples media tick lateness, session event queues depth,
+ * RTP drops and SIP timer lag on admission checks and RPC calls,
+ * at most once per sample_interval.
+ *
+ * reports overload_state, overload_cps_limit, overload_rejects
+ * and the sampled signals. RTP drops are reported by media_acl_dropped.
+ */
+class _AmOverloadControl
+{
+    AmMutex mut;
+    AmOverloadController controller;
+    unsigned long long last_rtp_drops;
+
+    AtomicCounter &stat_state;
+    AtomicCounter &stat_limit;
+    AtomicCounter &stat_rejects;
+    AtomicCounter &stat_media_tick_lateness;
+    AtomicCounter &stat_session_queue_depth;
+    AtomicCounter &stat_timer_lag;
+
+    void sample(unsigned long long now_ms);
+
+  protected:
+    _AmOverloadControl();
+    virtual ~_AmOverloadControl() {}
+    void dispose() {}
+
+  public:
+    /** @return false if the new session must be rejected */
+    bool admit();
+
+    void getInfo(AmArg &ret);
+};
+
+typedef singleton<_AmOverloadControl> AmOverloadControl;
+
+#endif
@@ -85,6 +85,31 @@ int AmPlaylist::get(unsigned long long system_ts, unsigned char* buffer,
   return ret;
 }
 
+int AmPlaylist::getEncoded(unsigned long long system_ts, AmAudioFormat& rtp_fmt,
+			   unsigned char* buffer)
+{
+  int ret = 0;
+
+  cur_mut.lock();
+  updateCurrentItem();
+
+  while(cur_item &&
+	cur_item->play &&
+	(ret = cur_item->play->getEncoded(system_ts,rtp_fmt,
+					  buffer)) < 0) {
+
+    DBG("getEncoded: gotoNextItem");
+    gotoNextItem(true);
+  }
+
+  // silence and not pre-encoded items are played with get()
+  if(!cur_item || !cur_item->play)
+    ret = 0;
+
+  cur_mut.unlock();
+  return ret;
+}
+
 int AmPlaylist::put(unsigned long long system_ts, unsigned char* buffer, 
 		    int input_sample_rate, unsigned int size)
 {
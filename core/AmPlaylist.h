@@ -79,6 +79,9 @@ class AmPlaylist: public AmAudio
   int get(unsigned long long system_ts, unsigned char* buffer, 
 	  int output_sample_rate, unsigned int nb_samples);
 
+  int getEncoded(unsigned long long system_ts, AmAudioFormat& rtp_fmt,
+		 unsigned char* buffer);
+
   int put(unsigned long long system_ts, unsigned char* buffer, 
 	  int input_sample_rate, unsigned int size);
 	
@@ -0,0 +1,430 @@
+/*
+ * This file is part of SEMS, a free SIP media server.
+ *
+ * SEMS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * For a license to use the sems software under conditions
+ * other than those described here, or to purchase support for this
+ * software, please contact iptel.org by e-mail at the following addresses:
+ *    info@iptel.org
+ *
+ * SEMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "AmPromptCache.h"
+#include "AmStatistics.h"
+#include "log.h"
+
+#include <string.h>
+
+namespace {
+
+struct PromptCacheMetrics {
+  AtomicCounter &file_hits;
+  AtomicCounter &file_misses;
+  AtomicCounter &encoded_hits;
+  AtomicCounter &encoded_misses;
+  AtomicCounter &memory;
+
+  PromptCacheMetrics()
+    : file_hits(stat_group(Counter, "core", "prompt_cache_hits").addAtomicCounter()
+		.addLabel("type", "file")),
+      file_misses(stat_group(Counter, "core", "prompt_cache_misses").addAtomicCounter()
+		  .addLabel("type", "file")),
+      encoded_hits(stat_group(Counter, "core", "prompt_cache_hits").addAtomicCounter()
+		   .addLabel("type", "encoded")),
+      encoded_misses(stat_group(Counter, "core", "prompt_cache_misses").addAtomicCounter()
+		     .addLabel("type", "encoded")),
+      memory(stat_group(Gauge, "core", "prompt_cache_memory").addAtomicCounter())
+  {}
+};
+
+PromptCacheMetrics& metrics()
+{
+  static PromptCacheMetrics m;
+  return m;
+}
+
+/** format of the encoder, initialized as the stream format */
+class PromptEncoderFormat
+  : public AmAudioFormat
+{
+ public:
+  PromptEncoderFormat(const AmPromptFrames& f)
+    : AmAudioFormat(-1)
+  {
+    codec_id = f.codec_id;
+    rate = f.rate;
+    frame_size = f.frame_size;
+    frame_time = f.frameTime();
+    sdp_format_parameters = f.sdp_format_parameters;
+  }
+};
+
+/** collects the encoded frames */
+class PromptEncoder
+  : public AmAudio
+{
+  AmPromptFrames& f;
+
+ protected:
+  int read(unsigned int user_ts, unsigned int size) { return -1; }
+
+  int write(unsigned int user_ts, unsigned int size) {
+    unsigned char* p = samples;
+    f.data.insert(f.data.end(), p, p + size);
+    f.offsets.push_back(f.data.size());
+    return size;
+  }
+
+ public:
+  PromptEncoder(AmPromptFrames& f, AmAudioFormat* enc_fmt)
+    : AmAudio(enc_fmt), f(f)
+  {}
+};
+
+} // namespace
+
+AmPromptFrames::AmPromptFrames(AmAudioFormat& fmt)
+  : codec_id(fmt.getCodecId()),
+    rate(fmt.getRate()),
+    frame_size(fmt.getFrameSize()),
+    sdp_format_parameters(fmt.sdp_format_parameters),
+    state(Pending)
+{}
+
+bool AmPromptFrames::matches(AmAudioFormat& fmt) const
+{
+  return codec_id == fmt.getCodecId() &&
+    rate == fmt.getRate() &&
+    frame_size == fmt.getFrameSize() &&
+    sdp_format_parameters == fmt.sdp_format_parameters;
+}
+
+AmPromptCacheEntry::AmPromptCacheEntry()
+{}
+
+AmPromptCacheEntry::~AmPromptCacheEntry()
+{
+  size_t mem = file.getSize();
+  for (std::vector<std::shared_ptr<const AmPromptFrames> >::iterator it =
+	 frames.begin(); it != frames.end(); it++)
+    mem += (*it)->memoryUsage();
+  metrics().memory.dec(mem);
+}
+
+int AmPromptCacheEntry::load(const string& filename)
+{
+  int res = file.load(filename);
+  if (!res)
+    metrics().memory.inc(file.getSize());
+  return res;
+}
+
+bool AmPromptCacheEntry::encode(AmPromptFrames& f)
+{
+  if (!f.frameTime() || f.frame_size > PCM16_B2S(AUDIO_BUFFER_SIZE))
+    return false;
+
+  AmCachedAudioFile src(&file);
+  if (!src.is_good())
+    return false;
+
+  PromptEncoderFormat* enc_fmt = new PromptEncoderFormat(f);
+  PromptEncoder enc(f, enc_fmt);
+  if (!enc_fmt->getCodec())
+    return false;
+
+  // played as AmSession::writeStreams() plays the file
+  unsigned char buffer[AUDIO_BUFFER_SIZE];
+  unsigned long long ts = 0;
+  size_t max_frames = PROMPT_CACHE_MAX_ENCODED_MS / f.frameTime();
+
+  f.offsets.push_back(0);
+  for (;;) {
+    int got = src.get(ts, buffer, f.rate, f.frame_size);
+    if (got <= 0)
+      break;
+
+    // frames which are not sent (DTX) can not be replayed as they are
+    if (enc.put(ts, buffer, f.rate, got) <= 0)
+      return false;
+
+    if (f.count() > max_frames) {
+      DBG("prompt '%s' is too long to be pre-encoded",
+	  file.getFilename().c_str());
+      return false;
+    }
+    ts += f.frame_size * WALLCLOCK_RATE / f.rate;
+  }
+
+  f.data.shrink_to_fit();
+  f.offsets.shrink_to_fit();
+  return true;
+}
+
+void AmPromptCacheEntry::encodeFrames(AmPromptFrames& f)
+{
+  AmPromptFrames::State state = AmPromptFrames::Bad;
+  if (encode(f)) {
+    state = AmPromptFrames::Good;
+    DBG("prompt '%s' pre-encoded: codec %d, rate %u, %zu frames, %zu bytes",
+	file.getFilename().c_str(), f.codec_id, f.rate,
+	f.count(), f.data.size());
+  } else {
+    // remembered, so the session does not retry on every frame
+    DBG("prompt '%s' can not be pre-encoded with codec %d, rate %u",
+	file.getFilename().c_str(), f.codec_id, f.rate);
+    f.data.clear();
+    f.data.shrink_to_fit();
+    f.offsets.clear();
+    f.offsets.shrink_to_fit();
+  }
+
+  metrics().memory.inc(f.memoryUsage());
+  f.state.store(state, std::memory_order_release);
+}
+
+std::shared_ptr<const AmPromptFrames> AmPromptCacheEntry::getFrames(AmAudioFormat& fmt)
+{
+  AmLock l(frames_mut);
+
+  for (std::vector<std::shared_ptr<const AmPromptFrames> >::iterator it =
+	 frames.begin(); it != frames.end(); it++) {
+    if ((*it)->matches(fmt)) {
+      metrics().encoded_hits.inc();
+      return *it;
+    }
+  }
+
+  metrics().encoded_misses.inc();
+
+  std::shared_ptr<AmPromptFrames> f(new AmPromptFrames(fmt));
+  if (f->frameTime()) {
+    AmPromptCache::instance()->encode(shared_from_this(), f);
+  } else {
+    DBG("prompt '%s' can not be pre-encoded with codec %d, rate %u",
+	file.getFilename().c_str(), f->codec_id, f->rate);
+    f->state.store(AmPromptFrames::Bad, std::memory_order_release);
+  }
+
+  frames.push_back(f);
+  return f;
+}
+
+_AmPromptCache::_AmPromptCache()
+  : jobs_pending(false),
+    running(false),
+    stopping(false),
+    suspended(false)
+{}
+
+_AmPromptCache::~_AmPromptCache()
+{}
+
+void _AmPromptCache::dispose()
+{
+  stop(true);
+
+  // frames left pending are played from the file
+  AmLock l(jobs_mut);
+  jobs.clear();
+}
+
+void _AmPromptCache::run()
+{
+  setThreadName("prompt-cache");
+
+  for (;;) {
+    jobs_pending.wait_for();
+
+    EncodeJob job;
+    {
+      AmLock l(jobs_mut);
+      if (stopping)
+	break;
+      if (jobs.empty() || suspended) {
+	jobs_pending.set(false);
+	continue;
+      }
+      job = jobs.front();
+      jobs.pop_front();
+    }
+
+    job.entry->encodeFrames(*job.frames);
+  }
+}
+
+void _AmPromptCache::on_stop()
+{
+  AmLock l(jobs_mut);
+  stopping = true;
+  jobs_pending.set(true);
+}
+
+void _AmPromptCache::encode(const std::shared_ptr<AmPromptCacheEntry>& entry,
+			    const std::shared_ptr<AmPromptFrames>& frames)
+{
+  AmLock l(jobs_mut);
+  if (stopping)
+    return;
+
+  jobs.push_back(EncodeJob{entry, frames});
+  jobs_pending.set(true);
+
+  if (!running) {
+    running = true;
+    start();
+  }
+}
+
+void _AmPromptCache::suspend()
+{
+  AmLock l(jobs_mut);
+  suspended = true;
+}
+
+void _AmPromptCache::resume()
+{
+  AmLock l(jobs_mut);
+  suspended = false;
+  if (!jobs.empty())
+    jobs_pending.set(true);
+}
+
+void _AmPromptCache::purge()
+{
+  for (std::map<string, std::weak_ptr<AmPromptCacheEntry> >::iterator it =
+	 entries.begin(); it != entries.end();) {
+    if (it->second.expired())
+      entries.erase(it++);
+    else
+      it++;
+  }
+}
+
+std::shared_ptr<AmPromptCacheEntry> _AmPromptCache::get(const string& filename)
+{
+  AmLock l(entries_mut);
+
+  std::map<string, std::weak_ptr<AmPromptCacheEntry> >::iterator it =
+    entries.find(filename);
+  if (it != entries.end()) {
+    std::shared_ptr<AmPromptCacheEntry> entry = it->second.lock();
+    if (entry) {
+      metrics().file_hits.inc();
+      return entry;
+    }
+  }
+
+  metrics().file_misses.inc();
+
+  // misses are rare, the released entries are dropped here
+  purge();
+
+  std::shared_ptr<AmPromptCacheEntry> entry(new AmPromptCacheEntry());
+  if (entry->load(filename))
+    return NULL;
+
+  entries[filename] = entry;
+  return entry;
+}
+
+AmCachedPromptFile::AmCachedPromptFile(const std::shared_ptr<AmPromptCacheEntry>& entry)
+  : AmCachedAudioFile(entry->getFile()),
+    entry(entry),
+    frame_idx(0),
+    encoded(false)
+{}
+
+AmCachedPromptFile::~AmCachedPromptFile()
+{}
+
+unsigned int AmCachedPromptFile::getPlayedTime()
+{
+  if (encoded)
+    return frame_idx * frames->frameTime();
+
+  if (!fmt->getRate() || fpos < begin)
+    return 0;
+  return (unsigned long long)bytes2samples(fpos - begin) * 1000 / fmt->getRate();
+}
+
+void AmCachedPromptFile::setPlayedTime(unsigned int ms)
+{
+  if (encoded) {
+    unsigned int frame_time = frames->frameTime();
+    frame_idx = frame_time ? ms / frame_time : 0;
+    return;
+  }
+
+  fpos = begin + calcBytesToRead((unsigned long long)ms * fmt->getRate() / 1000);
+  if (fpos > cache->getSize())
+    fpos = cache->getSize();
+}
+
+int AmCachedPromptFile::get(unsigned long long system_ts, unsigned char* buffer,
+			    int output_sample_rate, unsigned int nb_samples)
+{
+  if (encoded) {
+    unsigned int ms = getPlayedTime();
+    encoded = false;
+    setPlayedTime(ms);
+  }
+
+  return AmCachedAudioFile::get(system_ts, buffer, output_sample_rate, nb_samples);
+}
+
+int AmCachedPromptFile::getEncoded(unsigned long long system_ts, AmAudioFormat& rtp_fmt,
+				   unsigned char* buffer)
+{
+  if (!is_good())
+    return 0;
+
+  if (!frames || !frames->matches(rtp_fmt)) {
+    // first frame or payload changed
+    unsigned int ms = getPlayedTime();
+    frames = entry->getFrames(rtp_fmt);
+    encoded = frames->good();
+    setPlayedTime(ms);
+  } else if (!encoded && frames->good()) {
+    // encoding finished
+    unsigned int ms = getPlayedTime();
+    encoded = true;
+    setPlayedTime(ms);
+  }
+
+  // played from the file while pending
+  if (!encoded)
+    return 0;
+
+  if (frame_idx >= frames->count()) {
+    if (!loop.get() || !frames->count())
+      return -2;
+    DBG("rewinding pre-encoded prompt...");
+    frame_idx = 0;
+  }
+
+  unsigned int offset = frames->offsets[frame_idx];
+  unsigned int size = frames->offsets[frame_idx + 1] - offset;
+  memcpy(buffer, frames->data.data() + offset, size);
+  frame_idx++;
+
+  return size;
+}
+
+void AmCachedPromptFile::rewind()
+{
+  AmCachedAudioFile::rewind();
+  frame_idx = 0;
+}
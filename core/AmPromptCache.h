@@ -0,0 +1,213 @@
+/*
+ * This file is part of SEMS, a free SIP media server.
+ *
+ * SEMS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * For a license to use the sems software under conditions
+ * other than those described here, or to purchase support for this
+ * software, please contact iptel.org by e-mail at the following addresses:
+ *    info@iptel.org
+ *
+ * SEMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/** @file AmPromptCache.h */
+#ifndef _AMPROMPTCACHE_H
+#define _AMPROMPTCACHE_H
+
+#include "AmCachedAudioFile.h"
+#include "AmThread.h"
+#include "singleton.h"
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/** longer prompts are played without pre-encoding */
+#define PROMPT_CACHE_MAX_ENCODED_MS 120000
+
+/**
+ * \brief prompt encoded for one payload format
+ *
+ * frames are encoded by the prompt cache thread like the session
+ * would encode them when playing the prompt, and are immutable
+ * once they are ready.
+ */
+struct AmPromptFrames
+{
+  enum State {
+    Pending = 0,
+    Good,
+    /** the prompt can not be pre-encoded for this format */
+    Bad
+  };
+
+  int codec_id;
+  unsigned int rate;
+  unsigned int frame_size;
+  string sdp_format_parameters;
+
+  std::atomic<int> state;
+
+  std::vector<unsigned char> data;
+  /** frame i is data[offsets[i]..offsets[i+1]) */
+  std::vector<unsigned int> offsets;
+
+  AmPromptFrames(AmAudioFormat& fmt);
+
+  bool matches(AmAudioFormat& fmt) const;
+
+  /** data and offsets must not be used before the frames are good */
+  bool ready() const { return state.load(std::memory_order_acquire) != Pending; }
+  bool good() const { return state.load(std::memory_order_acquire) == Good; }
+
+  size_t count() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+  /** @return 0 for the formats without rate */
+  unsigned int frameTime() const { return rate ? frame_size * 1000 / rate : 0; }
+  size_t memoryUsage() const { return data.capacity() + offsets.capacity() * sizeof(unsigned int); }
+};
+
+/**
+ * \brief prompt file loaded once by all users of the same file
+ *
+ * keeps the file in memory and the frames
+ * pre-encoded on the first playback with the payload format.
+ */
+class AmPromptCacheEntry
+  : public std::enable_shared_from_this<AmPromptCacheEntry>
+{
+  AmFileCache file;
+
+  AmMutex frames_mut;
+  std::vector<std::shared_ptr<const AmPromptFrames> > frames;
+
+  /** encode the whole prompt into f */
+  bool encode(AmPromptFrames& f);
+
+  friend class _AmPromptCache;
+  /** called by the prompt cache thread */
+  void encodeFrames(AmPromptFrames& f);
+
+ public:
+  AmPromptCacheEntry();
+  ~AmPromptCacheEntry();
+
+  /** @return 0 if everything's OK */
+  int load(const string& filename);
+
+  AmFileCache* getFile() { return &file; }
+
+  /**
+   * frames for the format, queued for encoding on the first call.
+   * frames are not ready until encoded, and are not good
+   * if the prompt can not be pre-encoded for the format
+   */
+  std::shared_ptr<const AmPromptFrames> getFrames(AmAudioFormat& fmt);
+};
+
+/**
+ * \brief global cache of the prompt files
+ *
+ * the same file is loaded only once for all prompt collections,
+ * it is released when no collection uses it anymore.
+ *
+ * the frames are encoded by the cache thread, started on the first
+ * encoding request, so the media processing is not blocked by encoding.
+ *
+ * reports file and encoded frames lookups (prompt_cache_hits/misses,
+ * label 'type') and memory used by the files and frames (prompt_cache_memory).
+ */
+class _AmPromptCache
+  : public AmThread
+{
+  std::map<string, std::weak_ptr<AmPromptCacheEntry> > entries;
+  AmMutex entries_mut;
+
+  struct EncodeJob {
+    std::shared_ptr<AmPromptCacheEntry> entry;
+    std::shared_ptr<AmPromptFrames> frames;
+  };
+  std::deque<EncodeJob> jobs;
+  AmMutex jobs_mut;
+  AmCondition<bool> jobs_pending;
+  bool running;
+  bool stopping;
+  bool suspended;
+
+  /** drop the entries released by all the users */
+  void purge();
+
+ protected:
+  _AmPromptCache();
+  ~_AmPromptCache();
+
+  void dispose();
+
+  void run();
+  void on_stop();
+
+ public:
+  /**
+   * get loaded prompt file
+   * @return NULL if file could not be loaded
+   */
+  std::shared_ptr<AmPromptCacheEntry> get(const string& filename);
+
+  /** queue the frames for encoding by the cache thread */
+  void encode(const std::shared_ptr<AmPromptCacheEntry>& entry,
+	      const std::shared_ptr<AmPromptFrames>& frames);
+
+  /** keep the queued frames pending until resume() */
+  void suspend();
+  void resume();
+};
+
+typedef singleton<_AmPromptCache> AmPromptCache;
+
+/**
+ * \brief cached prompt played from the pre-encoded frames if possible
+ *
+ * the session gets the frames with getEncoded() for its payload,
+ * and plays the file with get() otherwise (e.g. while recording
+ * or while the frames are being encoded).
+ * position is kept when switching between the two.
+ */
+class AmCachedPromptFile
+  : public AmCachedAudioFile
+{
+  std::shared_ptr<AmPromptCacheEntry> entry;
+  std::shared_ptr<const AmPromptFrames> frames;
+  size_t frame_idx;
+  /** last played with getEncoded() */
+  bool encoded;
+
+  /** @return ms played */
+  unsigned int getPlayedTime();
+  void setPlayedTime(unsigned int ms);
+
+ public:
+  AmCachedPromptFile(const std::shared_ptr<AmPromptCacheEntry>& entry);
+  ~AmCachedPromptFile();
+
+  int get(unsigned long long system_ts, unsigned char* buffer,
+	  int output_sample_rate, unsigned int nb_samples);
+
+  int getEncoded(unsigned long long system_ts, AmAudioFormat& rtp_fmt,
+		 unsigned char* buffer);
+
+  void rewind();
+};
+
+#endif //_AMPROMPTCACHE_H
@@ -92,15 +92,15 @@ AudioFileEntry::~AudioFileEntry() {
 }
 
 int AudioFileEntry::load(const std::string& filename) {
-  int res = cache.load(filename);
-  isopen = !res;
-  return res;
+  prompt = AmPromptCache::instance()->get(filename);
+  isopen = (prompt != NULL);
+  return isopen ? 0 : -1;
 }
 
 AmCachedAudioFile* AudioFileEntry::getAudio(){
   if (!isopen)
     return NULL;
-  return new AmCachedAudioFile(&cache);
+  return new AmCachedPromptFile(prompt);
 }
 
 bool AmPromptCollection::hasPrompt(const string& name) {
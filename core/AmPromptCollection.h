@@ -54,6 +54,7 @@
 using std::string;
 
 #include "AmCachedAudioFile.h"
+#include "AmPromptCache.h"
 #include "AmPlaylist.h"
 #include "AmConfigReader.h"
 
@@ -111,10 +112,13 @@ class AmPromptCollection {
 
 /** 
  *  \brief AmAudioFile with filename and open flag 
+ *
+ *  the file is shared with the other collections
+ *  through the AmPromptCache.
  */
 
 class AudioFileEntry : public AmAudioFile {
-  AmFileCache cache;
+  std::shared_ptr<AmPromptCacheEntry> prompt;
   bool isopen;
 
 public:
@@ -352,6 +352,40 @@ int AmRtpAudio::put(
                 static_cast<unsigned int>(s));
 }
 
+int AmRtpAudio::getEncodedFrom(
+    AmAudio* audio, unsigned long long system_ts,
+    unsigned char* buffer)
+{
+    if(!fmt.get() || record_enabled || stereo_record_enabled)
+        return 0;
+
+    // frame size may be changed by the codec init
+    if(!fmt->getCodec())
+        return 0;
+
+    int s = audio->getEncoded(system_ts, *fmt, buffer);
+    return s > 0 ? s : 0;
+}
+
+int AmRtpAudio::putEncoded(
+    unsigned long long system_ts, unsigned char* buffer,
+    unsigned int size)
+{
+    last_send_ts_i = true;
+    last_send_ts = system_ts;
+
+    if(!size) return 0;
+
+    if(mute || hold) return 0;
+
+    if(!fmt.get())
+      return 0;
+
+    update_user_ts(system_ts);
+
+    return send(tx_user_ts, buffer, size);
+}
+
 void AmRtpAudio::put_on_idle(unsigned long long system_ts)
 {
     //DBG("%llu put_on_idle",system_ts);
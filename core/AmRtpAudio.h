@@ -155,6 +155,18 @@ public:
   int put(unsigned long long system_ts, unsigned char* buffer, 
 	  int input_sample_rate, unsigned int size);
 
+  /**
+   * get the next frame of audio pre-encoded for the current payload
+   * (@see AmAudio::getEncoded). not used while the sent audio is recorded.
+   * @return # bytes, 0 if audio has to be played with get() and put()
+   */
+  int getEncodedFrom(AmAudio* audio, unsigned long long system_ts,
+		     unsigned char* buffer);
+
+  /** send the frame got with getEncodedFrom() */
+  int putEncoded(unsigned long long system_ts, unsigned char* buffer,
+		 unsigned int size);
+
   void put_on_idle(unsigned long long system_ts);
 
   void update_user_ts(unsigned long long system_ts);
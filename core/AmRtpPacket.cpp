@@ -63,13 +63,42 @@
 #define NTP32_TO_USEC_SCALING_FACTOR (1e6/65536.0)
 
 AmRtpPacket::AmRtpPacket()
-  : data_offset(0)
+  : buffer(inline_buffer),
+    large_buffer(NULL),
+    b_size(0),
+    data_offset(0),
+    d_size(0),
+    pool(NULL)
 {
 }
 
 AmRtpPacket::~AmRtpPacket()
 {
-    //
+    delete [] large_buffer;
+}
+
+bool AmRtpPacket::reserveBuffer(unsigned int size)
+{
+    if(size <= getBufferCapacity())
+        return true;
+
+    if(size > RTP_PACKET_BUF_SIZE)
+        return false;
+
+    large_buffer = new unsigned char[RTP_PACKET_BUF_SIZE];
+    memcpy(large_buffer, inline_buffer, b_size);
+    buffer = large_buffer;
+    return true;
+}
+
+void AmRtpPacket::releaseLargeBuffer()
+{
+    if(!large_buffer) return;
+
+    delete [] large_buffer;
+    large_buffer = NULL;
+    buffer = inline_buffer;
+    b_size = d_size = data_offset = 0;
 }
 
 void AmRtpPacket::setAddr(struct sockaddr_storage* a)
@@ -416,17 +445,16 @@ int AmRtpPacket::compile(unsigned char* data_buf, unsigned int size)
     assert(data_buf);
     assert(size);
 
-    d_size = size;
-    b_size = d_size + sizeof(rtp_hdr_t);
-    assert(b_size <= 4096);
-    rtp_hdr_t* hdr = (rtp_hdr_t*)buffer;
-
-    if(b_size>sizeof(buffer)) {
+    if(!reserveBuffer(size + sizeof(rtp_hdr_t))) {
         ERROR("builtin buffer size (%d) exceeded: %d",
-              (int)sizeof(buffer), b_size);
+              RTP_PACKET_BUF_SIZE, (int)(size + sizeof(rtp_hdr_t)));
         return -1;
     }
 
+    d_size = size;
+    b_size = d_size + sizeof(rtp_hdr_t);
+    rtp_hdr_t* hdr = (rtp_hdr_t*)buffer;
+
     memset(hdr,0,sizeof(rtp_hdr_t));
     hdr->version = RTP_VERSION;
     hdr->m = marker;
@@ -447,9 +475,9 @@ int AmRtpPacket::compile_raw(unsigned char* data_buf, unsigned int size)
     if ((!size) || (!data_buf))
         return -1;
 
-    if(size>sizeof(buffer)){
+    if(!reserveBuffer(size)){
         ERROR("builtin buffer size (%d) exceeded: %d",
-              (int)sizeof(buffer), size);
+              RTP_PACKET_BUF_SIZE, size);
         return -1;
     }
 
@@ -462,6 +490,12 @@ int AmRtpPacket::compile_raw(unsigned char* data_buf, unsigned int size)
 
 void AmRtpPacket::setBuffer(unsigned char* buf, unsigned int b)
 {
+    b_size = 0;
+    if(!reserveBuffer(b)) {
+        ERROR("builtin buffer size (%d) exceeded: %d",
+              RTP_PACKET_BUF_SIZE, b);
+        return;
+    }
     memcpy(buffer, buf, b);
     b_size = b;
 }
@@ -39,6 +39,7 @@
 
 class AmRtpPacketTracer;
 class AmSrtpConnection;
+class AmRtpPacketPool;
 class msg_logger;
 
 #define RTP_PACKET_PARSE_ERROR -1
@@ -46,6 +47,8 @@ class msg_logger;
 #define RTP_PACKET_PARSE_RTCP 1
 
 #define RTP_PACKET_BUF_SIZE 4096
+/** bigger packets use a buffer of RTP_PACKET_BUF_SIZE allocated when needed */
+#define RTP_PACKET_INLINE_BUF_SIZE 1536
 #define RTP_PACKET_TIMESTAMP_DATASIZE (CMSG_SPACE(sizeof(struct timeval)))
 
 //seconds between 1900-01-01 and 1970-01-01
@@ -55,7 +58,10 @@ class msg_logger;
 /** \brief RTP packet implementation */
 class AmRtpPacket
 {
-    unsigned char  buffer[RTP_PACKET_BUF_SIZE];
+    /** inline_buffer or large_buffer */
+    unsigned char* buffer;
+    unsigned char* large_buffer;
+    unsigned char  inline_buffer[RTP_PACKET_INLINE_BUF_SIZE];
     unsigned int   b_size;
 
     unsigned int   data_offset;
@@ -74,9 +80,15 @@ class AmRtpPacket
     struct sockaddr_storage laddr;
     struct timeval recv_time;
 
+    /** pool the packet is returned to, NULL if not pooled */
+    AmRtpPacketPool* pool;
+
     AmRtpPacket();
     ~AmRtpPacket();
 
+    AmRtpPacket(const AmRtpPacket&) = delete;
+    AmRtpPacket& operator=(const AmRtpPacket&) = delete;
+
     void setAddr(struct sockaddr_storage* a);
     void getAddr(struct sockaddr_storage* a);
     void setLocalAddr(struct sockaddr_storage* a);
@@ -105,6 +117,16 @@ class AmRtpPacket
 
     unsigned int   getBufferSize() const { return b_size; }
     unsigned char* getBuffer();
+
+    unsigned int   getBufferCapacity() const { return large_buffer ? RTP_PACKET_BUF_SIZE : RTP_PACKET_INLINE_BUF_SIZE; }
+    /**
+     * make the buffer hold at least size bytes, keeps the content
+     * @return false if size exceeds RTP_PACKET_BUF_SIZE
+     */
+    bool reserveBuffer(unsigned int size);
+    /** use the inline buffer again (content is lost) */
+    void releaseLargeBuffer();
+    bool hasLargeBuffer() const { return large_buffer != NULL; }
     void logReceived(msg_logger *logger, struct sockaddr_storage *laddr);
     void logSent(msg_logger *logger, struct sockaddr_storage *laddr);
 
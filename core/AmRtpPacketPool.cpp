@@ -0,0 +1,126 @@
+/*
+ * This file is part of SEMS, a free SIP media server.
+ *
+ * SEMS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * For a license to use the sems software under conditions
+ * other than those described here, or to purchase support for this
+ * software, please contact iptel.org by e-mail at the following addresses:
+ *    info@iptel.org
+ *
+ * SEMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "AmRtpPacketPool.h"
+#include "log.h"
+
+#include <assert.h>
+
+thread_local AmRtpPacketPool* AmRtpPacketPool::thread_pool = nullptr;
+AmMutex AmRtpPacketPool::pools_mut;
+std::vector<AmRtpPacketPool*> AmRtpPacketPool::pools;
+
+AmRtpPacketPool::AmRtpPacketPool(const string& name)
+  : name(name),
+    size(stat_group(Gauge, "core", "rtp_packet_pool_size").addAtomicCounter()
+         .addLabel("pool", name)),
+    used(stat_group(Gauge, "core", "rtp_packet_pool_used").addAtomicCounter()
+         .addLabel("pool", name)),
+    large_buffers(stat_group(Counter, "core", "rtp_packet_large_buffers").addAtomicCounter()
+         .addLabel("pool", name))
+{}
+
+AmRtpPacketPool::~AmRtpPacketPool()
+{
+    for(auto chunk : chunks)
+        delete [] chunk;
+}
+
+AmRtpPacket* AmRtpPacketPool::get()
+{
+    AmLock l(mut);
+
+    if(free_packets.empty()) {
+        AmRtpPacket* chunk = new (std::nothrow) AmRtpPacket[RTP_PACKET_POOL_CHUNK];
+        if(!chunk) {
+            ERROR("failed to allocate RTP packets for pool %s", name.c_str());
+            return nullptr;
+        }
+        chunks.push_back(chunk);
+        free_packets.reserve(chunks.size() * RTP_PACKET_POOL_CHUNK);
+        for(int i = RTP_PACKET_POOL_CHUNK - 1; i >= 0; i--) {
+            chunk[i].pool = this;
+            free_packets.push_back(&chunk[i]);
+        }
+        size.inc(RTP_PACKET_POOL_CHUNK);
+    }
+
+    AmRtpPacket* p = free_packets.back();
+    free_packets.pop_back();
+    used.inc();
+    return p;
+}
+
+void AmRtpPacketPool::put(AmRtpPacket* p)
+{
+    AmRtpPacketPool* pool = p->pool;
+    assert(pool);
+
+    // large packets are rare, do not keep their memory in the pool
+    if(p->hasLargeBuffer()) {
+        pool->large_buffers.inc();
+        p->releaseLargeBuffer();
+    }
+
+    AmLock l(pool->mut);
+    pool->free_packets.push_back(p);
+    pool->used.dec();
+}
+
+AmRtpPacketPool* AmRtpPacketPool::current()
+{
+    if(thread_pool)
+        return thread_pool;
+
+    static AmRtpPacketPool* default_pool = nullptr;
+    AmLock l(pools_mut);
+    if(!default_pool) {
+        default_pool = new AmRtpPacketPool("default");
+        pools.push_back(default_pool);
+    }
+    return default_pool;
+}
+
+void AmRtpPacketPool::setThreadPool(const string& name)
+{
+    AmLock l(pools_mut);
+    for(auto pool : pools) {
+        if(pool->name == name) {
+            thread_pool = pool;
+            return;
+        }
+    }
+    thread_pool = new AmRtpPacketPool(name);
+    pools.push_back(thread_pool);
+}
+
+void AmRtpPacketPool::getInfo(AmArg& ret)
+{
+    AmLock l(pools_mut);
+    for(auto pool : pools) {
+        AmArg& p = ret[pool->name];
+        p["size"] = static_cast<long long>(pool->size.get());
+        p["used"] = static_cast<long long>(pool->used.get());
+        p["large_buffers"] = static_cast<long long>(pool->large_buffers.get());
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ * This file is part of SEMS, a free SIP media server.
+ *
+ * SEMS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * For a license to use the sems software under conditions
+ * other than those described here, or to purchase support for this
+ * software, please contact iptel.org by e-mail at the following addresses:
+ *    info@iptel.org
+ *
+ * SEMS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/** @file AmRtpPacketPool.h */
+#ifndef _AMRTPPACKETPOOL_H
+#define _AMRTPPACKETPOOL_H
+
+#include "AmRtpPacket.h"
+#include "AmThread.h"
+#include "AmStatistics.h"
+#include "AmArg.h"
+
+#include <string>
+#include <vector>
+
+/** packets allocated at once when the pool is empty */
+#define RTP_PACKET_POOL_CHUNK 64
+
+/**
+ * \brief RTP packets shared by the streams
+ *
+ * every RTP receiver thread takes the packets from its own pool,
+ * other threads use the default pool. packets are returned
+ * to the pool they were taken from by any thread.
+ * pools grow in chunks and live until the process exits,
+ * as packets may still be returned at shutdown.
+ *
+ * reports rtp_packet_pool_size, rtp_packet_pool_used (label 'pool')
+ * and rtp_packet_large_buffers.
+ */
+class AmRtpPacketPool
+{
+    string name;
+
+    AmMutex mut;
+    std::vector<AmRtpPacket*> free_packets;
+    std::vector<AmRtpPacket*> chunks;
+
+    AtomicCounter& size;
+    AtomicCounter& used;
+    AtomicCounter& large_buffers;
+
+    static thread_local AmRtpPacketPool* thread_pool;
+
+    static AmMutex pools_mut;
+    static std::vector<AmRtpPacketPool*> pools;
+
+    AmRtpPacketPool(const string& name);
+    ~AmRtpPacketPool();
+
+  public:
+    AmRtpPacketPool(const AmRtpPacketPool&) = delete;
+    AmRtpPacketPool& operator=(const AmRtpPacketPool&) = delete;
+
+    /** @return NULL if the packet can not be allocated */
+    AmRtpPacket* get();
+    /** return packet taken with get() */
+    static void put(AmRtpPacket* p);
+
+    /** pool of the thread, or the default one */
+    static AmRtpPacketPool* current();
+    /** use the pool with the name in the calling thread, created on first use */
+    static void setThreadPool(const string& name);
+
+    /** size and occupancy of all pools */
+    static void getInfo(AmArg& ret);
+};
+
+#endif //_AMRTPPACKETPOOL_H
@@ -26,6 +26,9 @@
  */
 
 #include "AmRtpReceiver.h"
+#include "AmRtpPacketPool.h"
+#include "AmCpuPlacement.h"
+#include "AmUtils.h"
 #include "log.h"
 
 #include <errno.h>
@@ -103,7 +106,9 @@ _AmRtpReceiver::~_AmRtpReceiver()
 }
 
 AmRtpReceiverThread::AmRtpReceiverThread()
-  : poll_fd(-1) { }
+  : poll_fd(-1),
+    idx(0)
+{ }
 
 AmRtpReceiverThread::~AmRtpReceiverThread()
 {
@@ -146,6 +151,8 @@ void AmRtpReceiverThread::run()
   stream_remove_event.link(poll_fd);
 
   setThreadName("rtp-rx");
+  AmCpuPlacement::instance()->place(this, "rtp-rx", CPU_ROLE_RTP, static_cast<int>(idx));
+  AmRtpPacketPool::setThreadPool("rtp-rx-" + int2str(idx));
 
   bool stop = false;
   while(!stop){
@@ -235,8 +242,10 @@ void AmRtpReceiverThread::removeStream(int sd, int ctx_idx)
 
 void _AmRtpReceiver::start()
 {
-  for(unsigned int i=0; i<n_receivers; i++)
+  for(unsigned int i=0; i<n_receivers; i++) {
+    receivers[i].idx = i;
     receivers[i].start();
+  }
 }
 
 int _AmRtpReceiver::addStream(int sd, AmRtpSession* stream, int old_ctx_idx)
@@ -255,3 +264,8 @@ void _AmRtpReceiver::inc_drop_packets()
 {
     drop_counter.inc();
 }
+
+unsigned long long _AmRtpReceiver::get_drop_packets()
+{
+    return drop_counter.get();
+}
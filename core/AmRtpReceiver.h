@@ -115,6 +115,8 @@ class AmRtpReceiverThread: public AmThread {
   AmEventFd stream_remove_event;
 
   int poll_fd;
+  /** receiver index, names the packet pool of the thread */
+  unsigned int idx;
 
   AmRtpReceiverThread();
   ~AmRtpReceiverThread();
@@ -150,6 +152,7 @@ public:
   int addStream(int sd, AmRtpSession* stream, int old_ctx_idx);
   void removeStream(int sd, int ctx_idx);
   void inc_drop_packets();
+  unsigned long long get_drop_packets();
 };
 
 typedef singleton<_AmRtpReceiver> AmRtpReceiver;
@@ -28,6 +28,7 @@
 #include "AmRtpStream.h"
 #include "AmSrtpConnection.h"
 #include "AmRtpPacket.h"
+#include "AmRtpPacketPool.h"
 #include "AmRtpReceiver.h"
 #include "AmLcConfig.h"
 #include "AmPlugIn.h"
@@ -132,6 +133,7 @@ AmRtpStream::AmRtpStream(AmSession* _s, int _if)
     multiplexing(false),
     mute(false),
     hold(false),
+    packets_used(0),
     receiving(true),
     monitor_rtp_timeout(true),
     symmetric_rtp_endless(false),
@@ -150,9 +152,12 @@ AmRtpStream::AmRtpStream(AmSession* _s, int _if)
     force_receive_dtmf(false),
     rtp_ping(false),
     force_buffering(false),
+    relay_fast_path(false),
     dead_rtp_time(AmConfig.dead_rtp_time),
     incoming_bytes(0),
     outgoing_bytes(0),
+    relay_fast_packets(0),
+    relay_generic_packets(0),
     dropped_packets_count(0),
     rtp_parse_errors(0),
     out_of_buffer_errors(0),
@@ -200,6 +205,7 @@ AmRtpStream::~AmRtpStream()
     for(auto trans : ip6_transports) {
         delete trans;
     }
+    clearReceiveBuffers();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1037,7 +1043,7 @@ void AmRtpStream::onUdptlPacket(AmRtpPacket* p, AmMediaTransport*)
     clearRTPTimeout(&p->recv_time);
     AmLock l(receive_mut);
     if(!receive_buf.insert(ReceiveBuffer::value_type(p->timestamp,p)).second) {
-        mem.freePacket(p);
+        freeRtpPacket(p);
     }
 }
 
@@ -1163,7 +1169,13 @@ int AmRtpStream::send_zrtp(unsigned char* buffer, unsigned int size)
 
 AmRtpPacket * AmRtpStream::createRtpPacket()
 {
-    AmRtpPacket* p = mem.newPacket();
+    AmRtpPacket* p = nullptr;
+    if(packets_used.fetch_add(1) < RTP_STREAM_BUF_PACKETS_COUNT) {
+        p = AmRtpPacketPool::current()->get();
+        if(!p) packets_used--;
+    } else {
+        packets_used--;
+    }
     if (!p) p = reuseBufferedPacket();
     if (!p) {
         out_of_buffer_errors++;
@@ -1171,7 +1183,7 @@ AmRtpPacket * AmRtpStream::createRtpPacket()
         CLASS_DBG("out of buffers for RTP packets, dropping."
                 "receive_buf: %ld, rtp_ev_qu: %ld",
                 receive_buf.size(),rtp_ev_qu.size());
-        mem.debug();
+        CLASS_DBG("used: %u", packets_used.load());
         receive_mut.unlock();
         // drop received data
         return 0;
@@ -1183,7 +1195,8 @@ AmRtpPacket * AmRtpStream::createRtpPacket()
 void AmRtpStream::freeRtpPacket(AmRtpPacket* packet)
 {
     assert(packet);
-    mem.freePacket(packet);
+    packets_used--;
+    AmRtpPacketPool::put(packet);
 }
 
 // returns
@@ -1249,7 +1262,7 @@ void AmRtpStream::bufferPacket(AmRtpPacket* p)
     if(!receiving) {
         if(force_receive_dtmf && isLocalTelephoneEventPayload(p->payload))
             recvDtmfPacket(p);
-        mem.freePacket(p);
+        freeRtpPacket(p);
         return;
     }
 
@@ -1280,20 +1293,20 @@ void AmRtpStream::bufferPacket(AmRtpPacket* p)
                 if(force_buffering && p->relayed) {
                     receive_mut.lock();
                     if(!receive_buf.insert(ReceiveBuffer::value_type(p->timestamp,p)).second) {
-                        mem.freePacket(p);
+                        freeRtpPacket(p);
                     }
                     receive_mut.unlock();
                     return;
                 }
             }
-            mem.freePacket(p);
+            freeRtpPacket(p);
             return;
         }
     } //if(relay_enabled)
 
     // throw away ZRTP packets
     if(p->version != RTP_VERSION) {
-        mem.freePacket(p);
+        freeRtpPacket(p);
         return;
     }
 
@@ -1302,7 +1315,7 @@ void AmRtpStream::bufferPacket(AmRtpPacket* p)
     // free packet on double packet for TS received
     // if(p->payload == getLocalTelephoneEventPT()) {
     //     if (receive_buf.find(p->timestamp) != receive_buf.end()) {
-    //         mem.freePacket(receive_buf[p->timestamp]);
+    //         freeRtpPacket(receive_buf[p->timestamp]);
     //     }
     // }
 
@@ -1311,7 +1324,7 @@ void AmRtpStream::bufferPacket(AmRtpPacket* p)
     } else {
         if(!receive_buf.insert(ReceiveBuffer::value_type(p->timestamp,p)).second) {
             // insert failed
-            mem.freePacket(p);
+            freeRtpPacket(p);
         }
     }
     receive_mut.unlock();
@@ -1511,6 +1524,10 @@ void AmRtpStream::relay(AmRtpPacket* p)
     if(session && !session->onBeforeRTPRelay(p,&recv_addr))
         return;
 
+    // same payload type on both legs: header is edited in place
+    // and the received buffer is sent as is
+    bool fast = false;
+
     if(!relay_raw) {
 
         if(dtmf_sender.isSending())
@@ -1528,25 +1545,39 @@ void AmRtpStream::relay(AmRtpPacket* p)
         if (!relay_transparent_ssrc)
             hdr->ssrc = htonl(l_ssrc);
 
-        hdr->pt = relay_map.get(hdr->pt);
+        unsigned char pt = relay_map.get(hdr->pt);
+        fast = (pt == hdr->pt);
+        hdr->pt = pt;
 
         p->timestamp = get_adjusted_ts(p->timestamp);
         hdr->ts = htonl(p->timestamp);
     } //if(!relay_raw)
 
-    if(cur_rtp_trans->send(p, relay_raw ? AmStreamConnection::RAW_CONN : AmStreamConnection::RTP_CONN) < 0) {
-        CLASS_ERROR("while sending RTP packet to '%s':%i",
-                    cur_rtp_trans->getRHost(false).c_str(),
-                    cur_rtp_trans->getRPort(false));
+    sockaddr_storage addr;
+    ssize_t ret = fast ? cur_rtp_trans->sendRelayed(p, &addr) : RELAY_NOT_SENT;
+    relay_fast_path = (ret != RELAY_NOT_SENT);
+
+    if(relay_fast_path) {
+        relay_fast_packets++;
     } else {
-        p->relayed = true;
-        if(session) {
-            sockaddr_storage addr;
+        relay_generic_packets++;
+        ret = cur_rtp_trans->send(p, relay_raw ? AmStreamConnection::RAW_CONN : AmStreamConnection::RTP_CONN);
+        if(ret >= 0 && session) {
             if(relay_raw) {
                 cur_rtp_trans->getRAddr(&addr);
             } else {
                 cur_rtp_trans->getRAddr(false, &addr);
             }
+        }
+    }
+
+    if(ret < 0) {
+        CLASS_ERROR("while sending RTP packet to '%s':%i",
+                    cur_rtp_trans->getRHost(false).c_str(),
+                    cur_rtp_trans->getRPort(false));
+    } else {
+        p->relayed = true;
+        if(session) {
             session->onAfterRTPRelay(p, &addr);
         }
         add_if_no_exist(outgoing_relayed_payloads,p->payload);
@@ -1729,16 +1760,23 @@ void AmRtpStream::resume()
 
     clearRTPTimeout();
 
-    receive_mut.lock();
-    mem.clear();
-    receive_buf.clear();
-    while (!rtp_ev_qu.empty())
-        rtp_ev_qu.pop();
-    receive_mut.unlock();
+    clearReceiveBuffers();
 
     receiving = true;
 }
 
+void AmRtpStream::clearReceiveBuffers()
+{
+    AmLock l(receive_mut);
+    for(auto& it : receive_buf)
+        freeRtpPacket(it.second);
+    receive_buf.clear();
+    while (!rtp_ev_qu.empty()) {
+        freeRtpPacket(rtp_ev_qu.front());
+        rtp_ev_qu.pop();
+    }
+}
+
 void AmRtpStream::setOnHold(bool on_hold)
 {
     hold = on_hold;
@@ -2130,7 +2168,13 @@ void AmRtpStream::getInfo(AmArg &ret){
     s.clear();
     ret["relay_enabled"] = relay_enabled;
     ret["relay_raw"] = relay_raw;
+    ret["relay_fast_path"] = relay_fast_path;
+    ret["relay_fast_packets"] = relay_fast_packets;
+    ret["relay_generic_packets"] = relay_generic_packets;
     ret["force_relay_cn"] = force_relay_cn;
+    ret["packets_used"] = packets_used.load();
+    ret["packets_memory"] = static_cast<long long>(packets_used.load() * sizeof(AmRtpPacket));
+    AmRtpPacketPool::getInfo(ret["packet_pools"]);
     AmArg &p = ret["relay_payloads"];
     for(auto& payload : payloads) {
         if(relay_payloads.get(payload.pt)) {
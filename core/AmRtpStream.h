@@ -73,54 +73,6 @@ class msg_logger;
 struct SdpPayload;
 struct amci_payload_t;
 
-/**
- * This provides the memory for the receive buffer.
- */
-template <int packets_count>
-class PacketMem {
-#define PacketMemUsedClearMask (~(ULONG_MAX>>(BITS_PER_LONG - packets_count)))
-    AmRtpPacket packets[packets_count];
-    unsigned long used; //used packets bitmask
-  public:
-    PacketMem()
-      : used(PacketMemUsedClearMask)
-    {}
-    AmRtpPacket* newPacket()
-    {
-        if (!(~(used)))
-            return nullptr;
-
-        for(int i = 0; i < packets_count; i++) {
-            if(!test_and_set_bit(i, &used)) {
-                return &packets[i];
-            }
-        }
-
-        return nullptr;
-    }
-    void freePacket(AmRtpPacket* p)
-    {
-        if (!p)  return;
-
-        int idx = p-packets;
-
-        assert(idx >= 0);
-        assert(idx < packets_count);
-
-        clear_bit(idx, &used);
-        __sync_synchronize();
-    }
-    void clear()
-    {
-        used = PacketMemUsedClearMask;
-        __sync_synchronize();
-    }
-    void debug()
-    {
-        DBG("used: 0x%lx",used);
-    }
-};
-
 /** \brief event fired on RTP timeout */
 class AmRtpTimeoutEvent
   : public AmEvent
@@ -226,6 +178,10 @@ class AmRtpStream
     std::vector<int> outgoing_relayed_payloads;
     unsigned long incoming_bytes;
     unsigned long outgoing_bytes;
+    /** packets relayed as received to the plain RTP connection */
+    unsigned long relay_fast_packets;
+    /** packets relayed through the connection send() */
+    unsigned long relay_generic_packets;
     unsigned long rtp_parse_errors;
     unsigned long out_of_buffer_errors;
     unsigned long srtp_unprotect_errors;
@@ -311,10 +267,12 @@ class AmRtpStream
     /** DTMF sender */
     AmDtmfSender   dtmf_sender;
 
+    /** packets taken from AmRtpPacketPool, at most RTP_STREAM_BUF_PACKETS_COUNT */
+    std::atomic<unsigned int> packets_used;
+
     /**
     * Receive buffer, queue and mutex
     */
-    PacketMem<RTP_STREAM_BUF_PACKETS_COUNT> mem;
     ReceiveBuffer   receive_buf;
     RtpEventQueue   rtp_ev_qu;
     AmMutex         receive_mut;
@@ -367,6 +325,9 @@ class AmRtpStream
 
     void relay(AmRtpPacket* p);
 
+    /** last relayed packet was sent by the relay fast path */
+    bool            relay_fast_path;
+
     /** Sets generic parameters on SDP media */
     void getSdp(SdpMedia& m);
 
@@ -483,6 +444,8 @@ class AmRtpStream
     int nextPacket(AmRtpPacket*& p);
     /** Try to reuse oldest buffered packet for newly coming packet */
     AmRtpPacket *reuseBufferedPacket();
+    /** return buffered packets to the pool */
+    void clearReceiveBuffers();
 
 #ifdef WITH_ZRTP
     zrtpContext* getZrtpContext() { return &zrtp_context; }
@@ -115,8 +115,8 @@ inline string profile_t_2_str(int pt, bool alternative)
         case CP_AES256_CM_SHA1_32: return alternative ? "AES_CM_256_HMAC_SHA1_32" : "AES_256_CM_HMAC_SHA1_32";
         case CP_NULL_SHA1_80: return "NULL_HMAC_SHA1_80";
         case CP_NULL_SHA1_32: return "NULL_HMAC_SHA1_32";
-//         case CP_AEAD_AES_128_GCM: return "AEAD_AES_256_GCM";
-//         case CP_AEAD_AES_256_GCM: return "AEAD_AES_256_GCM";
+        case CP_AEAD_AES_128_GCM: return "AEAD_AES_128_GCM";
+        case CP_AEAD_AES_256_GCM: return "AEAD_AES_256_GCM";
 //         case CP_AES192_CM_SHA1_80: return "AES_CM_192_HMAC_SHA1_80";
 //         case CP_AES192_CM_SHA1_32: return "AES_CM_192_HMAC_SHA1_32";
         default: return "<unknown_profile_type>";
@@ -2056,10 +2056,10 @@ static CryptoProfile crypto_profile(std::string profile, bool& alternative)
         return CP_AES256_CM_SHA1_32;
     else if(profile_uc == "AES_256_CM_HMAC_SHA1_80")
         return CP_AES256_CM_SHA1_80;
-//    else if(profile_uc == "AEAD_AES_128_GCM")
-//        return CP_AEAD_AES_128_GCM;
-//    else if(profile_uc == "AEAD_AES_256_GCM")
-//        return CP_AEAD_AES_256_GCM;
+    else if(profile_uc == "AEAD_AES_128_GCM")
+        return CP_AEAD_AES_128_GCM;
+    else if(profile_uc == "AEAD_AES_256_GCM")
+        return CP_AEAD_AES_256_GCM;
     else if(profile_uc == "NULL_HMAC_SHA1_32")
         return CP_NULL_SHA1_32;
     else if(profile_uc == "NULL_HMAC_SHA1_80")
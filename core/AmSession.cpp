@@ -55,6 +55,7 @@ volatile unsigned int AmSession::session_num = 0;
 AmMutex AmSession::session_num_mut;
 volatile unsigned int AmSession::max_session_num = 0;
 volatile unsigned long long AmSession::avg_session_num = 0;
+atomic_int64 AmSession::pending_events;
 bool AmSession::terminate_on_no_sessions = true;
 
 struct timeval get_now() {
@@ -101,6 +102,7 @@ AmSession::AmSession(AmSipDialog* p_dlg)
 
 {
   DBG("AmSession[%p](%p)",this,dlg);
+  setDepthCounter(&pending_events);
   if(!dlg) dlg = new AmSipDialog(this);
   else {
     dlg->setEventhandler(this);
@@ -1376,8 +1378,7 @@ void AmSession::getMediaAcl(trsp_acl& acl)
 void AmSession::setMediaAcl(const std::vector<AmSubnet>& networks)
 {
     media_acl.set_action(trsp_acl::Drop);
-    for(auto& network : networks)
-        media_acl.add_network(network);
+    media_acl.set_networks(networks);
 }
 
 AddressType AmSession::getLocalMediaAddressType()
@@ -1464,14 +1465,23 @@ int AmSession::writeStreams(unsigned long long ts, unsigned char *buffer)
   if (stream->sendIntReached()) { // FIXME: shouldn't depend on checkInterval call before!
     unsigned int f_size = stream->getFrameSize();
     int got = 0;
+    bool encoded = false;
     if (output) {
-        got = output->get(ts, buffer, stream->getSampleRate(), f_size);
+        // pre-encoded prompts skip decoding and encoding
+        got = stream->getEncodedFrom(output, ts, buffer);
+        if (got > 0)
+            encoded = true;
+        else
+            got = output->get(ts, buffer, stream->getSampleRate(), f_size);
         if(got < 0) got = 0; //suppress errors
     }
     stream->processRtcpTimers(ts, stream->scaleSystemTS(ts));
     if (got < 0) res = -1;
     if (got > 0) {
-        res = stream->put(ts, buffer, stream->getSampleRate(), got);
+        if (encoded)
+            res = stream->putEncoded(ts, buffer, got);
+        else
+            res = stream->put(ts, buffer, stream->getSampleRate(), got);
     } else {
         stream->put_on_idle(ts);
     }
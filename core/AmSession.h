@@ -136,6 +136,7 @@ private:
   static volatile unsigned int session_num;
   static volatile unsigned int max_session_num;
   static volatile unsigned long long avg_session_num;
+  static atomic_int64 pending_events;
   static bool terminate_on_no_sessions;
   static AmMutex session_num_mut;
 
@@ -481,6 +482,10 @@ public:
    * Gets the average of running sessions since last query
    */
   static unsigned int getAvgSessionNum();
+  /**
+   * Gets the number of events waiting in the queues of all sessions
+   */
+  static unsigned long long getPendingEventsNum() { return pending_events.get(); }
 
   /* ----         Shutdown mode                 ---- */
   static void setTerminateOnNoSessions(bool terminate) { terminate_on_no_sessions = terminate; }
@@ -31,6 +31,7 @@
 #include "AmApi.h"
 #include "AmUtils.h"
 #include "AmEventDispatcher.h"
+#include "AmOverloadControl.h"
 
 #include <assert.h>
 #include <sys/types.h>
@@ -64,6 +65,11 @@ AmSessionContainer::AmSessionContainer()
         return AmSession::getSessionNum();
     });
 
+    stat_group(Gauge, "core", "session_events_pending")
+        .addFunctionCounter([]() -> unsigned long long {
+            return AmSession::getPendingEventsNum();
+        });
+
     stat_group(Gauge, "core", "dead_sessions_count")
         .addFunctionCounter([]() -> unsigned long long {
             return AmSessionContainer::instance()->d_sessions.size();
@@ -545,6 +551,21 @@ AmSession* AmSessionContainer::createSession(const AmSipRequest& req,
       return NULL;
   }
 
+  if (!AmOverloadControl::instance()->admit()) {
+      DBG("overload. Not creating session.");
+      if(!is_uac) {
+        const OverloadControlConfig &overload = AmConfig.overload_control;
+        string hdrs;
+        if(overload.retry_after) {
+          hdrs = SIP_HDR_COLSP(SIP_HDR_RETRY_AFTER) +
+                 int2str(overload.retry_after) + CRLF;
+        }
+        AmSipDialog::reply_error(req,overload.err_code,
+                                 overload.err_reason,hdrs);
+      }
+      return NULL;
+  }
+
   if (check_and_add_cps()) {
       AmSipDialog::reply_error(req,AmConfig.cps_limit_err_code,
 			       AmConfig.cps_limit_err_reason);
@@ -31,6 +31,7 @@
 
 #include "AmSessionProcessor.h"
 #include "AmSession.h"
+#include "AmCpuPlacement.h"
 
 #include <vector>
 #include <list>
@@ -130,6 +131,7 @@ void AmSessionProcessorThread::notify(AmEventQueue* sender) {
 void AmSessionProcessorThread::run()
 {
     setThreadName("session-proc");
+    AmCpuPlacement::instance()->place(this, "session-proc", CPU_ROLE_SESSION);
 
     event_stats.addLabel("thread",long2str(_self_tid));
 
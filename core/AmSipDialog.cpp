@@ -241,7 +241,7 @@ int AmSipDialog::onTxRequest(AmSipRequest& req, int& flags)
     return -1;
 
   // add transcoder statistics into request headers
-  addTranscoderStats(req.hdrs);
+  addTranscoderStats(req.hdrs.modify());
 
   if((req.method == SIP_METH_INVITE) && (status == Disconnected)){
     setStatus(Trying);
@@ -315,7 +315,7 @@ int AmSipDialog::onTxReply(const AmSipRequest& req, AmSipReply& reply, int& flag
   }
 
   // add transcoder statistics into reply headers
-  addTranscoderStats(reply.hdrs);
+  addTranscoderStats(reply.hdrs.modify());
 
   // target-refresh requests and their replies need to contain Contact (1xx
   // replies only those establishing dialog, take care about them?)
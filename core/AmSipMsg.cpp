@@ -44,6 +44,87 @@ string getHeader(const string& hdrs,const string& hdr_name,
   return res;
 }
 
+uint32_t AmSipHeadersIndex::hash(const char* name, size_t len)
+{
+  //FNV-1a over lowercased name
+  uint32_t h = 2166136261u;
+  for(const char *c = name, *end = name + len; c != end; c++) {
+    char l = *c;
+    if('A' <= l && l <= 'Z')
+      l -= 'A' - 'a';
+    h = (h ^ static_cast<unsigned char>(l)) * 16777619u;
+  }
+  return h;
+}
+
+void AmSipHeadersIndex::add(size_t name_offset, size_t name_len, const string& hdrs,
+			    size_t value_offset, size_t value_len)
+{
+  entries.push_back(Entry{
+    hash(hdrs.data() + name_offset, name_len),
+    static_cast<uint32_t>(name_offset),
+    static_cast<uint32_t>(value_offset),
+    static_cast<uint32_t>(value_len),
+    static_cast<uint32_t>(name_len)
+  });
+}
+
+string AmSipHeadersIndex::get(const string& hdrs, const string& hdr_name, bool single) const
+{
+  string ret;
+  bool found = false;
+  uint32_t h = hash(hdr_name.data(), hdr_name.length());
+
+  for(const auto &e : entries) {
+    if(e.name_hash != h || e.name_len != hdr_name.length() ||
+       strncasecmp(hdrs.data() + e.name_offset, hdr_name.data(), e.name_len))
+      continue;
+
+    if(found)
+      ret.append(", ");
+    else if(single)
+      return hdrs.substr(e.value_offset, e.value_len);
+    ret.append(hdrs, e.value_offset, e.value_len);
+    found = true;
+  }
+  return ret;
+}
+
+bool AmSipHeadersIndex::has(const string& hdrs, const string& hdr_name) const
+{
+  uint32_t h = hash(hdr_name.data(), hdr_name.length());
+
+  for(const auto &e : entries) {
+    if(e.name_hash == h && e.name_len == hdr_name.length() &&
+       !strncasecmp(hdrs.data() + e.name_offset, hdr_name.data(), e.name_len))
+      return true;
+  }
+  return false;
+}
+
+string _AmSipMsgInDlg::getHeader(const string& hdr_name, bool single) const
+{
+  if(!hdrs.index().valid())
+    return ::getHeader(hdrs, hdr_name, single);
+  return hdrs.index().get(hdrs, hdr_name, single);
+}
+
+string _AmSipMsgInDlg::getHeader(const string& hdr_name,
+				 const string& compact_hdr_name, bool single) const
+{
+  string res = getHeader(hdr_name, single);
+  if (!res.length())
+    return getHeader(compact_hdr_name, single);
+  return res;
+}
+
+bool _AmSipMsgInDlg::hasHeader(const string& hdr_name) const
+{
+  if(!hdrs.index().valid())
+    return ::hasHeader(hdrs, hdr_name);
+  return hdrs.index().has(hdrs, hdr_name);
+}
+
 bool hasHeader(const string& hdrs,const string& hdr_name) {
   size_t skip = 0, pos1 = 0, pos2 = 0, hdr_start = 0;
   return findHeader(hdrs, hdr_name, skip, pos1, pos2, hdr_start);
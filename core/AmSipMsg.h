@@ -4,11 +4,129 @@
 #include "AmMimeBody.h"
 
 #include <string>
+#include <vector>
+#include <utility>
 using std::string;
 
+#include <stdint.h>
+
 #include "sip/trans_layer.h"
 #include "sip/msg_sensor.h"
 
+/**
+ * positions of the headers within _AmSipMsgInDlg::hdrs.
+ * built once by the SIP stack for the received messages
+ * from the headers split by the parser.
+ */
+class AmSipHeadersIndex
+{
+  struct Entry {
+    uint32_t name_hash;
+    uint32_t name_offset;
+    uint32_t value_offset;
+    uint32_t value_len;
+    uint32_t name_len;
+  };
+
+  std::vector<Entry> entries;
+  bool indexed;
+
+ public:
+  AmSipHeadersIndex()
+    : indexed(false)
+  {}
+
+  /** case-insensitive header name hash */
+  static uint32_t hash(const char* name, size_t len);
+
+  void clear() { entries.clear(); indexed = false; }
+  void reserve(size_t n) { entries.reserve(n); }
+
+  void add(size_t name_offset, size_t name_len, const string& hdrs,
+	   size_t value_offset, size_t value_len);
+  /** mark index complete */
+  void done() { indexed = true; }
+
+  bool valid() const { return indexed; }
+
+  /** same semantics as getHeader(hdrs, hdr_name, single). index must be valid */
+  string get(const string& hdrs, const string& hdr_name, bool single) const;
+  bool has(const string& hdrs, const string& hdr_name) const;
+};
+
+/**
+ * headers string of _AmSipMsgInDlg with its index.
+ *
+ * reads as const string. every modification goes through
+ * the members below and drops the index, so lookups fall back
+ * to the string scan. functions changing the string in place
+ * (removeHeader(), addOptionTag(), ...) take it from modify().
+ */
+class AmSipMsgHeaders
+{
+  string s;
+  AmSipHeadersIndex idx;
+
+ public:
+  operator const string&() const { return s; }
+  const string& str() const { return s; }
+  const AmSipHeadersIndex& index() const { return idx; }
+
+  const char* c_str() const { return s.c_str(); }
+  const char* data() const { return s.data(); }
+  size_t length() const { return s.length(); }
+  size_t size() const { return s.size(); }
+  bool empty() const { return s.empty(); }
+  char operator[](size_t pos) const { return s[pos]; }
+
+  template<typename... Args>
+  size_t find(Args&&... args) const { return s.find(std::forward<Args>(args)...); }
+  template<typename... Args>
+  string substr(Args&&... args) const { return s.substr(std::forward<Args>(args)...); }
+
+  /** string for the in place modification. drops the index */
+  string& modify() { idx.clear(); return s; }
+
+  /** set index built for the current string */
+  void setIndex(AmSipHeadersIndex&& index) { idx = std::move(index); idx.done(); }
+
+  void reserve(size_t n) { s.reserve(n); }
+
+  AmSipMsgHeaders& operator=(const string& v) { modify() = v; return *this; }
+  AmSipMsgHeaders& operator=(string&& v) { modify() = std::move(v); return *this; }
+  AmSipMsgHeaders& operator=(const char* v) { modify() = v; return *this; }
+
+  template<typename T>
+  AmSipMsgHeaders& operator+=(const T& v) { modify() += v; return *this; }
+
+  template<typename... Args>
+  AmSipMsgHeaders& append(Args&&... args) {
+    modify().append(std::forward<Args>(args)...);
+    return *this;
+  }
+  template<typename... Args>
+  AmSipMsgHeaders& replace(Args&&... args) {
+    modify().replace(std::forward<Args>(args)...);
+    return *this;
+  }
+  template<typename... Args>
+  AmSipMsgHeaders& erase(Args&&... args) {
+    modify().erase(std::forward<Args>(args)...);
+    return *this;
+  }
+  void clear() { modify().clear(); }
+
+  friend bool operator==(const AmSipMsgHeaders& h, const string& v) { return h.s == v; }
+  friend bool operator==(const AmSipMsgHeaders& h, const char* v) { return h.s == v; }
+  friend bool operator!=(const AmSipMsgHeaders& h, const string& v) { return h.s != v; }
+  friend bool operator!=(const AmSipMsgHeaders& h, const char* v) { return h.s != v; }
+
+  friend string operator+(const AmSipMsgHeaders& h, const string& v) { return h.s + v; }
+  friend string operator+(const AmSipMsgHeaders& h, const char* v) { return h.s + v; }
+  friend string operator+(const string& v, const AmSipMsgHeaders& h) { return v + h.s; }
+  friend string operator+(const char* v, const AmSipMsgHeaders& h) { return v + h.s; }
+};
+
 /* enforce common naming in Req&Rpl */
 class _AmSipMsgInDlg
   : public AmObject
@@ -30,7 +148,7 @@ class _AmSipMsgInDlg
   string route;
   string contact;
 
-  string hdrs;
+  AmSipMsgHeaders hdrs;
 
   AmMimeBody body;
 
@@ -52,6 +170,12 @@ class _AmSipMsgInDlg
   virtual ~_AmSipMsgInDlg() { }
 
   virtual string print() const = 0;
+
+  /** getHeader()/hasHeader() for hdrs using the headers index if possible */
+  string getHeader(const string& hdr_name, bool single = false) const;
+  string getHeader(const string& hdr_name, const string& compact_hdr_name,
+		   bool single = false) const;
+  bool hasHeader(const string& hdr_name) const;
 };
 
 #ifdef PROPAGATE_UNPARSED_REPLY_HEADERS
@@ -559,7 +559,7 @@ void AmSIPRegistration::onSipReply(const AmSipRequest& req,
 
         string contacts = reply.contact;
         if (contacts.empty())
-            contacts = getHeader(reply.hdrs, "Contact", "m", true);
+            contacts = reply.getHeader("Contact", "m", true);
 
         if (unregistering) {
             DBG("received positive reply to De-REGISTER");
@@ -619,7 +619,7 @@ void AmSIPRegistration::onSipReply(const AmSipRequest& req,
                         const auto contact_expires = server_contact.params.find("expires");
                         if(contact_expires == server_contact.params.end()) {
                             DBG("no 'expires' param in matched Contact header. check for Expires header");
-                             auto expires_header = getHeader(reply.hdrs, SIP_HDR_EXPIRES, true);
+                             auto expires_header = reply.getHeader(SIP_HDR_EXPIRES, true);
                              if(expires_header.empty()) {
                                  ERROR("missed both 'expires' param on macthed contact and Expires header");
                                  active = false;
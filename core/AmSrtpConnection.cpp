@@ -92,14 +92,14 @@ int srtp::profile_get_master_key_length(srtp_profile_t profile)
     switch((int)profile) {
         case CP_AES128_CM_SHA1_80:
         case CP_AES128_CM_SHA1_32:
-//         case CP_AEAD_AES_128_GCM:
+        case CP_AEAD_AES_128_GCM:
             return SRTP_AES_128_KEY_LEN;
 //         case CP_AES192_CM_SHA1_80:
 //         case CP_AES192_CM_SHA1_32:
 //             return SRTP_AES_192_KEY_LEN;
         case CP_AES256_CM_SHA1_80:
         case CP_AES256_CM_SHA1_32:
-//         case CP_AEAD_AES_256_GCM:
+        case CP_AEAD_AES_256_GCM:
             return SRTP_AES_256_KEY_LEN;
     }
 
@@ -117,9 +117,9 @@ int srtp::profile_get_master_salt_length(srtp_profile_t profile)
     case CP_AES256_CM_SHA1_32:
     case CP_NULL_SHA1_80:
         return SRTP_SALT_LEN;
-//     case CP_AEAD_AES_128_GCM:
-//     case CP_AEAD_AES_256_GCM:
-//         return SRTP_AEAD_SALT_LEN;
+    case CP_AEAD_AES_128_GCM:
+    case CP_AEAD_AES_256_GCM:
+        return SRTP_AEAD_SALT_LEN;
     }
 
     return 0;
@@ -149,15 +149,34 @@ void srtp::crypto_policy_set_from_profile_for_rtp(srtp_crypto_policy_t* policy,
         case CP_NULL_SHA1_80:
             srtp_crypto_policy_set_null_cipher_hmac_sha1_80(policy);
             break;
-//         case CP_AEAD_AES_128_GCM:
-//             srtp_crypto_policy_set_aes_gcm_128_16_auth(policy);
-//             break;
-//         case CP_AEAD_AES_256_GCM:
-//             srtp_crypto_policy_set_aes_gcm_256_16_auth(policy);
-//             break;
+        case CP_AEAD_AES_128_GCM:
+            srtp_crypto_policy_set_aes_gcm_128_16_auth(policy);
+            break;
+        case CP_AEAD_AES_256_GCM:
+            srtp_crypto_policy_set_aes_gcm_256_16_auth(policy);
+            break;
     }
 }
 
+bool srtp::profile_supported(srtp_profile_t profile)
+{
+    unsigned char key[SRTP_KEY_SIZE];
+    memset(key, 0, sizeof(key));
+
+    srtp_policy_t policy;
+    memset(&policy, 0, sizeof(policy));
+    crypto_policy_set_from_profile_for_rtp(&policy.rtp, profile);
+    crypto_policy_set_from_profile_for_rtcp(&policy.rtcp, profile);
+    policy.ssrc.type = ssrc_any_outbound;
+    policy.key = key;
+
+    srtp_t session;
+    if(srtp_create(&session, &policy) != srtp_err_status_ok)
+        return false;
+    srtp_dealloc(session);
+    return true;
+}
+
 std::string AmSrtpConnection::gen_base64_key(srtp_profile_t profile)
 {
     unsigned int master_key_len = srtp::profile_get_master_key_length(profile);
@@ -313,7 +332,7 @@ ssize_t AmSrtpConnection::send(AmRtpPacket* p)
     unsigned int size = p->getBufferSize();
     uint32_t trailer_len = 0;
     srtp_get_protect_trailer_length(srtp_tx_session, false, 0, &trailer_len);
-    if(size + trailer_len > RTP_PACKET_BUF_SIZE) {
+    if(!p->reserveBuffer(size + trailer_len)) {
         transport->getRtpStream()->onErrorRtpTransport(RTP_BUFFER_SIZE_ERROR, "size + trailer_len > RTP_PACKET_BUF_SIZE", transport);
         return -1;
     }
@@ -34,6 +34,9 @@ namespace srtp {
     int profile_get_master_salt_length(srtp_profile_t profile);
 #define crypto_policy_set_from_profile_for_rtcp crypto_policy_set_from_profile_for_rtp
     void crypto_policy_set_from_profile_for_rtp(srtp_crypto_policy_t* policy, srtp_profile_t profile);
+    /** check if libsrtp can create a session with the profile
+     *  (AEAD-GCM needs libsrtp built with OpenSSL). call after srtp_init() */
+    bool profile_supported(srtp_profile_t profile);
 }
 
 class AmSrtpConnection : public AmStreamConnection
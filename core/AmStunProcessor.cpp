@@ -3,11 +3,17 @@
 #include "AmUtils.h"
 #include "sip/ip_util.h"
 
+#include <chrono>
+
 #define STUN_TIMER_INTERVAL_MICROSECONDS 125000
 
 AmStunProcessor::AmStunProcessor()
   : epoll_fd(-1),
-    stopped(false)
+    stopped(false),
+    timers_count(stat_group(Gauge, "core", "stun_timers").addAtomicCounter()),
+    checks_sent(stat_group(Counter, "core", "stun_checks_sent").addAtomicCounter()),
+    timeouts(stat_group(Counter, "core", "stun_timeouts").addAtomicCounter()),
+    time_spent(stat_group(Counter, "core", "stun_timer_time_spent_us").addAtomicCounter())
 {
     if((epoll_fd = epoll_create(10)) == -1) {
         ERROR("epoll_create failed");
@@ -66,61 +72,74 @@ void AmStunProcessor::set_timer(AmStunConnection *connection, unsigned long long
 {
     DBG("AmStunProcessor::set_timer connection: %p, timeout: %llu",
         connection, timeout);
-    AmLock l(set_timer_events_mutex);
-    set_timer_events.emplace_back(connection, timeout);
+    auto now = wheeltimer::instance()->unix_ms_clock.get();
+    AmLock l(arm_events_mutex);
+    arm_events.emplace_back(connection, now + timeout);
 }
 
 void AmStunProcessor::remove_timer(AmStunConnection *connection)
 {
     DBG("AmStunProcessor::remove_timer for %p", connection);
 
-    connections_mutex.lock();
-    set_timer_events_mutex.lock();
+    AmLock timers_lock(timers_mutex);
+    AmLock arm_events_lock(arm_events_mutex);
 
-    connections.erase(connection);
+    bool removed = timers.cancel(connection);
 
-    auto i = set_timer_events.begin();
-    while(i != set_timer_events.end()) {
-        if(i->connection == connection) i = set_timer_events.erase(i);
+    auto i = arm_events.begin();
+    while(i != arm_events.end()) {
+        if(i->connection == connection) i = arm_events.erase(i);
         else ++i;
     }
 
-    set_timer_events_mutex.unlock();
-    connections_mutex.unlock();
+    if(removed)
+        timers_count.set(timers.size());
+}
+
+void AmStunProcessor::apply_arm_events()
+{
+    {
+        AmLock l(arm_events_mutex);
+        arm_events_processing.swap(arm_events);
+    }
+
+    for(const auto &e : arm_events_processing)
+        timers.arm(e.connection, e.deadline);
+    arm_events_processing.clear();
+
+    timers_count.set(timers.size());
 }
 
 void AmStunProcessor::on_timer()
 {
+    auto start = std::chrono::steady_clock::now();
     auto now = wheeltimer::instance()->unix_ms_clock.get();
 
     //DBG("AmStunProcessor::on_timer %llu", now);
 
-    //process connections
-    connections_mutex.lock();
-    auto i = connections.begin();
-    while(i != connections.end()) {
-        /*DBG("AmStunProcessor::on_timer process connection: %p, now: %llu, timeout: %llu",
-            i->first, now, i->second);*/
-        if(now > i->second) {
-            //DBG("send_request for connection %p", i->first);
-            i->first->send_request();
-            i = connections.erase(i);
-            continue;
-        }
-        ++i;
-    }
-    connections_mutex.unlock();
+    AmLock l(timers_mutex);
+
+    apply_arm_events();
 
-    //process add_timer_events
-    AmLock timer_events_lock(set_timer_events_mutex);
+    timers.expire(now, expired);
+    if(expired.empty()) return;
 
-    while(!set_timer_events.empty()) {
-        auto &e = set_timer_events.front();
-        /*DBG("AmStunProcessor::process set timer event: %p, %llu",
-            e.connection, e.timeout);*/
-        connections[e.connection] = now + e.timeout;
-        set_timer_events.pop_front();
+    for(auto connection : expired) {
+        //DBG("send_request for connection %p", connection);
+        connection->send_request();
     }
+
+    // retransmissions are over if send_request() did not rearm the timer
+    apply_arm_events();
+    for(auto connection : expired) {
+        if(!timers.armed(connection))
+            timeouts.inc();
+    }
+    checks_sent.inc(expired.size());
+    expired.clear();
+
+    time_spent.inc(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
 }
 
 #if 0
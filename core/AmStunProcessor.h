@@ -4,8 +4,11 @@
 #include "sip/sa_storage_transport_key.h"
 #include "hash_table.h"
 #include "singleton.h"
+#include "AmStatistics.h"
 
+#include <map>
 #include <unordered_map>
+#include <vector>
 
 #define STUN_PEER_HT_POWER 6
 #define STUN_PEER_HT_SIZE  (1 << STUN_PEER_HT_POWER)
@@ -24,6 +27,66 @@ typedef ht_map_bucket<sp_addr,AmStunConnection,
 
 typedef hash_table<sp_bucket_base> stun_pair_ht;
 
+/**
+ * connections ordered by the deadline of their next binding request.
+ * arm and cancel are O(log n), expired entries are taken from the front.
+ * not thread safe.
+ */
+class AmStunTimerQueue
+{
+    typedef std::multimap<unsigned long long, AmStunConnection *> deadlines_t;
+
+    deadlines_t deadlines;
+    std::unordered_map<AmStunConnection *, deadlines_t::iterator> index;
+
+  public:
+    /** (re)arm the timer of the connection */
+    void arm(AmStunConnection *connection, unsigned long long deadline)
+    {
+        auto it = index.find(connection);
+        if(it != index.end()) {
+            deadlines.erase(it->second);
+            it->second = deadlines.emplace(deadline, connection);
+        } else {
+            index.emplace(connection, deadlines.emplace(deadline, connection));
+        }
+    }
+
+    /** @return false if the connection has no timer */
+    bool cancel(AmStunConnection *connection)
+    {
+        auto it = index.find(connection);
+        if(it == index.end()) return false;
+        deadlines.erase(it->second);
+        index.erase(it);
+        return true;
+    }
+
+    bool armed(AmStunConnection *connection) const
+    {
+        return index.find(connection) != index.end();
+    }
+
+    /** move connections with the deadline before now to expired */
+    void expire(unsigned long long now, std::vector<AmStunConnection *> &expired)
+    {
+        auto it = deadlines.begin();
+        for(; it != deadlines.end() && it->first < now; ++it) {
+            expired.push_back(it->second);
+            index.erase(it->second);
+        }
+        deadlines.erase(deadlines.begin(), it);
+    }
+
+    size_t size() const { return index.size(); }
+};
+
+/**
+ * sends the STUN binding requests of the ICE connections
+ *
+ * reports stun_timers, stun_checks_sent, stun_timeouts
+ * and stun_timer_time_spent_us.
+ */
 class AmStunProcessor
   : public AmThread
 {
@@ -31,20 +94,33 @@ class AmStunProcessor
     AmTimerFd timer;
     bool stopped;
 
-    std::unordered_map<AmStunConnection *, unsigned long long> connections;
-    AmMutex connections_mutex;
+    /* timers_mutex is held by on_timer() while sending,
+     * so connections can not be destroyed until the batch is done.
+     * set_timer() is called from send_request() and with the stream locks held,
+     * so it only queues the deadline to arm_events applied by on_timer() */
+    AmStunTimerQueue timers;
+    AmMutex timers_mutex;
+    std::vector<AmStunConnection *> expired;
 
-    struct set_timer_event {
+    struct arm_event {
         AmStunConnection *connection;
-        unsigned long long timeout;
-        set_timer_event(AmStunConnection *connection, unsigned long long timeout = 0)
+        unsigned long long deadline;
+        arm_event(AmStunConnection *connection, unsigned long long deadline)
           : connection(connection),
-            timeout(timeout)
+            deadline(deadline)
         {}
     };
-    std::list<set_timer_event> set_timer_events;
-    AmMutex set_timer_events_mutex;
+    std::vector<arm_event> arm_events;
+    std::vector<arm_event> arm_events_processing;
+    AmMutex arm_events_mutex;
+
+    AtomicCounter &timers_count;
+    AtomicCounter &checks_sent;
+    AtomicCounter &timeouts;
+    AtomicCounter &time_spent;
 
+    /** move queued deadlines to timers. timers_mutex must be held */
+    void apply_arm_events();
     void on_timer();
 
   protected:
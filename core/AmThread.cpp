@@ -30,6 +30,8 @@
 #include "log.h"
 
 #include <sys/syscall.h>
+#include <sched.h>
+#include <string.h>
 #include <unistd.h>
 #include "errno.h"
 #include <string>
@@ -197,30 +199,23 @@ void AmThread::join()
         pthread_join(_td,nullptr);
 }
 
-int AmThread::setRealtime()
+int AmThread::setRealtime(int priority)
 {
-  // set process realtime
-  //     int policy;
-  //     struct sched_param rt_param;
-  //     memset (&rt_param, 0, sizeof (rt_param));
-  //     rt_param.sched_priority = 80;
-  //     int res = sched_setscheduler(0, SCHED_FIFO, &rt_param);
-  //     if (res) {
-  // 	ERROR("sched_setscheduler failed. Try to run SEMS as root or suid.");
-  //     }
-
-  //     policy = sched_getscheduler(0);
-    
-  //     std::string str_policy = "unknown";
-  //     switch(policy) {
-  // 	case SCHED_OTHER: str_policy = "SCHED_OTHER"; break;
-  // 	case SCHED_RR: str_policy = "SCHED_RR"; break;
-  // 	case SCHED_FIFO: str_policy = "SCHED_FIFO"; break;
-  //     }
- 
-  //     DBG("Thread has now policy '%s' - priority 80 (from %d to %d).", str_policy.c_str(), 
-  // 	sched_get_priority_min(policy), sched_get_priority_max(policy));
-  //     return 0;
+    struct sched_param rt_param;
+    memset(&rt_param, 0, sizeof(rt_param));
+    rt_param.sched_priority = priority;
+
+    int res = pthread_setschedparam(pthread_self(), SCHED_FIFO, &rt_param);
+    if(res) {
+        WARN("failed to set SCHED_FIFO priority %d: %s. "
+             "run SEMS as root or with CAP_SYS_NICE",
+             priority, strerror(res));
+        return -1;
+    }
+
+    DBG("thread %lu has now policy SCHED_FIFO - priority %d (from %d to %d)",
+        static_cast<unsigned long>(_pid), priority,
+        sched_get_priority_min(SCHED_FIFO), sched_get_priority_max(SCHED_FIFO));
     return 0;
 }
 
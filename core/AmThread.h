@@ -410,7 +410,8 @@ class AmThread
     /** kill the thread (if pthread_setcancelstate(PTHREAD_CANCEL_ENABLED) has been set) **/
     void cancel();
 
-    int setRealtime();
+    /** switch the calling thread to SCHED_FIFO. must be called from run() */
+    int setRealtime(int priority);
     void setThreadName(const char *thread_name);
 };
 
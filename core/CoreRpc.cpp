@@ -11,8 +11,16 @@
 
 #include "jsonArg.h"
 #include "codecs_bench.h"
+#include "json_bench.h"
+#include "amarg_bench.h"
+#include "iptree_bench.h"
+#include "audio_bench.h"
+#include "srtp_bench.h"
+#include "event_dispatcher_bench.h"
 #include "AmB2BSession.h"
 #include "AmAudioFileRecorder.h"
+#include "AmCpuPlacement.h"
+#include "AmOverloadControl.h"
 
 #include "signal.h"
 #include <fstream>
@@ -162,6 +170,9 @@ void CoreRpc::init_rpc_tree()
             reg_method(show_media,"streams","active media streams info",&CoreRpc::showMediaStreams);
         AmArg &show_recorder = reg_leaf(show,"recorder","async audio recorder instance");
             reg_method(show_recorder,"stats","",&CoreRpc::showRecorderStats);
+        reg_method(show,"overload","admission control state",&CoreRpc::showOverload);
+        AmArg &show_threads = reg_leaf(show,"threads");
+            reg_method(show_threads,"placement","cpu placement of the worker threads",&CoreRpc::showThreadsPlacement);
 
     //request
     AmArg &request = reg_leaf(root,"request");
@@ -178,6 +189,14 @@ void CoreRpc::init_rpc_tree()
             reg_method(request_resolver,"get","",&CoreRpc::requestResolverGet);
         AmArg &request_cerificates = reg_leaf(request ,"certificates");
             reg_method(request_cerificates ,"reload","",&CoreRpc::requestReloadCertificate);
+        AmArg &request_benchmark = reg_leaf(request,"benchmark");
+            reg_method(request_benchmark,"json","[sessions_count|sessions] [iterations]",&CoreRpc::requestBenchmarkJson);
+            reg_method(request_benchmark,"binarg","[sessions_count|sessions] [iterations]",&CoreRpc::requestBenchmarkBinArg);
+            reg_method(request_benchmark,"amarg","[sessions_count] [iterations]",&CoreRpc::requestBenchmarkAmArg);
+            reg_method(request_benchmark,"iptree","[prefixes] [lookups]",&CoreRpc::requestBenchmarkIPTree);
+            reg_method(request_benchmark,"audio","[calls] [ticks]",&CoreRpc::requestBenchmarkAudio);
+            reg_method(request_benchmark,"srtp","[packets] [payload_size]",&CoreRpc::requestBenchmarkSrtp);
+            reg_method(request_benchmark,"event_dispatcher","[queues] [posts]",&CoreRpc::requestBenchmarkEventDispatcher);
 
     //set
     AmArg &set = reg_leaf(root,"set");
@@ -662,6 +681,16 @@ void CoreRpc::showRecorderStats(const AmArg&, AmArg& ret)
     AmAudioFileRecorderProcessor::instance()->getStats(ret);
 }
 
+void CoreRpc::showThreadsPlacement(const AmArg&, AmArg& ret)
+{
+    AmCpuPlacement::instance()->getInfo(ret);
+}
+
+void CoreRpc::showOverload(const AmArg&, AmArg& ret)
+{
+    AmOverloadControl::instance()->getInfo(ret);
+}
+
 void CoreRpc::requestResolverClear(const AmArg&, AmArg& ret)
 {
     resolver::instance()->clear_cache();
@@ -678,6 +707,118 @@ void CoreRpc::showResolverCache(const AmArg&, AmArg& ret)
     resolver::instance()->dump_cache(ret);
 }
 
+void CoreRpc::requestBenchmarkJson(const AmArg& args, AmArg& ret)
+{
+    AmArg dump;
+    unsigned int sessions = DEFAULT_JSON_BENCH_SESSIONS,
+                 iterations = DEFAULT_JSON_BENCH_ITERATIONS;
+
+    if(args.size() && isArgCStr(args[0]) && args[0] == "sessions") {
+        //benchmark on the live 'show sessions' dump
+        showSessionsInfo(AmArg(), dump);
+        if(!dump.size())
+            throw AmSession::Exception(500,"no active sessions");
+    } else {
+        if(args.size() && str2i(arg2str(args[0]), sessions))
+            throw AmSession::Exception(500,"wrong sessions count");
+        json_bench_fill_sessions(dump, sessions);
+    }
+
+    if(args.size() > 1 && (str2i(arg2str(args[1]), iterations) || !iterations))
+        throw AmSession::Exception(500,"wrong iterations count");
+
+    json_bench(dump, iterations, ret);
+}
+
+void CoreRpc::requestBenchmarkBinArg(const AmArg& args, AmArg& ret)
+{
+    AmArg dump;
+    unsigned int sessions = DEFAULT_JSON_BENCH_SESSIONS,
+                 iterations = DEFAULT_JSON_BENCH_ITERATIONS;
+
+    if(args.size() && isArgCStr(args[0]) && args[0] == "sessions") {
+        showSessionsInfo(AmArg(), dump);
+        if(!dump.size())
+            throw AmSession::Exception(500,"no active sessions");
+    } else {
+        if(args.size() && str2i(arg2str(args[0]), sessions))
+            throw AmSession::Exception(500,"wrong sessions count");
+        json_bench_fill_sessions(dump, sessions);
+    }
+
+    if(args.size() > 1 && (str2i(arg2str(args[1]), iterations) || !iterations))
+        throw AmSession::Exception(500,"wrong iterations count");
+
+    binarg_bench(dump, iterations, ret);
+}
+
+void CoreRpc::requestBenchmarkAmArg(const AmArg& args, AmArg& ret)
+{
+    unsigned int sessions = DEFAULT_AMARG_BENCH_SESSIONS,
+                 iterations = DEFAULT_AMARG_BENCH_ITERATIONS;
+
+    if(args.size() && str2i(arg2str(args[0]), sessions))
+        throw AmSession::Exception(500,"wrong sessions count");
+    if(args.size() > 1 && (str2i(arg2str(args[1]), iterations) || !iterations))
+        throw AmSession::Exception(500,"wrong iterations count");
+
+    amarg_bench(sessions, iterations, ret);
+}
+
+void CoreRpc::requestBenchmarkIPTree(const AmArg& args, AmArg& ret)
+{
+    unsigned int prefixes = DEFAULT_IPTREE_BENCH_PREFIXES,
+                 lookups = DEFAULT_IPTREE_BENCH_LOOKUPS;
+
+    if(args.size() && str2i(arg2str(args[0]), prefixes))
+        throw AmSession::Exception(500,"wrong prefixes count");
+    if(args.size() > 1 && (str2i(arg2str(args[1]), lookups) || !lookups))
+        throw AmSession::Exception(500,"wrong lookups count");
+
+    iptree_bench(prefixes, lookups, ret);
+}
+
+void CoreRpc::requestBenchmarkAudio(const AmArg& args, AmArg& ret)
+{
+    unsigned int calls = DEFAULT_AUDIO_BENCH_CALLS,
+                 ticks = DEFAULT_AUDIO_BENCH_TICKS;
+
+    if(args.size() && (str2i(arg2str(args[0]), calls) || !calls))
+        throw AmSession::Exception(500,"wrong calls count");
+    if(args.size() > 1 && (str2i(arg2str(args[1]), ticks) || !ticks))
+        throw AmSession::Exception(500,"wrong ticks count");
+
+    audio_bench(calls, ticks, ret);
+}
+
+void CoreRpc::requestBenchmarkSrtp(const AmArg& args, AmArg& ret)
+{
+    unsigned int packets = DEFAULT_SRTP_BENCH_PACKETS,
+                 payload_size = DEFAULT_SRTP_BENCH_PAYLOAD;
+
+    if(!AmConfig.enable_srtp)
+        throw AmSession::Exception(500,"SRTP is disabled");
+    if(args.size() && (str2i(arg2str(args[0]), packets) || !packets))
+        throw AmSession::Exception(500,"wrong packets count");
+    if(args.size() > 1 && str2i(arg2str(args[1]), payload_size))
+        throw AmSession::Exception(500,"wrong payload size");
+
+    srtp_bench(packets, payload_size, ret);
+}
+
+void CoreRpc::requestBenchmarkEventDispatcher(const AmArg& args, AmArg& ret)
+{
+    unsigned int queues = DEFAULT_EVENT_DISPATCHER_BENCH_QUEUES,
+                 posts = DEFAULT_EVENT_DISPATCHER_BENCH_POSTS;
+
+    if(args.size() && (str2i(arg2str(args[0]), queues) || !queues))
+        throw AmSession::Exception(500,"wrong queues count");
+    if(args.size() > 1 && (str2i(arg2str(args[1]), posts) || !posts))
+        throw AmSession::Exception(500,"wrong posts count");
+
+    event_dispatcher_bench(queues, posts, ret);
+}
+
 void CoreRpc::requestResolverGet(const AmArg& args, AmArg& ret)
 {
     if(!args.size()){
@@ -82,11 +82,20 @@ class CoreRpc final
     rpc_handler setShutdownAutoTerm;
 
     rpc_handler showRecorderStats;
+    rpc_handler showThreadsPlacement;
+    rpc_handler showOverload;
 
     rpc_handler requestResolverClear;
     rpc_handler requestResolverGet;
 
     rpc_handler requestLogDump;
+    rpc_handler requestBenchmarkJson;
+    rpc_handler requestBenchmarkBinArg;
+    rpc_handler requestBenchmarkAmArg;
+    rpc_handler requestBenchmarkIPTree;
+    rpc_handler requestBenchmarkAudio;
+    rpc_handler requestBenchmarkSrtp;
+    rpc_handler requestBenchmarkEventDispatcher;
 
     rpc_handler plugin;
 
@@ -2,6 +2,7 @@
 #include "sip/ip_util.h"
 
 #include <byteswap.h>
+#include <algorithm>
 
 void IPTree::Node::clear()
 {
@@ -134,3 +135,220 @@ IPTree::operator AmArg() const
     serialize_nodes_tree(ipv6_root, ret["ip6"]);
     return ret;
 }
+
+std::shared_ptr<const CompiledIPTree> IPTree::compile() const
+{
+    return std::make_shared<const CompiledIPTree>(*this);
+}
+
+template<typename Key>
+CompiledIPTree::Table<Key>::Table()
+  : starts(1, 0),
+    ranges(1, 0),
+    lists(2, 0),
+    dir(2, 0),
+    dir_bits(0),
+    prefixes(0)
+{}
+
+template<typename Key>
+void CompiledIPTree::Table<Key>::build(std::vector<Prefix> &input)
+{
+    static const unsigned int bits = sizeof(Key) * 8;
+    const Key max = ~static_cast<Key>(0);
+
+    struct Node {
+        Key lo, hi;
+        int parent;
+        int list;
+    };
+
+    std::sort(input.begin(), input.end(), [](const Prefix &l, const Prefix &r) {
+        return l.net < r.net || (l.net == r.net && l.len < r.len);
+    });
+
+    std::vector<Node> nodes;
+    nodes.reserve(input.size());
+    starts.clear();
+    starts.reserve(input.size() * 2 + 1);
+    starts.push_back(0);
+    for(auto &p : input) {
+        Key mask = p.len ? max << (bits - p.len) : 0;
+        p.net &= mask;
+        nodes.push_back({ p.net, static_cast<Key>(p.net | ~mask), -1, -1 });
+        starts.push_back(nodes.back().lo);
+        if(nodes.back().hi != max) starts.push_back(nodes.back().hi + 1);
+    }
+    std::sort(starts.begin(), starts.end());
+    starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+    prefixes = input.size();
+
+    /* prefixes are nested or disjoint, so the active ones form
+     * the chain of the parents ordered by the prefix length */
+    auto get_list = [&](int node_idx) -> int {
+        Node &n = nodes[node_idx];
+        if(n.list >= 0) return n.list;
+
+        std::vector<int> chain;
+        for(int i = node_idx; i >= 0; i = nodes[i].parent)
+            chain.push_back(i);
+
+        n.list = lists.size();
+        lists.push_back(0); //count
+        lists.push_back(0); //longest prefix indexes offset
+        int count = 0;
+        for(auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            lists[n.list + 1] = count;
+            for(int idx : input[*it].indexes) {
+                lists.push_back(idx);
+                count++;
+            }
+        }
+        lists[n.list] = count;
+        return n.list;
+    };
+
+    std::vector<Key> merged_starts;
+    merged_starts.reserve(starts.size());
+    ranges.clear();
+    ranges.reserve(starts.size());
+
+    std::vector<int> stack;
+    size_t next = 0;
+    int prev_top = -2;
+    for(const auto &start : starts) {
+        while(!stack.empty() && nodes[stack.back()].hi < start)
+            stack.pop_back();
+        while(next < nodes.size() && nodes[next].lo == start) {
+            nodes[next].parent = stack.empty() ? -1 : stack.back();
+            stack.push_back(next++);
+        }
+
+        int top = stack.empty() ? -1 : stack.back();
+        if(top == prev_top) continue; //same matched set as for the previous range
+        prev_top = top;
+
+        merged_starts.push_back(start);
+        ranges.push_back(top < 0 ? 0 : get_list(top));
+    }
+    starts.swap(merged_starts);
+    starts.shrink_to_fit();
+    ranges.shrink_to_fit();
+    lists.shrink_to_fit();
+
+    dir_bits = 0;
+    while(dir_bits < 16 && (static_cast<size_t>(1) << dir_bits) < starts.size())
+        dir_bits++;
+
+    size_t dir_size = static_cast<size_t>(1) << dir_bits;
+    dir.assign(dir_size + 1, 0);
+    size_t range = 0;
+    for(size_t h = 0; h < dir_size; h++) {
+        Key key = dir_bits ? static_cast<Key>(h) << (bits - dir_bits) : 0;
+        while(range + 1 < starts.size() && starts[range + 1] <= key)
+            range++;
+        dir[h] = range;
+    }
+    dir[dir_size] = starts.size() - 1;
+}
+
+template<typename Key>
+const int *CompiledIPTree::Table<Key>::find(Key key) const
+{
+    static const unsigned int bits = sizeof(Key) * 8;
+    size_t h = dir_bits ? static_cast<size_t>(key >> (bits - dir_bits)) : 0;
+    uint32_t lo = dir[h], hi = dir[h + 1];
+    while(lo < hi) {
+        uint32_t mid = (lo + hi + 1) / 2;
+        if(starts[mid] <= key) lo = mid;
+        else hi = mid - 1;
+    }
+    return &lists[ranges[lo]];
+}
+
+template<typename Key>
+size_t CompiledIPTree::Table<Key>::memory() const
+{
+    return starts.capacity() * sizeof(Key) +
+           ranges.capacity() * sizeof(uint32_t) +
+           lists.capacity() * sizeof(int) +
+           dir.capacity() * sizeof(uint32_t);
+}
+
+template<typename Key>
+void CompiledIPTree::collect(const IPTree::Node &node, Key path, unsigned int depth,
+                             std::vector<typename Table<Key>::Prefix> &ret)
+{
+    static const unsigned int bits = sizeof(Key) * 8;
+    if(!node.indexes.empty()) {
+        ret.push_back({ path, depth,
+                        std::vector<int>(node.indexes.begin(), node.indexes.end()) });
+    }
+    if(depth >= bits) return;
+    if(node.zero)
+        collect(*node.zero, path, depth + 1, ret);
+    if(node.one)
+        collect(*node.one, static_cast<Key>(path | (static_cast<Key>(1) << (bits - 1 - depth))),
+                depth + 1, ret);
+}
+
+CompiledIPTree::CompiledIPTree(const IPTree &tree)
+{
+    std::vector<Table<uint32_t>::Prefix> ipv4_prefixes;
+    collect<uint32_t>(tree.ipv4_root, 0, 0, ipv4_prefixes);
+    ipv4.build(ipv4_prefixes);
+
+    std::vector<Table<unsigned __int128>::Prefix> ipv6_prefixes;
+    collect<unsigned __int128>(tree.ipv6_root, 0, 0, ipv6_prefixes);
+    ipv6.build(ipv6_prefixes);
+}
+
+const int *CompiledIPTree::find(const sockaddr_storage &addr) const
+{
+    if(addr.ss_family == AF_INET)
+        return ipv4.find(bswap_32(SAv4(&addr)->sin_addr.s_addr));
+
+    if(addr.ss_family == AF_INET6) {
+        const uint8_t *addr_bytes = &SAv6(&addr)->sin6_addr.s6_addr[0];
+        unsigned __int128 key = 0;
+        for(int i = 0; i < 16; i++)
+            key = (key << 8) | addr_bytes[i];
+        return ipv6.find(key);
+    }
+
+    return nullptr;
+}
+
+void CompiledIPTree::match(const sockaddr_storage &addr, MatchResult &ret) const
+{
+    const int *list = find(addr);
+    if(!list) return;
+    ret.insert(ret.end(), list + 2, list + 2 + list[0]);
+}
+
+bool CompiledIPTree::contains(const sockaddr_storage &addr) const
+{
+    const int *list = find(addr);
+    return list && list[0];
+}
+
+int CompiledIPTree::match_longest(const sockaddr_storage &addr) const
+{
+    const int *list = find(addr);
+    if(!list || !list[0]) return -1;
+    return list[2 + list[1]];
+}
+
+CompiledIPTree::operator AmArg() const
+{
+    AmArg ret;
+    AmArg &a4 = ret["ip4"];
+    a4["prefixes"] = static_cast<long long>(ipv4.prefixes);
+    a4["ranges"] = static_cast<long long>(ipv4.starts.size());
+    a4["memory"] = static_cast<long long>(ipv4.memory());
+    AmArg &a6 = ret["ip6"];
+    a6["prefixes"] = static_cast<long long>(ipv6.prefixes);
+    a6["ranges"] = static_cast<long long>(ipv6.starts.size());
+    a6["memory"] = static_cast<long long>(ipv6.memory());
+    return ret;
+}
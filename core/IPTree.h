@@ -6,8 +6,11 @@
 #include <set>
 #include <string>
 #include <memory>
+#include <stdint.h>
 #include <sys/socket.h>
 
+class CompiledIPTree;
+
 class IPTree
 {
     struct Node {
@@ -24,6 +27,8 @@ class IPTree
     Node *get_node_ipv4(const sockaddr_storage &addr, unsigned int mask_len);
     Node *get_node_ipv6(const sockaddr_storage &addr, unsigned int mask_len);
     void serialize_nodes_tree(const Node &node, AmArg &ret) const;
+
+    friend class CompiledIPTree;
   public:
     using MatchResult = std::vector<int /* external index */>;
     void clear();
@@ -32,5 +37,70 @@ class IPTree
     /* fills ret with matched nodes */
     void match(const sockaddr_storage &addr, MatchResult &ret);
 
+    /* build read-only lookup structure from the current tree state */
+    std::shared_ptr<const CompiledIPTree> compile() const;
+
+    operator AmArg() const;
+};
+
+/* read-only counterpart of IPTree.
+ * prefixes are flattened to the sorted array of the address ranges
+ * starts with the matched indexes list for each range.
+ * lookup is the direct index by the top address bits followed by
+ * the binary search within the small part of the array.
+ * safe for concurrent lookups */
+class CompiledIPTree
+{
+  public:
+    using MatchResult = IPTree::MatchResult;
+
+  private:
+    template<typename Key>
+    struct Table {
+        //sorted ranges starts. the first one is always 0
+        std::vector<Key> starts;
+        //range -> offset in lists
+        std::vector<uint32_t> ranges;
+        //[count, index, ...] for every distinct matched set. offset 0 is the empty list
+        std::vector<int> lists;
+        //top dir_bits of the address -> first range to search
+        std::vector<uint32_t> dir;
+        unsigned int dir_bits;
+        size_t prefixes;
+
+        struct Prefix {
+            Key net;
+            unsigned int len;
+            std::vector<int> indexes;
+        };
+
+        Table();
+        void build(std::vector<Prefix> &prefixes);
+        const int *find(Key key) const;
+        size_t memory() const;
+    };
+
+    Table<uint32_t> ipv4;
+    Table<unsigned __int128> ipv6;
+
+    template<typename Key>
+    static void collect(const IPTree::Node &node, Key path, unsigned int depth,
+                        std::vector<typename Table<Key>::Prefix> &ret);
+
+    const int *find(const sockaddr_storage &addr) const;
+
+  public:
+    CompiledIPTree() {}
+    CompiledIPTree(const IPTree &tree);
+
+    /* same results as for IPTree::match() */
+    void match(const sockaddr_storage &addr, MatchResult &ret) const;
+    /* true if any prefix contains addr */
+    bool contains(const sockaddr_storage &addr) const;
+    /* index of the longest prefix containing addr (the lowest one on collisions) or -1 */
+    int match_longest(const sockaddr_storage &addr) const;
+
+    size_t size() const { return ipv4.prefixes + ipv6.prefixes; }
+
     operator AmArg() const;
 };
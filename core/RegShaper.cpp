@@ -1,7 +1,83 @@
 #include "RegShaper.h"
+#include "AmStatistics.h"
 #include "log.h"
 
 #include <ctime>
+#include <map>
+#include <memory>
+
+RegShaper::Metrics::Metrics(const string &key_class)
+  : allowed(stat_group(Counter, "core", "shaper_allowed").addAtomicCounter()
+        .addLabel("class", key_class)),
+    throttled(stat_group(Counter, "core", "shaper_throttled").addAtomicCounter()
+        .addLabel("class", key_class)),
+    expired(stat_group(Counter, "core", "shaper_expired").addAtomicCounter()
+        .addLabel("class", key_class)),
+    keys(stat_group(Gauge, "core", "shaper_keys").addAtomicCounter()
+        .addLabel("class", key_class))
+{}
+
+RegShaper::Metrics &RegShaper::get_metrics(const string &key_class)
+{
+    static AmMutex metrics_mutex;
+    static std::map<string, std::unique_ptr<Metrics> > metrics;
+
+    AmLock l(metrics_mutex);
+    std::unique_ptr<Metrics> &m = metrics[key_class];
+    if(!m) m.reset(new Metrics(key_class));
+    return *m;
+}
+
+RegShaper::RegShaper(const string &key_class)
+  : enabled(false),
+    interval(0),
+    burst_tolerance(0),
+    idle_timeout(DEFAULT_REG_SHAPER_IDLE_TIMEOUT_MSEC),
+    metrics(get_metrics(key_class))
+{}
+
+RegShaper::~RegShaper()
+{
+    //metrics are shared by the key class and outlive the shaper
+    metrics.keys.dec(keys_count());
+}
+
+void RegShaper::set_rate(unsigned int rate, unsigned int per_msec, unsigned int burst)
+{
+    if(!rate || !per_msec) {
+        enabled = false;
+        return;
+    }
+    if(!burst) burst = 1;
+
+    interval = std::chrono::microseconds(per_msec * 1000ULL / rate);
+    burst_tolerance = interval * (burst - 1);
+    enabled = true;
+}
+
+RegShaper::Shard &RegShaper::get_shard(const ThrottlingHashKey &key)
+{
+    return shards[std::hash<ThrottlingHashKey>()(key) % REG_SHAPER_SHARDS];
+}
+
+void RegShaper::cleanup_unsafe(Shard &shard, const timep &now)
+{
+    if(now < shard.next_cleanup) return;
+    shard.next_cleanup = now + idle_timeout;
+
+    //bucket is full since 'tat', so it can be recreated on the next request
+    for(ThrottlingHash::iterator it = shard.buckets.begin();
+        it != shard.buckets.end();)
+    {
+        if(it->second + idle_timeout <= now) {
+            it = shard.buckets.erase(it);
+            metrics.expired.inc();
+            metrics.keys.dec();
+        } else {
+            ++it;
+        }
+    }
+}
 
 bool RegShaper::check_rate_limit(const string &key,
                                  timep &next_attempt_time)
@@ -16,24 +92,83 @@ bool RegShaper::check_rate_limit(const string &key,
                                  timep &next_attempt_time)
 {
     if(!enabled) return false;
+    if(!take_token(key, now, &next_attempt_time, true))
+        return false;
+
+    DBG("throttling limit reached for key: <%s>. next attempt in %ld ms",
+        key.c_str(),
+        static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            next_attempt_time - now).count()));
+    return true;
+}
 
-    ThrottlingHash::iterator i = throttling_hash.find(key);
-    if(i == throttling_hash.end()) {
-        //the first operation for this key
-        throttling_hash[key] = now;
+bool RegShaper::over_limit(const ThrottlingHashKey &key, const timep &now,
+                           timep *next_attempt_time)
+{
+    if(!enabled) return false;
+    return take_token(key, now, next_attempt_time, false);
+}
+
+bool RegShaper::take_token(const ThrottlingHashKey &key, const timep &now,
+                           timep *next_attempt_time, bool reserve)
+{
+    Shard &shard = get_shard(key);
+    AmLock l(shard.mutex);
+
+    cleanup_unsafe(shard, now);
+
+    std::pair<ThrottlingHash::iterator, bool> ret =
+        shard.buckets.emplace(key, now);
+    if(ret.second) metrics.keys.inc();
+
+    timep &tat = ret.first->second;
+    if(tat < now) tat = now;
+
+    if(tat - now <= burst_tolerance) {
+        tat += interval;
+        metrics.allowed.inc();
         return false;
     }
 
-    //we have previous operations for this key
-    timep &last_request_time = i->second;
-    auto diff = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_request_time);
-    if(diff > min_interval) {
-        last_request_time = now;
-        return false;
+    metrics.throttled.inc();
+
+    if(next_attempt_time) {
+        *next_attempt_time = tat - burst_tolerance;
+        //take the token from the future
+        if(reserve) tat += interval;
     }
-    DBG("throttling limit reached for key: <%s>. (diff: %ld, min: %ld)",
-        key.c_str(),diff.count(),min_interval.count());
-    last_request_time+=min_interval;
-    next_attempt_time = last_request_time;
     return true;
 }
+
+void RegShaper::drain(const ThrottlingHashKey &key, const timep &now)
+{
+    if(!enabled) return;
+
+    Shard &shard = get_shard(key);
+    AmLock l(shard.mutex);
+
+    std::pair<ThrottlingHash::iterator, bool> ret =
+        shard.buckets.emplace(key, now);
+    if(ret.second) metrics.keys.inc();
+
+    ret.first->second = now + burst_tolerance + interval;
+}
+
+void RegShaper::cleanup(const timep &now)
+{
+    for(int i = 0; i < REG_SHAPER_SHARDS; i++) {
+        AmLock l(shards[i].mutex);
+        shards[i].next_cleanup = timep();
+        cleanup_unsafe(shards[i], now);
+    }
+}
+
+size_t RegShaper::keys_count()
+{
+    size_t ret = 0;
+    for(int i = 0; i < REG_SHAPER_SHARDS; i++) {
+        AmLock l(shards[i].mutex);
+        ret += shards[i].buckets.size();
+    }
+    return ret;
+}
@@ -1,31 +1,81 @@
 #pragma once
 
+#include "AmThread.h"
+
 #include <string>
-#include <map>
+#include <unordered_map>
 
 #include <chrono>
 #include <ratio>
 
 using std::string;
-using std::map;
 
+class AtomicCounter;
+
+#define REG_SHAPER_SHARDS 16
+#define DEFAULT_REG_SHAPER_IDLE_TIMEOUT_MSEC 60000
+
+/**
+ * per-key rate limiter.
+ *
+ * every key has the token bucket with 'burst' tokens refilled
+ * at the configured rate. bucket is kept as the single 'theoretical
+ * arrival time' (GCRA) which is the time when the bucket becomes full.
+ * keys are removed when the bucket stays full for the idle timeout.
+ *
+ * buckets are stored in the lock-striped hash, so the shaper
+ * can be used from the multiple threads.
+ *
+ * counters are reported per key class (label 'class'),
+ * shapers with the same key class share them.
+ */
 class RegShaper {
   public:
     typedef std::chrono::system_clock::time_point timep;
     typedef string ThrottlingHashKey;
+
   private:
-    typedef timep ThrottlingHashValue;
-    typedef map<ThrottlingHashKey,ThrottlingHashValue> ThrottlingHash;
+    typedef std::unordered_map<ThrottlingHashKey, timep> ThrottlingHash;
+
+    struct Shard {
+        AmMutex mutex;
+        ThrottlingHash buckets;
+        timep next_cleanup;
+    };
+
+    struct Metrics {
+        AtomicCounter &allowed;
+        AtomicCounter &throttled;
+        AtomicCounter &expired;
+        AtomicCounter &keys;
+
+        Metrics(const string &key_class);
+    };
 
     bool enabled;
-    std::chrono::milliseconds min_interval;
-    ThrottlingHash throttling_hash;
+    std::chrono::microseconds interval;
+    //bucket capacity expressed in time: (burst - 1) * interval
+    std::chrono::microseconds burst_tolerance;
+    std::chrono::milliseconds idle_timeout;
 
-  public:
+    Shard shards[REG_SHAPER_SHARDS];
+    Metrics &metrics;
+
+    static Metrics &get_metrics(const string &key_class);
 
-    RegShaper()
-      : enabled(false)
-    {}
+    Shard &get_shard(const ThrottlingHashKey &key);
+    void cleanup_unsafe(Shard &shard, const timep &now);
+    /* @return true if there is no token for the key.
+     * sets next_attempt_time to the time of the next free token if not nullptr,
+     * and reserves this token if 'reserve' */
+    bool take_token(const ThrottlingHashKey &key, const timep &now,
+                    timep *next_attempt_time, bool reserve);
+
+  public:
+    RegShaper(const string &key_class);
+    RegShaper(const RegShaper &) = delete;
+    RegShaper &operator=(const RegShaper &) = delete;
+    ~RegShaper();
 
     /**
      * @brief check if we have to postpone operation
@@ -37,6 +87,10 @@ class RegShaper {
                           timep &next_attempt_time);
     /**
      * @brief check if we have to postpone operation (with external now timepoint)
+     *
+     * postponed operation takes the token at the next_attempt_time,
+     * so the following postponed operations are spread over time
+     *
      * @param[in] key key for throttling bucket
      * @param[in] now timepoint
      * @param[out] next_attempt_time scheduled time for next attempt for the operation
@@ -46,9 +100,36 @@ class RegShaper {
                           const timep &now,
                           timep &next_attempt_time);
 
+    /**
+     * @brief check if the operation exceeds the limit and will be dropped.
+     * dropped operations do not take tokens
+     * @param[out] next_attempt_time time of the next free token for the key if not nullptr
+     * @return true if limit is exceeded
+     */
+    bool over_limit(const ThrottlingHashKey &key, const timep &now,
+                    timep *next_attempt_time = nullptr);
+
+    /** take all tokens from the key bucket (e.g. for the slow start) */
+    void drain(const ThrottlingHashKey &key, const timep &now);
+
+    /** remove expired keys from all shards */
+    void cleanup(const timep &now);
+
+    /** single operation per msec interval without burst */
     void set_min_interval(int msec)
     {
-        min_interval = std::chrono::milliseconds(msec);
-        enabled = true;
+        set_rate(1, msec, 1);
     }
+
+    /** 'rate' operations per 'per_msec' with up to 'burst' operations at once.
+     *  settings must not be changed concurrently with the checks */
+    void set_rate(unsigned int rate, unsigned int per_msec, unsigned int burst);
+
+    void set_idle_timeout(unsigned int msec)
+    {
+        idle_timeout = std::chrono::milliseconds(msec);
+    }
+
+    bool is_enabled() const { return enabled; }
+    size_t keys_count();
 };
@@ -210,6 +210,8 @@ int _SipCtrlInterface::init_tcp_servers(unsigned short if_num, unsigned short pr
     }
     tcp_socket->set_connect_timeout(tcp_info->tcp_connect_timeout);
     tcp_socket->set_idle_timeout(tcp_info->tcp_idle_timeout);
+    tcp_socket->set_send_queue_watermarks(tcp_info->tcp_send_queue_high,
+                                          tcp_info->tcp_send_queue_low);
 
     if(tcp_socket->bind(info.local_ip, info.local_port) < 0) {
 	ERROR("Could not bind SIP/TCP socket to %s:%i",
@@ -291,6 +293,8 @@ int _SipCtrlInterface::init_tls_servers(unsigned short if_num, unsigned short pr
 
     tls_socket->set_connect_timeout(tls_info->tcp_connect_timeout);
     tls_socket->set_idle_timeout(tls_info->tcp_idle_timeout);
+    tls_socket->set_send_queue_watermarks(tls_info->tcp_send_queue_high,
+                                          tls_info->tcp_send_queue_low);
 
     if(tls_socket->bind(info.local_ip, info.local_port) < 0) {
 	ERROR("Could not bind SIP/TCP socket to %s:%i",
@@ -900,6 +904,54 @@ int _SipCtrlInterface::send(const AmSipReply &rep, const string& dialog_id,
 }
 
 
+/* headers passed to the application as is in _AmSipMsgInDlg::hdrs */
+static inline bool is_app_header(const sip_header *h)
+{
+    return h->type == sip_header::H_OTHER || h->type == sip_header::H_REQUIRE;
+}
+
+/* reserve hdrs and index for all application headers at once */
+static void reserve_app_headers(const list<sip_header*>& hdrs,
+                                string &app_hdrs, AmSipHeadersIndex &index)
+{
+    size_t len = 0, count = 0;
+    for(const auto &h: hdrs) {
+        if(!is_app_header(h)) continue;
+        len += h->name.len + h->value.len + (sizeof(COLSP) - 1) + (sizeof(CRLF) - 1);
+        count++;
+    }
+    app_hdrs.reserve(app_hdrs.length() + len);
+    index.reserve(count);
+}
+
+/* append header to hdrs skipping CR/LF of the folded value
+ * and add it to the headers index */
+static void add_app_header(const sip_header *h,
+                           string &hdrs, AmSipHeadersIndex &index)
+{
+    size_t name_offset = hdrs.length();
+    hdrs.append(h->name.s, h->name.len);
+    hdrs.append(COLSP);
+
+    size_t value_offset = hdrs.length();
+    const char *c = h->value.s, *end = h->value.s + h->value.len, *chunk = c;
+    for(; c != end; c++) {
+        if(*c != '\r' && *c != '\n') continue;
+        hdrs.append(chunk, c - chunk);
+        chunk = c + 1;
+    }
+    hdrs.append(chunk, c - chunk);
+
+    //value starts after the spaces as for findHeader()
+    size_t value_start = value_offset;
+    while(value_start < hdrs.length() && hdrs[value_start] == ' ')
+        value_start++;
+    index.add(name_offset, h->name.len, hdrs,
+              value_start, hdrs.length() - value_start);
+
+    hdrs.append(CRLF);
+}
+
 inline bool _SipCtrlInterface::sip_msg2am_request(const sip_msg *msg,
 						 const trans_ticket& tt,
 						 AmSipRequest &req)
@@ -1005,16 +1057,15 @@ inline bool _SipCtrlInterface::sip_msg2am_request(const sip_msg *msg,
 
     prepare_routes_uas(msg->record_route, req.route);
 
+    AmSipHeadersIndex index;
+    string &hdrs = req.hdrs.modify();
+    reserve_app_headers(msg->hdrs, hdrs, index);
     for(const auto &h: msg->hdrs) {
         switch(h->type) {
         case sip_header::H_OTHER:
-        case sip_header::H_REQUIRE: {
-            string value = c2stlstr(h->value);
-            size_t rpos = 0;
-            while ((rpos=value.find_first_of("\r\n",rpos)) != string::npos)
-                value.erase(rpos, 1);
-            req.hdrs += c2stlstr(h->name) + COLSP + value + CRLF;
-        } break;
+        case sip_header::H_REQUIRE:
+            add_app_header(h, hdrs, index);
+            break;
         case sip_header::H_VIA:
             req.vias += c2stlstr(h->name) + ": "
                 + c2stlstr(h->value) + CRLF;
@@ -1031,6 +1082,7 @@ inline bool _SipCtrlInterface::sip_msg2am_request(const sip_msg *msg,
             break;
         }
     }
+    req.hdrs.setIndex(std::move(index));
 
     if(req.max_forwards < 0)
         req.max_forwards = AmConfig.max_forwards;
@@ -1120,19 +1172,18 @@ inline bool _SipCtrlInterface::sip_msg2am_reply(sip_msg *msg, AmSipReply &reply)
     prepare_routes_uac(msg->record_route, reply.route);
 
     unsigned rseq;
+    AmSipHeadersIndex index;
+    string &hdrs = reply.hdrs.modify();
+    reserve_app_headers(msg->hdrs, hdrs, index);
     for(const auto &h: msg->hdrs) {
 #ifdef PROPAGATE_UNPARSED_REPLY_HEADERS
         reply.unparsed_headers.push_back(AmSipHeader((*it)->name, (*it)->value));
 #endif
         switch (h->type) {
         case sip_header::H_OTHER:
-        case sip_header::H_REQUIRE: {
-            string value = c2stlstr(h->value);
-            size_t rpos = 0;
-            while ((rpos=value.find_first_of("\r\n",rpos)) != string::npos)
-                value.erase(rpos, 1);
-            reply.hdrs += c2stlstr(h->name) + COLSP + value + CRLF;
-        } break;
+        case sip_header::H_REQUIRE:
+            add_app_header(h, hdrs, index);
+            break;
         case sip_header::H_RSEQ:
             if(!parse_rseq(&rseq, h->value.s, static_cast<int>(h->value.len))) {
                 ERROR("failed to parse (rcvd) '" SIP_HDR_RSEQ "' hdr.");
@@ -1142,6 +1193,7 @@ inline bool _SipCtrlInterface::sip_msg2am_reply(sip_msg *msg, AmSipReply &reply)
             break;
         }
     }
+    reply.hdrs.setIndex(std::move(index));
 
     reply.remote_ip = get_addr_str(&msg->remote_ip);
     reply.remote_port = am_get_port(&msg->remote_ip);
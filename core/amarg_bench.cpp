@@ -0,0 +1,63 @@
+#include "amarg_bench.h"
+
+#include "json_bench.h"
+#include "jsonArg.h"
+
+#include <chrono>
+
+typedef std::chrono::steady_clock bench_clock;
+
+static double elapsed_ms(const bench_clock::time_point &start, unsigned int iterations)
+{
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count() /
+           iterations;
+}
+
+static void run(unsigned int sessions, unsigned int iterations, AmArg &ret)
+{
+    double build_ms = 0, copy_ms = 0, serialize_ms = 0, destroy_ms = 0;
+    size_t size = 0;
+
+    for(unsigned int i = 0; i < iterations; i++) {
+        auto start = bench_clock::now();
+        AmArg *dump = new AmArg();
+        json_bench_fill_sessions(*dump, sessions);
+        build_ms += elapsed_ms(start, iterations);
+
+        start = bench_clock::now();
+        AmArg *copy = new AmArg(*dump);
+        copy_ms += elapsed_ms(start, iterations);
+
+        start = bench_clock::now();
+        size = arg2json(*copy).size();
+        serialize_ms += elapsed_ms(start, iterations);
+
+        start = bench_clock::now();
+        delete copy;
+        delete dump;
+        destroy_ms += elapsed_ms(start, iterations);
+    }
+
+    ret["build_ms"] = build_ms;
+    ret["copy_ms"] = copy_ms;
+    ret["serialize_ms"] = serialize_ms;
+    ret["destroy_ms"] = destroy_ms;
+    ret["total_ms"] = build_ms + copy_ms + serialize_ms + destroy_ms;
+    ret["json_size"] = static_cast<long long>(size);
+}
+
+void amarg_bench(unsigned int sessions, unsigned int iterations, AmArg &ret)
+{
+    if(!iterations) iterations = 1;
+
+    ret["sessions"] = static_cast<int>(sessions);
+    ret["iterations"] = static_cast<int>(iterations);
+    ret["sizeof_amarg"] = static_cast<int>(sizeof(AmArg));
+
+#ifdef USE_AMARG_COMPACT
+    ret["mode"] = "compact";
+#else
+    ret["mode"] = "default";
+#endif
+    run(sessions, iterations, ret);
+}
@@ -0,0 +1,13 @@
+#ifndef AMARG_BENCH_H
+#define AMARG_BENCH_H
+
+#include "AmArg.h"
+
+#define DEFAULT_AMARG_BENCH_SESSIONS   10000
+#define DEFAULT_AMARG_BENCH_ITERATIONS 10
+
+/** measure build/copy/serialize/destroy of the synthetic 'show sessions' dump
+ *  for the current AmArg representation */
+void amarg_bench(unsigned int sessions, unsigned int iterations, AmArg &ret);
+
+#endif // AMARG_BENCH_H
@@ -31,6 +31,9 @@ struct BusMsg
     string          local_tag;
     string          application_method;
     string          body;
+    /** encoded by the connection if body is empty.
+        binary for the peers supporting it, json otherwise */
+    AmArg           data;
     uint64_t        updated;
     uint64_t        timeout;
 
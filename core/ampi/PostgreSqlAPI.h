@@ -13,6 +13,7 @@ using std::string;
 #define PG_DEFAULT_RET_INTERVAL   10     //in sec
 #define PG_DEFAULT_REC_INTERVAL   1      //in sec
 #define PG_DEFAULT_WAIT_TIME      5      //in sec
+#define PG_DEFAULT_CACHE_MAX_ENTRIES 10000
 
 class PGEvent : public AmEvent
 {
@@ -93,12 +94,21 @@ public:
     vector<unsigned int> oids;
     vector<string> sql_types;
 
+    //results cache. disabled if cache_ttl is 0
+    uint32_t cache_ttl; //in sec
+    uint32_t cache_max_entries;
+    vector<string> cache_invalidate_channels;
+
     PGPrepareData(const string& stmt_, const string& query_)
-    : stmt(stmt_), query(query_) {}
+    : stmt(stmt_), query(query_)
+    , cache_ttl(0), cache_max_entries(PG_DEFAULT_CACHE_MAX_ENTRIES) {}
     PGPrepareData(const PGPrepareData& data)
     : stmt(data.stmt), query(data.query)
     , oids(data.oids)
     , sql_types(data.sql_types)
+    , cache_ttl(data.cache_ttl)
+    , cache_max_entries(data.cache_max_entries)
+    , cache_invalidate_channels(data.cache_invalidate_channels)
     {}
 
     PGPrepareData& add_param_oid(unsigned int oid) {
@@ -110,6 +120,22 @@ public:
         sql_types.emplace_back(sql_type);
         return *this;
     }
+
+    /* results of PGPrepareExec for this statement will be cached
+     * by parameters values for ttl seconds */
+    PGPrepareData& cache_results(uint32_t ttl,
+                                 uint32_t max_entries = PG_DEFAULT_CACHE_MAX_ENTRIES)
+    {
+        cache_ttl = ttl;
+        cache_max_entries = max_entries;
+        return *this;
+    }
+
+    /* NOTIFY on channel flushes cached results of this statement */
+    PGPrepareData& add_cache_invalidate_channel(const string& channel) {
+        cache_invalidate_channels.push_back(channel);
+        return *this;
+    }
 };
 
 class PGWorkerConfig : public PGEvent
@@ -322,6 +348,18 @@ public:
         pdata.add_param_oid(oid);
         return *this;
     }
+
+    PGPrepare& cache_results(uint32_t ttl,
+                             uint32_t max_entries = PG_DEFAULT_CACHE_MAX_ENTRIES)
+    {
+        pdata.cache_results(ttl, max_entries);
+        return *this;
+    }
+
+    PGPrepare& add_cache_invalidate_channel(const string& channel) {
+        pdata.add_cache_invalidate_channel(channel);
+        return *this;
+    }
 };
 
 class PGPrepareExec : public PGEvent
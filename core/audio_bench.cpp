@@ -0,0 +1,94 @@
+#include "audio_bench.h"
+
+#include "AmAudio.h"
+
+#include <chrono>
+#include <vector>
+#include <memory>
+
+typedef std::chrono::steady_clock bench_clock;
+
+#define AUDIO_BENCH_SAMPLE_RATE 8000
+
+namespace {
+
+/** silence source and sink, buffers are used as by the file based audio */
+class BenchAudio
+  : public AmAudio
+{
+  protected:
+    int read(unsigned int, unsigned int size) override
+    {
+        memset(static_cast<unsigned char*>(samples), 0, size);
+        return static_cast<int>(size);
+    }
+
+    int write(unsigned int, unsigned int size) override
+    {
+        return static_cast<int>(size);
+    }
+
+  public:
+    size_t getAllocated() const
+    {
+        return sizeof(*this) + samples.getAllocated();
+    }
+};
+
+struct BenchCall {
+    BenchAudio player;
+    BenchAudio recorder;
+};
+
+}
+
+static void run(unsigned int calls, unsigned int ticks, AmArg &ret, bool use_scratch)
+{
+    std::vector<std::unique_ptr<BenchCall>> c;
+    c.reserve(calls);
+    for(unsigned int i = 0; i < calls; i++)
+        c.emplace_back(new BenchCall());
+
+    unsigned char buffer[AUDIO_BUFFER_SIZE];
+    unsigned int nb_samples = AUDIO_BENCH_SAMPLE_RATE * WC_INC_MS / 1000;
+    size_t scratch_before = AmAudioScratch::getAllocated();
+    unsigned long long ts = 0;
+
+    auto start = bench_clock::now();
+    for(unsigned int t = 0; t < ticks; t++) {
+        for(auto &call : c) {
+            std::unique_ptr<AmAudioScratch::Scope> scope;
+            if(use_scratch) scope.reset(new AmAudioScratch::Scope());
+
+            int size = call->player.get(ts, buffer, AUDIO_BENCH_SAMPLE_RATE, nb_samples);
+            if(size > 0)
+                call->recorder.put(ts, buffer, AUDIO_BENCH_SAMPLE_RATE, static_cast<unsigned int>(size));
+        }
+        ts = (ts + WC_INC) & WALLCLOCK_MASK;
+    }
+    double tick_ms =
+        std::chrono::duration<double, std::milli>(bench_clock::now() - start).count() / ticks;
+
+    size_t allocated = 0;
+    for(auto &call : c)
+        allocated += call->player.getAllocated() + call->recorder.getAllocated();
+    size_t scratch = AmAudioScratch::getAllocated() - scratch_before;
+
+    ret["tick_ms"] = tick_ms;
+    ret["audio_allocated"] = static_cast<long long>(allocated);
+    ret["scratch_allocated"] = static_cast<long long>(scratch);
+    ret["bytes_per_call"] = static_cast<long long>((allocated + scratch) / calls);
+}
+
+void audio_bench(unsigned int calls, unsigned int ticks, AmArg &ret)
+{
+    if(!calls) calls = 1;
+    if(!ticks) ticks = 1;
+
+    ret["calls"] = static_cast<int>(calls);
+    ret["ticks"] = static_cast<int>(ticks);
+    ret["sizeof_audio"] = static_cast<int>(sizeof(BenchAudio));
+
+    run(calls, ticks, ret["own_buffers"], false);
+    run(calls, ticks, ret["scratch"], true);
+}
@@ -0,0 +1,14 @@
+#ifndef AUDIO_BENCH_H
+#define AUDIO_BENCH_H
+
+#include "AmArg.h"
+
+#define DEFAULT_AUDIO_BENCH_CALLS 10000
+#define DEFAULT_AUDIO_BENCH_TICKS 10
+
+/** measure memory per call and time per media tick for calls
+ *  with a player and a recorder, with the sample buffers owned by the
+ *  audio objects and taken from the thread scratch space */
+void audio_bench(unsigned int calls, unsigned int ticks, AmArg &ret);
+
+#endif // AUDIO_BENCH_H
@@ -0,0 +1,269 @@
+#include "binArg.h"
+
+#include <string.h>
+#include <stdint.h>
+
+namespace {
+
+enum bin_tag {
+    TAG_UNDEF = 0,
+    TAG_FALSE,
+    TAG_TRUE,
+    TAG_INT,
+    TAG_LONGLONG,
+    TAG_DOUBLE,
+    TAG_CSTR,
+    TAG_BLOB,
+    TAG_ARRAY,
+    TAG_STRUCT
+};
+
+inline void put_varint(std::string &out, uint64_t v)
+{
+    char buf[10];
+    int n = 0;
+    while(v >= 0x80) {
+        buf[n++] = static_cast<char>(v | 0x80);
+        v >>= 7;
+    }
+    buf[n++] = static_cast<char>(v);
+    out.append(buf, n);
+}
+
+inline void put_signed(std::string &out, int64_t v)
+{
+    put_varint(out, (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+}
+
+inline void put_string(std::string &out, const char *s, size_t len)
+{
+    put_varint(out, len);
+    out.append(s, len);
+    out.push_back('\0');
+}
+
+void write_bin(const AmArg &a, std::string &out)
+{
+    switch(a.getType()) {
+    case AmArg::Bool:
+        out.push_back(a.asBool() ? TAG_TRUE : TAG_FALSE);
+        return;
+
+    case AmArg::Int:
+        out.push_back(TAG_INT);
+        put_signed(out, a.asInt());
+        return;
+
+    case AmArg::LongLong:
+        out.push_back(TAG_LONGLONG);
+        put_signed(out, a.asLongLong());
+        return;
+
+    case AmArg::Double: {
+        double d = a.asDouble();
+        uint64_t v;
+        memcpy(&v, &d, sizeof(v));
+        char buf[8];
+        for(int i = 0; i < 8; i++, v >>= 8)
+            buf[i] = static_cast<char>(v);
+        out.push_back(TAG_DOUBLE);
+        out.append(buf, sizeof(buf));
+        return;
+    }
+
+    case AmArg::CStr: {
+        const char *s = a.asCStr();
+        out.push_back(TAG_CSTR);
+        put_string(out, s, strlen(s));
+        return;
+    }
+
+    case AmArg::Blob: {
+        const ArgBlob *b = a.asBlob();
+        out.push_back(TAG_BLOB);
+        put_varint(out, b->len);
+        out.append(static_cast<const char *>(b->data), b->len);
+        return;
+    }
+
+    case AmArg::Array:
+        out.push_back(TAG_ARRAY);
+        put_varint(out, a.size());
+        for(size_t i = 0; i < a.size(); i++)
+            write_bin(a.get(i), out);
+        return;
+
+    case AmArg::Struct:
+        out.push_back(TAG_STRUCT);
+        put_varint(out, a.asStruct()->size());
+        for(const auto &it : *a.asStruct()) {
+            put_string(out, it.first.data(), it.first.size());
+            write_bin(it.second, out);
+        }
+        return;
+
+    default:
+        out.push_back(TAG_UNDEF);
+        return;
+    }
+}
+
+class BinParser
+{
+    const unsigned char *p;
+    const unsigned char *end;
+
+    bool get_varint(uint64_t &v)
+    {
+        v = 0;
+        for(int shift = 0; shift < 64 && p != end; shift += 7) {
+            unsigned char c = *p++;
+            v |= static_cast<uint64_t>(c & 0x7f) << shift;
+            if(!(c & 0x80)) return true;
+        }
+        return false;
+    }
+
+    bool get_signed(int64_t &v)
+    {
+        uint64_t u;
+        if(!get_varint(u)) return false;
+        v = static_cast<int64_t>((u >> 1) ^ (~(u & 1) + 1));
+        return true;
+    }
+
+    /** @return terminated string within the input */
+    const char *get_string(size_t &len)
+    {
+        uint64_t l;
+        if(!get_varint(l)) return nullptr;
+        if(l >= static_cast<uint64_t>(end - p) || p[l] != '\0') return nullptr;
+        const char *s = reinterpret_cast<const char *>(p);
+        p += l + 1;
+        len = l;
+        return s;
+    }
+
+  public:
+    BinParser(const char *input, size_t len)
+      : p(reinterpret_cast<const unsigned char *>(input)),
+        end(p + len)
+    {}
+
+    bool at_end() const { return p == end; }
+
+    bool parse_version()
+    {
+        return p != end && *p++ == BINARG_VERSION;
+    }
+
+    bool parse_value(AmArg &res, int depth = 0)
+    {
+        res.clear();
+
+        if(depth > BINARG_MAX_NESTING_DEPTH || p == end) return false;
+
+        switch(*p++) {
+        case TAG_UNDEF:
+            return true;
+        case TAG_FALSE:
+            res = false;
+            return true;
+        case TAG_TRUE:
+            res = true;
+            return true;
+        case TAG_INT: {
+            int64_t v;
+            if(!get_signed(v)) return false;
+            res = static_cast<long int>(v);
+            return true;
+        }
+        case TAG_LONGLONG: {
+            int64_t v;
+            if(!get_signed(v)) return false;
+            res = static_cast<long long>(v);
+            return true;
+        }
+        case TAG_DOUBLE: {
+            if(end - p < 8) return false;
+            uint64_t v = 0;
+            for(int i = 7; i >= 0; i--)
+                v = (v << 8) | p[i];
+            p += 8;
+            double d;
+            memcpy(&d, &v, sizeof(d));
+            res = d;
+            return true;
+        }
+        case TAG_CSTR: {
+            size_t len;
+            const char *s = get_string(len);
+            if(!s) return false;
+            res = s;
+            return true;
+        }
+        case TAG_BLOB: {
+            uint64_t len;
+            if(!get_varint(len) || len > static_cast<uint64_t>(end - p)) return false;
+            res = ArgBlob(p, len);
+            p += len;
+            return true;
+        }
+        case TAG_ARRAY: {
+            uint64_t count;
+            if(!get_varint(count) || count > static_cast<uint64_t>(end - p)) return false;
+            res.assertArray();
+            for(uint64_t i = 0; i < count; i++) {
+                res.push(AmArg());
+                if(!parse_value(res.get(res.size() - 1), depth + 1))
+                    return false;
+            }
+            return true;
+        }
+        case TAG_STRUCT: {
+            uint64_t count;
+            if(!get_varint(count) || count > static_cast<uint64_t>(end - p)) return false;
+            res.assertStruct();
+            for(uint64_t i = 0; i < count; i++) {
+                size_t len;
+                const char *key = get_string(len);
+                if(!key) return false;
+                if(!parse_value(res[key], depth + 1))
+                    return false;
+            }
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+};
+
+} //namespace
+
+void arg2bin(const AmArg &a, std::string &out)
+{
+    out.push_back(BINARG_VERSION);
+    write_bin(a, out);
+}
+
+std::string arg2bin(const AmArg &a)
+{
+    std::string ret;
+    arg2bin(a, ret);
+    return ret;
+}
+
+bool bin2arg(const char* input, size_t len, AmArg &res)
+{
+    BinParser parser(input, len);
+    if(parser.parse_version() && parser.parse_value(res) && parser.at_end())
+        return true;
+    res.clear();
+    return false;
+}
+
+bool bin2arg(const std::string &input, AmArg &res)
+{
+    return bin2arg(input.data(), input.size(), res);
+}
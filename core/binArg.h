@@ -0,0 +1,42 @@
+#ifndef _binArg_h_
+#define _binArg_h_
+
+#include "AmArg.h"
+
+#include <string>
+#include <sys/types.h>
+
+/**
+ * compact binary AmArg encoding
+ *
+ * the value starts with the version byte followed by the typed TLV tree:
+ *   tag byte, then
+ *   Int, LongLong:    zigzag varint
+ *   Double:           8 bytes little-endian IEEE 754
+ *   CStr:             varint length, bytes, '\0'
+ *   Blob:             varint length, bytes
+ *   Array:            varint count, values
+ *   Struct:           varint count, (varint key length, key bytes, '\0', value)*
+ * Undef and Bool have no payload. AObject, ADynInv and Reference are encoded as Undef.
+ *
+ * strings are terminated to be taken by the decoder directly from the input buffer
+ */
+
+#define BINARG_VERSION 1
+#define BINARG_MAX_NESTING_DEPTH 128
+
+/** append encoded value to the out */
+void arg2bin(const AmArg &a, std::string &out);
+
+std::string arg2bin(const AmArg &a);
+
+/**
+ * decode len bytes of input in place
+ * @return true on success
+ */
+bool bin2arg(const char* input, size_t len, AmArg &res);
+
+/** @return true on success */
+bool bin2arg(const std::string &input, AmArg &res);
+
+#endif
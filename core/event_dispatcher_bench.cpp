@@ -0,0 +1,114 @@
+#include "event_dispatcher_bench.h"
+
+#include "AmEventDispatcher.h"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+typedef std::chrono::steady_clock bench_clock;
+
+static double elapsed_ms(const bench_clock::time_point &start)
+{
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+}
+
+static double rate(unsigned int posts, double ms)
+{
+    return ms > 0 ? posts * 1000.0 / ms : 0;
+}
+
+namespace {
+
+//deterministic xorshift to get the same posts order on each run
+struct Random {
+    uint64_t s;
+    Random(): s(0x9e3779b97f4a7c15ULL) {}
+    uint64_t next() {
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        return s;
+    }
+};
+
+//counts events without taking ownership to measure the dispatching only
+struct BenchQueue: public AmEventQueueInterface {
+    unsigned long long posted;
+    BenchQueue(): posted(0) {}
+    void postEvent(AmEvent*) override { posted++; }
+};
+
+struct BenchDialog {
+    std::string local_tag;
+    std::string callid;
+    std::string remote_tag;
+    std::string via_branch;
+    AmEventQueueId qid;
+};
+
+}
+
+static void set_result(AmArg &ret, unsigned int posts, unsigned long long posted, double ms)
+{
+    ret["posts_per_sec"] = rate(posts, ms);
+    ret["ns_per_post"] = posts ? ms * 1000000.0 / posts : 0;
+    ret["posted"] = static_cast<long long>(posted);
+}
+
+void event_dispatcher_bench(unsigned int queues, unsigned int posts, AmArg &ret)
+{
+    Random rnd;
+    std::vector<BenchQueue> q(queues);
+    std::vector<BenchDialog> dialogs(queues);
+    std::vector<unsigned int> order(queues ? posts : 0);
+    std::unique_ptr<AmEventDispatcher> dispatcher(new AmEventDispatcher());
+    AmEvent ev(0);
+
+    for(unsigned int i = 0; i < queues; i++) {
+        std::string n = std::to_string(i);
+        dialogs[i].local_tag = "bench-" + n;
+        dialogs[i].callid = "bench-call-" + n + "@127.0.0.1";
+        dialogs[i].remote_tag = "bench-remote-" + n;
+        dialogs[i].via_branch = "z9hG4bK-bench-" + n;
+    }
+    for(auto &i : order)
+        i = rnd.next() % queues;
+
+    ret["queues"] = static_cast<long long>(queues);
+    ret["posts"] = static_cast<long long>(order.size());
+
+    auto start = bench_clock::now();
+    for(unsigned int i = 0; i < queues; i++) {
+        BenchDialog &d = dialogs[i];
+        dispatcher->addEventQueue(d.local_tag, &q[i],
+                                  d.callid, d.remote_tag, d.via_branch,
+                                  &d.qid);
+    }
+    ret["register_ms"] = elapsed_ms(start);
+
+    unsigned long long posted = 0;
+    start = bench_clock::now();
+    for(auto i : order)
+        posted += dispatcher->post(dialogs[i].local_tag, &ev);
+    set_result(ret["local_tag"], order.size(), posted, elapsed_ms(start));
+
+    posted = 0;
+    start = bench_clock::now();
+    for(auto i : order) {
+        const BenchDialog &d = dialogs[i];
+        posted += dispatcher->post(d.callid, d.remote_tag, d.via_branch, &ev);
+    }
+    set_result(ret["callid"], order.size(), posted, elapsed_ms(start));
+
+    posted = 0;
+    start = bench_clock::now();
+    for(auto i : order)
+        posted += dispatcher->post(dialogs[i].qid, &ev);
+    set_result(ret["qid"], order.size(), posted, elapsed_ms(start));
+
+    start = bench_clock::now();
+    for(const auto &d : dialogs)
+        dispatcher->delEventQueue(d.local_tag);
+    ret["unregister_ms"] = elapsed_ms(start);
+}
@@ -0,0 +1,13 @@
+#ifndef EVENT_DISPATCHER_BENCH_H
+#define EVENT_DISPATCHER_BENCH_H
+
+#include "AmArg.h"
+
+#define DEFAULT_EVENT_DISPATCHER_BENCH_QUEUES 100000
+#define DEFAULT_EVENT_DISPATCHER_BENCH_POSTS  1000000
+
+/** measure AmEventDispatcher post rate to the random queues
+ *  by local tag, by Call-ID/remote tag/via branch and by interned id */
+void event_dispatcher_bench(unsigned int queues, unsigned int posts, AmArg &ret);
+
+#endif // EVENT_DISPATCHER_BENCH_H
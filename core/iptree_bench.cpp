@@ -0,0 +1,186 @@
+#include "iptree_bench.h"
+
+#include "IPTree.h"
+#include "AmSubnet.h"
+#include "sip/transport.h"
+
+#include <arpa/inet.h>
+#include <string.h>
+
+#include <chrono>
+#include <vector>
+
+typedef std::chrono::steady_clock bench_clock;
+
+//linear scan is too slow to run for all lookups on the big sets
+#define IPTREE_BENCH_LINEAR_MAX_CHECKS 100000000ULL
+
+static double elapsed_ms(const bench_clock::time_point &start)
+{
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+}
+
+static double rate(unsigned int lookups, double ms)
+{
+    return ms > 0 ? lookups * 1000.0 / ms : 0;
+}
+
+namespace {
+
+//deterministic xorshift to get the same sets on each run
+struct Random {
+    uint64_t s;
+    Random(): s(0x9e3779b97f4a7c15ULL) {}
+    uint64_t next() {
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        return s;
+    }
+};
+
+}
+
+/* 4 of 5 addresses are IPv4 ones.
+ * IPv4 addresses are taken from the 10.0.0.0/8 and IPv6 from 2001:db8::/32
+ * to get the nested prefixes and reasonable match ratio */
+static void random_addr(Random &rnd, sockaddr_storage &addr)
+{
+    memset(&addr, 0, sizeof(addr));
+    uint64_t r = rnd.next();
+    if(r % 5) {
+        sockaddr_in *sin = reinterpret_cast<sockaddr_in *>(&addr);
+        sin->sin_family = AF_INET;
+        sin->sin_addr.s_addr = htonl(0x0a000000 | ((r >> 8) & 0xffffff));
+    } else {
+        sockaddr_in6 *sin6 = reinterpret_cast<sockaddr_in6 *>(&addr);
+        sin6->sin6_family = AF_INET6;
+        uint64_t hi = 0x20010db800000000ULL | ((r >> 8) & 0xffffffff);
+        uint64_t lo = rnd.next();
+        for(int i = 0; i < 8; i++) {
+            sin6->sin6_addr.s6_addr[i] = hi >> (56 - i * 8);
+            sin6->sin6_addr.s6_addr[8 + i] = lo >> (56 - i * 8);
+        }
+    }
+}
+
+static bool random_subnet(Random &rnd, AmSubnet &net)
+{
+    sockaddr_storage addr;
+    char buf[INET6_ADDRSTRLEN];
+
+    random_addr(rnd, addr);
+    unsigned int len;
+    if(addr.ss_family == AF_INET) {
+        inet_ntop(AF_INET, &reinterpret_cast<sockaddr_in *>(&addr)->sin_addr, buf, sizeof(buf));
+        len = 16 + rnd.next() % 17;
+    } else {
+        inet_ntop(AF_INET6, &reinterpret_cast<sockaddr_in6 *>(&addr)->sin6_addr, buf, sizeof(buf));
+        len = 40 + rnd.next() % 89;
+    }
+
+    return net.parse(std::string(buf) + "/" + std::to_string(len));
+}
+
+void iptree_bench(unsigned int prefixes, unsigned int lookups, AmArg &ret)
+{
+    Random rnd;
+    std::vector<AmSubnet> subnets;
+    std::vector<sockaddr_storage> addrs(lookups ? lookups : 1);
+    lookups = addrs.size();
+
+    subnets.reserve(prefixes);
+    while(subnets.size() < prefixes) {
+        AmSubnet net;
+        if(random_subnet(rnd, net))
+            subnets.push_back(net);
+    }
+    for(auto &a : addrs)
+        random_addr(rnd, a);
+
+    ret["prefixes"] = static_cast<long long>(prefixes);
+    ret["lookups"] = static_cast<long long>(lookups);
+
+    auto start = bench_clock::now();
+    IPTree tree;
+    for(size_t i = 0; i < subnets.size(); i++)
+        tree.addSubnet(subnets[i], i);
+    ret["iptree"]["build_ms"] = elapsed_ms(start);
+
+    start = bench_clock::now();
+    CompiledIPTree compiled(tree);
+    ret["compiled"]["build_ms"] = elapsed_ms(start);
+    ret["compiled"]["info"] = compiled;
+
+    start = bench_clock::now();
+    trsp_acl acl;
+    acl.set_networks(subnets);
+    ret["acl"]["build_ms"] = elapsed_ms(start);
+
+    unsigned long long matched = 0;
+    IPTree::MatchResult m;
+
+    //linear scan of AmSubnet::contains() as it was done by trsp_acl
+    unsigned int linear_lookups = lookups;
+    if(prefixes && static_cast<unsigned long long>(linear_lookups) * prefixes > IPTREE_BENCH_LINEAR_MAX_CHECKS)
+        linear_lookups = IPTREE_BENCH_LINEAR_MAX_CHECKS / prefixes;
+    if(!linear_lookups) linear_lookups = 1;
+    start = bench_clock::now();
+    for(unsigned int i = 0; i < linear_lookups; i++) {
+        for(const auto &net : subnets) {
+            if(net.contains(addrs[i])) {
+                matched++;
+                break;
+            }
+        }
+    }
+    double ms = elapsed_ms(start);
+    ret["linear"]["lookups"] = static_cast<long long>(linear_lookups);
+    ret["linear"]["lookups_per_sec"] = rate(linear_lookups, ms);
+    ret["linear"]["matched"] = static_cast<long long>(matched);
+
+    matched = 0;
+    start = bench_clock::now();
+    for(const auto &a : addrs) {
+        m.clear();
+        tree.match(a, m);
+        matched += m.size();
+    }
+    ms = elapsed_ms(start);
+    ret["iptree"]["lookups_per_sec"] = rate(lookups, ms);
+    ret["iptree"]["matched"] = static_cast<long long>(matched);
+
+    matched = 0;
+    start = bench_clock::now();
+    for(const auto &a : addrs) {
+        m.clear();
+        compiled.match(a, m);
+        matched += m.size();
+    }
+    ms = elapsed_ms(start);
+    ret["compiled"]["match_per_sec"] = rate(lookups, ms);
+    ret["compiled"]["matched"] = static_cast<long long>(matched);
+
+    matched = 0;
+    start = bench_clock::now();
+    for(const auto &a : addrs)
+        matched += compiled.match_longest(a) >= 0;
+    ms = elapsed_ms(start);
+    ret["compiled"]["longest_per_sec"] = rate(lookups, ms);
+
+    matched = 0;
+    start = bench_clock::now();
+    for(const auto &a : addrs)
+        matched += compiled.contains(a);
+    ms = elapsed_ms(start);
+    ret["compiled"]["contains_per_sec"] = rate(lookups, ms);
+    ret["compiled"]["contained"] = static_cast<long long>(matched);
+
+    matched = 0;
+    start = bench_clock::now();
+    for(const auto &a : addrs)
+        matched += acl.check(a) == trsp_acl::Allow;
+    ms = elapsed_ms(start);
+    ret["acl"]["lookups_per_sec"] = rate(lookups, ms);
+    ret["acl"]["allowed"] = static_cast<long long>(matched);
+}
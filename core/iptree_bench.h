@@ -0,0 +1,13 @@
+#ifndef IPTREE_BENCH_H
+#define IPTREE_BENCH_H
+
+#include "AmArg.h"
+
+#define DEFAULT_IPTREE_BENCH_PREFIXES 10000
+#define DEFAULT_IPTREE_BENCH_LOOKUPS  1000000
+
+/** measure lookups rate for the random IPv4/IPv6 prefixes set
+ *  using linear AmSubnet scan, IPTree, CompiledIPTree and trsp_acl */
+void iptree_bench(unsigned int prefixes, unsigned int lookups, AmArg &ret);
+
+#endif // IPTREE_BENCH_H
@@ -38,6 +38,11 @@ using std::string;
 using namespace jsonxx;
 
 #include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
 
 const char *hex_chars = "0123456789abcdef";
 
@@ -51,19 +56,6 @@ string str2json(const string& str)
   return str2json(str.c_str(),str.length());
 }
 
-static bool isAnyCharRequiredQuoting(char const* s, size_t n)
-{
-    char const* const end = s + n;
-    for (char const* cur = s; cur < end; ++cur) {
-        if (*cur == '\\' || *cur == '\"' || *cur < ' ' ||
-            static_cast<unsigned char>(*cur) < 0x80)
-        {
-            return true;
-        }
-    }
-    return false;
-}
-
 static unsigned int utf8ToCodepoint(const char*& s, const char* e) {
     const unsigned int REPLACEMENT_CHARACTER = 0xFFFD;
 
@@ -115,149 +107,506 @@ static unsigned int utf8ToCodepoint(const char*& s, const char* e) {
     return REPLACEMENT_CHARACTER;
 }
 
-static const char hex2[] = "000102030405060708090a0b0c0d0e0f"
-                           "101112131415161718191a1b1c1d1e1f"
-                           "202122232425262728292a2b2c2d2e2f"
-                           "303132333435363738393a3b3c3d3e3f"
-                           "404142434445464748494a4b4c4d4e4f"
-                           "505152535455565758595a5b5c5d5e5f"
-                           "606162636465666768696a6b6c6d6e6f"
-                           "707172737475767778797a7b7c7d7e7f"
-                           "808182838485868788898a8b8c8d8e8f"
-                           "909192939495969798999a9b9c9d9e9f"
-                           "a0a1a2a3a4a5a6a7a8a9aaabacadaeaf"
-                           "b0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
-                           "c0c1c2c3c4c5c6c7c8c9cacbcccdcecf"
-                           "d0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
-                           "e0e1e2e3e4e5e6e7e8e9eaebecedeeef"
-                           "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
-
-static string toHex16Bit(unsigned int x) {
-  const unsigned int hi = (x >> 8) & 0xff;
-  const unsigned int lo = x & 0xff;
-  string result(4, ' ');
-  result[0] = hex2[2 * hi];
-  result[1] = hex2[2 * hi + 1];
-  result[2] = hex2[2 * lo];
-  result[3] = hex2[2 * lo + 1];
-  return result;
+namespace {
+
+/* SWAR helpers to check 8 bytes at once */
+const uint64_t ones = ~(uint64_t)0 / 255;
+const uint64_t highs = ones * 0x80;
+
+inline uint64_t load64(const char *s)
+{
+    uint64_t v;
+    memcpy(&v, s, sizeof(v));
+    return v;
 }
 
-string str2json(const char* str, size_t len)
+inline uint64_t has_zero(uint64_t v)
+{
+    return (v - ones) & ~v & highs;
+}
+
+inline uint64_t has_byte(uint64_t v, unsigned char c)
+{
+    return has_zero(v ^ (ones * c));
+}
+
+/* @return true if any of 8 bytes requires escaping:
+ * control characters, non-ASCII, '"' or '\\' */
+inline bool has_unsafe_byte(uint64_t v)
+{
+    return ((v - ones * 0x20) & ~v & highs) | //< 0x20
+           (v & highs) |                      //>= 0x80
+           has_byte(v, '"') | has_byte(v, '\\');
+}
+
+/* @return true if any of 8 bytes is '"' or '\\' */
+inline bool has_quote_or_backslash(uint64_t v)
 {
-    if(!isAnyCharRequiredQuoting(str,len)) {
-        string result = string("\"") + str + "\"";
-        fixup_utf8_inplace(result);
-        return result;
+    return has_byte(v, '"') | has_byte(v, '\\');
+}
+
+inline bool is_safe_char(unsigned char c)
+{
+    return c >= 0x20 && c < 0x80 && c != '"' && c != '\\';
+}
+
+/* appends into one growing string */
+struct JsonStringWriter {
+    string &s;
+
+    JsonStringWriter(string &s)
+      : s(s)
+    {}
+
+    bool put(char c) { s.push_back(c); return true; }
+    bool put(const char *p, size_t len) { s.append(p, len); return true; }
+};
+
+/* writes into the fixed size buffer. fails on overflow */
+struct JsonBufWriter {
+    char *p;
+    char *end;
+
+    JsonBufWriter(char *buf, size_t size)
+      : p(buf), end(buf + size)
+    {}
+
+    bool put(char c)
+    {
+        if(p == end) return false;
+        *p++ = c;
+        return true;
     }
 
-    // We have to walk value and escape any special characters.
-    // Appending to std::string is not efficient, but this should be rare.
-    // (Note: forward slashes are *not* rare, but I am not escaping them.)
-    unsigned maxsize = len*2 + 3; // allescaped+quotes+NULL
-    std::string result;
-    result.reserve(maxsize); // to avoid lots of mallocs
-    result += "\"";
-    const char* end = str + len;
-    for (const char* c = str; (c != end) && (*c != 0); ++c) {
-        switch(*c) {
-        case '\"':
-            result += "\\\"";
-            break;
-        case '\\':
-            result += "\\\\";
-            break;
-        case '\b':
-            result += "\\b";
-            break;
-        case '\f':
-            result += "\\f";
-            break;
-        case '\n':
-            result += "\\n";
-            break;
-        case '\r':
-            result += "\\r";
-            break;
-        case '\t':
-            result += "\\t";
+    bool put(const char *s, size_t len)
+    {
+        if(static_cast<size_t>(end - p) < len) return false;
+        memcpy(p, s, len);
+        p += len;
+        return true;
+    }
+};
+
+template<typename Writer>
+bool put_u16(Writer &w, unsigned int x)
+{
+    char buf[6] = {
+        '\\', 'u',
+        hex_chars[(x >> 12) & 0xf], hex_chars[(x >> 8) & 0xf],
+        hex_chars[(x >> 4) & 0xf], hex_chars[x & 0xf]
+    };
+    return w.put(buf, sizeof(buf));
+}
+
+/* escaping is stopped on the first null character.
+ * non-ASCII characters are written as \uXXXX sequences */
+template<typename Writer>
+bool write_json_string(const char *str, size_t len, Writer &w)
+{
+    if(!w.put('"')) return false;
+
+    const char *end = str + len;
+    const char *run = str; //start of not yet written safe characters
+    const char *c = str;
+
+    while(c != end) {
+        //skip safe characters by 8 bytes
+        while(end - c >= 8 && !has_unsafe_byte(load64(c)))
+            c += 8;
+        while(c != end && is_safe_char(static_cast<unsigned char>(*c)))
+            c++;
+
+        if(c != run && !w.put(run, c - run)) return false;
+        if(c == end || *c == 0) {
+            run = c;
             break;
-        //case '/':
-            // Even though \/ is considered a legal escape in JSON, a bare
-            // slash is also legal, so I see no reason to escape it.
-            // (I hope I am not misunderstanding something.)
+        }
+
+        bool ret;
+        switch(*c) {
+        case '"': ret = w.put("\\\"", 2); break;
+        case '\\': ret = w.put("\\\\", 2); break;
+        case '\b': ret = w.put("\\b", 2); break;
+        case '\f': ret = w.put("\\f", 2); break;
+        case '\n': ret = w.put("\\n", 2); break;
+        case '\r': ret = w.put("\\r", 2); break;
+        case '\t': ret = w.put("\\t", 2); break;
         default: {
             unsigned int cp = utf8ToCodepoint(c, end);
             if (cp < 0x80 && cp >= 0x20)
-                    result += static_cast<char>(cp);
-            else if (cp < 0x10000) { // codepoint is in Basic Multilingual Plane
-                result += "\\u";
-                result += toHex16Bit(cp);
-            } else {
+                ret = w.put(static_cast<char>(cp));
+            else if (cp < 0x10000) // codepoint is in Basic Multilingual Plane
+                ret = put_u16(w, cp);
+            else {
                 cp -= 0x10000;
-                result += "\\u";
-                result += toHex16Bit((cp >> 10) + 0xD800);
-                result += "\\u";
-                result += toHex16Bit((cp & 0x3FF) + 0xDC00);
+                ret = put_u16(w, (cp >> 10) + 0xD800) &&
+                      put_u16(w, (cp & 0x3FF) + 0xDC00);
             }
         } break;
-        } //switch(*c)
+        }
+        if(!ret) return false;
+
+        run = ++c;
     }
-    result += "\"";
 
-    fixup_utf8_inplace(result);
+    return w.put('"');
+}
 
-    return result;
+template<typename Writer>
+bool put_integer(Writer &w, long long v)
+{
+    char buf[24];
+    char *p = buf + sizeof(buf);
+    unsigned long long u = v < 0 ? 0ULL - static_cast<unsigned long long>(v) : v;
+    do {
+        *--p = '0' + u % 10;
+        u /= 10;
+    } while(u);
+    if(v < 0) *--p = '-';
+    return w.put(p, buf + sizeof(buf) - p);
 }
 
-string arg2json(const AmArg &a) {
-  // TODO: optimize to avoid lots of mallocs
-  // TODO: how to get a bool? 
-  string s;
-  switch (a.getType()) {
-  case AmArg::Undef:
-    return "null";
+template<typename Writer>
+bool write_json(const AmArg &a, Writer &w)
+{
+    switch (a.getType()) {
+    case AmArg::Undef:
+        return w.put("null", 4);
 
-  case AmArg::Int:
-    return a.asInt()<0?"-"+int2str(abs(a.asInt())):int2str(abs(a.asInt()));
+    case AmArg::Int:
+        return put_integer(w, a.asInt());
 
-  case AmArg::LongLong:
-    return longlong2str(a.asLongLong());
+    case AmArg::LongLong:
+        return put_integer(w, a.asLongLong());
 
-  case AmArg::Bool:
-    return a.asBool()?"true":"false";
+    case AmArg::Bool:
+        return a.asBool() ? w.put("true", 4) : w.put("false", 5);
 
-  case AmArg::Double: 
-    return double2str(a.asDouble());
+    case AmArg::Double: {
+        string d = double2str(a.asDouble());
+        return w.put(d.data(), d.size());
+    }
 
-  case AmArg::CStr:
-    return str2json(a.asCStr());
+    case AmArg::CStr: {
+        const char *s = a.asCStr();
+        return write_json_string(s, strlen(s), w);
+    }
 
-  case AmArg::Array:
-    s = "[";
-    for (size_t i = 0; i < a.size(); i ++)
-      s += arg2json(a[i]) + ",";
-    if (1 < s.size()) 
-      s.resize(s.size() - 1); // strip last ","
-    s += "]";
-    return s;
+    case AmArg::Array:
+        if(!w.put('[')) return false;
+        for (size_t i = 0; i < a.size(); i ++) {
+            if(i && !w.put(',')) return false;
+            if(!write_json(a[i], w)) return false;
+        }
+        return w.put(']');
+
+    case AmArg::Struct: {
+        if(!w.put('{')) return false;
+        bool first = true;
+        for (const auto &it : *a.asStruct()) {
+            if(!first && !w.put(',')) return false;
+            first = false;
+            //keys are written as is
+            if(!w.put('"') || !w.put(it.first.data(), it.first.size()) || !w.put("\":", 2))
+                return false;
+            if(!write_json(it.second, w)) return false;
+        }
+        return w.put('}');
+    }
 
-  case AmArg::Struct:
-    s = "{";
-    for (AmArg::ValueStruct::const_iterator it = a.asStruct()->begin();
-	 it != a.asStruct()->end(); it ++) {
-      s += '"'+it->first + "\":";
-      s += arg2json(it->second);
-      s += ",";
+    default: break;
     }
-    if (1 < s.size())
-      s.resize(s.size() - 1); // strip last ","
-    s += "}";
+
+    return w.put("{}", 2);
+}
+
+} //namespace
+
+string str2json(const char* str, size_t len)
+{
+    string result;
+    result.reserve(len + 2);
+    JsonStringWriter w(result);
+    write_json_string(str, len, w);
+    return result;
+}
+
+string arg2json(const AmArg &a)
+{
+    string s;
+    s.reserve(256);
+    JsonStringWriter w(s);
+    write_json(a, w);
     return s;
-  default: break;
-  }
+}
+
+ssize_t arg2json(const AmArg &a, char* buf, size_t buf_size)
+{
+    JsonBufWriter w(buf, buf_size);
+    if(!write_json(a, w)) return -1;
+    return w.p - buf;
+}
+
+namespace {
+
+#define JSON_MAX_NESTING_DEPTH 512
+
+/* in-place parser over the [p, end) range.
+ * accepts the same syntax as the jsonxx based istream parser:
+ * \u escapes are kept as is, trailing comma is allowed in objects,
+ * data after the top-level value is ignored */
+class JsonBufParser {
+    const char *p;
+    const char *end;
+    string scratch;
 
-  return "{}";
+    void skip_ws()
+    {
+        while(p != end && isspace(static_cast<unsigned char>(*p)))
+            p++;
+    }
+
+    bool match(char c)
+    {
+        skip_ws();
+        if(p == end || *p != c) return false;
+        p++;
+        return true;
+    }
+
+    bool match_word(const char *word, size_t len)
+    {
+        if(static_cast<size_t>(end - p) < len || memcmp(p, word, len))
+            return false;
+        p += len;
+        return true;
+    }
+
+    //expects p after opening quote
+    bool parse_string(string &s);
+    bool parse_number(AmArg &res);
+    bool parse_array(AmArg &res, int depth);
+    bool parse_object(AmArg &res, int depth);
+
+  public:
+    JsonBufParser(const char *input, size_t len)
+      : p(input), end(input + len)
+    {}
+
+    bool parse_value(AmArg &res, int depth = 0);
+};
+
+bool JsonBufParser::parse_string(string &s)
+{
+    s.clear();
+    while(true) {
+        const char *run = p;
+        //skip regular characters by 8 bytes
+        while(end - p >= 8 && !has_quote_or_backslash(load64(p)))
+            p += 8;
+        while(p != end && *p != '"' && *p != '\\')
+            p++;
+        s.append(run, p - run);
+
+        if(p == end) return false;
+
+        if(*p++ == '"') return true;
+
+        //escape sequence
+        if(p == end) return false;
+        switch(*p) {
+        case '"':
+        case '\\':
+        case '/': s.push_back(*p); break;
+        case 'b': s.push_back('\b'); break;
+        case 'f': s.push_back('\f'); break;
+        case 'n': s.push_back('\n'); break;
+        case 'r': s.push_back('\r'); break;
+        case 't': s.push_back('\t'); break;
+        case 'u': s.append("\\u", 2); break;
+        default: return false;
+        }
+        p++;
+    }
+}
+
+bool JsonBufParser::parse_number(AmArg &res)
+{
+    const char *start = p;
+    bool negative = false;
+    bool has_dot = false;
+    bool has_digits = false;
+    bool exp_negative = false;
+    unsigned int exp = 0;
+    unsigned long long mantissa = 0;
+    bool mantissa_overflow = false;
+
+    if(*p == '-' || *p == '+') {
+        negative = *p == '-';
+        p++;
+    }
+
+    for(; p != end; p++) {
+        if(*p >= '0' && *p <= '9') {
+            has_digits = true;
+            if(has_dot) continue;
+            if(mantissa > (ULLONG_MAX - 9) / 10) mantissa_overflow = true;
+            else mantissa = mantissa * 10 + (*p - '0');
+        } else if(*p == '.' && !has_dot) {
+            has_dot = true;
+        } else {
+            break;
+        }
+    }
+
+    if(!has_digits) return false;
+
+    if(p != end && (*p == 'e' || *p == 'E')) {
+        p++;
+        if(p != end && (*p == '-' || *p == '+')) {
+            exp_negative = *p == '-';
+            p++;
+        }
+        if(p == end || *p < '0' || *p > '9')
+            return false;
+        for(; p != end && *p >= '0' && *p <= '9'; p++) {
+            if(exp < 10000) exp = exp * 10 + (*p - '0');
+        }
+    }
+
+    if(!has_dot && !exp_negative && !mantissa_overflow) {
+        //integer value
+        bool overflow = false;
+        for(unsigned int i = 0; i < exp && mantissa; i++) {
+            if(mantissa > ULLONG_MAX / 10) {
+                overflow = true;
+                break;
+            }
+            mantissa *= 10;
+        }
+
+        if(!overflow) {
+            if(!negative && mantissa <= INT_MAX) {
+                res = static_cast<int>(mantissa);
+                return true;
+            }
+            if(negative && mantissa <= static_cast<unsigned long long>(INT_MAX) + 1) {
+                res = static_cast<int>(-static_cast<long long>(mantissa));
+                return true;
+            }
+            if(!negative && mantissa <= LLONG_MAX) {
+                res = static_cast<long long>(mantissa);
+                return true;
+            }
+            if(negative && mantissa <= static_cast<unsigned long long>(LLONG_MAX) + 1) {
+                res = static_cast<long long>(-mantissa);
+                return true;
+            }
+        }
+    }
+
+    //floating point or out of range integer value
+    size_t len = p - start;
+    char buf[64];
+    if(len < sizeof(buf)) {
+        memcpy(buf, start, len);
+        buf[len] = '\0';
+        res = strtod(buf, nullptr);
+    } else {
+        res = strtod(string(start, len).c_str(), nullptr);
+    }
+    return true;
+}
+
+bool JsonBufParser::parse_array(AmArg &res, int depth)
+{
+    res.assertArray();
+
+    if(match(']')) return true;
+
+    do {
+        res.push(AmArg());
+        if(!parse_value(res.get(res.size()-1), depth + 1))
+            return false;
+    } while(match(','));
+
+    return match(']');
+}
+
+bool JsonBufParser::parse_object(AmArg &res, int depth)
+{
+    res.assertStruct();
+
+    if(match('}')) return true;
+
+    do {
+        if(!match('"')) {
+            //allow trailing comma
+            return match('}');
+        }
+        if(!parse_string(scratch)) return false;
+        if(!match(':')) return false;
+        if(!parse_value(res[scratch], depth + 1))
+            return false;
+    } while(match(','));
+
+    return match('}');
+}
+
+bool JsonBufParser::parse_value(AmArg &res, int depth)
+{
+    res.clear();
+
+    if(depth > JSON_MAX_NESTING_DEPTH) return false;
+
+    skip_ws();
+    if(p == end) return false;
+
+    switch(*p) {
+    case '"':
+        p++;
+        if(!parse_string(scratch)) return false;
+        res = scratch;
+        return true;
+    case '[':
+        p++;
+        return parse_array(res, depth);
+    case '{':
+        p++;
+        return parse_object(res, depth);
+    case 't':
+        if(!match_word("true", 4)) return false;
+        res = true;
+        return true;
+    case 'f':
+        if(!match_word("false", 5)) return false;
+        res = false;
+        return true;
+    case 'n':
+        return match_word("null", 4);
+    default:
+        if((*p >= '0' && *p <= '9') || *p == '-' || *p == '+' || *p == '.')
+            return parse_number(res);
+        return false;
+    }
+}
+
+} //namespace
+
+bool json2arg(const std::string& input, AmArg& res) {
+  return json2arg(input.data(), input.size(), res);
+}
+
+bool json2arg(const char* input, AmArg& res) {
+  return json2arg(input, strlen(input), res);
+}
+
+bool json2arg(const char* input, size_t len, AmArg& res) {
+  JsonBufParser parser(input, len);
+  if(parser.parse_value(res))
+    return true;
+  res.clear();
+  return false;
 }
 
 // based on jsonxx
@@ -329,16 +678,6 @@ bool object_parse(std::istream& input, AmArg& res) {
   return true;
 }
 
-bool json2arg(const std::string& input, AmArg& res) {
-  std::istringstream iss(input);
-  return json2arg(iss, res);
-}
-
-bool json2arg(const char* input, AmArg& res) {
-  std::istringstream iss(input);
-  return json2arg(iss, res);
-}
-
 bool json2arg(std::istream& input, AmArg& res) {
 
   res.clear();
@@ -31,6 +31,7 @@
 #define _jsonArg_h_
 #include <string>
 #include <iostream>
+#include <sys/types.h>
 #include "AmArg.h"
 
 std::string str2json(const char* str);
@@ -39,6 +40,12 @@ std::string str2json(const char* str, size_t len);
 
 string arg2json(const AmArg &a);
 
+/**
+ * serialize directly into the preallocated buffer
+ * @return serialized data length or -1 if buf_size is not enough
+ */
+ssize_t arg2json(const AmArg &a, char* buf, size_t buf_size);
+
 /** @return true on success */
 bool json2arg(std::istream& input, AmArg& res);
 
@@ -47,4 +54,10 @@ bool json2arg(const char* input, AmArg& res);
 
 /** @return true on success */
 bool json2arg(const std::string& input, AmArg& res);
+
+/**
+ * parse len bytes of input in place (input is not required to be null-terminated)
+ * @return true on success
+ */
+bool json2arg(const char* input, size_t len, AmArg& res);
 #endif
@@ -0,0 +1,289 @@
+#include "json_bench.h"
+
+#include "jsonArg.h"
+#include "binArg.h"
+#include "AmUtils.h"
+#include "log.h"
+
+#include <chrono>
+#include <sstream>
+#include <vector>
+
+/* string based serializer as it was before the buffer writer.
+ * kept here as the reference for the benchmark */
+
+static unsigned int legacy_utf8_to_codepoint(const char*& s, const char* e)
+{
+    const unsigned int REPLACEMENT_CHARACTER = 0xFFFD;
+    unsigned int firstByte = static_cast<unsigned char>(*s);
+
+    if (firstByte < 0x80)
+        return firstByte;
+
+    if (firstByte < 0xE0) {
+        if (e - s < 2)
+            return REPLACEMENT_CHARACTER;
+        unsigned int calculated =
+            ((firstByte & 0x1F) << 6) | (static_cast<unsigned int>(s[1]) & 0x3F);
+        s += 1;
+        return calculated < 0x80 ? REPLACEMENT_CHARACTER : calculated;
+    }
+
+    if (firstByte < 0xF0) {
+        if (e - s < 3)
+            return REPLACEMENT_CHARACTER;
+        unsigned int calculated = ((firstByte & 0x0F) << 12) |
+                                  ((static_cast<unsigned int>(s[1]) & 0x3F) << 6) |
+                                  (static_cast<unsigned int>(s[2]) & 0x3F);
+        s += 2;
+        if (calculated >= 0xD800 && calculated <= 0xDFFF)
+            return REPLACEMENT_CHARACTER;
+        return calculated < 0x800 ? REPLACEMENT_CHARACTER : calculated;
+    }
+
+    if (firstByte < 0xF8) {
+        if (e - s < 4)
+            return REPLACEMENT_CHARACTER;
+        unsigned int calculated = ((firstByte & 0x07) << 18) |
+                                  ((static_cast<unsigned int>(s[1]) & 0x3F) << 12) |
+                                  ((static_cast<unsigned int>(s[2]) & 0x3F) << 6) |
+                                   (static_cast<unsigned int>(s[3]) & 0x3F);
+        s += 3;
+        return calculated < 0x10000 ? REPLACEMENT_CHARACTER : calculated;
+    }
+
+    return REPLACEMENT_CHARACTER;
+}
+
+static string legacy_hex16(unsigned int x)
+{
+    char buf[5];
+    snprintf(buf, sizeof(buf), "%04x", x & 0xffff);
+    return buf;
+}
+
+static string legacy_str2json(const char* str, size_t len)
+{
+    std::string result;
+    result.reserve(len*2 + 3);
+    result += "\"";
+    const char* end = str + len;
+    for (const char* c = str; (c != end) && (*c != 0); ++c) {
+        switch(*c) {
+        case '\"': result += "\\\""; break;
+        case '\\': result += "\\\\"; break;
+        case '\b': result += "\\b"; break;
+        case '\f': result += "\\f"; break;
+        case '\n': result += "\\n"; break;
+        case '\r': result += "\\r"; break;
+        case '\t': result += "\\t"; break;
+        default: {
+            unsigned int cp = legacy_utf8_to_codepoint(c, end);
+            if (cp < 0x80 && cp >= 0x20)
+                result += static_cast<char>(cp);
+            else if (cp < 0x10000) {
+                result += "\\u";
+                result += legacy_hex16(cp);
+            } else {
+                cp -= 0x10000;
+                result += "\\u";
+                result += legacy_hex16((cp >> 10) + 0xD800);
+                result += "\\u";
+                result += legacy_hex16((cp & 0x3FF) + 0xDC00);
+            }
+        } break;
+        }
+    }
+    result += "\"";
+    fixup_utf8_inplace(result);
+    return result;
+}
+
+static string legacy_arg2json(const AmArg &a)
+{
+    string s;
+    switch (a.getType()) {
+    case AmArg::Undef:
+        return "null";
+    case AmArg::Int:
+        return int2str(a.asInt());
+    case AmArg::LongLong:
+        return longlong2str(a.asLongLong());
+    case AmArg::Bool:
+        return a.asBool()?"true":"false";
+    case AmArg::Double:
+        return double2str(a.asDouble());
+    case AmArg::CStr:
+        return legacy_str2json(a.asCStr(), strlen(a.asCStr()));
+    case AmArg::Array:
+        s = "[";
+        for (size_t i = 0; i < a.size(); i ++)
+            s += legacy_arg2json(a[i]) + ",";
+        if (1 < s.size())
+            s.resize(s.size() - 1);
+        s += "]";
+        return s;
+    case AmArg::Struct:
+        s = "{";
+        for (AmArg::ValueStruct::const_iterator it = a.asStruct()->begin();
+             it != a.asStruct()->end(); it ++)
+        {
+            s += '"'+it->first + "\":";
+            s += legacy_arg2json(it->second);
+            s += ",";
+        }
+        if (1 < s.size())
+            s.resize(s.size() - 1);
+        s += "}";
+        return s;
+    default: break;
+    }
+    return "{}";
+}
+
+void json_bench_fill_sessions(AmArg &dump, unsigned int sessions)
+{
+    dump.assertStruct();
+    for(unsigned int i = 0; i < sessions; i++) {
+        string id = int2str(i);
+        AmArg &s = dump["3A0B1C2D-" + id + "-5E6F7A8B"];
+        s["a_leg"] = (i % 2) == 0;
+        s["call_group"] = "cg-" + int2str(i / 2);
+        s["session_status"] = "Connected";
+        s["other_id"] = "7F6E5D4C-" + id + "-3B2A1908";
+        s["dlg_status"] = "Connected";
+        s["dlg_callid"] = "a84b4c76e66710@pc33.example.com-" + id;
+        s["dlg_ruri"] = "\"Alice\" <sip:+1555" + id + "@gw" + int2str(i % 16) + ".example.net;transport=tcp>";
+        s["duration"] = 1.5 * i;
+        s["bytes"] = static_cast<long long>(i) * 1000000;
+        AmArg &streams = s["streams"];
+        for(int j = 0; j < 2; j++) {
+            AmArg st;
+            st["payload"] = j ? "PCMA/8000" : "opus/48000/2";
+            st["local_port"] = 10000 + 2*static_cast<int>(i % 20000);
+            st["rx_packets"] = static_cast<int>(i * 50);
+            st["jitter"] = 0.25 * j;
+            streams.push(st);
+        }
+    }
+}
+
+typedef std::chrono::steady_clock bench_clock;
+
+static double elapsed_ms(const bench_clock::time_point &start, unsigned int iterations)
+{
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count() /
+           iterations;
+}
+
+static void fill_result(AmArg &r, double ms, size_t size, double base_ms)
+{
+    r["ms"] = ms;
+    r["MBps"] = ms > 0 ? size / ms / 1000 : 0.0;
+    if(base_ms > 0) r["speedup"] = base_ms / ms;
+}
+
+void json_bench(const AmArg &dump, unsigned int iterations, AmArg &ret)
+{
+    if(!iterations) iterations = 1;
+
+    string reference = legacy_arg2json(dump);
+    string json = arg2json(dump);
+    size_t size = json.size();
+
+    ret["size"] = static_cast<long long>(size);
+    ret["iterations"] = static_cast<int>(iterations);
+    ret["identical_output"] = reference == json;
+
+    AmArg &serialize = ret["serialize"];
+    double legacy_ms;
+    {
+        auto start = bench_clock::now();
+        for(unsigned int i = 0; i < iterations; i++)
+            reference = legacy_arg2json(dump);
+        legacy_ms = elapsed_ms(start, iterations);
+        fill_result(serialize["legacy_string"], legacy_ms, size, 0);
+    }
+    {
+        auto start = bench_clock::now();
+        for(unsigned int i = 0; i < iterations; i++)
+            json = arg2json(dump);
+        fill_result(serialize["string"], elapsed_ms(start, iterations), size, legacy_ms);
+    }
+    {
+        std::vector<char> buf(size + 1);
+        auto start = bench_clock::now();
+        for(unsigned int i = 0; i < iterations; i++)
+            arg2json(dump, buf.data(), buf.size());
+        fill_result(serialize["buffer"], elapsed_ms(start, iterations), size, legacy_ms);
+    }
+
+    AmArg &parse = ret["parse"];
+    {
+        AmArg a;
+        auto start = bench_clock::now();
+        for(unsigned int i = 0; i < iterations; i++) {
+            std::istringstream iss(json);
+            json2arg(iss, a);
+        }
+        legacy_ms = elapsed_ms(start, iterations);
+        fill_result(parse["legacy_istream"], legacy_ms, size, 0);
+    }
+    {
+        AmArg a;
+        auto start = bench_clock::now();
+        for(unsigned int i = 0; i < iterations; i++)
+            json2arg(json.data(), json.size(), a);
+        fill_result(parse["buffer"], elapsed_ms(start, iterations), size, legacy_ms);
+        //integer types are not preserved by json, compare serialized data
+        ret["identical_parse"] = arg2json(a) == json;
+    }
+}
+
+void binarg_bench(const AmArg &dump, unsigned int iterations, AmArg &ret)
+{
+    if(!iterations) iterations = 1;
+
+    string json = arg2json(dump);
+    string bin = arg2bin(dump);
+
+    ret["iterations"] = static_cast<int>(iterations);
+    ret["json_size"] = static_cast<long long>(json.size());
+    ret["binary_size"] = static_cast<long long>(bin.size());
+
+    AmArg &serialize = ret["serialize"];
+    double json_ms;
+    {
+        auto start = bench_clock::now();
+        for(unsigned int i = 0; i < iterations; i++)
+            json = arg2json(dump);
+        json_ms = elapsed_ms(start, iterations);
+        fill_result(serialize["json"], json_ms, json.size(), 0);
+    }
+    {
+        auto start = bench_clock::now();
+        for(unsigned int i = 0; i < iterations; i++) {
+            bin.clear();
+            arg2bin(dump, bin);
+        }
+        fill_result(serialize["binary"], elapsed_ms(start, iterations), bin.size(), json_ms);
+    }
+
+    AmArg &parse = ret["parse"];
+    {
+        AmArg a;
+        auto start = bench_clock::now();
+        for(unsigned int i = 0; i < iterations; i++)
+            json2arg(json.data(), json.size(), a);
+        json_ms = elapsed_ms(start, iterations);
+        fill_result(parse["json"], json_ms, json.size(), 0);
+    }
+    {
+        AmArg a;
+        auto start = bench_clock::now();
+        for(unsigned int i = 0; i < iterations; i++)
+            bin2arg(bin.data(), bin.size(), a);
+        fill_result(parse["binary"], elapsed_ms(start, iterations), bin.size(), json_ms);
+        ret["identical_parse"] = arg2json(a) == json;
+    }
+}
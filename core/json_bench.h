@@ -0,0 +1,18 @@
+#ifndef JSON_BENCH_H
+#define JSON_BENCH_H
+
+#include "AmArg.h"
+
+#define DEFAULT_JSON_BENCH_SESSIONS   10000
+#define DEFAULT_JSON_BENCH_ITERATIONS 10
+
+/** fill dump with the synthetic 'show sessions' like data */
+void json_bench_fill_sessions(AmArg &dump, unsigned int sessions);
+
+/** compare jsonArg parser/writer with the istream/string based implementation */
+void json_bench(const AmArg &dump, unsigned int iterations, AmArg &ret);
+
+/** compare binary AmArg encoding with json */
+void binarg_bench(const AmArg &dump, unsigned int iterations, AmArg &ret);
+
+#endif // JSON_BENCH_H
@@ -121,7 +121,7 @@ bool SessionTimer::onSipReply(const AmSipRequest& req, const AmSipReply& reply,
 
     // get Min-SE
     unsigned int i_minse;
-    string min_se_hdr = getHeader(reply.hdrs, SIP_HDR_MIN_SE, true);
+    string min_se_hdr = reply.getHeader(SIP_HDR_MIN_SE, true);
     if (!min_se_hdr.empty()) {
       if (str2i(strip_header_params(min_se_hdr), i_minse)) {
 	WARN("error while parsing " SIP_HDR_MIN_SE " header value '%s'",
@@ -177,12 +177,12 @@ bool SessionTimer::onSendRequest(AmSipRequest& req, int& flags)
     // 					     req.hdrs);
   // }
 
-  addOptionTag(req.hdrs, SIP_HDR_SUPPORTED, TIMER_OPTION_TAG);
+  addOptionTag(req.hdrs.modify(), SIP_HDR_SUPPORTED, TIMER_OPTION_TAG);
   if  ((req.method != SIP_METH_INVITE) && (req.method != SIP_METH_UPDATE))
     return false; // session-expires / min-se only in INV/UPD
 
-  removeHeader(req.hdrs, SIP_HDR_SESSION_EXPIRES);
-  removeHeader(req.hdrs, SIP_HDR_MIN_SE);
+  removeHeader(req.hdrs.modify(), SIP_HDR_SESSION_EXPIRES);
+  removeHeader(req.hdrs.modify(), SIP_HDR_MIN_SE);
   req.hdrs += SIP_HDR_COLSP(SIP_HDR_SESSION_EXPIRES) + int2str(session_interval) + CRLF
     + SIP_HDR_COLSP(SIP_HDR_MIN_SE) + int2str(min_se) + CRLF;
 
@@ -199,17 +199,17 @@ bool SessionTimer::onSendReply(const AmSipRequest& req,
        (reply.code < 200) || (reply.code >= 300))
     return false;
 
-  addOptionTag(reply.hdrs, SIP_HDR_SUPPORTED, TIMER_OPTION_TAG);
+  addOptionTag(reply.hdrs.modify(), SIP_HDR_SUPPORTED, TIMER_OPTION_TAG);
 
   if (((session_refresher_role==UAC) && (session_refresher==refresh_remote))
       || ((session_refresher_role==UAS) && remote_timer_aware)) {
-    addOptionTag(reply.hdrs, SIP_HDR_REQUIRE, TIMER_OPTION_TAG);
+    addOptionTag(reply.hdrs.modify(), SIP_HDR_REQUIRE, TIMER_OPTION_TAG);
   } else {
-    removeOptionTag(reply.hdrs, SIP_HDR_REQUIRE, TIMER_OPTION_TAG);
+    removeOptionTag(reply.hdrs.modify(), SIP_HDR_REQUIRE, TIMER_OPTION_TAG);
   }
 
   // remove (possibly existing) Session-Expires header
-  removeHeader(reply.hdrs, SIP_HDR_SESSION_EXPIRES);
+  removeHeader(reply.hdrs.modify(), SIP_HDR_SESSION_EXPIRES);
 
   reply.hdrs += SIP_HDR_COLSP(SIP_HDR_SESSION_EXPIRES) +
     int2str(session_interval) + ";refresher="+
@@ -253,7 +253,7 @@ bool SessionTimerFactory::checkSessionExpires(const AmSipRequest& req, AmConfigR
     return false;
   }
 
-  string session_expires = getHeader(req.hdrs, SIP_HDR_SESSION_EXPIRES,
+  string session_expires = req.getHeader(SIP_HDR_SESSION_EXPIRES,
 				     SIP_HDR_SESSION_EXPIRES_COMPACT, true);
 
   if (session_expires.length()) {
@@ -278,11 +278,11 @@ void SessionTimer::updateTimer(AmSession* s, const AmSipRequest& req) {
   if((req.method == SIP_METH_INVITE)||(req.method == SIP_METH_UPDATE)){
     
     remote_timer_aware = 
-      key_in_list(getHeader(req.hdrs, SIP_HDR_SUPPORTED, SIP_HDR_SUPPORTED_COMPACT),
+      key_in_list(req.getHeader(SIP_HDR_SUPPORTED, SIP_HDR_SUPPORTED_COMPACT),
 		  TIMER_OPTION_TAG);
     
     // determine session interval
-    string sess_expires_hdr = getHeader(req.hdrs, SIP_HDR_SESSION_EXPIRES,
+    string sess_expires_hdr = req.getHeader(SIP_HDR_SESSION_EXPIRES,
 					SIP_HDR_SESSION_EXPIRES_COMPACT, true);
     
     bool rem_has_sess_expires = false;
@@ -299,7 +299,7 @@ void SessionTimer::updateTimer(AmSession* s, const AmSipRequest& req) {
 
     // get Min-SE
     unsigned int i_minse = min_se;
-    string min_se_hdr = getHeader(req.hdrs, SIP_HDR_MIN_SE, true);
+    string min_se_hdr = req.getHeader(SIP_HDR_MIN_SE, true);
     if (!min_se_hdr.empty()) {
       if (str2i(strip_header_params(min_se_hdr),
 		i_minse)) {
@@ -361,7 +361,7 @@ void SessionTimer::updateTimer(AmSession* s, const AmSipReply& reply)
     return;
   
   // determine session interval
-  string sess_expires_hdr = getHeader(reply.hdrs, SIP_HDR_SESSION_EXPIRES,
+  string sess_expires_hdr = reply.getHeader(SIP_HDR_SESSION_EXPIRES,
 				      SIP_HDR_SESSION_EXPIRES_COMPACT, true);
 
   session_refresher = refresh_local;
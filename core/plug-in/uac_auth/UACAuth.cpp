@@ -464,8 +464,8 @@ bool UACAuth::onSipReply(
         reply.cseq_method.data(), reply.code, nonce_reuse);
 
     string auth_hdr = proxy_auth ?
-        getHeader(reply.hdrs, SIP_HDR_PROXY_AUTHENTICATE, true) :
-        getHeader(reply.hdrs, SIP_HDR_WWW_AUTHENTICATE, true);
+        reply.getHeader(SIP_HDR_PROXY_AUTHENTICATE, true) :
+        reply.getHeader(SIP_HDR_WWW_AUTHENTICATE, true);
 
     if(!nonce_reuse &&
         (proxy_auth ?
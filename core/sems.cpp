@@ -35,6 +35,7 @@
 #include "AmEventDispatcher.h"
 #include "AmSessionProcessor.h"
 #include "AmAudioFileRecorder.h"
+#include "AmPromptCache.h"
 #include "AmAppTimer.h"
 #include "RtspClient.h"
 #include "CoreRpc.h"
@@ -75,6 +76,7 @@ using std::string;
 #if defined(__linux__)
 #include <sys/prctl.h>
 #include <srtp.h>
+#include "AmSrtpConnection.h"
 #include "PcapFileRecorder.h"
 #include "sip/tls_trsp.h"
 #include "sip/tr_blacklist.h"
@@ -97,6 +99,42 @@ const char *get_sems_version(void)
     return SEMS_VERSION;
 }
 
+/** fail on configured AEAD-GCM profiles if the linked libsrtp has no GCM ciphers */
+static bool check_srtp_profiles()
+{
+    for(auto& iface : AmConfig.media_ifs) {
+        for(auto info : iface.proto_info) {
+            RTP_info* rtp_info = RTP_info::toMEDIA_RTP(info);
+            if(!rtp_info || !rtp_info->srtp_enable) continue;
+
+            std::vector<uint16_t> profiles(rtp_info->profiles.begin(), rtp_info->profiles.end());
+            if(rtp_info->dtls_enable) {
+                profiles.insert(profiles.end(),
+                                rtp_info->client_settings.srtp_profiles.begin(),
+                                rtp_info->client_settings.srtp_profiles.end());
+                profiles.insert(profiles.end(),
+                                rtp_info->server_settings.srtp_profiles.begin(),
+                                rtp_info->server_settings.srtp_profiles.end());
+            }
+
+            for(auto profile : profiles) {
+                if(profile != CP_AEAD_AES_128_GCM && profile != CP_AEAD_AES_256_GCM)
+                    continue;
+                if(!srtp::profile_supported(static_cast<srtp_profile_t>(profile))) {
+                    ERROR("media interface %s: SRTP profile %s requires libsrtp built with OpenSSL",
+                          iface.name.c_str(),
+                          SdpCrypto::profile2str(static_cast<CryptoProfile>(profile)).c_str());
+                    return false;
+                }
+            }
+        }
+    }
+
+    INFO("SRTP: %s, AEAD-GCM profiles %savailable", srtp_get_version_string(),
+         srtp::profile_supported(static_cast<srtp_profile_t>(CP_AEAD_AES_128_GCM)) ? "" : "not ");
+    return true;
+}
+
 static void print_supported_srtp_profiles() {
     printf(
         "  Supported SRTP profiles:\n"
@@ -744,6 +782,8 @@ int main(int argc, char* argv[])
             goto error;
         }
         srtp_install_log_handler(log_handler, NULL);
+        if(!check_srtp_profiles())
+            goto error;
     }
 
     if(AmConfig.enable_rtsp) {
@@ -900,6 +940,9 @@ int main(int argc, char* argv[])
     INFO("Disposing pcap file recorder");
     PcapFileRecorderProcessor::dispose();
 
+    INFO("Disposing prompt cache");
+    AmPromptCache::dispose();
+
     INFO("Disposing event dispatcher");
     AmEventDispatcher::dispose();
 
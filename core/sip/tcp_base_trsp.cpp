@@ -1,4 +1,5 @@
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #include <algorithm>
 #include "tcp_base_trsp.h"
 #include "socket_ssl.h"
@@ -9,6 +10,7 @@
 #include "parse_common.h"
 #include "parse_via.h"
 #include "AmLcConfig.h"
+#include "AmCpuPlacement.h"
 #include "AmUtils.h"
 
 trsp_base_input::trsp_base_input()
@@ -155,7 +157,10 @@ tcp_base_trsp::tcp_base_trsp(
     server_sock(server_sock_), server_worker(server_worker_),
     closed(false), connected(false),
     evbase(evbase_), input(input_),
-    read_ev(NULL), write_ev(NULL)
+    read_ev(NULL), write_ev(NULL),
+    send_q_bytes(0), send_q_peak_bytes(0), send_q_rejects(0),
+    send_q_congested(false),
+    writev_calls(0), writev_msgs(0)
 {
     sockaddr_ssl* sa_ssl = (sockaddr_ssl*)(sa);
     CLASS_DBG("tcp_base_trsp() server_socket:%p transport:%d sa:%s:%i trsp:%d ssl_marker:%d sig:%d cipher:%d mac:%d",
@@ -236,6 +241,9 @@ void tcp_base_trsp::close()
         sd = -1;
     }
 
+    send_q_bytes = 0;
+    send_q_congested = false;
+
     generate_transport_errors();
 
     dec_ref((atomic_ref_cnt*)this);
@@ -266,6 +274,47 @@ void tcp_base_trsp::generate_transport_errors()
     }
 }
 
+bool tcp_base_trsp::check_send_queue(int msg_len)
+{
+    unsigned int high = server_sock->get_send_queue_high();
+    if(!high) return true;
+
+    if(!send_q_congested) {
+        // a single big message is allowed into the empty queue
+        if(!send_q_bytes || send_q_bytes + msg_len <= high)
+            return true;
+
+        WARN("send queue to %s:%d is over the high watermark (%llu+%d > %u). "
+             "reject new messages",
+             peer_ip.c_str(), peer_port, send_q_bytes, msg_len, high);
+        send_q_congested = true;
+    }
+
+    send_q_rejects++;
+    server_sock->inc_send_queue_rejects();
+    return false;
+}
+
+void tcp_base_trsp::inc_send_queue(int bytes)
+{
+    send_q_bytes += bytes;
+    if(send_q_bytes > send_q_peak_bytes)
+        send_q_peak_bytes = send_q_bytes;
+}
+
+void tcp_base_trsp::dec_send_queue(int bytes)
+{
+    send_q_bytes = send_q_bytes > static_cast<unsigned long long>(bytes) ?
+                   send_q_bytes - bytes : 0;
+
+    if(send_q_congested && send_q_bytes <= server_sock->get_send_queue_low()) {
+        INFO("send queue to %s:%d is drained below the low watermark (%llu). "
+             "accept new messages",
+             peer_ip.c_str(), peer_port, send_q_bytes);
+        send_q_congested = false;
+    }
+}
+
 void tcp_base_trsp::add_read_event_ul()
 {
   sock_mut.unlock();
@@ -510,6 +559,12 @@ void tcp_base_trsp::getInfo(AmArg &ret)
     ret["proto"] = get_transport();
     ret["ifnum"] = if_num;
     ret["queue_size"] = send_q.size();
+    ret["queue_bytes"] = static_cast<long long>(send_q_bytes);
+    ret["queue_peak_bytes"] = static_cast<long long>(send_q_peak_bytes);
+    ret["queue_congested"] = send_q_congested;
+    ret["queue_rejects"] = static_cast<long long>(send_q_rejects);
+    ret["writev_calls"] = static_cast<long long>(writev_calls);
+    ret["writev_msgs"] = static_cast<long long>(writev_msgs);
 }
 
 void tcp_base_trsp::on_write(short ev)
@@ -527,17 +582,34 @@ void tcp_base_trsp::on_write(short ev)
     pre_write();
     while(!send_q.empty()) {
 
-        msg_buf* msg = send_q.front();
-        if(!msg || !msg->bytes_left()) {
-            send_q.pop_front();
-            delete msg;
-            continue;
+        // coalesce the queued messages
+        struct iovec iov[TCP_WRITEV_MAX_IOV];
+        int iovcnt = 0;
+        ssize_t bytes_left = 0;
+        for(auto msg : send_q) {
+            if(iovcnt == TCP_WRITEV_MAX_IOV)
+                break;
+            if(!msg || !msg->bytes_left())
+                continue;
+            iov[iovcnt].iov_base = msg->cursor;
+            iov[iovcnt].iov_len = msg->bytes_left();
+            bytes_left += iov[iovcnt].iov_len;
+            iovcnt++;
         }
 
-        // send msg
-        int bytes = write(sd,msg->cursor,msg->bytes_left());
+        if(!iovcnt) {
+            // empty messages only
+            while(!send_q.empty()) {
+                delete send_q.front();
+                send_q.pop_front();
+            }
+            break;
+        }
+
+        // send msgs
+        ssize_t bytes = writev(sd,iov,iovcnt);
         if(bytes < 0) {
-            DBG("error on write: %i",bytes);
+            DBG("error on write: %zd",bytes);
             switch(errno) {
             case EINTR:
             case EAGAIN: // would block
@@ -554,23 +626,37 @@ void tcp_base_trsp::on_write(short ev)
             return;
         }
 
-        DBG("sent msg via %s/%i from %s:%i to %s:%i. bytes: %d/%d",
+        DBG("sent %d msgs via %s/%i from %s:%i to %s:%i. bytes: %zd/%zd",
+            iovcnt,
             get_transport(),
             sd,
             actual_ip.c_str(), actual_port,
-            get_addr_str(&msg->addr).c_str(),
-            am_get_port(&msg->addr),
+            peer_ip.c_str(), peer_port,
             bytes,
-            msg->bytes_left());
+            bytes_left);
 
-        if(bytes < msg->bytes_left()) {
-            msg->cursor += bytes;
+        writev_calls++;
+        dec_send_queue(bytes);
+
+        // drop the sent messages, move the cursor of the partially sent one
+        for(ssize_t sent = bytes; !send_q.empty();) {
+            msg_buf* msg = send_q.front();
+            if(msg && msg->bytes_left() > sent) {
+                msg->cursor += sent;
+                break;
+            }
+            if(msg) {
+                sent -= msg->bytes_left();
+                writev_msgs++;
+            }
+            send_q.pop_front();
+            delete msg;
+        }
+
+        if(bytes < bytes_left) {
             add_write_event();
             return;
         }
-
-        send_q.pop_front();
-        delete msg;
     }
 
     post_write();
@@ -797,6 +883,7 @@ void trsp_worker::run()
     event_add(ev_default,NULL);
 
     setThreadName("sip-worker");
+    AmCpuPlacement::instance()->place(this, "sip-worker", CPU_ROLE_SIP);
 
     /* Start the event loop. */
     /*int ret = */event_base_dispatch(evbase);
@@ -823,7 +910,13 @@ trsp_server_socket::trsp_server_socket(
             .addLabel("protocol", AmConfig.sip_ifs[if_num].proto_info[proto_idx]->ipTypeToStr()),
         if_num, proto_idx, opts, sock_factory->transport),
     ev_accept(nullptr),
-    sock_factory(sock_factory)
+    sock_factory(sock_factory),
+    send_queue_high(0),
+    send_queue_low(0),
+    send_queue_rejects(stat_group(Counter, "core", "sip_send_queue_rejects").addAtomicCounter()
+        .addLabel("interface", AmConfig.sip_ifs[if_num].name)
+        .addLabel("transport", socket_transport2proto_str(sock_factory->transport))
+        .addLabel("protocol", AmConfig.sip_ifs[if_num].proto_info[proto_idx]->ipTypeToStr()))
 {
     inc_ref(sock_factory);
 }
@@ -997,6 +1090,12 @@ void trsp_server_socket::set_idle_timeout(unsigned int ms)
     idle_timeout.tv_usec = (ms % 1000) * 1000;
 }
 
+void trsp_server_socket::set_send_queue_watermarks(unsigned int high, unsigned int low)
+{
+    send_queue_high = high;
+    send_queue_low = low;
+}
+
 struct timeval* trsp_server_socket::get_connect_timeout()
 {
     if(connect_timeout.tv_sec || connect_timeout.tv_usec)
@@ -17,6 +17,11 @@ using std::string;
  */
 #define MAX_TCP_MSGLEN 65535
 
+/**
+ * Maximum queued messages written by one writev()
+ */
+#define TCP_WRITEV_MAX_IOV 64
+
 #include <sys/socket.h>
 #include <event2/event.h>
 
@@ -99,6 +104,26 @@ protected:
     AmMutex sock_mut;
     deque<msg_buf*> send_q;
 
+    /* send queue accounting (guarded by sock_mut).
+     * bytes accepted by send() and not written to the socket yet,
+     * including the TLS records waiting in send_q */
+    unsigned long long send_q_bytes;
+    unsigned long long send_q_peak_bytes;
+    unsigned long long send_q_rejects;
+    bool               send_q_congested;
+    unsigned long long writev_calls;
+    unsigned long long writev_msgs;
+
+    /**
+    * Checks the send queue watermarks.
+    * Once the queue exceeds the high watermark new messages
+    * are rejected until it is drained below the low one.
+    * @return false if the message must be rejected
+    */
+    bool check_send_queue(int msg_len);
+    void inc_send_queue(int bytes);
+    void dec_send_queue(int bytes);
+
 
     /** fake implementation: we will never bind a connection socket */
     int bind(const string& address, unsigned short port) {
@@ -262,6 +287,15 @@ protected:
     */
     struct timeval idle_timeout;
 
+    /**
+    * Per connection send queue watermarks in bytes.
+    * 0 high watermark disables the limit.
+    */
+    unsigned int send_queue_high;
+    unsigned int send_queue_low;
+
+    AtomicCounter& send_queue_rejects;
+
     /* callback on new connection */
     void on_accept(int sd, short ev);
 
@@ -298,8 +332,16 @@ public:
     */
     void set_idle_timeout(unsigned int ms);
 
+    /**
+    * Set the send queue watermarks in bytes for new connections.
+    */
+    void set_send_queue_watermarks(unsigned int high, unsigned int low);
+
     struct timeval* get_connect_timeout();
     struct timeval* get_idle_timeout();
+    unsigned int get_send_queue_high() { return send_queue_high; }
+    unsigned int get_send_queue_low() { return send_queue_low; }
+    void inc_send_queue_rejects() { send_queue_rejects.inc(); }
 
     void inc_sip_parse_error() { sip_parse_errors.inc(); }
 };
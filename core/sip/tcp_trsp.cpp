@@ -51,6 +51,9 @@ int tcp_trsp_socket::send(const sockaddr_storage* sa, const char* msg,
   if(closed || (check_connection() < 0))
     return -1;
 
+  if(!check_send_queue(msg_len))
+    return TRSP_SEND_QUEUE_FULL;
+
   DBG("add msg to send deque/from %s:%i to %s:%i\n--++--\n%.*s--++--",
             actual_ip.c_str(), actual_port,
             get_addr_str(sa).c_str(),
@@ -58,6 +61,7 @@ int tcp_trsp_socket::send(const sockaddr_storage* sa, const char* msg,
             msg_len,msg);
 
   send_q.push_back(new msg_buf(sa,msg,msg_len));
+  inc_send_queue(msg_len);
 
   if(connected) {
     add_write_event();
@@ -376,12 +376,28 @@ void tls_trsp_socket::pre_write()
     /*DBG("pre_write(): tls_connected:%d, senq_q.size():%zd, orig_send_q.size():%zd",
         tls_connected, send_q.size(),orig_send_q.size());*/
 
+    if(!tls_connected)
+        return;
+
     try {
-        if(tls_connected && !orig_send_q.empty()) {
-            msg_buf* msg = orig_send_q.front();
-            tls_channel->send((const uint8_t*)msg->cursor, msg->bytes_left());
-            msg->cursor += msg->msg_len;
+        // pass all the pending messages to the channel
+        // in batches of the max record size
+        string batch;
+        for(auto msg : orig_send_q) {
+            int len = msg->bytes_left();
+            if(len <= 0)
+                continue;
+            if(!batch.empty() && batch.size() + len > TLS_SEND_BATCH_SIZE) {
+                tls_channel->send((const uint8_t*)batch.data(), batch.size());
+                batch.clear();
+            }
+            batch.append(msg->cursor, len);
+            msg->cursor += len;
+            // accounted as TLS records in send_q now
+            dec_send_queue(len);
         }
+        if(!batch.empty())
+            tls_channel->send((const uint8_t*)batch.data(), batch.size());
     } catch(Botan::Exception& exc) {
       ERROR("unforseen error in tls: close connection (%s)",
                       exc.what());
@@ -441,6 +457,7 @@ void tls_trsp_socket::copy_peer_addr(sockaddr_storage* sa)
 void tls_trsp_socket::tls_emit_data(const uint8_t data[], size_t size)
 {
     send_q.push_back(new msg_buf(&peer_addr,(char*)data,size));
+    inc_send_queue(size);
 
     if(connected) {
         add_write_event();
@@ -503,6 +520,9 @@ int tls_trsp_socket::send(const sockaddr_storage* sa, const char* msg,
   if(closed || (check_connection() < 0))
     return -1;
 
+  if(!check_send_queue(msg_len))
+    return TRSP_SEND_QUEUE_FULL;
+
   DBG("add msg to send deque/from %s:%i to %s:%i\n--++--\n%.*s--++--",
             actual_ip.c_str(), actual_port,
             get_addr_str(sa).c_str(),
@@ -510,6 +530,7 @@ int tls_trsp_socket::send(const sockaddr_storage* sa, const char* msg,
             msg_len,msg);
 
   orig_send_q.push_back(new msg_buf(sa,msg,msg_len));
+  inc_send_queue(msg_len);
 
   if(connected) {
     add_write_event();
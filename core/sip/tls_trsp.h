@@ -26,6 +26,12 @@ using std::string;
 #include <botan/tls_callbacks.h>
 #include <botan/credentials_manager.h>
 
+/**
+ * Max plaintext passed to the TLS channel at once
+ * to be sent as one record
+ */
+#define TLS_SEND_BATCH_SIZE 16384
+
 class tls_conf : public Botan::TLS::Policy, public Botan::Credentials_Manager
 {
     friend class tls_trsp_socket;
@@ -77,6 +77,7 @@
 static trsp_acls fake_acls;
 
 static const cstring sip_resp_forbidden("Forbidden");
+static const cstring sip_resp_unavailable("Service Unavailable");
 
 unsigned int _trans_layer::default_bl_ttl;
 extern unsigned long long count_transactions();
@@ -91,7 +92,8 @@ trans_stats::trans_stats()
     sent_reply_retrans(stat_group(Counter, "core", "tx_replies_retrans").addAtomicCounter()),
     sent_request_retrans(stat_group(Counter, "core", "tx_requests_retrans").addAtomicCounter()),
     sip_acl_dropped(stat_group(Counter, "core", "sip_acl_dropped").addAtomicCounter()),
-    sip_acl_rejected(stat_group(Counter, "core", "sip_acl_rejected").addAtomicCounter())
+    sip_acl_rejected(stat_group(Counter, "core", "sip_acl_rejected").addAtomicCounter()),
+    sip_rate_limited(stat_group(Counter, "core", "sip_rate_limited").addAtomicCounter())
 { }
 
 _trans_layer::_trans_layer()
@@ -1433,11 +1435,14 @@ int _trans_layer::send_request(sip_msg* msg, trans_ticket* tt,
     
     err = p_msg->send(flags);
     if(err < 0){
-        ERROR("Error from transport layer: call_id %s", p_msg->callid ? p_msg->callid->value.s : "unknown");
+        ERROR("Error from transport layer%s: call_id %s",
+              err == TRSP_SEND_QUEUE_FULL ? " (send queue is full)" : "",
+              p_msg->callid ? p_msg->callid->value.s : "unknown");
 	delete p_msg;
 	p_msg = NULL;
 
-	if(default_bl_ttl) {
+	// congested connection is alive, just try the next destination
+	if(default_bl_ttl && err != TRSP_SEND_QUEUE_FULL) {
 		SA_transport(&msg->remote_ip) = msg->local_socket->get_transport_id();
 		tr_blacklist::instance()->insert(&msg->remote_ip, default_bl_ttl,"503");
 	}
@@ -1890,29 +1895,46 @@ void _trans_layer::process_rcvd_msg(sip_msg* msg, const trsp_acls &acls)
  
                  default:
                      trsp_acl::action_t acl_action;
+                     const trsp_acl *acl;
 
                      switch(msg->u.request->method){
                          case sip_request::INVITE:
                              if(nullptr==static_cast<sip_from_to*>(msg->to->p)->tag.s) {
                                  //check ACL for initial INVITEs (without To-tag) only
-                                 acl_action = acls.inv.check(msg->remote_ip);
+                                 acl = &acls.inv;
                              } else {
-                                 acl_action = trsp_acl::Allow;
+                                 acl = nullptr;
                              }
                              break;
                          case sip_request::OPTIONS:
-                             acl_action = acls.opt.check(msg->remote_ip);
+                             acl = &acls.opt;
                              break;
                          case sip_request::REGISTER:
-                             acl_action = acls.reg.check(msg->remote_ip);
+                             acl = &acls.reg;
                              break;
                          default:
-                             acl_action = trsp_acl::Allow;
+                             acl = nullptr;
                      }
+                     acl_action = acl ? acl->check(msg->remote_ip) : trsp_acl::Allow;
 
                      switch(acl_action) {
-                     case trsp_acl::Allow:
-                         break;
+                     case trsp_acl::Allow: {
+                         unsigned int retry_after;
+                         if(acl && acl->over_rate_limit(msg->remote_ip, &retry_after)) {
+                             bucket->unlock();
+                             stats.inc_sip_rate_limited();
+                             if(acl->get_action() == trsp_acl::Drop) {
+                                 DBG("message dropped by interface rate limit");
+                                 DROP_MSG;
+                             }
+                             DBG("message rejected by interface rate limit");
+                             string retry_after_hdr = SIP_HDR_COLSP(SIP_HDR_RETRY_AFTER) +
+                                 int2str(retry_after) + CRLF;
+                             send_sl_reply(msg,503,sip_resp_unavailable,
+                                           cstring(),stl2cstr(retry_after_hdr));
+                             return;
+                         }
+                     } break;
                      case trsp_acl::Drop:
                          bucket->unlock();
                          DBG("message dropped by interface ACL");
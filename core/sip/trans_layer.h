@@ -93,6 +93,7 @@ class trans_stats
     AtomicCounter &sent_request_retrans;
     AtomicCounter &sip_acl_dropped;
     AtomicCounter &sip_acl_rejected;
+    AtomicCounter &sip_rate_limited;
 
   public:
     trans_stats();
@@ -123,6 +124,7 @@ class trans_stats
 
     void inc_sip_acl_dropped() { sip_acl_dropped.inc(); }
     void inc_sip_acl_rejected() { sip_acl_rejected.inc(); }
+    void inc_sip_rate_limited() { sip_rate_limited.inc(); }
 
     unsigned get_sent_requests() const { return sent_requests.atomic_int64::get(); }
     unsigned get_sent_replies() const { return sent_replies.atomic_int64::get(); }
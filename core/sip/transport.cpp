@@ -205,19 +205,103 @@ unsigned short trsp_socket::get_proto_idx() const
     return proto_idx;
 }
 
+trsp_acl::trsp_acl(const trsp_acl &acl)
+  : networks(std::atomic_load(&acl.networks)),
+    action(acl.action),
+    rate_limiter(acl.rate_limiter)
+{}
+
+trsp_acl &trsp_acl::operator=(const trsp_acl &acl)
+{
+    if(this != &acl) {
+        std::atomic_store(&networks, std::atomic_load(&acl.networks));
+        action = acl.action;
+        rate_limiter = acl.rate_limiter;
+    }
+    return *this;
+}
+
 trsp_acl::action_t trsp_acl::check(const sockaddr_storage &ip) const
 {
-    if(networks.empty()) return Allow;
+    std::shared_ptr<const networks_t> n = std::atomic_load(&networks);
+    if(!n) return Allow;
 
-    for(vector<AmSubnet>::const_iterator i = networks.begin();
-        i!=networks.end();++i)
-    {
-        if(i->contains(ip))
-            return Allow;
-    }
+    if(n->tree.contains(ip))
+        return Allow;
     return action;
 }
 
+void trsp_acl::add_network(const AmSubnet &net)
+{
+    vector<AmSubnet> nets;
+    std::shared_ptr<const networks_t> n = std::atomic_load(&networks);
+    if(n) nets = n->subnets;
+    nets.push_back(net);
+    set_networks(nets);
+}
+
+void trsp_acl::set_networks(const vector<AmSubnet> &nets)
+{
+    if(nets.empty()) {
+        std::atomic_store(&networks, std::shared_ptr<const networks_t>());
+        return;
+    }
+
+    IPTree tree;
+    for(size_t i = 0; i < nets.size(); i++)
+        tree.addSubnet(nets[i], i);
+
+    auto n = std::make_shared<networks_t>();
+    n->subnets = nets;
+    n->tree = CompiledIPTree(tree);
+    std::atomic_store(&networks, std::shared_ptr<const networks_t>(std::move(n)));
+}
+
+size_t trsp_acl::networks_count() const
+{
+    std::shared_ptr<const networks_t> n = std::atomic_load(&networks);
+    return n ? n->subnets.size() : 0;
+}
+
+void trsp_acl::set_rate_limit(unsigned int rate, unsigned int burst,
+                              const string &key_class)
+{
+    if(!rate) {
+        rate_limiter.reset();
+        return;
+    }
+    rate_limiter = std::make_shared<RegShaper>(key_class);
+    rate_limiter->set_rate(rate, 1000, burst ? burst : rate);
+}
+
+bool trsp_acl::over_rate_limit(const sockaddr_storage &ip,
+                               unsigned int *retry_after) const
+{
+    if(!rate_limiter) return false;
+
+    //raw address bytes are enough to identify the source
+    RegShaper::ThrottlingHashKey key;
+    if(ip.ss_family == AF_INET6) {
+        const sockaddr_in6 *sa6 = reinterpret_cast<const sockaddr_in6 *>(&ip);
+        key.assign(reinterpret_cast<const char *>(&sa6->sin6_addr), sizeof(sa6->sin6_addr));
+    } else {
+        const sockaddr_in *sa4 = reinterpret_cast<const sockaddr_in *>(&ip);
+        key.assign(reinterpret_cast<const char *>(&sa4->sin_addr), sizeof(sa4->sin_addr));
+    }
+
+    RegShaper::timep now = std::chrono::system_clock::now(), next;
+    if(!rate_limiter->over_limit(key, now, retry_after ? &next : nullptr))
+        return false;
+
+    if(retry_after) {
+        //round up to the whole seconds
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next - now);
+        *retry_after = static_cast<unsigned int>((wait.count() + 999) / 1000);
+        if(!*retry_after) *retry_after = 1;
+    }
+    return true;
+}
+
 /** EMACS **
  * Local variables:
  * mode: c++
@@ -32,6 +32,8 @@
 #include "../AmThread.h"
 #include "../atomic_types.h"
 #include "../AmSubnet.h"
+#include "../IPTree.h"
+#include "../RegShaper.h"
 #include <sys/socket.h>
 #include "AmArg.h"
 
@@ -41,9 +43,14 @@ using std::string;
 #include <vector>
 using std::vector;
 
+#include <memory>
+
 #define DEFAULT_IDLE_TIMEOUT 3600000 /* 1 hour */
 #define DEFAULT_TCP_CONNECT_TIMEOUT 2000 /* 2 seconds */
 
+/* send() result: the connection send queue is over the high watermark */
+#define TRSP_SEND_QUEUE_FULL -2
+
 #define sock_transport_addr_shift(v) (v << 3)
 #define sock_transport_addr_mask  0x8
 #define sock_transport_proto_mask 0x7
@@ -251,7 +258,9 @@ public:
 
     /**
      * Sends a message.
-     * @return -1 if error(s) occured.
+     * @return -1 if error(s) occured,
+     *         TRSP_SEND_QUEUE_FULL if the message was rejected
+     *         by the send queue watermarks of a reliable transport.
      */
     virtual int send(const sockaddr_storage* sa, const char* msg, 
 		     const int msg_len, unsigned int flags)=0;
@@ -271,15 +280,45 @@ class trsp_acl {
     };
 
   private:
-    vector<AmSubnet> networks;
+    struct networks_t {
+        vector<AmSubnet> subnets;
+        CompiledIPTree tree;
+    };
+
+    /* networks are compiled on change and replaced as a whole.
+     * accessed with std::atomic_load/atomic_store only, readers hold
+     * their own reference until done. copies share the compiled data */
+    std::shared_ptr<const networks_t> networks;
     action_t action;
+    /* per source address rate limit for the allowed requests */
+    std::shared_ptr<RegShaper> rate_limiter;
 
   public:
     trsp_acl(): action(Reject) { }
+    trsp_acl(const trsp_acl &acl);
+    trsp_acl &operator=(const trsp_acl &acl);
+
     action_t check(const sockaddr_storage &ip) const;
 
     void set_action(action_t a) { action = a; }
-    void add_network(AmSubnet net) { networks.push_back(net); }
+    action_t get_action() const { return action; }
+    /* recompiles all networks, use set_networks() for the big lists */
+    void add_network(const AmSubnet &net);
+    /* replace networks. safe to call while check() is used
+     * by other threads, but not concurrently with other modifications */
+    void set_networks(const vector<AmSubnet> &nets);
+
+    size_t networks_count() const;
+
+    /* 'rate' requests per second from the same address
+     * with up to 'burst' requests at once. 0 disables the limit */
+    void set_rate_limit(unsigned int rate, unsigned int burst,
+                        const string &key_class);
+    /* @return true if the request from the address must be throttled.
+     * sets retry_after to the seconds until the next allowed request
+     * from the address (at least 1) if not nullptr */
+    bool over_rate_limit(const sockaddr_storage &ip,
+                         unsigned int *retry_after = nullptr) const;
 };
 
 struct trsp_acls {
@@ -48,6 +48,7 @@
 #include <errno.h>
 #include <string.h>
 #include <AmLcConfig.h>
+#include <AmCpuPlacement.h>
 
 #include <algorithm>
 
@@ -423,6 +424,7 @@ udp_trsp::~udp_trsp()
 void udp_trsp::run()
 {
     setThreadName("sip-udp-rx");
+    AmCpuPlacement::instance()->place(this, "sip-udp-rx", CPU_ROLE_SIP);
 
     INFO("Started SIP server UDP transport");
 
@@ -44,7 +44,9 @@ timer::~timer()
 
 _wheeltimer::_wheeltimer(const char *thread_name)
     : wall_clock(0),
-      thread_name(thread_name)
+      thread_name(thread_name),
+      reqs_backlog(NULL),
+      max_lag_us(0)
 {
     struct timeval now;
     gettimeofday(&now,NULL);
@@ -53,14 +55,28 @@ _wheeltimer::_wheeltimer(const char *thread_name)
 }
 
 _wheeltimer::~_wheeltimer()
-{}
+{
+    timer_req* rq = reqs_backlog.exchange(NULL);
+    while(rq) {
+	timer_req* next = rq->next;
+	delete rq;
+	rq = next;
+    }
+}
+
+void _wheeltimer::push_req(timer* t, bool insert)
+{
+    timer_req* rq = new timer_req(t,insert);
+    rq->next = reqs_backlog.load(std::memory_order_relaxed);
+    while(!reqs_backlog.compare_exchange_weak(rq->next, rq,
+					      std::memory_order_release,
+					      std::memory_order_relaxed));
+}
 
 void _wheeltimer::insert_timer(timer* t)
 {
     //add new timer to user request list
-    reqs_m.lock();
-    reqs_backlog.push_back(timer_req(t,true));
-    reqs_m.unlock();
+    push_req(t,true);
 }
 
 void _wheeltimer::remove_timer(timer* t)
@@ -70,9 +86,7 @@ void _wheeltimer::remove_timer(timer* t)
     }
 
     //add timer to remove to user request list
-    reqs_m.lock();
-    reqs_backlog.push_back(timer_req(t,false));
-    reqs_m.unlock();
+    push_req(t,false);
 }
 
 void _wheeltimer::run()
@@ -103,9 +117,12 @@ void _wheeltimer::run()
       if(sdiff.tv_nsec > 2000000) // 2 ms 
 	nanosleep(&sdiff,&rem);
     }
-    //else {
-    //printf("missed one tick\n");
-    //}
+    else {
+      timersub(&now,&next_tick,&diff);
+      unsigned long long lag = diff.tv_sec*1000000ULL + diff.tv_usec;
+      if(lag > max_lag_us.load(std::memory_order_relaxed))
+        max_lag_us.store(lag, std::memory_order_relaxed);
+    }
 
     gettimeofday(&now,NULL);
     unix_clock.set(now.tv_sec);
@@ -159,21 +176,28 @@ void _wheeltimer::turn_wheel()
     // Update existing timer entries
     update_wheel(i);
 	
-    // Swap the lists for timer insertion/deletion requests
-    reqs_m.lock();
-    reqs_process.swap(reqs_backlog);
-    reqs_m.unlock();
+    // Take the timer insertion/deletion requests
+    // and restore the order they were made in
+    timer_req* rq = reqs_backlog.exchange(NULL, std::memory_order_acquire);
+    timer_req* reqs = NULL;
+    while(rq) {
+	timer_req* next = rq->next;
+	rq->next = reqs;
+	reqs = rq;
+	rq = next;
+    }
 
-    while(!reqs_process.empty()) {
-	timer_req rq = reqs_process.front();
-	reqs_process.pop_front();
+    while(reqs) {
+	rq = reqs;
+	reqs = reqs->next;
 
-	if(rq.insert) {
-	    place_timer(rq.t);
+	if(rq->insert) {
+	    place_timer(rq->t);
 	}
 	else {
-	    delete_timer(rq.t);
+	    delete_timer(rq->t);
 	}
+	delete rq;
     }
 	
     //check for expired timer to process
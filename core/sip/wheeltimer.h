@@ -34,6 +34,7 @@
 #include "../ObjectsCounter.h"
 #include <sys/types.h>
 #include <deque>
+#include <atomic>
 
 #include "atomic_types.h"
 
@@ -89,9 +90,10 @@ class _wheeltimer:
 
 	timer* t;
 	bool   insert; // false -> remove
+	timer_req* next;
 	
 	timer_req(timer* t, bool insert)
-	    : t(t), insert(insert)
+	    : t(t), insert(insert), next(NULL)
 	{}
     };
 
@@ -100,10 +102,13 @@ class _wheeltimer:
     base_timer wheels[WHEELS][ELMTS_PER_WHEEL];
 
     AmCondition<bool> is_stop;
-    // request backlog lock (insert/remove)
-    AmMutex               reqs_m;
-    std::deque<timer_req> reqs_backlog;
-    std::deque<timer_req> reqs_process;
+    // request backlog (insert/remove): lock-free stack,
+    // taken at once by the timer thread on every tick
+    std::atomic<timer_req*> reqs_backlog;
+    // max delay of the tick start since the last take_max_lag()
+    std::atomic<unsigned long long> max_lag_us;
+
+    void push_req(timer* t, bool insert);
 
     void turn_wheel();
     void update_wheel(int wheel);
@@ -137,6 +142,12 @@ public:
 
     void insert_timer(timer* t);
     void remove_timer(timer* t);
+
+    /** @return max tick lag in microseconds and reset it */
+    unsigned long long take_max_lag()
+    {
+	return max_lag_us.exchange(0, std::memory_order_relaxed);
+    }
 };
 
 typedef singleton<_wheeltimer> wheeltimer;
@@ -489,6 +489,7 @@ ws_trsp_socket::~ws_trsp_socket()
 int ws_trsp_socket::send_data(const char* msg, const int msg_len, unsigned int flags)
 {
     send_q.push_back(new msg_buf(&peer_addr,(char*)msg,msg_len));
+    inc_send_queue(msg_len);
 
     if(connected) {
         add_write_event();
@@ -582,6 +583,7 @@ wss_trsp_socket::~wss_trsp_socket()
 int wss_trsp_socket::send_data(const char* msg, const int msg_len, unsigned int flags)
 {
     orig_send_q.push_back(new msg_buf(&peer_addr,(char*)msg,msg_len));
+    inc_send_queue(msg_len);
 
     if(connected) {
         add_write_event();
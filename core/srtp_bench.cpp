@@ -0,0 +1,115 @@
+#include "srtp_bench.h"
+
+#include "AmSrtpConnection.h"
+#include "AmSdp.h"
+#include "AmUtils.h"
+#include "rtp/rtp.h"
+
+#include <arpa/inet.h>
+#include <chrono>
+#include <vector>
+
+typedef std::chrono::steady_clock bench_clock;
+
+#define SRTP_BENCH_SSRC 0x5e3500aa
+#define SRTP_BENCH_MAX_PAYLOAD 1200
+
+static double elapsed_s(const bench_clock::time_point &start)
+{
+    return std::chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+static bool create_session(srtp_t &session, srtp_profile_t profile,
+                           unsigned char *key, bool outbound)
+{
+    srtp_policy_t policy;
+    memset(&policy, 0, sizeof(policy));
+    srtp::crypto_policy_set_from_profile_for_rtp(&policy.rtp, profile);
+    srtp::crypto_policy_set_from_profile_for_rtcp(&policy.rtcp, profile);
+    policy.ssrc.type = outbound ? ssrc_any_outbound : ssrc_any_inbound;
+    policy.key = key;
+    policy.window_size = 128;
+
+    return srtp_create(&session, &policy) == srtp_err_status_ok;
+}
+
+static void run(srtp_profile_t profile, unsigned int packets,
+                unsigned int payload_size, AmArg &ret)
+{
+    unsigned char key[SRTP_KEY_SIZE];
+    for(auto &b : key) b = static_cast<unsigned char>(get_random());
+
+    srtp_t tx, rx;
+    if(!create_session(tx, profile, key, true)) {
+        ret["error"] = "failed to create tx session";
+        return;
+    }
+    if(!create_session(rx, profile, key, false)) {
+        srtp_dealloc(tx);
+        ret["error"] = "failed to create rx session";
+        return;
+    }
+
+    size_t packet_size = sizeof(rtp_hdr_t) + payload_size;
+    size_t slot_size = packet_size + SRTP_MAX_TRAILER_LEN;
+    std::vector<unsigned char> buf(slot_size * packets);
+    std::vector<int> sizes(packets);
+
+    for(unsigned int i = 0; i < packets; i++) {
+        unsigned char *p = &buf[slot_size * i];
+        rtp_hdr_t *hdr = reinterpret_cast<rtp_hdr_t *>(p);
+        hdr->version = RTP_VERSION;
+        hdr->pt = 0;
+        hdr->seq = htons(static_cast<uint16_t>(i));
+        hdr->ts = htonl(i * payload_size);
+        hdr->ssrc = htonl(SRTP_BENCH_SSRC);
+        memset(p + sizeof(rtp_hdr_t), 0xd5, payload_size);
+        sizes[i] = static_cast<int>(packet_size);
+    }
+
+    unsigned int errors = 0;
+    auto start = bench_clock::now();
+    for(unsigned int i = 0; i < packets; i++) {
+        if(srtp_protect(tx, &buf[slot_size * i], &sizes[i]) != srtp_err_status_ok)
+            errors++;
+    }
+    double protect_s = elapsed_s(start);
+
+    start = bench_clock::now();
+    for(unsigned int i = 0; i < packets; i++) {
+        if(srtp_unprotect(rx, &buf[slot_size * i], &sizes[i]) != srtp_err_status_ok)
+            errors++;
+    }
+    double unprotect_s = elapsed_s(start);
+
+    srtp_dealloc(tx);
+    srtp_dealloc(rx);
+
+    ret["protect_pps"] = protect_s > 0 ? packets / protect_s : 0.0;
+    ret["unprotect_pps"] = unprotect_s > 0 ? packets / unprotect_s : 0.0;
+    ret["errors"] = static_cast<int>(errors);
+}
+
+void srtp_bench(unsigned int packets, unsigned int payload_size, AmArg &ret)
+{
+    if(!packets) packets = 1;
+    if(payload_size > SRTP_BENCH_MAX_PAYLOAD) payload_size = SRTP_BENCH_MAX_PAYLOAD;
+
+    ret["packets"] = static_cast<int>(packets);
+    ret["payload_size"] = static_cast<int>(payload_size);
+    ret["libsrtp"] = srtp_get_version_string();
+
+    AmArg &profiles = ret["profiles"];
+    for(int i = CP_NONE + 1; i <= CP_MAX; i++) {
+        srtp_profile_t profile = static_cast<srtp_profile_t>(i);
+        string name = SdpCrypto::profile2str(static_cast<CryptoProfile>(i));
+        if(SdpCrypto::str2profile(name) == CP_NONE)
+            continue;
+
+        if(!srtp::profile_supported(profile)) {
+            profiles[name]["error"] = "not supported";
+            continue;
+        }
+        run(profile, packets, payload_size, profiles[name]);
+    }
+}
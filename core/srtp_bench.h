@@ -0,0 +1,13 @@
+#ifndef SRTP_BENCH_H
+#define SRTP_BENCH_H
+
+#include "AmArg.h"
+
+#define DEFAULT_SRTP_BENCH_PACKETS 100000
+#define DEFAULT_SRTP_BENCH_PAYLOAD 160
+
+/** measure srtp_protect/srtp_unprotect packets per second
+ *  for every SRTP profile supported by the linked libsrtp */
+void srtp_bench(unsigned int packets, unsigned int payload_size, AmArg &ret);
+
+#endif // SRTP_BENCH_H
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <AmArg.h>
+#include <jsonArg.h>
+#include <AmUtils.h>
+
+#include <map>
+
+TEST(AmArg, Struct)
+{
+    AmArg a;
+    a["b"] = 2;
+    a["a"] = "short";
+    a[string("c")] = "long string value which does not fit inline";
+    a["aa"] = AmArg();
+
+    ASSERT_TRUE(isArgStruct(a));
+    EXPECT_EQ(a.size(), 4u);
+    EXPECT_TRUE(a.hasMember("aa"));
+    EXPECT_TRUE(a.hasMember(string("c")));
+    EXPECT_FALSE(a.hasMember("d"));
+    EXPECT_STREQ(a["a"].asCStr(), "short");
+    EXPECT_STREQ(a["c"].asCStr(), "long string value which does not fit inline");
+
+    std::vector<string> keys = a.enumerateKeys();
+    ASSERT_EQ(keys.size(), 4u);
+    EXPECT_EQ(keys[0], "a");
+    EXPECT_EQ(keys[1], "aa");
+    EXPECT_EQ(keys[2], "b");
+    EXPECT_EQ(keys[3], "c");
+
+    a.erase("aa");
+    a.erase(string("unknown"));
+    EXPECT_EQ(a.size(), 3u);
+    EXPECT_FALSE(a.hasMember("aa"));
+
+    const AmArg &c = a;
+    int n = 0;
+    for(AmArg::ValueStruct::const_iterator it = c.begin(); it != c.end(); it++)
+        n += it->first.size();
+    EXPECT_EQ(n, 3);
+}
+
+TEST(AmArg, StructOrder)
+{
+    //keys order must match std::map one to keep serialized data the same
+    std::map<string, int> ref;
+    AmArg a;
+    for(int i = 0; i < 1000; i++) {
+        string key = int2str((i * 7919) % 1000) + (i % 3 ? "x" : "");
+        ref[key] = i;
+        a[key] = i;
+    }
+    ASSERT_EQ(a.size(), ref.size());
+
+    auto rit = ref.begin();
+    for(auto &it : *a.asStruct()) {
+        ASSERT_EQ(it.first, rit->first);
+        ASSERT_EQ(it.second.asInt(), rit->second);
+        ++rit;
+    }
+}
+
+TEST(AmArg, StructReferences)
+{
+    AmArg a;
+    AmArg &first = a["first"];
+    first = 1;
+    for(int i = 0; i < 100; i++)
+        a[int2str(i)] = i;
+    a.erase("0");
+    a["new"] = 2;
+
+    //references stay valid as for std::map
+    EXPECT_EQ(first.asInt(), 1);
+    first = 3;
+    EXPECT_EQ(a["first"].asInt(), 3);
+}
+
+TEST(AmArg, Copy)
+{
+    AmArg a;
+    for(int i = 0; i < 20; i++) {
+        AmArg &s = a[int2str(i)];
+        s["str"] = string(i, 'x');
+        s["arr"].push(i);
+        s["arr"].push("y");
+    }
+
+    AmArg b(a), c;
+    c = b;
+    a["0"]["str"] = "changed";
+
+    EXPECT_EQ(arg2json(b), arg2json(c));
+    EXPECT_STREQ(c["19"]["str"].asCStr(), string(19, 'x').c_str());
+    EXPECT_STREQ(c["0"]["str"].asCStr(), "");
+    EXPECT_EQ(c["7"]["arr"][0].asInt(), 7);
+    EXPECT_STREQ(c["7"]["arr"][1].asCStr(), "y");
+}
+
+TEST(AmArg, StructIterators)
+{
+    AmArg a;
+    for(int i = 0; i < 100; i++)
+        a[int2str(i)] = i;
+    AmArg::ValueStruct &s = *a.asStruct();
+
+    //iterators stay valid on the insertion as for std::map
+    auto it = s.find("50");
+    ASSERT_TRUE(it != s.end());
+    for(int i = 0; i < 100; i++)
+        a["new" + int2str(i)] = i;
+    a["0a"] = 0;
+    EXPECT_EQ(it->first, "50");
+    ++it;
+    EXPECT_EQ(it->first, "51");
+    --it;
+    --it;
+    EXPECT_EQ(it->first, "5");
+
+    //erase(it++) and erase() result iterate over all the entries
+    int erased = 0;
+    for(auto it = s.begin(); it != s.end();) {
+        if(it->first.compare(0, 3, "new") == 0) {
+            s.erase(it++);
+            erased++;
+        } else
+            ++it;
+    }
+    EXPECT_EQ(erased, 100);
+    EXPECT_EQ(a.size(), 101u);
+
+    for(auto it = s.begin(); it != s.end();) {
+        if(it->second.asInt() % 2) it = s.erase(it);
+        else ++it;
+    }
+    EXPECT_EQ(a.size(), 51u);
+    for(auto &e : s)
+        EXPECT_EQ(e.second.asInt() % 2, 0);
+}
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include <AmAudio.h>
+
+TEST(AudioScratch, Scopes)
+{
+    DblBuffer a, b;
+
+    {
+        AmAudioScratch::Scope scope;
+        unsigned char* pa = a;
+        unsigned char* pb = b;
+        EXPECT_NE(pa, pb);
+        EXPECT_EQ(static_cast<unsigned char*>(a), pa);
+        EXPECT_EQ(a.back_buffer(), pa + AUDIO_BUFFER_SIZE);
+
+        {
+            AmAudioScratch::Scope nested;
+            DblBuffer c;
+            unsigned char* pc = c;
+            EXPECT_NE(pc, pa);
+            EXPECT_NE(pc, pb);
+        }
+
+        // frames of the outer scope are kept
+        EXPECT_EQ(static_cast<unsigned char*>(a), pa);
+        EXPECT_EQ(static_cast<unsigned char*>(b), pb);
+    }
+
+    size_t allocated = AmAudioScratch::getAllocated();
+    {
+        AmAudioScratch::Scope scope;
+        unsigned char* pb = b;
+        unsigned char* pa = a;
+        EXPECT_NE(pa, pb);
+    }
+    EXPECT_EQ(AmAudioScratch::getAllocated(), allocated);
+    EXPECT_EQ(a.getAllocated(), 0u);
+}
+
+TEST(AudioScratch, OutOfScope)
+{
+    DblBuffer a;
+    unsigned char* p = a;
+    EXPECT_EQ(a.getAllocated(), static_cast<size_t>(AUDIO_BUFFER_SIZE * 2));
+    EXPECT_EQ(static_cast<unsigned char*>(a), p);
+    a.swap();
+    EXPECT_EQ(a.back_buffer(), p);
+}
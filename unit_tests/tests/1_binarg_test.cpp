@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <binArg.h>
+#include <jsonArg.h>
+
+#include <limits.h>
+
+TEST(BinArg, RoundTrip)
+{
+    AmArg a;
+    a["int"] = -12345;
+    a["long"] = static_cast<long long>(1) << 40;
+    a["min"] = static_cast<long long>(LLONG_MIN);
+    a["double"] = 0.25;
+    a["true"] = true;
+    a["false"] = false;
+    a["str"] = "string with \"quotes\"\n";
+    a["empty"] = "";
+    a["null"] = AmArg();
+    a["blob"] = ArgBlob("\0\1\2", 3);
+    a["array"].push(1);
+    a["array"].push("two");
+    a["array"].push(AmArg());
+    a["array"][2]["nested"] = 3;
+    a["empty_struct"].assertStruct();
+    a["empty_array"].assertArray();
+
+    string bin = arg2bin(a);
+
+    AmArg b;
+    ASSERT_TRUE(bin2arg(bin, b));
+    ASSERT_TRUE(isArgStruct(b));
+
+    EXPECT_TRUE(isArgInt(b["int"]));
+    EXPECT_EQ(b["int"].asInt(), -12345);
+    EXPECT_TRUE(isArgLongLong(b["long"]));
+    EXPECT_EQ(b["long"].asLongLong(), static_cast<long long>(1) << 40);
+    EXPECT_EQ(b["min"].asLongLong(), LLONG_MIN);
+    EXPECT_EQ(b["double"].asDouble(), 0.25);
+    EXPECT_TRUE(b["true"].asBool());
+    EXPECT_FALSE(b["false"].asBool());
+    EXPECT_STREQ(b["str"].asCStr(), "string with \"quotes\"\n");
+    EXPECT_STREQ(b["empty"].asCStr(), "");
+    EXPECT_TRUE(isArgUndef(b["null"]));
+    ASSERT_EQ(b["blob"].getType(), AmArg::Blob);
+    EXPECT_EQ(b["blob"].asBlob()->len, 3);
+    EXPECT_EQ(memcmp(b["blob"].asBlob()->data, "\0\1\2", 3), 0);
+    EXPECT_TRUE(isArgStruct(b["empty_struct"]));
+    EXPECT_TRUE(isArgArray(b["empty_array"]));
+
+    b.erase("blob");
+    a.erase("blob");
+    EXPECT_EQ(arg2json(b), arg2json(a));
+}
+
+TEST(BinArg, Malformed)
+{
+    AmArg a;
+    a["key"] = "value";
+    a["list"].push(100000);
+    string bin = arg2bin(a);
+
+    AmArg b;
+    for(size_t len = 0; len < bin.size(); len++)
+        EXPECT_FALSE(bin2arg(bin.data(), len, b)) << "len: " << len;
+    EXPECT_TRUE(isArgUndef(b));
+
+    EXPECT_FALSE(bin2arg(bin + '\0', b));
+
+    string wrong_version = bin;
+    wrong_version[0]++;
+    EXPECT_FALSE(bin2arg(wrong_version, b));
+
+    //unterminated string
+    string unterminated = bin;
+    unterminated[unterminated.find("value") + 5] = 'x';
+    EXPECT_FALSE(bin2arg(unterminated, b));
+
+    //nesting limit
+    string deep(1, BINARG_VERSION);
+    for(int i = 0; i < BINARG_MAX_NESTING_DEPTH + 2; i++)
+        deep.append("\x08\x01", 2);
+    deep.push_back(0);
+    EXPECT_FALSE(bin2arg(deep, b));
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <AmCpuPlacement.h>
+
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <fstream>
+
+static void write_file(const std::string &path, const std::string &value)
+{
+    std::string dir = path.substr(0, path.rfind('/'));
+    for(size_t pos = 1; (pos = dir.find('/', pos)) != std::string::npos; pos++)
+        mkdir(dir.substr(0, pos).c_str(), 0755);
+    mkdir(dir.c_str(), 0755);
+    std::ofstream(path) << value << std::endl;
+}
+
+/** 2 nodes, 2 cores per node, 2 threads per core */
+static std::string make_sysfs()
+{
+    char tmpl[] = "/tmp/sems_sysfs_XXXXXX";
+    if(!mkdtemp(tmpl)) return std::string();
+    std::string root = tmpl;
+
+    write_file(root + "/cpu/online", "0-7");
+    for(int cpu = 0; cpu < 8; cpu++) {
+        std::string topology = root + "/cpu/cpu" + std::to_string(cpu) + "/topology/";
+        write_file(topology + "core_id", std::to_string(cpu % 4));
+        write_file(topology + "physical_package_id", std::to_string((cpu % 4) / 2));
+    }
+    write_file(root + "/node/online", "0-1");
+    write_file(root + "/node/node0/cpulist", "0-1,4-5");
+    write_file(root + "/node/node1/cpulist", "2-3,6-7");
+
+    return root;
+}
+
+static int remove_entry(const char *path, const struct stat *, int, struct FTW *)
+{
+    return remove(path);
+}
+
+class CpuPlacementSysfs : public ::testing::Test
+{
+protected:
+    std::string sysfs;
+
+    void SetUp() override
+    {
+        sysfs = make_sysfs();
+        ASSERT_FALSE(sysfs.empty());
+    }
+    void TearDown() override
+    {
+        if(!sysfs.empty())
+            nftw(sysfs.c_str(), remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+    }
+};
+
+TEST(CpuPlacement, CpuList)
+{
+    std::vector<int> cpus;
+    ASSERT_TRUE(parse_cpu_list("0-3,8,10-11", cpus));
+    EXPECT_EQ(cpus, std::vector<int>({0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(cpu_list2str(cpus), "0-3,8,10-11");
+
+    ASSERT_TRUE(parse_cpu_list("", cpus));
+    EXPECT_TRUE(cpus.empty());
+
+    EXPECT_FALSE(parse_cpu_list("3-1", cpus));
+    EXPECT_FALSE(parse_cpu_list("1,a", cpus));
+    EXPECT_FALSE(parse_cpu_list("100000", cpus));
+}
+
+TEST_F(CpuPlacementSysfs, Topology)
+{
+    CpuTopology topology;
+    ASSERT_TRUE(topology.load(sysfs));
+
+    ASSERT_EQ(topology.cpus.size(), 8u);
+    EXPECT_EQ(topology.nodes(), 2u);
+    EXPECT_EQ(topology.nodeCpus(1), std::vector<int>({2, 3, 6, 7}));
+
+    // siblings are grouped, nodes interleaved
+    auto cores = topology.cores();
+    ASSERT_EQ(cores.size(), 4u);
+    EXPECT_EQ(cores[0], std::vector<int>({0, 4}));
+    EXPECT_EQ(cores[1], std::vector<int>({2, 6}));
+    EXPECT_EQ(cores[2], std::vector<int>({1, 5}));
+    EXPECT_EQ(cores[3], std::vector<int>({3, 7}));
+
+    EXPECT_FALSE(topology.load("/nonexistent"));
+}
+
+TEST_F(CpuPlacementSysfs, Select)
+{
+    CpuTopology topology;
+    ASSERT_TRUE(topology.load(sysfs));
+
+    CpuPlacementConfig cfg;
+    EXPECT_TRUE(topology.select(cfg, CPU_ROLE_MEDIA, 0).empty());
+
+    cfg.policy = CpuPlacementConfig::PLACEMENT_ROLE;
+    cfg.role_cpus[CPU_ROLE_RTP] = {1, 2};
+    EXPECT_EQ(topology.select(cfg, CPU_ROLE_RTP, 5), std::vector<int>({1, 2}));
+    EXPECT_TRUE(topology.select(cfg, CPU_ROLE_SIP, 0).empty());
+
+    cfg.policy = CpuPlacementConfig::PLACEMENT_SPREAD;
+    cfg.role_threads[CPU_ROLE_MEDIA] = 2;
+    cfg.role_threads[CPU_ROLE_RTP] = 1;
+    EXPECT_EQ(topology.select(cfg, CPU_ROLE_MEDIA, 1), std::vector<int>({2, 6}));
+    EXPECT_EQ(topology.select(cfg, CPU_ROLE_RTP, 0), std::vector<int>({1, 5}));
+    EXPECT_EQ(topology.select(cfg, CPU_ROLE_SESSION, 0), std::vector<int>({3, 7}));
+    EXPECT_EQ(topology.select(cfg, CPU_ROLE_SESSION, 1), std::vector<int>({0, 4}));
+
+    // media processor and RTP receiver with the same index share the node
+    cfg.policy = CpuPlacementConfig::PLACEMENT_NUMA;
+    for(unsigned int idx = 0; idx < 4; idx++) {
+        auto media = topology.select(cfg, CPU_ROLE_MEDIA, idx);
+        EXPECT_EQ(media, topology.nodeCpus(static_cast<int>(idx % 2)));
+        EXPECT_EQ(media, topology.select(cfg, CPU_ROLE_RTP, idx));
+    }
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <AmEventDispatcher.h>
+
+#include <memory>
+
+namespace {
+
+struct TestQueue: public AmEventQueueInterface {
+    std::vector<int> events;
+    void postEvent(AmEvent* ev) override {
+        events.push_back(ev->event_id);
+        delete ev;
+    }
+};
+
+}
+
+TEST(EventDispatcher, QueueId)
+{
+    std::unique_ptr<AmEventDispatcher> d(new AmEventDispatcher());
+    TestQueue q1, q2;
+    AmEventQueueId id1, id2, id3;
+
+    ASSERT_TRUE(d->addEventQueue("tag1", &q1, &id1));
+    ASSERT_TRUE(d->addEventQueue("tag2", &q2, "callid", "remote", "branch", &id2));
+    EXPECT_NE(id1, EVENT_QUEUE_ID_NONE);
+    EXPECT_NE(id1, id2);
+    EXPECT_EQ(d->getQueueId("tag2"), id2);
+    EXPECT_EQ(d->getQueueId("tag3"), EVENT_QUEUE_ID_NONE);
+    EXPECT_FALSE(d->addEventQueue("tag1", &q2, &id3));
+
+    EXPECT_TRUE(d->post(id1, new AmEvent(1)));
+    EXPECT_TRUE(d->post(id2, new AmEvent(2)));
+    EXPECT_TRUE(d->post("tag2", new AmEvent(3)));
+    EXPECT_TRUE(d->post("callid", "remote", "branch", new AmEvent(4)));
+    EXPECT_EQ(q1.events, std::vector<int>({1}));
+    EXPECT_EQ(q2.events, std::vector<int>({2, 3, 4}));
+
+    // ids are not reused
+    EXPECT_EQ(d->delEventQueue("tag2"), &q2);
+    ASSERT_TRUE(d->addEventQueue("tag2", &q2, &id3));
+    EXPECT_NE(id3, id2);
+
+    AmEvent ev(5);
+    EXPECT_FALSE(d->post(id2, &ev));
+    EXPECT_FALSE(d->post("callid", "remote", "branch", &ev));
+    EXPECT_TRUE(d->post(id3, new AmEvent(6)));
+    EXPECT_EQ(q2.events, std::vector<int>({2, 3, 4, 6}));
+}
+
+TEST(EventDispatcher, IdTable)
+{
+    std::unique_ptr<EventQueueIdTable> t(new EventQueueIdTable());
+    TestQueue q;
+    std::vector<AmEventQueueId> ids;
+
+    // grow the shards and remove every other id from the clusters
+    for(int i = 0; i < 10000; i++)
+        ids.push_back(t->add(&q));
+    EXPECT_EQ(t->size(), ids.size());
+
+    for(size_t i = 0; i < ids.size(); i += 2)
+        EXPECT_TRUE(t->remove(ids[i]));
+    EXPECT_FALSE(t->remove(ids[0]));
+    EXPECT_EQ(t->size(), ids.size() / 2);
+
+    AmEvent ev(0);
+    for(size_t i = 0; i < ids.size(); i++) {
+        bool posted = i % 2;
+        EXPECT_EQ(t->post(ids[i], posted ? new AmEvent(i) : &ev), posted);
+    }
+    EXPECT_EQ(q.events.size(), ids.size() / 2);
+}
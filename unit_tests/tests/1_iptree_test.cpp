@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <IPTree.h>
 #include <sip/ip_util.h>
+#include <AmUtils.h>
 
 TEST(Common, IPTree)
 {
@@ -57,3 +58,91 @@ TEST(Common, IPTree)
         EXPECT_EQ(match_result[i],i);
     }
 }
+
+TEST(Common, CompiledIPTree)
+{
+    IPTree tree;
+    AmSubnet subnet;
+    sockaddr_storage addr;
+    IPTree::MatchResult match_result;
+
+    //empty tree
+    memset(&addr,0,sizeof(sockaddr_storage));
+    am_inet_pton("10.255.0.2", &addr);
+    EXPECT_FALSE(tree.compile()->contains(addr));
+    EXPECT_EQ(tree.compile()->match_longest(addr), -1);
+
+    subnet.parse("10.255.0.2");
+    tree.addSubnet(subnet, 0x3);
+    tree.addSubnet(subnet, 0x4); //collision
+
+    subnet.parse("10.255.0.0/26");
+    tree.addSubnet(subnet, 0x2);
+
+    subnet.parse("10.255.0.0/16");
+    tree.addSubnet(subnet, 0x1);
+
+    subnet.parse("0.0.0.0/0");
+    tree.addSubnet(subnet, 0x0);
+
+    subnet.parse("192.168.0.0/24");
+    tree.addSubnet(subnet, 0x5);
+
+    subnet.parse("dead:beef::1");
+    tree.addSubnet(subnet, 0x2);
+
+    subnet.parse("dead:beef::/64");
+    tree.addSubnet(subnet, 0x1);
+
+    auto compiled = tree.compile();
+    EXPECT_EQ(compiled->size(), 7);
+
+    compiled->match(addr, match_result);
+    ASSERT_EQ(match_result.size(),5);
+    for(int i = 0; i < 5; i++) {
+        EXPECT_EQ(match_result[i],i);
+    }
+    EXPECT_EQ(compiled->match_longest(addr), 3);
+
+    am_inet_pton("10.255.0.64", &addr);
+    match_result.clear();
+    compiled->match(addr, match_result);
+    ASSERT_EQ(match_result.size(),2);
+    EXPECT_EQ(compiled->match_longest(addr), 1);
+
+    am_inet_pton("192.168.1.1", &addr);
+    EXPECT_TRUE(compiled->contains(addr));
+    EXPECT_EQ(compiled->match_longest(addr), 0);
+
+    am_inet_pton("dead:beef::1", &addr);
+    match_result.clear();
+    compiled->match(addr, match_result);
+    ASSERT_EQ(match_result.size(),2);
+    EXPECT_EQ(match_result[0],1);
+    EXPECT_EQ(match_result[1],2);
+
+    am_inet_pton("dead:beef:0:1::1", &addr);
+    EXPECT_FALSE(compiled->contains(addr));
+
+    //compare with IPTree on the random prefixes
+    tree.clear();
+    srand(1);
+    for(int i = 0; i < 2000; i++) {
+        string net = int2str(rand() % 4) + "." + int2str(rand() % 256) + "." +
+                     int2str(rand() % 256) + "." + int2str(rand() % 256) + "/" +
+                     int2str(rand() % 33);
+        ASSERT_TRUE(subnet.parse(net));
+        tree.addSubnet(subnet, i);
+    }
+    compiled = tree.compile();
+    for(int i = 0; i < 10000; i++) {
+        string ip = int2str(rand() % 4) + "." + int2str(rand() % 256) + "." +
+                    int2str(rand() % 256) + "." + int2str(rand() % 256);
+        am_inet_pton(ip.c_str(), &addr);
+        IPTree::MatchResult expected;
+        tree.match(addr, expected);
+        match_result.clear();
+        compiled->match(addr, match_result);
+        ASSERT_EQ(match_result, expected) << ip;
+    }
+}
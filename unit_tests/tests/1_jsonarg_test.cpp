@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <jsonArg.h>
+#include <sstream>
+
+TEST(JsonArg, Parse)
+{
+    AmArg a;
+    ASSERT_TRUE(json2arg("{\"a\": [1, -2, 1.5, \"s\", true, false, null, {}], \"b\": {\"\" :1}}", a));
+    ASSERT_TRUE(isArgArray(a["a"]));
+    EXPECT_EQ(a["a"][0].asInt(), 1);
+    EXPECT_EQ(a["a"][1].asInt(), -2);
+    EXPECT_EQ(a["a"][2].asDouble(), 1.5);
+    EXPECT_STREQ(a["a"][3].asCStr(), "s");
+    EXPECT_TRUE(a["a"][4].asBool());
+    EXPECT_FALSE(a["a"][5].asBool());
+    EXPECT_TRUE(isArgUndef(a["a"][6]));
+    EXPECT_TRUE(isArgStruct(a["a"][7]));
+    EXPECT_EQ(a["b"][""].asInt(), 1);
+
+    //trailing comma is allowed in objects only
+    EXPECT_TRUE(json2arg("{\"a\":1,}", a));
+    EXPECT_FALSE(json2arg("[1,]", a));
+    EXPECT_FALSE(json2arg("{\"result\": [ :1]}", a));
+    EXPECT_FALSE(json2arg("{\"result\": { :1}}", a));
+    EXPECT_FALSE(json2arg("{\"a\":\"unterminated}", a));
+    EXPECT_FALSE(json2arg(" ", a));
+}
+
+TEST(JsonArg, ParseNumbers)
+{
+    AmArg a;
+    ASSERT_TRUE(json2arg("[0E1, 1E1, 5e0, 1E-1, 1.21, 2147483648, -2147483648, 99999999999999999999]", a));
+    EXPECT_TRUE(isArgInt(a[0]) && a[0].asInt() == 0);
+    EXPECT_TRUE(isArgInt(a[1]) && a[1].asInt() == 10);
+    EXPECT_TRUE(isArgInt(a[2]) && a[2].asInt() == 5);
+    EXPECT_TRUE(isArgDouble(a[3]) && a[3].asDouble() == 0.1);
+    EXPECT_TRUE(isArgDouble(a[4]) && a[4].asDouble() == 1.21);
+    EXPECT_TRUE(isArgLongLong(a[5]) && a[5].asLongLong() == 2147483648LL);
+    EXPECT_TRUE(isArgInt(a[6]) && a[6].asInt() == -2147483647 - 1);
+    EXPECT_TRUE(isArgDouble(a[7]));
+
+    EXPECT_FALSE(json2arg("{\"result\": 1E}", a));
+}
+
+TEST(JsonArg, ParseStrings)
+{
+    AmArg a;
+    ASSERT_TRUE(json2arg("\"q\\\" b\\\\ s\\/ \\b\\f\\n\\r\\t \\u00e9 long string to check 8 bytes scan\"", a));
+    EXPECT_STREQ(a.asCStr(), "q\" b\\ s/ \b\f\n\r\t \\u00e9 long string to check 8 bytes scan");
+    EXPECT_FALSE(json2arg("\"\\x\"", a));
+}
+
+TEST(JsonArg, ParseBuffer)
+{
+    AmArg a;
+    const char buf[] = "{\"a\":[1,2]}{\"b\":3}";
+    ASSERT_TRUE(json2arg(buf, 11, a));
+    EXPECT_EQ(a["a"][1].asInt(), 2);
+    EXPECT_FALSE(a.hasMember("b"));
+    EXPECT_FALSE(json2arg(buf, 10, a));
+}
+
+TEST(JsonArg, ParseNesting)
+{
+    AmArg a;
+    EXPECT_TRUE(json2arg(string(100, '[') + string(100, ']'), a));
+    EXPECT_FALSE(json2arg(string(10000, '[') + string(10000, ']'), a));
+}
+
+TEST(JsonArg, Serialize)
+{
+    AmArg a;
+    a["i"] = -5;
+    a["l"] = 1LL << 40;
+    a["b"] = true;
+    a["n"] = AmArg();
+    a["arr"].push(1);
+    a["arr"].push("x");
+    a["s"] = "q\"\\\n\x01 \xc3\xa9 \xf0\x9d\x84\x9e";
+
+    EXPECT_EQ(arg2json(a),
+        "{\"arr\":[1,\"x\"],\"b\":true,\"i\":-5,\"l\":1099511627776,\"n\":null,"
+        "\"s\":\"q\\\"\\\\\\n\\u0001 \\u00e9 \\ud834\\udd1e\"}");
+    EXPECT_EQ(str2json(""), "\"\"");
+    EXPECT_EQ(str2json("0123456789abcdef\""), "\"0123456789abcdef\\\"\"");
+
+    string s = arg2json(a);
+    char buf[256];
+    ASSERT_EQ(arg2json(a, buf, sizeof(buf)), (ssize_t)s.size());
+    EXPECT_EQ(string(buf, s.size()), s);
+    EXPECT_EQ(arg2json(a, buf, s.size() - 1), -1);
+}
+
+TEST(JsonArg, RoundTrip)
+{
+    AmArg a, b;
+    a["test"] = 1;
+    a["test2"].push("asdf");
+    a["test2"].push(1);
+    a["test3"]["nested"] = "with \"quotes\"";
+    ASSERT_TRUE(json2arg(arg2json(a), b));
+    EXPECT_EQ(arg2json(b), arg2json(a));
+    EXPECT_STREQ(b["test3"]["nested"].asCStr(), "with \"quotes\"");
+
+    //istream parser
+    std::istringstream iss(arg2json(a));
+    ASSERT_TRUE(json2arg(iss, b));
+    EXPECT_EQ(arg2json(b), arg2json(a));
+}
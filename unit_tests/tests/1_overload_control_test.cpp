@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <AmOverloadControl.h>
+
+static unsigned int admit_during(AmOverloadController &c,
+                                 unsigned long long &now,
+                                 unsigned int ms, unsigned int cps)
+{
+    unsigned int admitted = 0;
+    unsigned int step = 1000 / cps;
+    for(unsigned int t = 0; t < ms; t += step) {
+        if(c.admit(now + t)) admitted++;
+    }
+    now += ms;
+    return admitted;
+}
+
+TEST(OverloadControl, Decrease)
+{
+    OverloadControlConfig cfg;
+    cfg.decrease_percent = 50;
+    cfg.min_cps = 10;
+
+    unsigned long long now = 1000000;
+    AmOverloadController c(cfg, now);
+
+    // 100 cps are admitted without overload
+    EXPECT_EQ(admit_during(c, now, 1000, 100), 100u);
+    ASSERT_TRUE(c.sampleDue(now));
+    c.onSample(OverloadSample(), now);
+    EXPECT_EQ(c.getState(), AmOverloadController::NORMAL);
+    EXPECT_EQ(c.getLimit(), 0u);
+
+    EXPECT_EQ(admit_during(c, now, 1000, 100), 100u);
+    OverloadSample overloaded;
+    overloaded.media_tick_lateness_us = (cfg.media_tick_lateness + 1) * 1000;
+    c.onSample(overloaded, now);
+    EXPECT_EQ(c.getState(), AmOverloadController::OVERLOAD);
+    EXPECT_EQ(c.getLimit(), 50u);
+
+    unsigned int admitted = admit_during(c, now, 1000, 100);
+    EXPECT_GE(admitted, 49u);
+    EXPECT_LE(admitted, 51u);
+
+    // limit goes down to min_cps
+    overloaded.media_tick_lateness_us = 0;
+    overloaded.session_queue_depth = cfg.session_queue_depth + 1;
+    c.onSample(overloaded, now);
+    EXPECT_EQ(c.getLimit(), 25u);
+    c.onSample(overloaded, now);
+    c.onSample(overloaded, now);
+    EXPECT_EQ(c.getLimit(), 10u);
+}
+
+TEST(OverloadControl, Recovery)
+{
+    OverloadControlConfig cfg;
+    cfg.decrease_percent = 50;
+    cfg.increase_cps = 10;
+
+    unsigned long long now = 1000000;
+    AmOverloadController c(cfg, now);
+
+    admit_during(c, now, 1000, 100);
+    OverloadSample overloaded;
+    overloaded.timer_lag_us = (cfg.timer_lag + 1) * 1000;
+    c.onSample(overloaded, now);
+    ASSERT_EQ(c.getLimit(), 50u);
+
+    // healthy but still limiting
+    admit_during(c, now, 1000, 100);
+    c.onSample(OverloadSample(), now);
+    EXPECT_EQ(c.getState(), AmOverloadController::RECOVERY);
+    EXPECT_EQ(c.getLimit(), 60u);
+
+    // offered load is below the limit
+    now += 100;
+    EXPECT_EQ(admit_during(c, now, 1000, 20), 20u);
+    c.onSample(OverloadSample(), now);
+    EXPECT_EQ(c.getState(), AmOverloadController::NORMAL);
+    EXPECT_EQ(c.getLimit(), 0u);
+}
+
+TEST(OverloadControl, DisabledSignals)
+{
+    OverloadControlConfig cfg;
+    cfg.media_tick_lateness = 0;
+    cfg.rtp_drop_rate = 100;
+
+    unsigned long long now = 1000000;
+    AmOverloadController c(cfg, now);
+
+    OverloadSample s;
+    s.media_tick_lateness_us = 1000000;
+    s.rtp_drops = 50;
+    now += 1000;
+    c.onSample(s, now);
+    EXPECT_EQ(c.getState(), AmOverloadController::NORMAL);
+
+    // 200 drops in one second
+    s.rtp_drops = 200;
+    now += 1000;
+    c.onSample(s, now);
+    EXPECT_EQ(c.getState(), AmOverloadController::OVERLOAD);
+
+    AmArg info;
+    c.getInfo(info);
+    EXPECT_EQ(info["overload_signal"].asCStr(), std::string("rtp_drop_rate"));
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <RegShaper.h>
+#include <AmStatistics.h>
+
+using std::chrono::milliseconds;
+
+static unsigned long long shaper_keys_gauge(const string &key_class)
+{
+    unsigned long long ret = 0;
+    stat_group(Gauge, "core", "shaper_keys").iterate_counters(
+        [&](unsigned long long value, const map<string, string> &labels) {
+            auto it = labels.find("class");
+            if(it != labels.end() && it->second == key_class) ret = value;
+        });
+    return ret;
+}
+
+TEST(RegShaper, Disabled)
+{
+    RegShaper shaper("test_disabled");
+    RegShaper::timep now = std::chrono::system_clock::now(), next;
+
+    EXPECT_FALSE(shaper.is_enabled());
+    for(int i = 0; i < 10; i++) {
+        EXPECT_FALSE(shaper.check_rate_limit("key", now, next));
+        EXPECT_FALSE(shaper.over_limit("key", now));
+    }
+    EXPECT_EQ(shaper.keys_count(), 0u);
+}
+
+TEST(RegShaper, MinInterval)
+{
+    RegShaper shaper("test_min_interval");
+    RegShaper::timep now = std::chrono::system_clock::now(), next;
+    shaper.set_min_interval(100);
+
+    EXPECT_FALSE(shaper.check_rate_limit("key", now, next));
+
+    //postponed requests reserve consecutive slots
+    ASSERT_TRUE(shaper.check_rate_limit("key", now, next));
+    EXPECT_EQ(next, now + milliseconds(100));
+    ASSERT_TRUE(shaper.check_rate_limit("key", now, next));
+    EXPECT_EQ(next, now + milliseconds(200));
+
+    //other keys are not affected
+    EXPECT_FALSE(shaper.check_rate_limit("other", now, next));
+    EXPECT_EQ(shaper.keys_count(), 2u);
+
+    EXPECT_FALSE(shaper.check_rate_limit("key", now + milliseconds(300), next));
+}
+
+TEST(RegShaper, Burst)
+{
+    RegShaper shaper("test_burst");
+    RegShaper::timep now = std::chrono::system_clock::now();
+    //10 per second, up to 5 at once
+    shaper.set_rate(10, 1000, 5);
+
+    for(int i = 0; i < 5; i++)
+        EXPECT_FALSE(shaper.over_limit("key", now));
+
+    //dropped requests do not take tokens
+    for(int i = 0; i < 5; i++)
+        EXPECT_TRUE(shaper.over_limit("key", now));
+
+    EXPECT_FALSE(shaper.over_limit("key", now + milliseconds(100)));
+    EXPECT_TRUE(shaper.over_limit("key", now + milliseconds(100)));
+
+    //bucket is full again
+    now += milliseconds(1000);
+    for(int i = 0; i < 5; i++)
+        EXPECT_FALSE(shaper.over_limit("key", now));
+    EXPECT_TRUE(shaper.over_limit("key", now));
+}
+
+TEST(RegShaper, NextAttemptTime)
+{
+    RegShaper shaper("test_next_attempt");
+    RegShaper::timep now = std::chrono::system_clock::now(), next;
+    shaper.set_rate(10, 1000, 2);
+
+    EXPECT_FALSE(shaper.over_limit("key", now, &next));
+    EXPECT_FALSE(shaper.over_limit("key", now, &next));
+    ASSERT_TRUE(shaper.over_limit("key", now, &next));
+    EXPECT_EQ(next, now + milliseconds(100));
+
+    //dropped requests do not reserve the next token
+    ASSERT_TRUE(shaper.over_limit("key", now + milliseconds(50), &next));
+    EXPECT_EQ(next, now + milliseconds(100));
+    EXPECT_FALSE(shaper.over_limit("key", now + milliseconds(100)));
+}
+
+TEST(RegShaper, Drain)
+{
+    RegShaper shaper("test_drain");
+    RegShaper::timep now = std::chrono::system_clock::now();
+    shaper.set_rate(10, 1000, 10);
+
+    shaper.drain("key", now);
+    EXPECT_TRUE(shaper.over_limit("key", now));
+    EXPECT_TRUE(shaper.over_limit("key", now + milliseconds(99)));
+    EXPECT_FALSE(shaper.over_limit("key", now + milliseconds(100)));
+    EXPECT_TRUE(shaper.over_limit("key", now + milliseconds(100)));
+}
+
+TEST(RegShaper, Expiry)
+{
+    RegShaper shaper("test_expiry");
+    RegShaper::timep now = std::chrono::system_clock::now();
+    shaper.set_rate(1, 1000, 2);
+    shaper.set_idle_timeout(5000);
+
+    for(int i = 0; i < 100; i++)
+        shaper.over_limit("key" + std::to_string(i), now);
+    EXPECT_EQ(shaper.keys_count(), 100u);
+
+    //buckets are not full yet
+    shaper.cleanup(now + milliseconds(5000));
+    EXPECT_EQ(shaper.keys_count(), 100u);
+
+    shaper.over_limit("key0", now + milliseconds(5000));
+    shaper.cleanup(now + milliseconds(6000));
+    EXPECT_EQ(shaper.keys_count(), 1u);
+
+    shaper.cleanup(now + milliseconds(11000));
+    EXPECT_EQ(shaper.keys_count(), 0u);
+}
+
+TEST(RegShaper, KeysGauge)
+{
+    RegShaper::timep now = std::chrono::system_clock::now();
+    {
+        RegShaper shaper("test_keys_gauge");
+        shaper.set_rate(1, 1000, 1);
+        for(int i = 0; i < 3; i++)
+            shaper.over_limit("key" + std::to_string(i), now);
+        EXPECT_EQ(shaper_keys_gauge("test_keys_gauge"), 3u);
+
+        //replaced shaper of the same class
+        RegShaper other("test_keys_gauge");
+        other.set_rate(1, 1000, 1);
+        other.over_limit("key", now);
+        EXPECT_EQ(shaper_keys_gauge("test_keys_gauge"), 4u);
+    }
+    EXPECT_EQ(shaper_keys_gauge("test_keys_gauge"), 0u);
+}
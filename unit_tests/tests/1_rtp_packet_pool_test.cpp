@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <AmRtpPacketPool.h>
+
+#include <string.h>
+
+TEST(RtpPacketPool, GetPut)
+{
+    AmRtpPacketPool::setThreadPool("test");
+    AmRtpPacketPool* pool = AmRtpPacketPool::current();
+
+    AmRtpPacket* p1 = pool->get();
+    AmRtpPacket* p2 = pool->get();
+    ASSERT_TRUE(p1 && p2);
+    EXPECT_NE(p1, p2);
+    EXPECT_EQ(p1->pool, pool);
+
+    AmRtpPacketPool::put(p2);
+    EXPECT_EQ(pool->get(), p2);
+
+    AmArg info;
+    AmRtpPacketPool::getInfo(info);
+    ASSERT_TRUE(info.hasMember("test"));
+    EXPECT_EQ(info["test"]["size"].asLongLong(), RTP_PACKET_POOL_CHUNK);
+    EXPECT_EQ(info["test"]["used"].asLongLong(), 2);
+
+    AmRtpPacketPool::put(p1);
+    AmRtpPacketPool::put(p2);
+}
+
+TEST(RtpPacketPool, LargeBuffer)
+{
+    AmRtpPacketPool::setThreadPool("test");
+    AmRtpPacket* p = AmRtpPacketPool::current()->get();
+    ASSERT_TRUE(p);
+
+    unsigned char data[RTP_PACKET_BUF_SIZE];
+    memset(data, 0x5a, sizeof(data));
+
+    p->setBuffer(data, 160);
+    EXPECT_FALSE(p->hasLargeBuffer());
+
+    p->setBuffer(data, 3000);
+    ASSERT_TRUE(p->hasLargeBuffer());
+    EXPECT_EQ(p->getBufferSize(), 3000u);
+    EXPECT_EQ(memcmp(p->getBuffer(), data, 3000), 0);
+
+    // content is kept when the buffer grows
+    p->setBuffer(data, 1000);
+    p->releaseLargeBuffer();
+    p->setBuffer(data, 1000);
+    ASSERT_TRUE(p->reserveBuffer(2000));
+    EXPECT_EQ(memcmp(p->getBuffer(), data, 1000), 0);
+
+    EXPECT_FALSE(p->reserveBuffer(RTP_PACKET_BUF_SIZE + 1));
+
+    AmRtpPacketPool::put(p);
+    EXPECT_FALSE(p->hasLargeBuffer());
+}
@@ -0,0 +1,21 @@
+#include <gtest/gtest.h>
+#include <AmSdp.h>
+#include <AmSrtpConnection.h>
+
+TEST(SrtpProfiles, AeadGcm)
+{
+    EXPECT_EQ(SdpCrypto::str2profile("AEAD_AES_128_GCM"), CP_AEAD_AES_128_GCM);
+    EXPECT_EQ(SdpCrypto::str2profile("aead_aes_256_gcm"), CP_AEAD_AES_256_GCM);
+    EXPECT_EQ(SdpCrypto::profile2str(CP_AEAD_AES_128_GCM), "AEAD_AES_128_GCM");
+    EXPECT_EQ(SdpCrypto::profile2str(CP_AEAD_AES_256_GCM), "AEAD_AES_256_GCM");
+
+    // rfc7714 12: 16/32 bytes key with 12 bytes salt
+    srtp_profile_t gcm128 = static_cast<srtp_profile_t>(CP_AEAD_AES_128_GCM);
+    srtp_profile_t gcm256 = static_cast<srtp_profile_t>(CP_AEAD_AES_256_GCM);
+    EXPECT_EQ(srtp::profile_get_master_key_length(gcm128), 16);
+    EXPECT_EQ(srtp::profile_get_master_salt_length(gcm128), 12);
+    EXPECT_EQ(srtp::profile_get_master_key_length(gcm256), 32);
+    EXPECT_EQ(srtp::profile_get_master_salt_length(gcm256), 12);
+    EXPECT_LE(srtp::profile_get_master_key_length(gcm256) +
+              srtp::profile_get_master_salt_length(gcm256), SRTP_KEY_SIZE);
+}
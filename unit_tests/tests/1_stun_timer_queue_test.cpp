@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include <AmStunProcessor.h>
+
+static AmStunConnection *conn(uintptr_t id)
+{
+    return reinterpret_cast<AmStunConnection *>(id);
+}
+
+TEST(StunTimerQueue, Expire)
+{
+    AmStunTimerQueue q;
+    std::vector<AmStunConnection *> expired;
+
+    q.arm(conn(1), 300);
+    q.arm(conn(2), 100);
+    q.arm(conn(3), 200);
+    EXPECT_EQ(q.size(), 3u);
+
+    q.expire(100, expired);
+    EXPECT_TRUE(expired.empty());
+
+    q.expire(250, expired);
+    ASSERT_EQ(expired.size(), 2u);
+    EXPECT_EQ(expired[0], conn(2));
+    EXPECT_EQ(expired[1], conn(3));
+    EXPECT_FALSE(q.armed(conn(2)));
+    EXPECT_TRUE(q.armed(conn(1)));
+    EXPECT_EQ(q.size(), 1u);
+}
+
+TEST(StunTimerQueue, RearmCancel)
+{
+    AmStunTimerQueue q;
+    std::vector<AmStunConnection *> expired;
+
+    q.arm(conn(1), 100);
+    q.arm(conn(2), 100);
+    q.arm(conn(1), 500);
+    EXPECT_EQ(q.size(), 2u);
+
+    EXPECT_TRUE(q.cancel(conn(2)));
+    EXPECT_FALSE(q.cancel(conn(2)));
+
+    q.expire(200, expired);
+    EXPECT_TRUE(expired.empty());
+
+    q.expire(1000, expired);
+    ASSERT_EQ(expired.size(), 1u);
+    EXPECT_EQ(expired[0], conn(1));
+    EXPECT_EQ(q.size(), 0u);
+}
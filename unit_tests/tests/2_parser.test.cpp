@@ -4,6 +4,7 @@
 #include <sip/parse_header.h>
 #include <sip/parse_nameaddr.h>
 #include <AmUriParser.h>
+#include <AmSipMsg.h>
 
 TEST(SipParser, Parsing)
 {
@@ -167,3 +168,66 @@ TEST(Parser, AmUriParser)
     ASSERT_EQ((++p.params.begin())->first, "hdr_param_n_2");
     ASSERT_EQ((++p.params.begin())->second, "hdr_param_v_2");
 }
+
+TEST(SipParser, HeadersIndex)
+{
+    AmSipReply reply;
+    const char *headers[][2] = {
+        { "Supported", "100rel, timer" },
+        { "X-Test", "first" },
+        { "Expires", "  3600" },
+        { "x-test", "second" },
+        { "X-Test-Long", "other" },
+        { "k", "compact" },
+    };
+
+    AmSipHeadersIndex index;
+    string &hdrs = reply.hdrs.modify();
+    for(const auto &h : headers) {
+        size_t name_offset = hdrs.length();
+        hdrs += string(h[0]) + ": ";
+        size_t value_offset = hdrs.length();
+        hdrs += h[1];
+        while(hdrs[value_offset] == ' ') value_offset++;
+        index.add(name_offset, strlen(h[0]), hdrs,
+                  value_offset, hdrs.length() - value_offset);
+        hdrs += "\r\n";
+    }
+    reply.hdrs.setIndex(std::move(index));
+    ASSERT_TRUE(reply.hdrs.index().valid());
+
+    const char *names[] = { "X-Test", "x-TEST", "Expires", "Supported", "X-Test-Long", "X-Tes", "Missed", "" };
+    for(const auto &name : names) {
+        EXPECT_EQ(reply.getHeader(name), getHeader(reply.hdrs, name)) << name;
+        EXPECT_EQ(reply.getHeader(name, true), getHeader(reply.hdrs, name, true)) << name;
+        EXPECT_EQ(reply.hasHeader(name), hasHeader(reply.hdrs, name)) << name;
+    }
+    EXPECT_EQ(reply.getHeader("X-Test"), "first, second");
+    EXPECT_EQ(reply.getHeader("Expires", true), "3600");
+    EXPECT_EQ(reply.getHeader("Supported", "k", true), "100rel, timer");
+    EXPECT_EQ(reply.getHeader("Require", "k", true), "compact");
+
+    //copies keep the index
+    AmSipReply copy(reply);
+    EXPECT_TRUE(copy.hdrs.index().valid());
+    EXPECT_EQ(copy.getHeader("X-Test", true), "first");
+
+    //any modification drops the index
+    AmSipReply same_len(reply);
+    same_len.hdrs.replace(same_len.hdrs.find("first"), 5, "third");
+    EXPECT_FALSE(same_len.hdrs.index().valid());
+    EXPECT_EQ(same_len.getHeader("X-Test", true), "third");
+    same_len.hdrs.replace(same_len.hdrs.find("Expires"), 7, "Ex-Pire");
+    EXPECT_FALSE(same_len.hasHeader("Expires"));
+
+    copy.hdrs += "X-Added: value\r\n";
+    EXPECT_FALSE(copy.hdrs.index().valid());
+    EXPECT_EQ(copy.getHeader("X-Added"), "value");
+    removeHeader(copy.hdrs.modify(), "X-Test");
+    EXPECT_FALSE(copy.hasHeader("X-Test"));
+
+    AmSipReply assigned(reply);
+    assigned.hdrs = "X-Test: assigned\r\n";
+    EXPECT_FALSE(assigned.hdrs.index().valid());
+    EXPECT_EQ(assigned.getHeader("X-Test"), "assigned");
+}
@@ -0,0 +1,206 @@
+#include <AmPromptCache.h>
+#include <AmRtpAudio.h>
+#include <AmPlugIn.h>
+#include <amci/codecs.h>
+#include <gtest/gtest.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <vector>
+
+#define TEST_PROMPT_RATE 8000
+#define TEST_PROMPT_FRAME 160
+
+static void write_le(FILE* f, uint32_t v, int bytes)
+{
+    for(int i = 0; i < bytes; i++)
+        fputc((v >> (8 * i)) & 0xff, f);
+}
+
+/** one second of 440Hz, 16 bit mono wav */
+static bool write_test_prompt(int fd)
+{
+    std::vector<int16_t> pcm(TEST_PROMPT_RATE);
+    for(size_t i = 0; i < pcm.size(); i++)
+        pcm[i] = (int16_t)(8000 * sin(i * 2 * M_PI * 440 / TEST_PROMPT_RATE));
+    uint32_t data_size = pcm.size() * 2;
+
+    FILE* f = fdopen(fd, "wb");
+    if(!f) return false;
+    fwrite("RIFF", 1, 4, f);
+    write_le(f, 36 + data_size, 4);
+    fwrite("WAVEfmt ", 1, 8, f);
+    write_le(f, 16, 4);
+    write_le(f, 1, 2); //PCM
+    write_le(f, 1, 2); //channels
+    write_le(f, TEST_PROMPT_RATE, 4);
+    write_le(f, TEST_PROMPT_RATE * 2, 4);
+    write_le(f, 2, 2);
+    write_le(f, 16, 2);
+    fwrite("data", 1, 4, f);
+    write_le(f, data_size, 4);
+    for(size_t i = 0; i < pcm.size(); i++)
+        write_le(f, (uint16_t)pcm[i], 2);
+    return fclose(f) == 0;
+}
+
+static void set_pcmu(AmAudioRtpFormat& fmt)
+{
+    Payload pl;
+    pl.pt = 0;
+    pl.name = "PCMU";
+    pl.clock_rate = TEST_PROMPT_RATE;
+    pl.advertised_clock_rate = TEST_PROMPT_RATE;
+    pl.codec_id = CODEC_ULAW;
+    fmt.setCurrentPayload(pl, 20);
+}
+
+/** frames are encoded by the prompt cache thread */
+static std::shared_ptr<const AmPromptFrames> wait_frames(
+    const std::shared_ptr<AmPromptCacheEntry>& entry, AmAudioFormat& fmt)
+{
+    std::shared_ptr<const AmPromptFrames> f = entry->getFrames(fmt);
+    for(int i = 0; i < 5000 && !f->ready(); i++)
+        usleep(1000);
+    return f;
+}
+
+class PromptCacheTest : public ::testing::Test
+{
+protected:
+    string fname;
+
+    void SetUp() override
+    {
+        char tmpl[] = "/tmp/sems_prompt_cache_XXXXXX.wav";
+        int fd = mkstemps(tmpl, 4);
+        ASSERT_NE(fd, -1);
+        fname = tmpl;
+        ASSERT_TRUE(write_test_prompt(fd));
+    }
+    void TearDown() override
+    {
+        AmPromptCache::instance()->resume();
+        if(!fname.empty())
+            unlink(fname.c_str());
+    }
+};
+
+TEST_F(PromptCacheTest, SharedFile)
+{
+    std::shared_ptr<AmPromptCacheEntry> e1 = AmPromptCache::instance()->get(fname);
+    std::shared_ptr<AmPromptCacheEntry> e2 = AmPromptCache::instance()->get(fname);
+    ASSERT_TRUE(e1.get());
+    EXPECT_EQ(e1.get(), e2.get());
+
+    EXPECT_FALSE(AmPromptCache::instance()->get("/nonexistent/prompt.wav").get());
+
+    //loaded again when released by all users
+    e1.reset();
+    e2.reset();
+    e1 = AmPromptCache::instance()->get(fname);
+    EXPECT_TRUE(e1.get());
+}
+
+TEST_F(PromptCacheTest, EncodedFrames)
+{
+    std::shared_ptr<AmPromptCacheEntry> entry = AmPromptCache::instance()->get(fname);
+    ASSERT_TRUE(entry.get());
+
+    amci_codec_t* ulaw = AmPlugIn::instance()->codec(CODEC_ULAW);
+    ASSERT_TRUE(ulaw && ulaw->encode);
+
+    AmAudioRtpFormat rtp_fmt;
+    set_pcmu(rtp_fmt);
+    ASSERT_TRUE(rtp_fmt.getCodec());
+    ASSERT_TRUE(wait_frames(entry, rtp_fmt)->good());
+
+    //frames are the same as decoded and encoded on every playback
+    AmCachedAudioFile ref(entry->getFile());
+    AmCachedPromptFile prompt(entry);
+    unsigned char pcm[AUDIO_BUFFER_SIZE], expected[AUDIO_BUFFER_SIZE], buf[AUDIO_BUFFER_SIZE];
+    int frames = 0;
+    for(;;) {
+        int got = ref.get(0, pcm, TEST_PROMPT_RATE, TEST_PROMPT_FRAME);
+        int s = prompt.getEncoded(0, rtp_fmt, buf);
+        if(got <= 0) {
+            EXPECT_EQ(s, -2);
+            break;
+        }
+        int e = (*ulaw->encode)(expected, pcm, got, 1, TEST_PROMPT_RATE, 0);
+        ASSERT_EQ(s, e);
+        EXPECT_EQ(memcmp(buf, expected, e), 0);
+        frames++;
+    }
+    EXPECT_GT(frames, 40);
+
+    //the other playback uses the same frames
+    std::shared_ptr<const AmPromptFrames> f1 = entry->getFrames(rtp_fmt);
+    std::shared_ptr<const AmPromptFrames> f2 = entry->getFrames(rtp_fmt);
+    EXPECT_TRUE(f1->good());
+    EXPECT_EQ(f1.get(), f2.get());
+    EXPECT_EQ(f1->count(), (size_t)frames);
+}
+
+TEST_F(PromptCacheTest, SwitchToDecoded)
+{
+    std::shared_ptr<AmPromptCacheEntry> entry = AmPromptCache::instance()->get(fname);
+    ASSERT_TRUE(entry.get());
+
+    AmAudioRtpFormat rtp_fmt;
+    set_pcmu(rtp_fmt);
+    ASSERT_TRUE(wait_frames(entry, rtp_fmt)->good());
+
+    AmCachedAudioFile ref(entry->getFile());
+    AmCachedPromptFile prompt(entry);
+    unsigned char expected[AUDIO_BUFFER_SIZE], buf[AUDIO_BUFFER_SIZE];
+
+    for(int i = 0; i < 10; i++) {
+        ASSERT_GT(prompt.getEncoded(0, rtp_fmt, buf), 0);
+        ASSERT_GT(ref.get(0, expected, TEST_PROMPT_RATE, TEST_PROMPT_FRAME), 0);
+    }
+
+    //playback continues at the same position
+    int got = prompt.get(0, buf, TEST_PROMPT_RATE, TEST_PROMPT_FRAME);
+    ASSERT_EQ(got, ref.get(0, expected, TEST_PROMPT_RATE, TEST_PROMPT_FRAME));
+    EXPECT_EQ(memcmp(buf, expected, got), 0);
+}
+
+TEST_F(PromptCacheTest, PlayedWhileEncoding)
+{
+    std::shared_ptr<AmPromptCacheEntry> entry = AmPromptCache::instance()->get(fname);
+    ASSERT_TRUE(entry.get());
+
+    AmAudioRtpFormat rtp_fmt;
+    set_pcmu(rtp_fmt);
+
+    //the file is played until the frames are encoded
+    AmPromptCache::instance()->suspend();
+    AmCachedPromptFile prompt(entry);
+    unsigned char buf[AUDIO_BUFFER_SIZE];
+    ASSERT_EQ(prompt.getEncoded(0, rtp_fmt, buf), 0);
+    EXPECT_FALSE(entry->getFrames(rtp_fmt)->ready());
+    for(int i = 0; i < 10; i++) {
+        ASSERT_GT(prompt.get(0, buf, TEST_PROMPT_RATE, TEST_PROMPT_FRAME), 0);
+        ASSERT_EQ(prompt.getEncoded(0, rtp_fmt, buf), 0);
+    }
+
+    AmPromptCache::instance()->resume();
+    ASSERT_TRUE(wait_frames(entry, rtp_fmt)->good());
+    EXPECT_GT(prompt.getEncoded(0, rtp_fmt, buf), 0);
+}
+
+TEST(PromptCache, ZeroRate)
+{
+    AmAudioRtpFormat rtp_fmt;
+    set_pcmu(rtp_fmt);
+
+    AmPromptFrames f(rtp_fmt);
+    f.rate = 0;
+    EXPECT_EQ(f.frameTime(), 0u);
+    EXPECT_FALSE(f.matches(rtp_fmt));
+}
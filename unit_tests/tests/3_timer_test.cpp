@@ -1,11 +1,13 @@
 #include <gtest/gtest.h>
 #include <string>
+#include <vector>
 #include <AmAppTimer.h>
 #include <DirectAppTimer.h>
 #include <AmEventProcessingThread.h>
 #include <AmEventDispatcher.h>
 
 #define TIMER_RECEIVER_QUEUE_NAME "TimerReceiver"
+#define APP_TIMER_STOP_ID 100
 
 class TimerEvent : public AmEvent
 {
@@ -37,6 +39,7 @@ protected:
     ReuseTimer timer;
     bool is_stop;
     int seq;
+    std::vector<int> app_timers_fired;
 public:
     TimerTest() : timer(this), is_stop(false), seq(0){}
     ~TimerTest() {
@@ -60,6 +63,13 @@ public:
     }
 
     void onEvent(AmEvent* event) override {
+        AmPluginEvent* pev = dynamic_cast<AmPluginEvent*>(event);
+        if(pev && pev->name == TIMEOUTEVENT_NAME) {
+            int id = pev->data.get(0).asInt();
+            app_timers_fired.push_back(id);
+            if(id == APP_TIMER_STOP_ID) is_stop = true;
+            return;
+        }
         TimerEvent* tev = dynamic_cast<TimerEvent*>(event);
         if(tev) {
             EXPECT_EQ(tev->seq, seq);
@@ -91,3 +101,22 @@ TEST_F(TimerTest, ReuseTimer) {
 
 
 
+
+TEST_F(TimerTest, AppTimers) {
+    AmAppTimer::instance()->setTimer(TIMER_RECEIVER_QUEUE_NAME, 4, 0.02);
+    AmAppTimer::instance()->setTimer(TIMER_RECEIVER_QUEUE_NAME, 5, 0.02);
+    AmAppTimer::instance()->removeTimers(TIMER_RECEIVER_QUEUE_NAME);
+
+    AmAppTimer::instance()->setTimer(TIMER_RECEIVER_QUEUE_NAME, 1, 0.02);
+    AmAppTimer::instance()->setTimer(TIMER_RECEIVER_QUEUE_NAME, 2, 0.02);
+    AmAppTimer::instance()->removeTimer(TIMER_RECEIVER_QUEUE_NAME, 2);
+
+    //reset
+    AmAppTimer::instance()->setTimer(TIMER_RECEIVER_QUEUE_NAME, 3, 10);
+    AmAppTimer::instance()->setTimer(TIMER_RECEIVER_QUEUE_NAME, 3, 0.06);
+
+    AmAppTimer::instance()->setTimer(TIMER_RECEIVER_QUEUE_NAME, APP_TIMER_STOP_ID, 0.2);
+    run();
+
+    EXPECT_EQ(app_timers_fired, std::vector<int>({1, 3, APP_TIMER_STOP_ID}));
+}
@@ -1,10 +1,13 @@
 #include "../Config.h"
 #include <sip/ws_trsp.h>
+#include <sip/tcp_trsp.h>
 #include <AmLcConfig.h>
 #include <gtest/gtest.h>
 #include <string>
 #include <AmSipDialog.h>
 #include <sip/sip_parser.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 using std::string;
 
@@ -114,3 +117,62 @@ TEST(TransportTest, WebSocket)
     worker.send(&server, &sa, data, sizeof(data), 0);
     worker.join();
 }
+
+class tcp_trsp_test : public tcp_trsp_socket
+{
+public:
+    tcp_trsp_test(trsp_server_socket* server_sock, int sd,
+                  const sockaddr_storage* sa, event_base* evbase)
+    : tcp_trsp_socket(server_sock, nullptr, sd, sa, trsp_socket::tcp_ipv4, evbase, new tcp_input)
+    {
+        connected = true;
+    }
+
+    void write() { on_write(EV_WRITE); }
+};
+
+TEST(TransportTest, TcpSendQueue)
+{
+    unsigned int idx = AmConfig.sip_if_names[test_config::instance()->signalling_interface];
+    ASSERT_TRUE(AmConfig.sip_ifs[idx].proto_info.size());
+
+    tcp_server_socket server(idx, 0, 0, trsp_socket::tcp_ipv4);
+    server.set_send_queue_watermarks(1000, 500);
+
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    event_base* evbase = event_base_new();
+
+    sockaddr_storage sa;
+    server.copy_addr_to(&sa);
+    tcp_trsp_test* sock = new tcp_trsp_test(&server, fds[0], &sa, evbase);
+    inc_ref(sock);
+
+    string msg(300, 'a');
+    for(int i = 0; i < 3; i++)
+        EXPECT_EQ(sock->send(&sa, msg.data(), msg.size(), 0), 0);
+    // over the high watermark
+    EXPECT_EQ(sock->send(&sa, msg.data(), msg.size(), 0), TRSP_SEND_QUEUE_FULL);
+    // rejected until drained below the low watermark
+    EXPECT_EQ(sock->send(&sa, msg.data(), 10, 0), TRSP_SEND_QUEUE_FULL);
+
+    // queued messages are coalesced into one writev()
+    sock->write();
+    char buf[2000];
+    EXPECT_EQ(read(fds[1], buf, sizeof(buf)), 900);
+
+    AmArg info;
+    sock->getInfo(info);
+    EXPECT_EQ(info["queue_bytes"].asLongLong(), 0);
+    EXPECT_EQ(info["queue_peak_bytes"].asLongLong(), 900);
+    EXPECT_EQ(info["queue_rejects"].asLongLong(), 2);
+    EXPECT_EQ(info["writev_calls"].asLongLong(), 1);
+    EXPECT_EQ(info["writev_msgs"].asLongLong(), 3);
+    EXPECT_FALSE(info["queue_congested"].asBool());
+
+    EXPECT_EQ(sock->send(&sa, msg.data(), msg.size(), 0), 0);
+
+    dec_ref(sock);
+    close(fds[1]);
+    event_base_free(evbase);
+}